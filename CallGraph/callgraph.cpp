@@ -41,6 +41,7 @@
 #include <wx/txtstrm.h>
 #include <wx/sstream.h>
 #include <wx/mstream.h>
+#include <wx/stopwatch.h>
 
 #include "file_logger.h"
 #include <wx/msgdlg.h>
@@ -92,6 +93,9 @@ extern "C" EXPORT PluginInfo GetPluginInfo()
     info.SetName(wxT("CallGraph"));
     info.SetDescription(_("Create application call graph from profiling information provided by gprof tool."));
     info.SetVersion(wxT("v1.1.0"));
+    // Only needed once there is something to profile
+    info.SetActivateOnWorkspace(wxT("*.workspace"));
+    info.SetActivateOnMenu(true);
     return info;
 }
 
@@ -483,9 +487,13 @@ void CallGraph::OnShowCallGraph(wxCommandEvent& event)
     // start parsing and writing to dot language file
     GprofParser pgp;
 
+    wxStopWatch parseTime;
     pgp.GprofParserStream(process_is);
 
-    // myLog("gprof done (read %d lines)", (int) pgp.lines.GetCount());
+    CL_DEBUG("CallGraph: gprof output parsed in %ld ms (%lu functions, %lu calls)",
+             parseTime.Time(),
+             (unsigned long)pgp.callgraph.functions.size(),
+             (unsigned long)pgp.callgraph.edges.size());
 
     delete proc;
 
@@ -496,7 +504,7 @@ void CallGraph::OnShowCallGraph(wxCommandEvent& event)
     DotWriter dotWriter;
 
     // DotWriter
-    dotWriter.SetLineParser(&(pgp.lines));
+    dotWriter.SetCallGraph(&(pgp.callgraph));
 
     int suggestedThreshold = pgp.GetSuggestedNodeThreshold();
 
@@ -553,7 +561,7 @@ void CallGraph::OnShowCallGraph(wxCommandEvent& event)
         return MessageBox(_("Failed to open file CallGraph.png. Please check the project settings, rebuild the project and try again."), wxICON_INFORMATION);
 
     // show image and create table in the editor tab page
-    uicallgraphpanel	*panel = new uicallgraphpanel(m_mgr->GetEditorPaneNotebook(), m_mgr, output_png_fn, base_path, suggestedThreshold, &(pgp.lines));
+    uicallgraphpanel	*panel = new uicallgraphpanel(m_mgr->GetEditorPaneNotebook(), m_mgr, output_png_fn, base_path, suggestedThreshold, &(pgp.callgraph));
 
     wxString	tstamp = wxDateTime::Now().Format(wxT(" %Y-%m-%d %H:%M:%S"));
 
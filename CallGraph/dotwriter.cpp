@@ -47,7 +47,7 @@ DotWriter::DotWriter()
 	dlabel = wxT("");
 	graph = wxT("");
 	// m_OutputString = wxT("");
-	mlines = NULL;
+	mgraph = NULL;
 	dwcn = 0;
 	dwce = 0;
 	dwtn = 0;
@@ -62,9 +62,9 @@ DotWriter::~DotWriter()
 
 }
 
-void DotWriter::SetLineParser(LineParserList *pLines )//, int numOfLines)
+void DotWriter::SetCallGraph(GprofCallGraph *pGraph)
 {
-	mlines = pLines;
+	mgraph = pGraph;
 }
 
 void DotWriter::SetDotWriterFromDialogSettings(IManager *mgr)
@@ -92,14 +92,13 @@ void DotWriter::SetDotWriterFromDetails(int colnode, int coledge, int thrnode, i
 
 void DotWriter::WriteToDotLanguage()
 {
-	int pl_index = 0;
-	float pl_time = 0;
-	bool is_node = false;
-	wxArrayInt index_pl_nodes;
-
-	if (mlines == NULL)
+	if (mgraph == NULL)
 		return;
 
+	// select only the part of the graph which is going to be shown
+	std::vector<size_t> nodes, edges;
+	mgraph->Prune(dwtn, dwte, nodes, edges);
+
 	graph = wxT("graph [ranksep=\"0.25\", fontname=") + fontname + wxT(", nodesep=\"0.125\"];");
 
 	hnode = wxT("node [label=\"\\N\", fontsize=\"9.00\", fontname=") + fontname + wxT(", style=\"") + style + wxT("\", height=0, width=0, shape=") + shape + wxT(", fontcolor=") + cwhite + wxT("];");
@@ -108,89 +107,56 @@ void DotWriter::WriteToDotLanguage()
 
 	//graph []; -- not used
 
-	m_OutputString += begin_graph + wxT("\n") + graph + wxT("\n") + hnode + wxT("\n") + hedge + wxT("\n");
-
-	LineParserList::compatibility_iterator it = mlines->GetFirst();
-
-	while(it) {
-		LineParser *line = it->GetData();
-
-		if(line->pline && wxRound(line->time) >= dwtn) {
-			is_node = true;
-			index_pl_nodes.Add(line->index);
-			dlabel = wxString::Format(wxT("%i"),line->index);
-			dlabel += wxT(" [label=\"");
-			dlabel += OptionsShortNameAndParameters(line->name);
-			dlabel += wxT("\\n");
-			dlabel += wxString::Format(wxT("%.2f"), line->time);
-			dlabel += wxT("% \\n");
-			dlabel += wxT("(");
-			// self or children if have function childern line
-			//if(line->self >= line->childern)
-			//	dlabel += wxString::Format(wxT("%.2f"), line->self);
-			//else
-			dlabel += wxString::Format(wxT("%.2f"), line->self + line->children);
-			dlabel += wxT("s)");
-			dlabel += wxT("\\n");
-			if(line->called0 != -1)
-				dlabel += wxString::Format(wxT("%i"),line->called0) + wxT("x");
-			//if(line->recursive)
-			//	dlabel += wxT(" (") + wxString::Format(wxT("%i"),line->called0 + line->called1) + wxT("x)");
-			dlabel += wxT("\",fontcolor=\"");
-			dlabel += DefineColorForLabel(ReturnIndexForColor(line->time, dwcn));
-			dlabel += wxT("\", color=\"");
-			dlabel += DefineColorForNodeEdge(ReturnIndexForColor(line->time, dwcn));
-			//
-			dlabel += wxT("\"];"); //, fontsize=\"10.00\"
-			//
-			m_OutputString += dlabel + wxT("\n");
-			//
-			dlabel.Clear();
-		}
-		it = it->GetNext();
+	m_OutputString.Clear();
+	m_OutputString.reserve(256 + nodes.size() * 160 + edges.size() * 128);
+	m_OutputString << begin_graph << wxT("\n") << graph << wxT("\n") << hnode << wxT("\n") << hedge << wxT("\n");
+
+	for(size_t i = 0; i < nodes.size(); ++i) {
+		const GprofFunction& function = mgraph->functions[nodes[i]];
+
+		m_OutputString << function.index;
+		m_OutputString << wxT(" [label=\"");
+		m_OutputString << OptionsShortNameAndParameters(function.name);
+		m_OutputString << wxT("\\n");
+		m_OutputString << wxString::Format(wxT("%.2f"), function.time);
+		m_OutputString << wxT("% \\n");
+		m_OutputString << wxT("(");
+		// self or children if have function childern line
+		m_OutputString << wxString::Format(wxT("%.2f"), function.self + function.children);
+		m_OutputString << wxT("s)");
+		m_OutputString << wxT("\\n");
+		if(function.called0 != -1)
+			m_OutputString << function.called0 << wxT("x");
+		m_OutputString << wxT("\",fontcolor=\"");
+		m_OutputString << DefineColorForLabel(ReturnIndexForColor(function.time, dwcn));
+		m_OutputString << wxT("\", color=\"");
+		m_OutputString << DefineColorForNodeEdge(ReturnIndexForColor(function.time, dwcn));
+		//
+		m_OutputString << wxT("\"];\n"); //, fontsize=\"10.00\"
 	}
 
-	it = mlines->GetFirst();
-
-	float	max_time = -2;
-	
-	while(it) {
-		LineParser *line = it->GetData();
-
-		if (max_time < line->time)	max_time = line->time;
-		
-		if(line->pline) {
-			pl_index = line->index; // index for primary node
-			pl_time = line->time; // time for primary node
-		}
-
-		if (line->child && IsInArray(line->nameid,index_pl_nodes) && IsInArray(pl_index,index_pl_nodes) && (wxRound(pl_time) >= dwte)) {
-			dedge = wxString::Format(wxT("%i"), pl_index);
-			dedge += wxT(" -> ");
-			dedge += wxString::Format(wxT("%i"),line->nameid);
-			dedge += wxT(" [color=\"");
-			dedge += DefineColorForNodeEdge(ReturnIndexForColor(pl_time, dwce)); // color by primary node
-			dedge += wxT("\", label=\"");
-			//if(line->self != -1)
-			//dedge += wxString::Format(wxT("%.2f"),line->self) + wxT("%");
-			//dedge += wxT("\\n");
-			dedge += wxString::Format(wxT("%i"),line->called0);
-			dedge += wxT("x");
-			dedge += wxT("\" ,arrowsize=\"0.50\", fontsize=\"9.00\", fontcolor=\"");
-			dedge += cblack;
-			dedge += wxT("\", penwidth=\"2.00\"];"); // labeldistance=\"4.00\",
-			//
-			m_OutputString += dedge + wxT("\n");
-			//
-			dedge.Clear();
-		}
-		it = it->GetNext();
+	for(size_t i = 0; i < edges.size(); ++i) {
+		const GprofEdge& edge = mgraph->edges[edges[i]];
+		const GprofFunction& caller = mgraph->functions[edge.caller];
+		const GprofFunction& callee = mgraph->functions[edge.callee];
+
+		m_OutputString << caller.index;
+		m_OutputString << wxT(" -> ");
+		m_OutputString << callee.index;
+		m_OutputString << wxT(" [color=\"");
+		m_OutputString << DefineColorForNodeEdge(ReturnIndexForColor(caller.time, dwce)); // color by primary node
+		m_OutputString << wxT("\", label=\"");
+		m_OutputString << edge.called0;
+		m_OutputString << wxT("x");
+		m_OutputString << wxT("\" ,arrowsize=\"0.50\", fontsize=\"9.00\", fontcolor=\"");
+		m_OutputString << cblack;
+		m_OutputString << wxT("\", penwidth=\"2.00\"];\n"); // labeldistance=\"4.00\",
 	}
-	m_OutputString += end_graph;
+	m_OutputString << end_graph;
 
-	if (!is_node) { // if the call graph is empty create new graph with label node
+	if (nodes.empty()) { // if the call graph is empty create new graph with label node
 		m_OutputString = wxT("digraph e {0 [label=");
-		m_OutputString += _(wxString::Format("\"The call-graph is empty; the node threshold ceiling is %d !\"", wxRound(max_time)));
+		m_OutputString += _(wxString::Format("\"The call-graph is empty; the node threshold ceiling is %d !\"", wxRound(mgraph->GetMaxTime())));
 		m_OutputString += wxT(", shape=none, height=2, width=2, fontname=Arial, fontsize=14.00];}");
 	}
 }
@@ -310,6 +276,7 @@ int DotWriter::ReturnIndexForColor(float time, int dwc)
 			break;
 		}
 	}
+	delete [] colorSelect;
 	return index;
 }
 
@@ -319,14 +286,6 @@ wxString DotWriter::DefineColorForNodeEdge(int index)
 	return colors[index];
 }
 
-bool DotWriter::IsInArray(int index, const wxArrayInt& arr)
-{
-	for(unsigned int i = 0; i < arr.GetCount(); i++) {
-		if (arr.Item(i) == index) return true;
-	}
-	return false;
-}
-
 wxString DotWriter::DefineColorForLabel(int index)
 {
 	if ((index < 3) || (index > 6)) {
@@ -54,7 +54,7 @@ private:
 	wxString style, shape, fontname;
 	wxString cwhite, cblack;
 	wxString dlabel, dedge, hedge, hnode;
-	LineParserList *mlines;
+	GprofCallGraph *mgraph;
 	wxString m_OutputString;
 	bool m_writedotfileFlag;
 	bool dwhideparams;
@@ -90,10 +90,10 @@ public:
 	 */
 	~DotWriter();
 	/**
-	 * @brief Function sets object DotWriter and assign the pointer pLines.
-	 * @param pLines
+	 * @brief Function sets object DotWriter and assign the pointer pGraph.
+	 * @param pGraph
 	 */	
-	void SetLineParser(LineParserList *pLines);
+	void SetCallGraph(GprofCallGraph *pGraph);
 	/**
 	 * @brief Function sets object DotWriter from stored configuration data.
 	 * @param mgr
@@ -113,7 +113,7 @@ public:
 	void SetDotWriterFromDetails(int colnode, int coledge, int thrnode, int thredge, bool hideparams, bool stripparams, bool hidenamespaces);
 	//
 	/**
-	 * @brief Function create data in the DOT language and prepare it to write.
+	 * @brief Function create data in the DOT language and prepare it to write. Graph is pruned by thresholds first.
 	 */
 	void WriteToDotLanguage();
 	/**
@@ -137,12 +137,6 @@ public:
 	 * @param index of the color, this value return function ReturnIndexForColor.
 	 */
 	wxString DefineColorForLabel(int index);
-	/**
-	 * @brief Function return bool value if index is exist in the array.
-	 * @param index of the function stored in the list of objects.
-	 * @param array of index by nodes added to the call graph.
-	 */
-	bool IsInArray(int index, const wxArrayInt& array);
 	/**
 	 * @brief Function return optimal index for color by the value time and options in the dialog settings of the plugin.
 	 * @param time of the function stored in the list of objects.
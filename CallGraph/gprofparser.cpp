@@ -24,253 +24,217 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "gprofparser.h"
-#include <wx/intl.h>
-#include <wx/regex.h>
-#include <wx/strconv.h>
+#include <wx/math.h>
+#include <string.h>
+#include <vector>
+
+#define GPROF_READ_BUFFER (256 * 1024)
 
 int cmpint(int* a, int* b) { return *b - *a; }
 
-GprofParser::GprofParser()
+static inline void SkipSpaces(const char*& p)
 {
-	lineheader = false;
-	primaryline = false;
-	nameLen = 0;
-	nameandid = NULL;
-	isdot = false;
-	iscycle = false;
-	islom = false;
-	isplus = false;
-	isspontaneous = false;
-	lines.DeleteContents(true);
-	lines.Clear();
-};
+	while(*p == ' ' || *p == '\t') ++p;
+}
 
-GprofParser::~GprofParser()
+static inline int ReadInt(const char*& p)
 {
-	lines.DeleteContents(true);
-	lines.Clear();
-};
+	int value = 0;
+	while(*p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+	return value;
+}
 
-void	GprofParser::GprofParserStream(wxInputStream *gprof_output)
+// gprof always prints '.' as decimal point, so it is read by hand (sscanf/strtod depend on locale)
+static float ReadFloat(const char*& p)
 {
-	wxRegEx re;
-	readlinetext = wxT("");
-	readlinetexttemp = wxT("");
-	wxCSConv conv( wxT("ISO-8859-1") );
-	wxTextInputStream text(*gprof_output);//, wxT(" \t"), conv);
-	//wxFileOutputStream out( wxT("DEBUG.TXT") );
-	//wxTextOutputStream tout( out );
-
-	isspontaneous = false;
-	calls.clear();
-
-	while(!gprof_output->Eof()) {
-		readlinetext = text.ReadLine();
-		//tout.WriteString( readlinetext + wxT("\n") );
-		nameLen = readlinetext.Len();
-
-		if(readlinetext != wxT("")) {
-			if(readlinetext == wxT("index % time    self  children    called     name")) {
-				lineheader = true;
-			} else if (readlinetext[0] == wxT('-')) {
-				primaryline = false;
-				continue;
-			} else if (readlinetext.Contains(wxT("<spontaneous>"))) {
-				isspontaneous = true;
-				continue;
-			} else if (lineheader) {
-				delete [] nameandid;
-				nameandid = new char[nameLen + 1]; // dynam array for pointer nameandid
-				memset(nameandid, 0, nameLen + 1);
-
-				LineParser *line = new LineParser();
-
-				//inicializace struktury
-				line->called0 = -1;
-				line->called1 = -1;
-				line->child = false;
-				line->children = -1;
-				line->cycle = false;
-				line->cycleid = -1;
-				line->index = -1;
-				line->name = wxT("<undefined>");
-				line->nameid = -1;
-				line->parents = false;
-				line->pline = false;
-				line->recursive = false;
-				line->self = -1;
-				line->time = -1;
-
-				if(re.Compile(wxT("[ ]{2,}")) && re.Matches( readlinetext )) {
-					re.Replace(&readlinetext, wxT(" "));
-				}
-
-				if (readlinetext.Contains(wxT("."))) isdot = true;
-				else isdot = false;
-
-				if (readlinetext.Contains(wxT("cycle"))) iscycle = true;
-				else iscycle = false;
-
-				//if (readlinetext.Contains(wxT("/"))) islom = true;
-				if(re.Compile( wxT("[0-9]+/[0-9]+"), wxRE_ADVANCED) && re.Matches( readlinetext)) islom = true;
-				else islom = false;
-
-				//if (readlinetext.Contains(wxT("+"))) isplus = true;
-				if(re.Compile( wxT("([0-9]+)\\+([0-9]+)"), wxRE_ADVANCED) && re.Matches( readlinetext)) { 
-					isplus = true;
-					//readlinetext.Replace( wxT("+"), wxT(" ") );
-					re.Replace(&readlinetext, wxT("\\1 \\2"));
-				}
-				else isplus = false;
-
-				wxString dot = wxLocale::GetInfo(wxLOCALE_DECIMAL_POINT, wxLOCALE_CAT_NUMBER);
-				readlinetext.Replace( wxT("."), dot );
-
-				if ((readlinetext[0] == '[') && (readlinetext[(readlinetext.length()) - 1] == ']')) {
-					primaryline = true;
-					//
-					if(iscycle && isplus) { // [3]     91.71    1.77        0.00    1+5    <cycle 1 as a whole> [3]
-						//warning
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %d %d <cycle %d as a whole> [%d]",&line->index,&line->time,&line->self,&line->children,&line->called0,&line->called1,&line->cycleid,&line->nameid);
-						line->name = wxT("whole");
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = true;
-						line->recursive = true;
-					} else if(iscycle) { //  [5]     38.86    0.75        0    1      a <cycle 1> [5]
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %d %[^\n]s",&line->index,&line->time,&line->self,&line->children,&line->called0,nameandid);
+	float value = ReadInt(p);
+	if(*p == '.') {
+		++p;
+		float scale = 0.1f;
+		while(*p >= '0' && *p <= '9') {
+			value += (*p++ - '0') * scale;
+			scale /= 10;
+		}
+	}
+	return value;
+}
 
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('<'));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('<')).BeforeFirst(wxT('>')),wxT("cycle %d"), &line->cycleid);
-						//line->cycleid = readlinesubtext.AfterFirst('<').BeforeFirst('>');
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
+// token of numeric columns: "0.00", "12", "1/3", "1+5"
+static bool IsNumberToken(const char* p)
+{
+	if(*p < '0' || *p > '9') return false;
+	while((*p >= '0' && *p <= '9') || *p == '.' || *p == '/' || *p == '+') ++p;
+	return *p == ' ' || *p == '\t' || *p == 0;
+}
 
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = true;
-						line->recursive = false;
-					} else if(isplus) { //[4]      3.7    0.00    0.01       1+6       quicksort(int*, int, int) [4]
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %d %d %[^\n]s",&line->index,&line->time,&line->self,&line->children,&line->called0,&line->called1,nameandid);
-						//
-						wxString readlinesubtext(nameandid, conv);
-						//
-						line->name = readlinesubtext.BeforeFirst(wxT('['));
-						//
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = false;
-						line->recursive = true;
-					} else if (isspontaneous) { // || !readlinetext.Contains(wxT('('))) // [3]    100.0    0.00    0.03       %d - neni        main [3]
-						//special case (probably appears after 'spontaneous'
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %[^\n]s",&line->index,&line->time,&line->self,&line->children,nameandid);
-						//
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('['));
-						//
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = false;
-						line->recursive = false;
+// "name [id]", "name <cycle 1> [id]" or "<cycle 1 as a whole> [id]"
+static void ReadName(const char* p, const char* end, wxString* name, int& nameid, bool& cycle, int& cycleid)
+{
+	while(end > p && (end[-1] == ' ' || end[-1] == '\t')) --end;
+
+	const char* id = end;
+	if(end > p && end[-1] == ']') {
+		id = end - 1;
+		while(id > p && *id != '[') --id;
+		if(*id == '[') {
+			const char* digits = id + 1;
+			nameid = ReadInt(digits);
+			end = id;
+			while(end > p && (end[-1] == ' ' || end[-1] == '\t')) --end;
+		}
+	}
 
-						isspontaneous = false;
-					} else { //[2]    100.00    0.16     1.77    1      main [2]
-						sscanf((const char*)readlinetext.mb_str(conv),"[%d] %f %f %f %d %[^\n]s",&line->index,&line->time,&line->self,&line->children,&line->called0,nameandid);
-						//
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('['));
-						//
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
-						line->parents = false;
-						line->pline = true;
-						line->child = false;
-						line->cycle = false;
-						line->recursive = false;
+	if(end > p && end[-1] == '>') {
+		const char* tag = end - 1;
+		while(tag > p && *tag != '<') --tag;
+		if(*tag == '<' && strncmp(tag, "<cycle ", 7) == 0) {
+			const char* digits = tag + 7;
+			cycleid = ReadInt(digits);
+			cycle = true;
+			if(tag > p) { // member of cycle, otherwise "<cycle N as a whole>" is the name
+				end = tag;
+				while(end > p && (end[-1] == ' ' || end[-1] == '\t')) --end;
+			}
+		}
+	}
 
-					}
-				} else { //parents and childern
-					if(iscycle && !islom) { //3          a <cycle 1> [5]
-						// warning
-						sscanf((const char*)readlinetext.mb_str(conv),"%d %[^\n]s",&line->called0,nameandid);
-						wxString readlinesubtext(nameandid, conv);
-						line->name = readlinesubtext.BeforeFirst(wxT('<'));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('<')).BeforeFirst(wxT('>')),wxT("cycle %d"), &line->cycleid);
-						//line->cycleid = readlinesubtext.AfterFirst('<').BeforeFirst('>');
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
+	if(name) *name = wxString(p, wxConvISO8859_1, end - p);
+}
 
-						line->cycle = true;
-						line->recursive = false;
+GprofParser::GprofParser()
+{
+	lineheader = false;
+	primary = -1;
+};
 
-					} else if(!iscycle && islom) { // 0        0    6/6        c [6]
-						sscanf((const char*)readlinetext.mb_str(conv),"%f %f %d/%d %[^\n]s",&line->self,&line->children,&line->called0,&line->called1,nameandid);
-						wxString readlinesubtext(nameandid, conv);
-						line->name = (wxString)readlinesubtext.BeforeFirst(wxT('['));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
+GprofParser::~GprofParser()
+{
+};
 
-						line->cycle = false;
-						line->recursive = false;
-						//
-					} else if(iscycle && islom) { //1.77        0    1/1        a <cycle 1> [5]
-						sscanf((const char*)readlinetext.mb_str(conv),"%f %f %d/%d %[^\n]s",&line->self,&line->children,&line->called0,&line->called1,nameandid);
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('<'));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('<')).BeforeFirst(wxT('>')),wxT("cycle %d"), &line->cycleid);
-						//line->cycleid = readlinesubtext.AfterFirst('<').BeforeFirst('>');
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
+void	GprofParser::GprofParserStream(wxInputStream *gprof_output)
+{
+	lineheader = false;
+	primary = -1;
+	calls.clear();
+	callgraph.Clear();
+
+	// read in big blocks and split lines by hand, wxTextInputStream::ReadLine is too slow for huge outputs
+	std::vector<char> buffer(GPROF_READ_BUFFER);
+	std::string line;
+	bool done = false;
+
+	while(!done && !gprof_output->Eof()) {
+		gprof_output->Read(&buffer[0], buffer.size());
+		size_t bytes = gprof_output->LastRead();
+		if(bytes == 0) break;
+
+		const char *p = &buffer[0];
+		const char *end = p + bytes;
+		while(p < end) {
+			const char *nl = (const char*)memchr(p, '\n', end - p);
+			if(!nl) {
+				line.append(p, end);
+				break;
+			}
+			line.append(p, nl);
+			p = nl + 1;
+			if(!ParseLine(line)) {
+				done = true;
+				break;
+			}
+			line.clear();
+		}
+	}
+	if(!done && !line.empty()) ParseLine(line);
 
-						line->cycle = true;
-						line->recursive = false;
+	callgraph.Resolve();
+}
 
-					} else if(!iscycle && !islom && !isdot) { //15             faktorial(int) [8]
-						sscanf((const char*)readlinetext.mb_str(conv),"%d %[^\n]s",&line->called0,nameandid);
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst(wxT('['));
-						wxSscanf(readlinesubtext.AfterFirst(wxT('[')).BeforeFirst(wxT(']')),wxT("%d"),&line->nameid);
+bool GprofParser::ParseLine(std::string& line)
+{
+	if(!line.empty() && line[line.length() - 1] == '\r') line.erase(line.length() - 1);
 
-						line->cycle = false;
-						line->recursive = true;
+	if(line.empty()) return !lineheader; // empty line ends the call graph table
 
-					}
-					/*else if(!iscycle && !islom)
-					{
-						sscanf((const char*)readlinetext.mb_str(conv),"%f %f %d %[^\n]s",&line->self,&line->childern,&line->called0,nameandid);
-						//
-						wxString readlinesubtext(nameandid, conv); // musi byt kodovani ?
-						line->name = readlinesubtext.BeforeFirst('[');
-						//
-						wxSscanf(readlinesubtext.AfterFirst('[').BeforeFirst(']'),"%d",&line->nameid);
+	if(!lineheader) {
+		if(line.compare(0, 12, "index % time") == 0) lineheader = true;
+		return true;
+	}
 
-						line->cycle = false;
-						line->recursive = false;
-						//
-					}*/
+	if(line[0] == '-') {
+		primary = -1;
+		return true;
+	}
 
-					if (primaryline) {
-						line->parents = false;
-						line->pline = false;
-						line->child = true;
-					} else {
-						line->parents = true;
-						line->pline = false;
-						line->child = false;
-					}
-				}
-				
-				lines.Append( line );
-				calls[ wxRound(line->time) ] = calls[ wxRound(line->time) ] + 1;
+	if(line.find("<spontaneous>") != std::string::npos) return true;
+
+	const char *p = line.c_str();
+	const char *end = p + line.length();
+	SkipSpaces(p);
+
+	if(*p == '[') { //[2]    100.00    0.16     1.77    1      main [2]
+		GprofFunction function;
+		++p;
+		function.index = ReadInt(p);
+		if(*p == ']') ++p;
+		SkipSpaces(p);
+		function.time = ReadFloat(p);
+		SkipSpaces(p);
+		function.self = ReadFloat(p);
+		SkipSpaces(p);
+		function.children = ReadFloat(p);
+		SkipSpaces(p);
+		// 'called' column is empty for spontaneous functions, "1+5" for recursive ones
+		if(IsNumberToken(p)) {
+			function.called0 = ReadInt(p);
+			if(*p == '+') {
+				++p;
+				function.called1 = ReadInt(p);
+				function.recursive = true;
 			}
-		} else if (lineheader) {
-			break;
+			SkipSpaces(p);
+		}
+		int nameid = -1;
+		ReadName(p, end, &function.name, nameid, function.cycle, function.cycleid);
+
+		primary = (int)callgraph.functions.size();
+		callgraph.functions.push_back(function);
+		calls[ wxRound(function.time) ] = calls[ wxRound(function.time) ] + 1;
+
+	} else if(primary != -1) { // children: "0.00 0.03 1/1 foo [2]", "15 faktorial(int) [8]"
+		GprofEdge edge;
+		// numeric columns: [self children] called[/total]
+		const char *tokens[4];
+		int count = 0;
+		while(count < 4 && IsNumberToken(p)) {
+			tokens[count++] = p;
+			while(*p != ' ' && *p != '\t' && *p != 0) ++p;
+			SkipSpaces(p);
+		}
+		if(count >= 3) {
+			const char *q = tokens[count - 3];
+			edge.self = ReadFloat(q);
+			q = tokens[count - 2];
+			edge.children = ReadFloat(q);
 		}
+		if(count >= 1) {
+			const char *q = tokens[count - 1];
+			edge.called0 = ReadInt(q);
+			if(*q == '/' || *q == '+') {
+				++q;
+				edge.called1 = ReadInt(q);
+			}
+		}
+		bool cycle = false;
+		int cycleid = -1;
+		ReadName(p, end, NULL, edge.calleeindex, cycle, cycleid);
+
+		edge.caller = primary;
+		callgraph.edges.push_back(edge);
 	}
+	// lines before primary line are parents - not used in call graph
 
-	delete [] nameandid;
+	return true;
 }
 
 int GprofParser::GetSuggestedNodeThreshold()
@@ -36,8 +36,8 @@
 #include <wx/wx.h>
 #include <wx/string.h> 
 #include <wx/stream.h>
-#include <wx/txtstrm.h>
 #include <wx/hashmap.h>
+#include <string>
 
 #include "lineparser.h"
 
@@ -46,25 +46,25 @@ WX_DECLARE_HASH_MAP(int, int, wxIntegerHash, wxIntegerEqual, OccurenceMap);
 /**
  * @class GprofParser
  * @brief Class define structure for parser to read stream of data from gprof tool.
+ *
+ * The call graph is read in one pass, lines are split and scanned by hand (no regular expressions, no temporary
+ * strings per line), and stored to compact arrays of functions and calls.
  */
 class GprofParser
 {
 private:
-	wxString readlinetext;
-	wxString readlinetexttemp;
 	bool lineheader;
-	bool primaryline;
-	int nameLen;
-	char *nameandid;
-	bool isdot;
-	bool iscycle;
-	bool islom;
-	bool isplus;	
-	bool isspontaneous;	
+	int primary; // position of the current primary line function, -1 if none
 	
 	OccurenceMap calls;
 	wxArrayInt sortedCalls;
 	
+	/**
+	 * @brief Scan one line of the call graph.
+	 * @return false when the call graph table ends
+	 */
+	bool ParseLine(std::string& line);
+	
 public:
 	/**
 	 * @brief Defautl constructor.
@@ -75,11 +75,11 @@ public:
 	 */
 	~GprofParser();
 	/**
-	 * @brief  List lines type LineParserList.
+	 * @brief Functions and calls read from gprof output.
 	 */
-	LineParserList lines;
+	GprofCallGraph callgraph;
 	/**
-	 * @brief Function is reading the input stream from gprof application and scan the rows to save to collection of objects lines. 
+	 * @brief Function is reading the input stream from gprof application and scan the rows to save to the call graph. 
 	 * @param m_pInputStream pointer of type wxInputStream. 
 	 */
 	void GprofParserStream(wxInputStream *m_pInputStream);
@@ -24,29 +24,59 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "lineparser.h"
+#include <wx/math.h>
 
-#include <wx/listimpl.cpp>
+void GprofCallGraph::Clear()
+{
+	functions.clear();
+	edges.clear();
+}
+
+void GprofCallGraph::Resolve()
+{
+	// gprof indices are dense (1..N), so plain array is enough to map them to positions
+	std::vector<int> positions;
+	for(size_t i = 0; i < functions.size(); ++i) {
+		int index = functions[i].index;
+		if(index < 0) continue;
+		if((size_t)index >= positions.size()) positions.resize(index + 1, -1);
+		positions[index] = (int)i;
+	}
+
+	for(size_t i = 0; i < edges.size(); ++i) {
+		GprofEdge& edge = edges[i];
+		int index = edge.calleeindex;
+		edge.callee = (index >= 0 && (size_t)index < positions.size()) ? positions[index] : -1;
+	}
+}
+
+void GprofCallGraph::Prune(int nodeThreshold, int edgeThreshold, std::vector<size_t>& nodes, std::vector<size_t>& selectedEdges) const
+{
+	nodes.clear();
+	selectedEdges.clear();
 
-WX_DEFINE_LIST(LineParserList);
+	std::vector<bool> visible(functions.size(), false);
+	for(size_t i = 0; i < functions.size(); ++i) {
+		if(wxRound(functions[i].time) >= nodeThreshold) {
+			visible[i] = true;
+			nodes.push_back(i);
+		}
+	}
+
+	for(size_t i = 0; i < edges.size(); ++i) {
+		const GprofEdge& edge = edges[i];
+		if(edge.caller < 0 || edge.callee < 0) continue;
+		if(!visible[edge.caller] || !visible[edge.callee]) continue;
+		if(wxRound(functions[edge.caller].time) < edgeThreshold) continue;
+		selectedEdges.push_back(i);
+	}
+}
 
-LineParser* LineParser::Clone()
+float GprofCallGraph::GetMaxTime() const
 {
-	LineParser *newline = new LineParser();
-	
-	newline->index = this->index;
-	newline->time = this->time;
-	newline->self = this->self;
-	newline->children = this->children;
-	newline->called0 = this->called0;
-	newline->called1 = this->called1;
-	newline->name = this->name;
-	newline->nameid = this->nameid;
-	newline->parents = this->parents; 
-	newline->pline = this->pline;
-	newline->child = this->child;
-	newline->cycle = this->cycle; 
-	newline->recursive = this->recursive;
-	newline->cycleid = this->cycleid;
-	
-	return newline;
+	float maxTime = -2;
+	for(size_t i = 0; i < functions.size(); ++i) {
+		if(maxTime < functions[i].time) maxTime = functions[i].time;
+	}
+	return maxTime;
 }
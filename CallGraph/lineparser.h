@@ -25,7 +25,7 @@
 
 /***************************************************************
  * Name:      lineparser.h
- * Purpose:   Header to store lines from gprof parser.
+ * Purpose:   Header to store call graph read by gprof parser.
  * Author:    Vaclav Sprucek
  * Created:   2012-03-04
  * Copyright: Vaclav Sprucek
@@ -37,32 +37,80 @@
 #define _LINEPARSER_H__
 
 #include <wx/string.h>
-#include <wx/list.h>
+#include <vector>
+
 /**
- * @class LineParser
- * @brief Class define structure for data structure.
+ * @class GprofFunction
+ * @brief Primary line of gprof call graph - one function.
  */
-class LineParser
-{	
+class GprofFunction
+{
 public:
-	int index;
-	float time;
+	int index; // gprof index of the function ([index])
+	float time; // % of total time (incl. children)
 	float self;
 	float children;
 	int called0;
-	int called1;
+	int called1; // recursive calls (called0+called1)
 	wxString name;
-	int nameid;
-	bool parents; // input to primary line - not used in call graph
-	bool pline; // primary line
-	bool child; //  output from primary line
-	bool cycle; 
+	bool cycle;
 	bool recursive;
-	int  cycleid;
-	
-	LineParser* Clone();
+	int cycleid;
+
+	GprofFunction()
+		: index(-1), time(-1), self(-1), children(-1), called0(-1), called1(-1),
+		  name(wxT("<undefined>")), cycle(false), recursive(false), cycleid(-1) {}
 };
 
-WX_DECLARE_LIST( LineParser, LineParserList );
+/**
+ * @class GprofEdge
+ * @brief Child line of gprof call graph - call from primary function to other one.
+ */
+class GprofEdge
+{
+public:
+	int caller; // position of the calling function in GprofCallGraph::functions
+	int callee; // position of the called function in GprofCallGraph::functions, -1 if not known
+	int calleeindex; // gprof index of the called function
+	float self; // time spent in callee when called from caller
+	float children;
+	int called0;
+	int called1;
+
+	GprofEdge()
+		: caller(-1), callee(-1), calleeindex(-1), self(-1), children(-1), called0(-1), called1(-1) {}
+};
+
+/**
+ * @class GprofCallGraph
+ * @brief Compact storage of the whole call graph: array of functions and array of calls.
+ */
+class GprofCallGraph
+{
+public:
+	std::vector<GprofFunction> functions;
+	std::vector<GprofEdge> edges;
+
+	/**
+	 * @brief Remove all functions and calls.
+	 */
+	void Clear();
+	/**
+	 * @brief Resolve callees of all calls to positions in functions array. Called when whole graph is read.
+	 */
+	void Resolve();
+	/**
+	 * @brief Select part of the graph worth to show, so DOT generator doesn't have to process whole graph.
+	 * @param nodeThreshold minimal time (%) of function to be shown
+	 * @param edgeThreshold minimal time (%) of calling function to show its calls
+	 * @param nodes positions of selected functions
+	 * @param selectedEdges positions of selected calls (both functions of the call are selected)
+	 */
+	void Prune(int nodeThreshold, int edgeThreshold, std::vector<size_t>& nodes, std::vector<size_t>& selectedEdges) const;
+	/**
+	 * @brief Return maximal time (%) of all functions.
+	 */
+	float GetMaxTime() const;
+};
 
 #endif
\ No newline at end of file
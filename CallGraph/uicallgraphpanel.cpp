@@ -31,18 +31,17 @@
 #include <wx/filefn.h>
 #include <wx/xrc/xmlres.h>
 #include "callgraph.h"
+#include <limits.h>
 
-uicallgraphpanel::uicallgraphpanel(wxWindow *parent, IManager *mgr, const wxString& imagepath, const wxString& projectpath, int suggestedThreshold, LineParserList *pLines) : uicallgraph(parent)
+uicallgraphpanel::uicallgraphpanel(wxWindow *parent, IManager *mgr, const wxString& imagepath, const wxString& projectpath, int suggestedThreshold, GprofCallGraph *pGraph) : uicallgraph(parent)
 {
 	m_mgr = mgr;
 	m_pathimage = imagepath;
 	m_pathproject = projectpath;
 	m_scale = 1;
 
-	// copy lines to local storage
-	m_lines.DeleteContents( true );
-	for(LineParserList::iterator it = pLines->begin(); it != pLines->end(); ++it)
-		m_lines.Append((*it)->Clone());
+	// copy call graph to local storage
+	m_graph = *pGraph;
 
 	m_bmpOrig.LoadFile(m_pathimage, wxBITMAP_TYPE_PNG);
 	UpdateImage();
@@ -64,7 +63,7 @@ uicallgraphpanel::uicallgraphpanel(wxWindow *parent, IManager *mgr, const wxStri
 
 uicallgraphpanel::~uicallgraphpanel()
 {
-	m_lines.Clear();
+	m_graph.Clear();
 }
 
 void uicallgraphpanel::OnPaint(wxPaintEvent& event)
@@ -103,35 +102,28 @@ void uicallgraphpanel::OnClosePanel(wxCommandEvent& event)
 
 int uicallgraphpanel::CreateAndInserDataToTable(int node_thr)
 {
-	LineParserList::compatibility_iterator it = m_lines.GetFirst();
-	int nr = 0;
-	float max_time = -2;
-	
-	while(it) {
-		LineParser *line = it->GetData();
-		
-		if (max_time < line->time)	max_time = line->time;
-		
-		if(line->pline && wxRound(line->time) >= node_thr) {
-			m_grid->AppendRows(1, true);
-			//name   time %   self  children    called
-			m_grid->SetCellValue(nr, 0, line->name);
-			m_grid->SetCellValue(nr, 1, wxString::Format(wxT("%.2f"),line->time));
-			m_grid->SetCellValue(nr, 2, wxString::Format(wxT("%.2f"),line->self + line->children));
-
-			int callsum;
-			if(line->called0 != -1) {
-				callsum = line->called0;
-				if(line->called1 != -1) callsum += line->called1;
-			} else callsum = 1;
-
-			m_grid->SetCellValue(nr, 3, wxString::Format(wxT("%i"),callsum));
-			nr ++;
-		}
-		it = it->GetNext();
+	std::vector<size_t> nodes, edges;
+	m_graph.Prune(node_thr, INT_MAX, nodes, edges);
+
+	if(!nodes.empty()) m_grid->AppendRows(nodes.size(), true);
+
+	for(size_t nr = 0; nr < nodes.size(); ++nr) {
+		const GprofFunction& function = m_graph.functions[nodes[nr]];
+		//name   time %   self  children    called
+		m_grid->SetCellValue(nr, 0, function.name);
+		m_grid->SetCellValue(nr, 1, wxString::Format(wxT("%.2f"),function.time));
+		m_grid->SetCellValue(nr, 2, wxString::Format(wxT("%.2f"),function.self + function.children));
+
+		int callsum;
+		if(function.called0 != -1) {
+			callsum = function.called0;
+			if(function.called1 != -1) callsum += function.called1;
+		} else callsum = 1;
+
+		m_grid->SetCellValue(nr, 3, wxString::Format(wxT("%i"),callsum));
 	}
 	
-	return wxRound(max_time);
+	return wxRound(m_graph.GetMaxTime());
 }
 
 void uicallgraphpanel::OnRefreshClick(wxCommandEvent& event)
@@ -140,7 +132,7 @@ void uicallgraphpanel::OnRefreshClick(wxCommandEvent& event)
 
 	// write to output png file
 	DotWriter dw;
-	dw.SetLineParser(&m_lines);
+	dw.SetCallGraph(&m_graph);
 	dw.SetDotWriterFromDetails(confData.GetColorsNode(),
 	                           confData.GetColorsEdge(),
 	                           m_spinNT->GetValue(),
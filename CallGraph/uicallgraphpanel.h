@@ -46,7 +46,7 @@ class uicallgraphpanel : public uicallgraph
 {
 
 public:
-	uicallgraphpanel(wxWindow *parent, IManager *mgr, const wxString& imagepath, const wxString& projectpath, int suggestedThreshold, LineParserList *pLines);
+	uicallgraphpanel(wxWindow *parent, IManager *mgr, const wxString& imagepath, const wxString& projectpath, int suggestedThreshold, GprofCallGraph *pGraph);
 	virtual ~uicallgraphpanel();
 
 protected:
@@ -71,7 +71,7 @@ protected:
 	IManager *m_mgr;
 	wxString m_pathimage;
 	wxString m_pathproject;
-	LineParserList m_lines;
+	GprofCallGraph m_graph;
 	ConfCallGraph confData; // stored configuration data
 	wxPoint m_viewPortOrigin;
 	wxPoint m_startigPoint;
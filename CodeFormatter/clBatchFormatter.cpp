@@ -0,0 +1,311 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : clBatchFormatter.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include "clBatchFormatter.h"
+#include "codeformatter.h"
+#include "asyncprocess.h"
+#include "globals.h"
+#include "fileutils.h"
+#include "file_logger.h"
+#include "json_node.h"
+
+#define CLANG_FORMAT_SUCCESS_MARKER "__codelite_clang_format_ok__"
+
+//------------------------------------------------------------------------
+// clFormatCache
+//------------------------------------------------------------------------
+
+clFormatCache::clFormatCache() {}
+
+clFormatCache::~clFormatCache() {}
+
+wxString clFormatCache::DoMakeKey(const wxString& contentHash, const wxString& optionsHash)
+{
+    return contentHash + ":" + optionsHash;
+}
+
+void clFormatCache::Load(const wxFileName& filename)
+{
+    wxCriticalSectionLocker locker(m_cs);
+    m_filename = filename;
+    m_entries.clear();
+    if(!filename.FileExists()) return;
+
+    JSONRoot root(filename);
+    m_entries = root.toElement().namedObject("files").toStringMap();
+}
+
+void clFormatCache::Save()
+{
+    wxCriticalSectionLocker locker(m_cs);
+    if(!m_filename.IsOk()) return;
+
+    JSONRoot root(cJSON_Object);
+    root.toElement().addProperty("files", m_entries);
+    root.save(m_filename);
+}
+
+bool clFormatCache::IsFormatted(const wxString& file, const wxString& contentHash, const wxString& optionsHash)
+{
+    wxCriticalSectionLocker locker(m_cs);
+    std::map<wxString, wxString>::const_iterator iter = m_entries.find(file);
+    return iter != m_entries.end() && iter->second == DoMakeKey(contentHash, optionsHash);
+}
+
+void clFormatCache::SetFormatted(const wxString& file, const wxString& contentHash, const wxString& optionsHash)
+{
+    wxCriticalSectionLocker locker(m_cs);
+    m_entries[file] = DoMakeKey(contentHash, optionsHash);
+}
+
+//------------------------------------------------------------------------
+// clBatchFormatterThread
+//------------------------------------------------------------------------
+
+class clBatchFormatterThread : public wxThread
+{
+    clBatchFormatter* m_owner;
+
+public:
+    clBatchFormatterThread(clBatchFormatter* owner)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_owner(owner)
+    {
+    }
+    virtual ~clBatchFormatterThread() {}
+
+protected:
+    void* Entry()
+    {
+        size_t index;
+        while(m_owner->Next(index)) {
+            m_owner->Process(index);
+        }
+        return NULL;
+    }
+};
+
+//------------------------------------------------------------------------
+// clBatchFormatter
+//------------------------------------------------------------------------
+
+clBatchFormatter::clBatchFormatter(CodeFormatter* formatter,
+                                   const std::vector<wxFileName>& files,
+                                   eEngine engine,
+                                   const wxString& options,
+                                   const wxString& eol,
+                                   const wxString& clangFormatExe,
+                                   clFormatCache* cache)
+    : m_formatter(formatter)
+    , m_files(files)
+    , m_engine(engine)
+    , m_options(options)
+    , m_eol(eol)
+    , m_clangFormatExe(clangFormatExe)
+    , m_cache(cache)
+    , m_next(0)
+    , m_processed(0)
+    , m_skipped(0)
+    , m_failed(0)
+    , m_cancelled(false)
+{
+    // everything that affects the output is part of the options hash
+    wxString allOptions;
+    allOptions << (int)m_engine << "|" << m_options << "|" << m_eol << "|" << m_clangFormatExe;
+    m_optionsHash = FileUtils::Hash(allOptions);
+}
+
+clBatchFormatter::~clBatchFormatter()
+{
+    Cancel();
+    Wait();
+}
+
+void clBatchFormatter::Start(size_t threads)
+{
+    if(threads == 0) threads = 1;
+    if(threads > m_files.size()) threads = m_files.size();
+
+    for(size_t i = 0; i < threads; ++i) {
+        clBatchFormatterThread* thread = new clBatchFormatterThread(this);
+        if(thread->Create() != wxTHREAD_NO_ERROR || thread->Run() != wxTHREAD_NO_ERROR) {
+            delete thread;
+            continue;
+        }
+        m_threads.push_back(thread);
+    }
+
+    if(m_threads.empty()) {
+        // could not start any thread, format on the calling thread
+        size_t index;
+        while(Next(index)) {
+            Process(index);
+        }
+    }
+}
+
+void clBatchFormatter::Cancel()
+{
+    wxCriticalSectionLocker locker(m_cs);
+    m_cancelled = true;
+}
+
+void clBatchFormatter::Wait()
+{
+    for(size_t i = 0; i < m_threads.size(); ++i) {
+        m_threads.at(i)->Wait();
+        delete m_threads.at(i);
+    }
+    m_threads.clear();
+}
+
+bool clBatchFormatter::Next(size_t& index)
+{
+    wxCriticalSectionLocker locker(m_cs);
+    if(m_cancelled || m_next >= m_files.size()) return false;
+    index = m_next++;
+    m_currentFile = m_files.at(index).GetFullName();
+    return true;
+}
+
+void clBatchFormatter::Process(size_t index)
+{
+    bool res = DoFormatFile(m_files.at(index));
+
+    wxCriticalSectionLocker locker(m_cs);
+    ++m_processed;
+    if(!res) ++m_failed;
+}
+
+bool clBatchFormatter::DoFormatFile(const wxFileName& file)
+{
+    wxString content;
+    if(!FileUtils::ReadFileContent(file, content)) {
+        CL_WARNING("Failed to read file content. File: %s", file.GetFullPath());
+        return false;
+    }
+
+    // Skip files that were not modified since we last formatted them
+    wxString contentHash = FileUtils::Hash(content);
+    if(m_cache && m_cache->IsFormatted(file.GetFullPath(), contentHash, m_optionsHash)) {
+        wxCriticalSectionLocker locker(m_cs);
+        ++m_skipped;
+        return true;
+    }
+
+    wxString formatted;
+    bool res = (m_engine == kAStyle) ? DoAStyleFormat(file, content, formatted) : DoClangFormat(file, formatted);
+    if(res && m_cache) {
+        m_cache->SetFormatted(file.GetFullPath(), FileUtils::Hash(formatted), m_optionsHash);
+    }
+    return res;
+}
+
+bool clBatchFormatter::DoAStyleFormat(const wxFileName& file, const wxString& content, wxString& formatted)
+{
+    m_formatter->AstyleFormat(content, m_options, formatted);
+    formatted << m_eol;
+
+    // Don't touch files that are already formatted
+    if(formatted == content) return true;
+
+    // Replace the content of the file
+    if(!FileUtils::WriteFileContent(file, formatted)) {
+        CL_WARNING("Failed to write file content. File: %s", file.GetFullPath());
+        return false;
+    }
+    return true;
+}
+
+bool clBatchFormatter::DoClangFormat(const wxFileName& file, wxString& formatted)
+{
+    wxString command, filename;
+    command << m_clangFormatExe;
+    ::WrapWithQuotes(command);
+
+    command << " -i "; // inline editing
+    command << m_options;
+    filename = file.GetFullPath();
+    ::WrapWithQuotes(filename);
+    command << " " << filename;
+
+    // The process API does not report the exit code, so let the shell
+    // print a marker when clang-format succeeded (works with both sh and cmd)
+    command << " && echo " << CLANG_FORMAT_SUCCESS_MARKER;
+
+    // Wrap the command in the local shell
+    ::WrapInShell(command);
+
+    // Log the command
+    CL_DEBUG("CodeForamtter: running:\n%s\n", command);
+
+    // Execute clang-format and reand the output
+    IProcess::Ptr_t clangFormatProc(::CreateSyncProcess(command, IProcessCreateDefault | IProcessCreateWithHiddenConsole));
+    CHECK_PTR_RET_FALSE(clangFormatProc);
+
+    wxString output;
+    clangFormatProc->WaitForTerminate(output);
+    CL_DEBUG("clang-format returned with:\n%s\n", output);
+
+    // Nothing is cached for a file clang-format failed on
+    if(!output.Contains(CLANG_FORMAT_SUCCESS_MARKER)) {
+        CL_WARNING("clang-format failed. File: %s", file.GetFullPath());
+        return false;
+    }
+
+    // Read back the formatted file (needed for the cache)
+    return FileUtils::ReadFileContent(file, formatted);
+}
+
+bool clBatchFormatter::IsDone()
+{
+    wxCriticalSectionLocker locker(m_cs);
+    return m_processed == m_files.size() || (m_cancelled && m_processed == m_next);
+}
+
+size_t clBatchFormatter::GetProcessed()
+{
+    wxCriticalSectionLocker locker(m_cs);
+    return m_processed;
+}
+
+size_t clBatchFormatter::GetSkipped()
+{
+    wxCriticalSectionLocker locker(m_cs);
+    return m_skipped;
+}
+
+size_t clBatchFormatter::GetFailed()
+{
+    wxCriticalSectionLocker locker(m_cs);
+    return m_failed;
+}
+
+wxString clBatchFormatter::GetCurrentFile()
+{
+    wxCriticalSectionLocker locker(m_cs);
+    // return a deep copy, the string is shared with the workers
+    return m_currentFile.c_str();
+}
@@ -0,0 +1,152 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : clBatchFormatter.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLBATCHFORMATTER_H
+#define CLBATCHFORMATTER_H
+
+#include <wx/string.h>
+#include <wx/filename.h>
+#include <wx/thread.h>
+#include <vector>
+#include <map>
+
+class CodeFormatter;
+
+/**
+ * @class clFormatCache
+ * @brief remembers the files that are already formatted: for each file we keep the hash of its
+ * formatted content and the hash of the options used to format it. A file whose content and
+ * options did not change since it was last formatted does not need to be formatted again
+ */
+class clFormatCache
+{
+    std::map<wxString, wxString> m_entries;
+    wxCriticalSection m_cs;
+    wxFileName m_filename;
+
+protected:
+    static wxString DoMakeKey(const wxString& contentHash, const wxString& optionsHash);
+
+public:
+    clFormatCache();
+    virtual ~clFormatCache();
+
+    /**
+     * @brief load the cache from the disk
+     */
+    void Load(const wxFileName& filename);
+    /**
+     * @brief save the cache to the file it was loaded from
+     */
+    void Save();
+
+    bool IsFormatted(const wxString& file, const wxString& contentHash, const wxString& optionsHash);
+    void SetFormatted(const wxString& file, const wxString& contentHash, const wxString& optionsHash);
+};
+
+/**
+ * @class clBatchFormatter
+ * @brief format a list of files concurrently, using a pool of worker threads.
+ * Each worker formats its files either in process (AStyle) or by running clang-format.
+ * Files found in the cache are skipped
+ */
+class clBatchFormatter
+{
+public:
+    enum eEngine {
+        kAStyle,
+        kClangFormat,
+    };
+
+protected:
+    CodeFormatter* m_formatter;
+    std::vector<wxFileName> m_files;
+    eEngine m_engine;
+    wxString m_options;
+    wxString m_optionsHash;
+    wxString m_eol;
+    wxString m_clangFormatExe;
+    clFormatCache* m_cache;
+    std::vector<wxThread*> m_threads;
+
+    wxCriticalSection m_cs;
+    size_t m_next;
+    size_t m_processed;
+    size_t m_skipped;
+    size_t m_failed;
+    wxString m_currentFile;
+    bool m_cancelled;
+
+protected:
+    bool DoFormatFile(const wxFileName& file);
+    bool DoAStyleFormat(const wxFileName& file, const wxString& content, wxString& formatted);
+    bool DoClangFormat(const wxFileName& file, wxString& formatted);
+
+public:
+    /**
+     * @param formatter the plugin (used for AStyle formatting)
+     * @param options the engine options (AStyle options string or clang-format command line options)
+     * @param eol the EOL appended to AStyle output
+     */
+    clBatchFormatter(CodeFormatter* formatter,
+                     const std::vector<wxFileName>& files,
+                     eEngine engine,
+                     const wxString& options,
+                     const wxString& eol,
+                     const wxString& clangFormatExe,
+                     clFormatCache* cache);
+    virtual ~clBatchFormatter();
+
+    /**
+     * @brief start formatting using 'threads' workers
+     */
+    void Start(size_t threads);
+    /**
+     * @brief stop formatting new files. The files being formatted are completed
+     */
+    void Cancel();
+    /**
+     * @brief wait for all the workers to exit
+     */
+    void Wait();
+
+    /**
+     * @brief pick the next file to format. Called by the workers
+     */
+    bool Next(size_t& index);
+    /**
+     * @brief format the file at 'index'. Called by the workers
+     */
+    void Process(size_t index);
+
+    bool IsDone();
+    size_t GetCount() const { return m_files.size(); }
+    size_t GetProcessed();
+    size_t GetSkipped();
+    size_t GetFailed();
+    wxString GetCurrentFile();
+};
+
+#endif // CLBATCHFORMATTER_H
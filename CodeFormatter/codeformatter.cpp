@@ -45,6 +45,7 @@
 #include "macros.h"
 #include <wx/progdlg.h>
 #include "fileutils.h"
+#include "clBatchFormatter.h"
 
 static int ID_TOOL_SOURCE_CODE_FORMATTER = ::wxNewId();
 
@@ -661,11 +662,12 @@ bool CodeFormatter::BatchFormat(const std::vector<wxFileName>& files)
     m_mgr->GetConfigTool()->ReadObject(wxT("FormatterOptions"), &options);
 
     if(options.GetEngine() == kFormatEngineAStyle) {
-        AStyleBatchFOrmat(files, options);
+        return AStyleBatchFOrmat(files, options);
 
     } else if(options.GetEngine() == kFormatEngineClangFormat) {
-        ClangBatchFormat(files, options);
+        return ClangBatchFormat(files, options);
     }
+    return false;
 }
 
 bool CodeFormatter::ClangBatchFormat(const std::vector<wxFileName>& files, const FormatOptions& options)
@@ -673,77 +675,63 @@ bool CodeFormatter::ClangBatchFormat(const std::vector<wxFileName>& files, const
     if(options.GetClangFormatExe().IsEmpty()) {
         return false;
     }
-
-    wxProgressDialog dlg(
-        _("Source Code Formatter"), _("Formatting files..."), (int)files.size(), m_mgr->GetTheApp()->GetTopWindow());
-
-    for(size_t i = 0; i < files.size(); ++i) {
-        wxString command, file;
-        command << options.GetClangFormatExe();
-        ::WrapWithQuotes(command);
-
-        command << " -i "; // inline editing
-        command << options.ClangFormatOptionsAsString();
-        file = files.at(i).GetFullPath();
-        ::WrapWithQuotes(file);
-        command << " " << file;
-
-        // Wrap the command in the local shell
-        ::WrapInShell(command);
-
-        // Log the command
-        CL_DEBUG("CodeForamtter: running:\n%s\n", command);
-
-        wxString msg;
-        msg << "[ " << i << " / " << files.size() << " ] " << files.at(i).GetFullName();
-        dlg.Update(i, msg);
-
-        // Execute clang-format and reand the output
-        IProcess::Ptr_t clangFormatProc(
-            ::CreateSyncProcess(command, IProcessCreateDefault | IProcessCreateWithHiddenConsole));
-        CHECK_PTR_RET_FALSE(clangFormatProc);
-
-        wxString output;
-        clangFormatProc->WaitForTerminate(output);
-        CL_DEBUG("clang-format returned with:\n%s\n", output);
-    }
-
-    return true;
+    return DoBatchFormat(
+        files, clBatchFormatter::kClangFormat, options.ClangFormatOptionsAsString(), options.GetClangFormatExe());
 }
 
 bool CodeFormatter::AStyleBatchFOrmat(const std::vector<wxFileName>& files, const FormatOptions& options)
 {
     wxString fmtOptions = options.AstyleOptionsAsString();
 
-    wxProgressDialog dlg(
-        _("Source Code Formatter"), _("Formatting files..."), (int)files.size(), m_mgr->GetTheApp()->GetTopWindow());
-    for(size_t i = 0; i < files.size(); ++i) {
+    // determine indentation method and amount
+    bool useTabs = m_mgr->GetEditorSettings()->GetIndentUsesTabs();
+    int tabWidth = m_mgr->GetEditorSettings()->GetTabWidth();
+    int indentWidth = m_mgr->GetEditorSettings()->GetIndentWidth();
+    fmtOptions << (useTabs && tabWidth == indentWidth ? wxT(" -t") : wxT(" -s")) << indentWidth;
 
-        wxString content;
-        if(!FileUtils::ReadFileContent(files.at(i), content)) {
-            CL_WARNING("Failed to read file content. File: %s", files.at(i).GetFullPath());
-            continue;
-        }
+    return DoBatchFormat(files, clBatchFormatter::kAStyle, fmtOptions, wxEmptyString);
+}
 
-        wxString msg;
-        msg << "[ " << i << " / " << files.size() << " ] " << files.at(i).GetFullName();
-        dlg.Update(i, msg);
+bool CodeFormatter::DoBatchFormat(const std::vector<wxFileName>& files,
+                                  clBatchFormatter::eEngine engine,
+                                  const wxString& options,
+                                  const wxString& clangFormatExe)
+{
+    // Files that were not modified since we last formatted them are skipped
+    clFormatCache cache;
+    if(WorkspaceST::Get()->IsOpen()) {
+        cache.Load(wxFileName(WorkspaceST::Get()->GetPrivateFolder(), "formatter-cache.json"));
+    }
 
-        // determine indentation method and amount
-        bool useTabs = m_mgr->GetEditorSettings()->GetIndentUsesTabs();
-        int tabWidth = m_mgr->GetEditorSettings()->GetTabWidth();
-        int indentWidth = m_mgr->GetEditorSettings()->GetIndentWidth();
-        fmtOptions << (useTabs && tabWidth == indentWidth ? wxT(" -t") : wxT(" -s")) << indentWidth;
+    // The files are formatted by worker threads, we only report the progress here
+    clBatchFormatter formatter(this, files, engine, options, DoGetGlobalEOLString(), clangFormatExe, &cache);
+    wxProgressDialog dlg(_("Source Code Formatter"),
+                         _("Formatting files..."),
+                         (int)files.size(),
+                         m_mgr->GetTheApp()->GetTopWindow(),
+                         wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME);
 
-        wxString output;
-        AstyleFormat(content, fmtOptions, output);
-        output << DoGetGlobalEOLString();
+    int cpus = wxThread::GetCPUCount();
+    formatter.Start(cpus > 0 ? cpus : 1);
 
-        // Replace the content of the file
-        if(!FileUtils::WriteFileContent(files.at(i), output)) {
-            CL_WARNING("Failed to write file content. File: %s", files.at(i).GetFullPath());
+    while(!formatter.IsDone()) {
+        size_t processed = formatter.GetProcessed();
+        wxString msg;
+        msg << "[ " << processed << " / " << files.size() << " ] " << formatter.GetCurrentFile();
+        if(!dlg.Update((int)processed, msg)) {
+            // user cancelled, the files that are being formatted are completed
+            formatter.Cancel();
         }
+        wxMilliSleep(50);
     }
+    formatter.Wait();
+    cache.Save();
+
+    CL_DEBUG("CodeFormatter: batch format completed. %u files processed, %u skipped (unmodified), %u failed",
+             (unsigned int)formatter.GetProcessed(),
+             (unsigned int)formatter.GetSkipped(),
+             (unsigned int)formatter.GetFailed());
+    return formatter.GetFailed() == 0;
 }
 
 bool CodeFormatter::PhpFormat(const wxString& content, wxString& formattedOutput, const FormatOptions& options)
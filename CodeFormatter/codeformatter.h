@@ -28,6 +28,7 @@
 #include "plugin.h"
 #include "cl_command_event.h"
 #include "formatoptions.h"
+#include "clBatchFormatter.h"
 
 class CodeFormatter : public IPlugin
 {
@@ -45,6 +46,14 @@ private:
                        int length,
                        const FormatOptions& options);
 
+    /**
+     * @brief format the files concurrently, skipping files that were not modified since they were last formatted
+     */
+    bool DoBatchFormat(const std::vector<wxFileName>& files,
+                       clBatchFormatter::eEngine engine,
+                       const wxString& options,
+                       const wxString& clangFormatExe);
+
 public:
     /**
      * @brief format a file using clang-foramt tool. Optioanlly, you can format a portion of
@@ -1,10 +1,19 @@
 #include "PHPDocComment.h"
 #include <wx/regex.h>
 #include <wx/tokenzr.h>
+#include <wx/thread.h>
+
+// The regular expressions below are shared and keep their match state, while
+// source files may be parsed by several threads at once
+static wxCriticalSection s_regexCS;
 
 PHPDocComment::PHPDocComment(PHPSourceFile& sourceFile, const wxString& comment)
     : m_comment(comment)
 {
+    // All the patterns below require a tag
+    if(m_comment.Find('@') == wxNOT_FOUND) return;
+
+    wxCriticalSectionLocker locker(s_regexCS);
     static wxRegEx reReturnStatement(wxT("@(return)[ \t]+([\\a-zA-Z_]{1}[\\a-zA-Z0-9_]*)"));
     if(reReturnStatement.IsValid() && reReturnStatement.Matches(m_comment)) {
         m_returnValue = sourceFile.MakeIdentifierAbsolute(reReturnStatement.GetMatch(m_comment, 2));
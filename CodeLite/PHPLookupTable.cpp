@@ -1,11 +1,15 @@
 #include "PHPLookupTable.h"
 #include <wx/filename.h>
 #include "file_logger.h"
+#include "fileutils.h"
 #include "PHPEntityNamespace.h"
 #include "PHPEntityClass.h"
 #include "PHPEntityVariable.h"
 #include "PHPEntityFunction.h"
 #include "event_notifier.h"
+#include <wx/ffile.h>
+#include <wx/thread.h>
+#include <map>
 
 wxDEFINE_EVENT(wxPHP_PARSE_STARTED, clParseEvent);
 wxDEFINE_EVENT(wxPHP_PARSE_ENDED, clParseEvent);
@@ -81,8 +85,187 @@ const static wxString CREATE_VARIABLES_TABLE_SQL_IDX3 =
 const static wxString CREATE_VARIABLES_TABLE_SQL_IDX4 =
     "CREATE INDEX IF NOT EXISTS VARIABLES_TABLE_IDX_4 ON VARIABLES_TABLE(FUNCTION_ID)";
 
+//------------------------------------------------
+// Files table
+//------------------------------------------------
+const static wxString CREATE_FILES_TABLE_SQL =
+    "CREATE TABLE IF NOT EXISTS FILES_TABLE(ID INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, "
+    "FILE_NAME TEXT, "
+    "CONTENT_HASH TEXT )"; // Hash of the file content when it was last parsed
+
+const static wxString CREATE_FILES_TABLE_SQL_IDX1 =
+    "CREATE UNIQUE INDEX IF NOT EXISTS FILES_TABLE_IDX_1 ON FILES_TABLE(FILE_NAME)";
+
+// Maximum number of parsed files waiting to be written to the database
+#define PHP_PARSED_FILES_WINDOW 256
+
+//------------------------------------------------
+// Parallel parsing
+//------------------------------------------------
+struct PHPParsedFile {
+    PHPSourceFile* source; // NULL if the file was not modified or could not be read
+    wxString hash;
+
+    PHPParsedFile()
+        : source(NULL)
+    {
+    }
+
+    /**
+     * @brief return a copy which does not share its strings with this object.
+     * Used when passing a parsed file from one thread to another
+     */
+    PHPParsedFile Clone() const
+    {
+        PHPParsedFile parsed;
+        parsed.source = source;
+        parsed.hash = hash.c_str();
+        return parsed;
+    }
+};
+
+/**
+ * @class PHPParseQueue
+ * @brief hands out files to the parsing threads and returns the parsed files
+ * to the database writer in their original order
+ */
+class PHPParseQueue
+{
+    wxArrayString m_files;
+    const std::map<wxString, wxString>& m_hashes;
+    bool m_parseFuncBodies;
+    size_t m_next;
+    size_t m_written;
+    bool m_cancelled;
+    std::map<size_t, PHPParsedFile> m_parsed;
+    wxMutex m_mutex;
+    wxCondition m_cond;
+
+public:
+    PHPParseQueue(const wxArrayString& files, const std::map<wxString, wxString>& hashes, bool parseFuncBodies)
+        : m_hashes(hashes)
+        , m_parseFuncBodies(parseFuncBodies)
+        , m_next(0)
+        , m_written(0)
+        , m_cancelled(false)
+        , m_cond(m_mutex)
+    {
+        // Make our own copy of the strings, they are used by several threads
+        for(size_t i = 0; i < files.GetCount(); ++i) {
+            m_files.Add(files.Item(i).c_str());
+        }
+    }
+
+    ~PHPParseQueue()
+    {
+        std::map<size_t, PHPParsedFile>::iterator iter = m_parsed.begin();
+        for(; iter != m_parsed.end(); ++iter) {
+            wxDELETE(iter->second.source);
+        }
+    }
+
+    /**
+     * @brief pick the next file to parse. Blocks while the writer is too far behind
+     */
+    bool Next(size_t& index, wxString& filename)
+    {
+        wxMutexLocker locker(m_mutex);
+        while(!m_cancelled && m_next < m_files.GetCount() && m_next >= (m_written + PHP_PARSED_FILES_WINDOW)) {
+            m_cond.Wait();
+        }
+        if(m_cancelled || m_next >= m_files.GetCount()) return false;
+        index = m_next++;
+        filename = m_files.Item(index).c_str();
+        return true;
+    }
+
+    void Push(size_t index, const PHPParsedFile& parsed)
+    {
+        wxMutexLocker locker(m_mutex);
+        m_parsed.insert(std::make_pair(index, parsed.Clone()));
+        m_cond.Broadcast();
+    }
+
+    /**
+     * @brief return the next file (in the original order) to the writer
+     */
+    PHPParsedFile Pop()
+    {
+        wxMutexLocker locker(m_mutex);
+        while(m_parsed.count(m_written) == 0) {
+            m_cond.Wait();
+        }
+        std::map<size_t, PHPParsedFile>::iterator iter = m_parsed.find(m_written);
+        PHPParsedFile parsed = iter->second.Clone();
+        m_parsed.erase(iter);
+        ++m_written;
+        m_cond.Broadcast();
+        return parsed;
+    }
+
+    void Cancel()
+    {
+        wxMutexLocker locker(m_mutex);
+        m_cancelled = true;
+        m_cond.Broadcast();
+    }
+
+    /**
+     * @brief read and parse a single file. Files whose content did not change
+     * since they were last stored are not parsed
+     */
+    void Parse(const wxString& filename, PHPParsedFile& parsed)
+    {
+        wxFFile fp(filename, "rb");
+        if(!fp.IsOpened()) return;
+
+        wxString content;
+        fp.ReadAll(&content, wxConvUTF8);
+        fp.Close();
+
+        parsed.hash = FileUtils::Hash(content);
+        std::map<wxString, wxString>::const_iterator iter = m_hashes.find(filename);
+        if(iter != m_hashes.end() && iter->second == parsed.hash) {
+            // Not modified
+            return;
+        }
+
+        wxFileName fnSourceFile(filename);
+        fnSourceFile.MakeAbsolute();
+        parsed.source = new PHPSourceFile(content);
+        parsed.source->SetFilename(fnSourceFile);
+        parsed.source->SetParseFunctionBody(m_parseFuncBodies);
+        parsed.source->Parse();
+    }
+};
+
+class PHPParserWorker : public wxThread
+{
+    PHPParseQueue* m_queue;
+
+public:
+    PHPParserWorker(PHPParseQueue* queue)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_queue(queue)
+    {
+    }
+
+    virtual void* Entry()
+    {
+        size_t index;
+        wxString filename;
+        while(m_queue->Next(index, filename)) {
+            PHPParsedFile parsed;
+            m_queue->Parse(filename, parsed);
+            m_queue->Push(index, parsed);
+        }
+        return NULL;
+    }
+};
+
 PHPLookupTable::PHPLookupTable()
     : m_sizeLimit(50)
+    , m_scopesLoaded(false)
 {
 }
 
@@ -122,6 +305,7 @@ void PHPLookupTable::Open(const wxString& workspacePath)
     fnDBFile.AppendDir(".codelite");
     fnDBFile.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
 
+    ClearCache();
     try {
         wxFileName::Mkdir(fnDBFile.GetPath(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
         m_db.Open(fnDBFile.GetFullPath());
@@ -157,6 +341,10 @@ void PHPLookupTable::CreateSchema()
         m_db.ExecuteUpdate(CREATE_VARIABLES_TABLE_SQL_IDX3);
         m_db.ExecuteUpdate(CREATE_VARIABLES_TABLE_SQL_IDX4);
 
+        // files table
+        m_db.ExecuteUpdate(CREATE_FILES_TABLE_SQL);
+        m_db.ExecuteUpdate(CREATE_FILES_TABLE_SQL_IDX1);
+
     } catch(wxSQLite3Exception& e) {
         CL_WARNING("PHPLookupTable::CreateSchema: %s", e.GetMessage());
     }
@@ -190,71 +378,66 @@ void PHPLookupTable::UpdateSourceFile(PHPSourceFile& source, bool autoCommit)
         if(topNamespace) {
             topNamespace->StoreRecursive(m_db);
         }
+
+        // The stored content hash no longer describes the entries
+        // (the source may come from an unsaved buffer)
+        if(autoCommit) {
+            wxSQLite3Statement st = m_db.PrepareStatement("DELETE FROM FILES_TABLE WHERE FILE_NAME=:FILE_NAME");
+            st.Bind(st.GetParamIndex(":FILE_NAME"), source.GetFilename().GetFullPath());
+            st.ExecuteUpdate();
+        }
         if(autoCommit) m_db.Commit();
 
     } catch(wxSQLite3Exception& e) {
         CL_WARNING("PHPLookupTable::SaveSourceFile: %s", e.GetMessage());
     }
+
+    // Storing the entries assigns new IDs to the scopes
+    ClearCache();
 }
 
 PHPEntityBase::Ptr_t PHPLookupTable::DoFindMemberOf(wxLongLong parentDbId, const wxString& exactName)
 {
     // Find members of of parentDbID
-    try {
-        PHPEntityBase::List_t matches;
-        {
-            wxString sql;
-            sql << "SELECT * from FUNCTION_TABLE WHERE SCOPE_ID=" << parentDbId << " AND NAME='" << exactName << "'";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while(res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityFunction());
-                match->FromResultSet(res);
-                matches.push_back(match);
+    const Members& members = DoGetMembers(parentDbId);
+    PHPEntityBase::Ptr_t match(NULL);
+    PHPEntityBase::List_t::const_iterator iter = members.functions.begin();
+    for(; iter != members.functions.end(); ++iter) {
+        if((*iter)->GetName() == exactName) {
+            if(match) {
+                // we found more than 1 match in the function table
+                // return NULL
+                return PHPEntityBase::Ptr_t(NULL);
             }
+            match = *iter;
         }
-        if(matches.empty()) {
-            // Could not find a match in the function table, check the variable table
-            wxString sql;
-            wxString nameWDollar, namwWODollar;
-            nameWDollar = exactName;
-            if(exactName.StartsWith("$")) {
-                namwWODollar = exactName.Mid(1);
-            } else {
-                namwWODollar = exactName;
-                nameWDollar.Prepend("$");
-            }
+    }
 
-            sql << "SELECT * from VARIABLES_TABLE WHERE SCOPE_ID=" << parentDbId << " AND NAME IN ('" << nameWDollar
-                << "', '" << namwWODollar << "')";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
+    if(match) {
+        // exactly one match was found in the function table
+        // return it
+        return match;
+    }
 
-            while(res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityVariable());
-                match->FromResultSet(res);
-                matches.push_back(match);
-            }
-            if(matches.empty() || matches.size() > 1) {
+    // Could not find a match in the function table, check the variable table
+    wxString nameWDollar, namwWODollar;
+    nameWDollar = exactName;
+    if(exactName.StartsWith("$")) {
+        namwWODollar = exactName.Mid(1);
+    } else {
+        namwWODollar = exactName;
+        nameWDollar.Prepend("$");
+    }
+
+    for(iter = members.variables.begin(); iter != members.variables.end(); ++iter) {
+        if((*iter)->GetName() == nameWDollar || (*iter)->GetName() == namwWODollar) {
+            if(match) {
                 return PHPEntityBase::Ptr_t(NULL);
-            } else {
-                return (*matches.begin());
             }
-        } else if(matches.size() > 1) {
-            // we found more than 1 match in the function table
-            // return NULL
-            return PHPEntityBase::Ptr_t(NULL);
-        } else {
-            // exactly one match was found in the function table
-            // return it
-            return (*matches.begin());
+            match = *iter;
         }
-
-    } catch(wxSQLite3Exception& e) {
-        CL_WARNING("PHPLookupTable::DoFindMemberOf: %s", e.GetMessage());
     }
-    return PHPEntityBase::Ptr_t(NULL);
+    return match;
 }
 
 void PHPLookupTable::DoGetInheritanceParentIDs(PHPEntityBase::Ptr_t cls,
@@ -263,11 +446,16 @@ void PHPLookupTable::DoGetInheritanceParentIDs(PHPEntityBase::Ptr_t cls,
 {
     parents.push_back(cls->GetDbId());
     parentsVisited.insert(cls->GetDbId());
-    wxArrayString parentsArr = cls->Cast<PHPEntityClass>()->GetInheritanceArray();
-    for(size_t i = 0; i < parentsArr.GetCount(); ++i) {
-        PHPEntityBase::Ptr_t parent = FindClass(parentsArr.Item(i));
-        if(parent && !parentsVisited.count(parent->GetDbId())) {
-            DoGetInheritanceParentIDs(parent, parents, parentsVisited);
+
+    // The inheritance was resolved to IDs when the scopes were loaded
+    DoLoadScopes();
+    ScopeMap_t::iterator iter = m_scopes.find(cls->GetDbId());
+    if(iter == m_scopes.end()) return;
+
+    const std::vector<wxLongLong>& parentsIds = iter->second.parents;
+    for(size_t i = 0; i < parentsIds.size(); ++i) {
+        if(!parentsVisited.count(parentsIds.at(i))) {
+            DoGetInheritanceParentIDs(m_scopes[parentsIds.at(i)].scope, parents, parentsVisited);
         }
     }
 }
@@ -275,43 +463,12 @@ void PHPLookupTable::DoGetInheritanceParentIDs(PHPEntityBase::Ptr_t cls,
 PHPEntityBase::Ptr_t PHPLookupTable::DoFindScope(const wxString& fullname, ePhpScopeType scopeType)
 {
     // locate the scope
-    try {
-        wxString sql;
-
-        // limit by 2 for performance reason
-        // we will return NULL incase the number of matches is greater than 1...
-        sql << "SELECT * from SCOPE_TABLE WHERE NAME='" << fullname << "'";
-        if(scopeType != kPhpScopeTypeAny) {
-            sql << " AND SCOPE_TYPE = " << static_cast<int>(scopeType);
-        }
-        sql << " LIMIT 2 ";
-
-        wxSQLite3Statement st = m_db.PrepareStatement(sql);
-        wxSQLite3ResultSet res = st.ExecuteQuery();
-        PHPEntityBase::Ptr_t match(NULL);
-
-        while(res.NextRow()) {
-            if(match) {
-                // only one match
-                return PHPEntityBase::Ptr_t(NULL);
-            }
-
-            int scopeType = res.GetInt("SCOPE_TYPE", 1);
-            if(scopeType == 0) {
-                // namespace
-                match.reset(new PHPEntityNamespace());
-            } else {
-                // class
-                match.reset(new PHPEntityClass());
-            }
-            match->FromResultSet(res);
-        }
-        return match;
-
-    } catch(wxSQLite3Exception& e) {
-        CL_WARNING("PHPLookupTable::FindScope: %s", e.GetMessage());
+    DoLoadScopes();
+    std::map<wxString, wxLongLong>::const_iterator iter = m_scopeNames.find(fullname);
+    if(iter == m_scopeNames.end()) {
+        return PHPEntityBase::Ptr_t(NULL);
     }
-    return PHPEntityBase::Ptr_t(NULL);
+    return DoFindScope(iter->second, scopeType);
 }
 
 PHPEntityBase::Ptr_t PHPLookupTable::FindClass(const wxString& fullname)
@@ -322,90 +479,136 @@ PHPEntityBase::Ptr_t PHPLookupTable::FindClass(const wxString& fullname)
 PHPEntityBase::Ptr_t PHPLookupTable::DoFindScope(wxLongLong id, ePhpScopeType scopeType)
 {
     // locate the scope
-    try {
-        wxString sql;
+    DoLoadScopes();
+    ScopeMap_t::const_iterator iter = m_scopes.find(id);
+    if(iter == m_scopes.end()) {
+        return PHPEntityBase::Ptr_t(NULL);
+    }
 
-        // limit by 2 for performance reason
-        // we will return NULL incase the number of matches is greater than 1...
-        sql << "SELECT * from SCOPE_TABLE WHERE ID=" << id;
-        if(scopeType != kPhpScopeTypeAny) {
-            sql << " AND SCOPE_TYPE = " << static_cast<int>(scopeType);
+    PHPEntityBase::Ptr_t match = iter->second.scope;
+    if((scopeType == kPhpScopeTypeClass && !match->Is(kEntityTypeClass)) ||
+       (scopeType == kPhpScopeTypeNamespace && !match->Is(kEntityTypeNamespace))) {
+        return PHPEntityBase::Ptr_t(NULL);
+    }
+    return match;
+}
+
+PHPEntityBase::Ptr_t PHPLookupTable::FindClass(wxLongLong id) { return DoFindScope(id, kPhpScopeTypeClass); }
+
+PHPEntityBase::List_t PHPLookupTable::FindChildren(wxLongLong parentId, eLookupFlags flags, const wxString& nameHint)
+{
+    // Find members of of parentDbID
+    const Members& members = DoGetMembers(parentId);
+    if(nameHint.IsEmpty() || !(flags & (kLookupFlags_ExactMatch | kLookupFlags_PartialMatch))) {
+        PHPEntityBase::List_t matches = members.functions;
+        matches.insert(matches.end(), members.variables.begin(), members.variables.end());
+        return matches;
+    }
+
+    // Same rules as the SQL 'LIKE' operator: partial match is case insensitive
+    PHPEntityBase::List_t matches;
+    wxString lcNameHint = nameHint.Lower();
+    const PHPEntityBase::List_t* lists[] = { &members.functions, &members.variables };
+    for(size_t i = 0; i < 2; ++i) {
+        PHPEntityBase::List_t::const_iterator iter = lists[i]->begin();
+        for(; iter != lists[i]->end(); ++iter) {
+            const wxString& name = (*iter)->GetName();
+            if(flags & kLookupFlags_ExactMatch) {
+                if(name == nameHint) matches.push_back(*iter);
+            } else if(name.Lower().Contains(lcNameHint)) {
+                matches.push_back(*iter);
+            }
         }
-        sql << " LIMIT 1";
+    }
+    return matches;
+}
 
-        wxSQLite3Statement st = m_db.PrepareStatement(sql);
-        wxSQLite3ResultSet res = st.ExecuteQuery();
+void PHPLookupTable::ClearCache()
+{
+    m_scopes.clear();
+    m_scopeNames.clear();
+    m_members.clear();
+    m_scopesLoaded = false;
+}
+
+void PHPLookupTable::DoLoadScopes()
+{
+    if(m_scopesLoaded) return;
+    m_scopesLoaded = true;
 
-        if(res.NextRow()) {
-            PHPEntityBase::Ptr_t match(NULL);
+    try {
+        wxSQLite3ResultSet res = m_db.ExecuteQuery("SELECT * from SCOPE_TABLE");
+        while(res.NextRow()) {
+            PHPEntityBase::Ptr_t scope(NULL);
             int scopeType = res.GetInt("SCOPE_TYPE", 1);
             if(scopeType == kPhpScopeTypeNamespace) {
                 // namespace
-                match.reset(new PHPEntityNamespace());
+                scope.reset(new PHPEntityNamespace());
             } else {
                 // class
-                match.reset(new PHPEntityClass());
+                scope.reset(new PHPEntityClass());
             }
-            match->FromResultSet(res);
-            return match;
+            scope->FromResultSet(res);
+            m_scopes[scope->GetDbId()].scope = scope;
+            m_scopeNames.insert(std::make_pair(res.GetString("NAME"), scope->GetDbId()));
         }
     } catch(wxSQLite3Exception& e) {
-        CL_WARNING("PHPLookupTable::DoFindScope: %s", e.GetMessage());
+        CL_WARNING("PHPLookupTable::DoLoadScopes: %s", e.GetMessage());
     }
-    return PHPEntityBase::Ptr_t(NULL);
-}
 
-PHPEntityBase::Ptr_t PHPLookupTable::FindClass(wxLongLong id) { return DoFindScope(id, kPhpScopeTypeClass); }
+    // Resolve the inheritance of the classes to IDs
+    ScopeMap_t::iterator iter = m_scopes.begin();
+    for(; iter != m_scopes.end(); ++iter) {
+        PHPEntityClass* cls = iter->second.scope->Cast<PHPEntityClass>();
+        if(!cls) continue;
+
+        wxArrayString parentsArr = cls->GetInheritanceArray();
+        for(size_t i = 0; i < parentsArr.GetCount(); ++i) {
+            std::map<wxString, wxLongLong>::const_iterator parent = m_scopeNames.find(parentsArr.Item(i));
+            if(parent != m_scopeNames.end() && m_scopes[parent->second].scope->Is(kEntityTypeClass)) {
+                iter->second.parents.push_back(parent->second);
+            }
+        }
+    }
+}
 
-PHPEntityBase::List_t PHPLookupTable::FindChildren(wxLongLong parentId, eLookupFlags flags, const wxString& nameHint)
+const PHPLookupTable::Members& PHPLookupTable::DoGetMembers(wxLongLong scopeId)
 {
-    // Find members of of parentDbID
-    PHPEntityBase::List_t matches;
+    MembersMap_t::iterator iter = m_members.find(scopeId);
+    if(iter != m_members.end()) {
+        return iter->second;
+    }
+
+    // First time: load the members of this scope from the database
+    Members& members = m_members[scopeId];
     try {
         {
             // load functions
             wxString sql;
-            sql << "SELECT * from FUNCTION_TABLE WHERE SCOPE_ID=" << parentId;
-            if(flags & kLookupFlags_ExactMatch && !nameHint.IsEmpty()) {
-                sql << " AND NAME = '" << nameHint << "'";
-
-            } else if(flags & kLookupFlags_PartialMatch && !nameHint.IsEmpty()) {
-                sql << " AND NAME LIKE '%%" << EscapeWildCards(nameHint) << "%%' ESCAPE '^'";
-            }
-
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
+            sql << "SELECT * from FUNCTION_TABLE WHERE SCOPE_ID=" << scopeId;
+            wxSQLite3ResultSet res = m_db.ExecuteQuery(sql);
             while(res.NextRow()) {
                 PHPEntityBase::Ptr_t match(new PHPEntityFunction());
                 match->FromResultSet(res);
-                matches.push_back(match);
+                members.functions.push_back(match);
             }
         }
 
         {
             // Add members from the variables table
             wxString sql;
-            sql << "SELECT * from VARIABLES_TABLE WHERE SCOPE_ID=" << parentId;
-            if(flags & kLookupFlags_ExactMatch && !nameHint.IsEmpty()) {
-                sql << " AND NAME = '" << nameHint << "'";
-
-            } else if(flags & kLookupFlags_PartialMatch && !nameHint.IsEmpty()) {
-                sql << " AND NAME LIKE '%%" << EscapeWildCards(nameHint) << "%%' ESCAPE '^'";
-            }
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
+            sql << "SELECT * from VARIABLES_TABLE WHERE SCOPE_ID=" << scopeId;
+            wxSQLite3ResultSet res = m_db.ExecuteQuery(sql);
             while(res.NextRow()) {
                 PHPEntityBase::Ptr_t match(new PHPEntityVariable());
                 match->FromResultSet(res);
-                matches.push_back(match);
+                members.variables.push_back(match);
             }
         }
     } catch(wxSQLite3Exception& e) {
-        CL_WARNING("PHPLookupTable::FindChildren: %s", e.GetMessage());
+        CL_WARNING("PHPLookupTable::DoGetMembers: %s", e.GetMessage());
     }
-    return matches;
+    return members;
 }
 
 wxString PHPLookupTable::EscapeWildCards(const wxString& str)
@@ -417,8 +620,42 @@ wxString PHPLookupTable::EscapeWildCards(const wxString& str)
 
 void PHPLookupTable::DoAddLimit(wxString& sql) { sql << " LIMIT " << m_sizeLimit; }
 
-void PHPLookupTable::UpdateSourceFiles(const wxArrayString& files, bool parseFuncBodies)
+void PHPLookupTable::DoLoadFileHashes(std::map<wxString, wxString>& hashes)
 {
+    try {
+        wxSQLite3ResultSet res = m_db.ExecuteQuery("SELECT FILE_NAME, CONTENT_HASH FROM FILES_TABLE");
+        while(res.NextRow()) {
+            hashes.insert(std::make_pair(res.GetString(0), res.GetString(1)));
+        }
+    } catch(wxSQLite3Exception& e) {
+        CL_WARNING("PHPLookupTable::DoLoadFileHashes: %s", e.GetMessage());
+    }
+}
+
+void PHPLookupTable::UpdateSourceFiles(const wxArrayString& files, bool parseFuncBodies, bool force)
+{
+    // Files are parsed by several threads while this thread is the only one
+    // writing to the database (in the original order of the files)
+    std::map<wxString, wxString> hashes;
+    if(!force) {
+        DoLoadFileHashes(hashes);
+    }
+
+    PHPParseQueue queue(files, hashes, parseFuncBodies);
+    std::vector<PHPParserWorker*> workers;
+    int cpus = wxThread::GetCPUCount();
+    size_t count = cpus > 0 ? cpus : 1;
+    if(count > files.GetCount()) count = files.GetCount();
+    for(size_t i = 0; i < count; ++i) {
+        PHPParserWorker* worker = new PHPParserWorker(&queue);
+        if(worker->Create() != wxTHREAD_NO_ERROR || worker->Run() != wxTHREAD_NO_ERROR) {
+            delete worker;
+            break;
+        }
+        workers.push_back(worker);
+    }
+
+    size_t skipped = 0;
     try {
 
         {
@@ -428,6 +665,11 @@ void PHPLookupTable::UpdateSourceFiles(const wxArrayString& files, bool parseFun
             EventNotifier::Get()->AddPendingEvent(event);
         }
 
+        wxSQLite3Statement st = m_db.PrepareStatement(
+            "REPLACE INTO FILES_TABLE (ID, FILE_NAME, CONTENT_HASH) VALUES (NULL, :FILE_NAME, :CONTENT_HASH)");
+        int fileNameIdx = st.GetParamIndex(":FILE_NAME");
+        int hashIdx = st.GetParamIndex(":CONTENT_HASH");
+
         m_db.Begin();
         for(size_t i = 0; i < files.GetCount(); ++i) {
             {
@@ -438,12 +680,30 @@ void PHPLookupTable::UpdateSourceFiles(const wxArrayString& files, bool parseFun
                 EventNotifier::Get()->AddPendingEvent(event);
             }
 
-            wxFileName fnSourceFile(files.Item(i));
-            PHPSourceFile sourceFile(fnSourceFile);
-            sourceFile.SetFilename(fnSourceFile);
-            sourceFile.SetParseFunctionBody(parseFuncBodies);
-            sourceFile.Parse();
-            UpdateSourceFile(sourceFile, false);
+            if(workers.empty()) {
+                // No threads, parse it ourselves
+                size_t index;
+                wxString filename;
+                if(queue.Next(index, filename)) {
+                    PHPParsedFile parsed;
+                    queue.Parse(filename, parsed);
+                    queue.Push(index, parsed);
+                }
+            }
+
+            PHPParsedFile parsed = queue.Pop();
+            if(!parsed.source) {
+                ++skipped;
+                continue;
+            }
+
+            UpdateSourceFile(*parsed.source, false);
+            wxDELETE(parsed.source);
+
+            st.Bind(fileNameIdx, files.Item(i));
+            st.Bind(hashIdx, parsed.hash);
+            st.ExecuteUpdate();
+            st.Reset();
         }
         m_db.Commit();
 
@@ -458,4 +718,14 @@ void PHPLookupTable::UpdateSourceFiles(const wxArrayString& files, bool parseFun
         m_db.Rollback();
         CL_WARNING("PHPLookupTable::UpdateSourceFiles: %s", e.GetMessage());
     }
+
+    queue.Cancel();
+    for(size_t i = 0; i < workers.size(); ++i) {
+        workers.at(i)->Wait();
+        delete workers.at(i);
+    }
+    CL_DEBUG("PHPLookupTable::UpdateSourceFiles: %u files, %u skipped (not modified), %u threads",
+             (unsigned int)files.GetCount(),
+             (unsigned int)skipped,
+             (unsigned int)workers.size());
 }
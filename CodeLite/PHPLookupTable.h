@@ -8,6 +8,7 @@
 #include "PHPSourceFile.h"
 #include <vector>
 #include <set>
+#include <map>
 #include <wx/longlong.h>
 #include "cl_command_event.h"
 
@@ -29,8 +30,35 @@ enum ePhpScopeType {
  */
 class WXDLLIMPEXP_CL PHPLookupTable
 {
+    /**
+     * @brief a scope loaded from the database. The inheritance of a class
+     * is kept as the IDs of its parent classes
+     */
+    struct Scope {
+        PHPEntityBase::Ptr_t scope;
+        std::vector<wxLongLong> parents;
+    };
+    typedef std::map<wxLongLong, Scope> ScopeMap_t;
+
+    /**
+     * @brief the members (functions and variables) of a scope
+     */
+    struct Members {
+        PHPEntityBase::List_t functions;
+        PHPEntityBase::List_t variables;
+    };
+    typedef std::map<wxLongLong, Members> MembersMap_t;
+
     wxSQLite3Database m_db;
     size_t m_sizeLimit;
+
+    // In memory copy of the scopes table and of the members queried so far
+    // so code completion does not hit the database
+    ScopeMap_t m_scopes;
+    std::map<wxString, wxLongLong> m_scopeNames;
+    MembersMap_t m_members;
+    bool m_scopesLoaded;
+
 public:
     enum eLookupFlags {
         kLookupFlags_None = 0,
@@ -56,6 +84,22 @@ private:
     wxString EscapeWildCards(const wxString &str);
     
     void DoAddLimit(wxString& sql);
+
+    /**
+     * @brief load the content hash of every file stored in the database
+     */
+    void DoLoadFileHashes(std::map<wxString, wxString>& hashes);
+
+    /**
+     * @brief load all the scopes from the database (once)
+     */
+    void DoLoadScopes();
+
+    /**
+     * @brief return the members of a scope, loading them from the database on first use
+     */
+    const Members& DoGetMembers(wxLongLong scopeId);
+
 public:
     PHPLookupTable();
     virtual ~PHPLookupTable();
@@ -65,6 +109,12 @@ public:
      */
     void Open(const wxString& workspacePath);
 
+    /**
+     * @brief discard the in-memory scopes and members. Call this when the database
+     * was updated by another instance (e.g. the parser thread)
+     */
+    void ClearCache();
+
     /**
      * @brief find a scope symbol (class or namespace) by its fullname
      */
@@ -96,9 +146,10 @@ public:
     void UpdateSourceFile(PHPSourceFile& source, bool autoCommit = true);
     
     /**
-     * @brief update list of source files
+     * @brief update list of source files. The files are parsed in parallel, files
+     * whose content did not change since they were last stored are skipped unless 'force' is true
      */
-    void UpdateSourceFiles(const wxArrayString& files, bool parseFuncBodies = true);
+    void UpdateSourceFiles(const wxArrayString& files, bool parseFuncBodies = true, bool force = false);
 };
 
 #endif // PHPLOOKUPTABLE_H
@@ -27,8 +27,45 @@
 #include <wx/stdpaths.h>
 #include <wx/filefn.h>
 #include <wx/log.h>
+#include <wx/timer.h>
+#include <wx/thread.h>
+#include <wx/ffile.h>
+#include <wx/app.h>
 #include <algorithm>
 #include "cl_standard_paths.h"
+#include "file_logger.h"
+
+// Delay between the first change and the write to the disk
+#define CONFIG_FLUSH_DELAY_MS 1000
+
+/// Writes the pending changes of a clConfig object once the timer expires
+class clConfigFlushTimer : public wxTimer
+{
+    clConfig* m_config;
+
+public:
+    clConfigFlushTimer(clConfig* config)
+        : m_config(config)
+    {
+    }
+    virtual ~clConfigFlushTimer() {}
+    virtual void Notify() { m_config->Flush(); }
+};
+
+// All the live clConfig instances. Used to flush the pending changes of other instances
+// before reading a file they share. clConfig objects are also created by worker threads,
+// so the set must only be accessed while holding GetInstancesLock()
+static std::set<clConfig*>& GetInstances()
+{
+    static std::set<clConfig*> instances;
+    return instances;
+}
+
+static wxCriticalSection& GetInstancesLock()
+{
+    static wxCriticalSection lock;
+    return lock;
+}
 
 #define ADD_OBJ_IF_NOT_EXISTS(parent, objName) \
     if ( !parent.hasNamedObject( objName ) ) { \
@@ -43,6 +80,8 @@
     }\
     
 clConfig::clConfig(const wxString& filename)
+    : m_dirty(false)
+    , m_flushTimer(NULL)
 {
     if ( wxFileName(filename).IsAbsolute() ) {
         m_filename = filename;
@@ -57,6 +96,13 @@ clConfig::clConfig(const wxString& filename)
         wxMkdir( m_filename.GetPath() );
     }
     
+    // Another instance may have changes for this file which are not on the disk yet
+    DoFlushInstances();
+    {
+        wxCriticalSectionLocker locker(GetInstancesLock());
+        GetInstances().insert(this);
+    }
+    
     if ( m_filename.FileExists() ) {
         m_root = new JSONRoot(m_filename);
         
@@ -67,7 +113,13 @@ clConfig::clConfig(const wxString& filename)
 
 clConfig::~clConfig()
 {
-    m_root->save( m_filename );
+    {
+        // Flush under the lock so DoFlushInstances() of another thread does not write us at the same time
+        wxCriticalSectionLocker locker(GetInstancesLock());
+        Flush();
+        GetInstances().erase(this);
+    }
+    wxDELETE(m_flushTimer);
     wxDELETE(m_root);
 }
 
@@ -97,8 +149,7 @@ void clConfig::SetWorkspaceTabOrder(const wxArrayString& tabs, int selected)
     e.addProperty("tabs", tabs);
     e.addProperty("selected", selected);
     m_root->toElement().append( e );
-    
-    m_root->save(m_filename);
+    DoSetDirty();
 }
 
 void clConfig::DoDeleteProperty(const wxString& property)
@@ -123,16 +174,19 @@ void clConfig::WriteItem(const clConfigItem* item, const wxString &differentName
     wxString nameToUse = differentName.IsEmpty() ? item->GetName() : differentName;
     DoDeleteProperty(nameToUse);
     m_root->toElement().append(item->ToJSON());
-    m_root->save(m_filename);
+    DoSetDirty();
 }
 
 void clConfig::Reload() 
 {
+    // Our own changes and the ones made by other instances must be on the disk first
+    DoFlushInstances();
     if ( m_filename.FileExists() == false )
         return;
         
     delete m_root;
     m_root = new JSONRoot(m_filename);
+    DoClearCache();
 }
 
 wxArrayString clConfig::MergeArrays(const wxArrayString& arr1, const wxArrayString& arr2) const
@@ -160,8 +214,98 @@ JSONElement::wxStringMap_t clConfig::MergeStringMaps(const JSONElement::wxString
 
 void clConfig::Save()
 {
-    if ( m_root )
-        m_root->save(m_filename);
+    m_dirty = true;
+    Flush();
+}
+
+void clConfig::Flush()
+{
+    if ( m_flushTimer && wxThread::IsMain() ) {
+        m_flushTimer->Stop();
+    }
+    
+    if ( !m_dirty || !m_root )
+        return;
+        
+    m_dirty = false;
+    DoSaveAtomically();
+}
+
+void clConfig::DoSetDirty()
+{
+    m_dirty = true;
+    
+    // Timers can only be used from the main thread of an application
+    if ( !wxTheApp || !wxThread::IsMain() ) {
+        Flush();
+        return;
+    }
+    
+    if ( !m_flushTimer ) {
+        m_flushTimer = new clConfigFlushTimer(this);
+    }
+    
+    if ( !m_flushTimer->IsRunning() ) {
+        m_flushTimer->Start(CONFIG_FLUSH_DELAY_MS, wxTIMER_ONE_SHOT);
+    }
+}
+
+void clConfig::DoSaveAtomically()
+{
+    // Write the content to a temporary file and rename it over the configuration file
+    // so a crash while writing never leaves a truncated file behind
+    wxString target = m_filename.GetFullPath();
+    wxString tmpfile = target + ".tmp";
+    
+    wxLogNull noLog;
+    {
+        wxFFile fp(tmpfile, "w+b");
+        if ( !fp.IsOpened() ) {
+            CL_WARNING("clConfig: failed to open file '%s' for write", tmpfile);
+            return;
+        }
+        
+        if ( !fp.Write(m_root->toElement().format(), wxConvUTF8) ) {
+            CL_WARNING("clConfig: failed to write file '%s'", tmpfile);
+            fp.Close();
+            ::wxRemoveFile(tmpfile);
+            return;
+        }
+        fp.Close();
+    }
+    
+    if ( !::wxRenameFile(tmpfile, target, true) ) {
+        CL_WARNING("clConfig: failed to rename file '%s' to '%s'", tmpfile, target);
+        ::wxRemoveFile(tmpfile);
+    }
+}
+
+void clConfig::DoFlushInstances()
+{
+    // Hold the lock while flushing so an instance can not be destroyed under our feet
+    wxCriticalSectionLocker locker(GetInstancesLock());
+    std::set<clConfig*>::iterator iter = GetInstances().begin();
+    for(; iter != GetInstances().end(); ++iter) {
+        if ( (*iter)->m_filename == m_filename ) {
+            (*iter)->Flush();
+        }
+    }
+}
+
+void clConfig::DoClearCache()
+{
+    m_boolCache.clear();
+    m_intCache.clear();
+    m_stringCache.clear();
+    m_missingKeys.clear();
+}
+
+void clConfig::DoClearCache(const wxString& name)
+{
+    m_boolCache.erase(name);
+    m_intCache.erase(name);
+    m_stringCache.erase(name);
+    m_missingKeys.erase(name);
 }
 
 void clConfig::Save(const wxFileName& fn)
@@ -187,14 +331,32 @@ void clConfig::Write(const wxString& name, bool value)
     }
 
     general.addProperty(name, value);
-    Save();
+    DoClearCache(name);
+    m_boolCache[name] = value;
+    DoSetDirty();
 }
 
 bool clConfig::Read(const wxString& name, bool defaultValue)
 {
+    std::map<wxString, bool>::const_iterator iter = m_boolCache.find(name);
+    if (iter != m_boolCache.end()) {
+        return iter->second;
+    }
+    
+    if (m_missingKeys.count(name)) {
+        return defaultValue;
+    }
+
     JSONElement general = GetGeneralSetting();
-    if (general.namedObject(name).isBool()) {
-        return general.namedObject(name).toBool();
+    if (!general.hasNamedObject(name)) {
+        m_missingKeys.insert(name);
+        return defaultValue;
+    }
+    
+    JSONElement value = general.namedObject(name);
+    if (value.isBool()) {
+        m_boolCache[name] = value.toBool();
+        return m_boolCache[name];
     }
 
     return defaultValue;
@@ -208,13 +370,37 @@ void clConfig::Write(const wxString& name, int value)
     }
 
     general.addProperty(name, value);
-    Save();
+    DoClearCache(name);
+    m_intCache[name] = value;
+    DoSetDirty();
 }
 
 int clConfig::Read(const wxString& name, int defaultValue)
 {
+    std::map<wxString, int>::const_iterator iter = m_intCache.find(name);
+    if (iter != m_intCache.end()) {
+        return iter->second;
+    }
+    
+    if (m_missingKeys.count(name)) {
+        return defaultValue;
+    }
+
     JSONElement general = GetGeneralSetting();
-    return general.namedObject(name).toInt(defaultValue);
+    if (!general.hasNamedObject(name)) {
+        m_missingKeys.insert(name);
+        return defaultValue;
+    }
+    
+    // toInt() returns the default value for non numbers: a value that is returned
+    // with two different defaults is an actual number
+    JSONElement value = general.namedObject(name);
+    int number = value.toInt(0);
+    if (number != 0 || value.toInt(1) == 0) {
+        m_intCache[name] = number;
+        return number;
+    }
+    return defaultValue;
 }
 
 void clConfig::Write(const wxString& name, const wxString& value)
@@ -225,14 +411,32 @@ void clConfig::Write(const wxString& name, const wxString& value)
     }
 
     general.addProperty(name, value);
-    Save();
+    DoClearCache(name);
+    m_stringCache[name] = value;
+    DoSetDirty();
 }
 
 wxString clConfig::Read(const wxString& name, const wxString& defaultValue)
 {
+    std::map<wxString, wxString>::const_iterator iter = m_stringCache.find(name);
+    if (iter != m_stringCache.end()) {
+        return iter->second;
+    }
+    
+    if (m_missingKeys.count(name)) {
+        return defaultValue;
+    }
+
     JSONElement general = GetGeneralSetting();
-    if (general.namedObject(name).isString()) {
-        return general.namedObject(name).toString();
+    if (!general.hasNamedObject(name)) {
+        m_missingKeys.insert(name);
+        return defaultValue;
+    }
+    
+    JSONElement value = general.namedObject(name);
+    if (value.isString()) {
+        m_stringCache[name] = value.toString();
+        return m_stringCache[name];
     }
 
     return defaultValue;
@@ -262,13 +466,13 @@ void clConfig::SetAnnoyingDlgAnswer(const wxString& name, int value)
         element.removeProperty(name);
     }
     element.addProperty(name, value);
-    Save();
+    DoSetDirty();
 }
 
 void clConfig::ClearAnnoyingDlgAnswers()
 {
     DoDeleteProperty("AnnoyingDialogsAnswers");
-    Save();
+    DoSetDirty();
     Reload();
 }
 
@@ -299,7 +503,7 @@ void clConfig::AddQuickFindReplaceItem(const wxString& str)
     
     quickFindBar.removeProperty( "ReplaceHistory" );
     quickFindBar.addProperty("ReplaceHistory", items);
-    Save();
+    DoSetDirty();
 }
 
 void clConfig::AddQuickFindSearchItem(const wxString& str)
@@ -329,7 +533,7 @@ void clConfig::AddQuickFindSearchItem(const wxString& str)
 
     quickFindBar.removeProperty( "SearchHistory" );
     quickFindBar.addProperty("SearchHistory", items);
-    Save();
+    DoSetDirty();
 }
 
 wxArrayString clConfig::GetQuickFindReplaceItems() const
@@ -28,6 +28,8 @@
 
 #include "codelite_exports.h"
 #include "json_node.h"
+#include <map>
+#include <set>
 
 ////////////////////////////////////////////////////////
 
@@ -59,15 +61,34 @@ public:
 
 ////////////////////////////////////////////////////////
 
+class wxTimer;
 class WXDLLIMPEXP_CL clConfig
 {
 protected:
     wxFileName m_filename;
     JSONRoot* m_root;
+    
+    // Changes are kept in m_root and written to the disk by a single-shot timer,
+    // so a burst of writes costs one file rewrite
+    bool m_dirty;
+    wxTimer* m_flushTimer;
+    
+    // Typed cache of the "General" settings. m_missingKeys holds the names that
+    // are known not to exist in the file
+    std::map<wxString, bool> m_boolCache;
+    std::map<wxString, int> m_intCache;
+    std::map<wxString, wxString> m_stringCache;
+    std::set<wxString> m_missingKeys;
 
 protected:
     void DoDeleteProperty(const wxString &property);
     JSONElement GetGeneralSetting();
+    void DoSetDirty();
+    void DoSaveAtomically();
+    void DoClearCache();
+    void DoClearCache(const wxString& name);
+    // Flush the pending changes of all the instances sharing our file
+    void DoFlushInstances();
 
 public:
     // We provide a global configuration
@@ -82,6 +103,8 @@ public:
     void Save(const wxFileName& fn);
     // Save the content the file passed on the construction
     void Save();
+    // Write the pending changes (if any) to the disk
+    void Flush();
 
     // Utility functions
     //------------------------------
@@ -0,0 +1,59 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : cl_string_pool.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+
+#include "cl_string_pool.h"
+#include <wx/tls.h>
+
+// The pool of the current thread. It is intentionally never deleted: objects created
+// by a thread may outlive it and still point to its strings
+static wxTLS_TYPE(clStringPool*) gs_threadPool;
+
+clStringPool::clStringPool() {}
+
+clStringPool::~clStringPool() {}
+
+clStringPool& clStringPool::Get()
+{
+    clStringPool*& pool = wxTLS_VALUE(gs_threadPool);
+    if(!pool) {
+        pool = new clStringPool();
+    }
+    return *pool;
+}
+
+const wxString* clStringPool::Intern(const wxString& str)
+{
+    if(str.IsEmpty()) {
+        return &m_empty;
+    }
+
+    clStringPoolSet::iterator iter = m_strings.find(str);
+    if(iter == m_strings.end()) {
+        // Keep our own copy of the string, 'str' may be owned by another thread
+        iter = m_strings.insert(wxString(str.c_str())).first;
+    }
+    return &(*iter);
+}
@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : cl_string_pool.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef CLSTRINGPOOL_H
+#define CLSTRINGPOOL_H
+
+#include "codelite_exports.h"
+#include <wx/string.h>
+#include <wx/hashset.h>
+
+WX_DECLARE_HASH_SET(wxString, wxStringHash, wxStringEqual, clStringPoolSet);
+
+/**
+ * @class clStringPool
+ * @brief a per thread pool of immutable strings. Values that repeat across many
+ * objects (file names, kinds, scopes etc) are kept once, the objects hold a pointer
+ * to the pooled copy. Strings are never removed from the pool and the pool of a
+ * thread is never destroyed, so the pointers remain valid for the lifetime of the
+ * process. Only pool values with a bounded number of distinct values.
+ * Each thread interns into its own pool without locking. The strings of a pool are
+ * only meant to be used by the objects of its thread: an object passed to another
+ * thread must be copied there (re-interning its strings in that thread's pool),
+ * wxString reference counts are not atomic
+ */
+class WXDLLIMPEXP_CL clStringPool
+{
+    clStringPoolSet m_strings;
+    wxString m_empty;
+
+private:
+    clStringPool();
+    ~clStringPool();
+
+public:
+    /**
+     * @brief return the pool of the calling thread
+     */
+    static clStringPool& Get();
+
+    /**
+     * @brief return the pooled copy of 'str'. 'str' is only read, it may belong
+     * to the pool of another thread
+     */
+    const wxString* Intern(const wxString& str);
+
+    /**
+     * @brief return the pooled empty string
+     */
+    const wxString* Empty() const { return &m_empty; }
+};
+
+#endif // CLSTRINGPOOL_H
@@ -447,6 +447,42 @@ TagTreePtr TagsManager::TreeFromTags(const wxString& tags, int &count)
     return tree;
 }
 
+void TagsManager::EntriesFromTags(const wxString& tags, std::vector<TagEntry>& entries, int& count)
+{
+    // key -> index in 'entries'
+    wxStringToNumHashMap indexes;
+
+    wxStringTokenizer tkz(tags, wxT("\n"));
+    while (tkz.HasMoreTokens()) {
+        wxString line = tkz.NextToken();
+
+        line = line.Trim();
+        line = line.Trim(false);
+        if (line.IsEmpty())
+            continue;
+
+        // Construct the tag from the line
+        TagEntry tag;
+        tag.FromLine(line);
+
+        // locals are not stored
+        count++;
+        if ( tag.GetKind() == wxT("local") )
+            continue;
+
+        // Same as TagTree::AddEntry(): an existing entry with the same key is updated
+        wxString key = tag.Key();
+        wxStringToNumHashMap::iterator iter = indexes.find(key);
+        if ( iter != indexes.end() ) {
+            if ( tag.IsOk() )
+                entries.at(iter->second) = tag;
+            continue;
+        }
+        indexes[key] = entries.size();
+        entries.push_back(tag);
+    }
+}
+
 bool TagsManager::IsValidCtagsFile(const wxFileName &filename) const
 {
     bool is_ok(false);
@@ -2657,6 +2693,12 @@ void TagsManager::ClearTagsCache()
     GetDatabase()->ClearCache();
 }
 
+void TagsManager::ClearTagsCache(const wxString& filename)
+{
+    GetDatabase()->ClearCache(filename);
+    CL_DEBUG1(wxT("%s"), GetDatabase()->GetCacheStatistics().c_str());
+}
+
 void TagsManager::SetProjectPaths(const wxArrayString& paths)
 {
     m_projectPaths.Clear();
@@ -2957,6 +2999,16 @@ void TagsManager::GetTagsByPartialName(const wxString& partialName, std::vector<
     GetDatabase()->GetTagsByPartName(partialName, tags);
 }
 
+void TagsManager::GetTagsByNames(const wxArrayString& names, std::vector<TagEntryPtr>& tags)
+{
+    GetDatabase()->GetTagsByNames(names, tags);
+}
+
+void TagsManager::GetTagsNamesNoLimit(const wxArrayString& kinds, wxArrayString& names)
+{
+    GetDatabase()->GetTagsNamesNoLimit(kinds, names);
+}
+
 bool TagsManager::AreTheSame(const TagEntryPtrVector_t& v1, const TagEntryPtrVector_t& v2) const
 {
     // Assuming that v1 and v2 are sorted!
@@ -677,6 +677,17 @@ public:
      */
     void GetTagsByPartialName(const wxString& partialName, std::vector<TagEntryPtr>& tags);
 
+    /**
+     * @brief return all the tags whose name is one of 'names'
+     */
+    void GetTagsByNames(const wxArrayString& names, std::vector<TagEntryPtr>& tags);
+
+    /**
+     * @brief return the unique names of all the tags in the database (no limit is applied)
+     * @param kinds when not empty, only tags of these kinds are returned
+     */
+    void GetTagsNamesNoLimit(const wxArrayString& kinds, wxArrayString& names);
+
     /**
      * @brief return list of tags by KIND
      * @param tags [output]
@@ -809,11 +820,26 @@ public:
      */
     TagTreePtr TreeFromTags(const wxString& tags, int& count);
 
+    /**
+     * Parse tags from memory into a flat list, without building a TagTree.
+     * The entries are the ones TreeFromTags() would place in the tree (tags with the same key
+     * are merged and locals are skipped), without the intermediate scopes.
+     * Use this when the tags are only stored into the database
+     * @param tags wxString containing the tags to parse
+     * @param entries [output]
+     */
+    void EntriesFromTags(const wxString& tags, std::vector<TagEntry>& entries, int& count);
+
     /**
      * @brief clear the underlying caching mechanism
      */
     void ClearTagsCache();
 
+    /**
+     * @brief clear only the cache entries affected by re-tagging 'filename'
+     */
+    void ClearTagsCache(const wxString& filename);
+
     /**
      * @brief return true of v1 cotnains the same tags as v2
      */
@@ -47,8 +47,36 @@ wxString TagEntry::KIND_MACRO = "macro";
 wxString TagEntry::KIND_STRUCT = "struct";
 wxString TagEntry::KIND_FILE = "file";
 
+// Only read by the threads, the pooled copies belong to each thread's pool
+static const wxString s_kindUnknown = wxT("<unknown>");
+static const wxString s_scopeGlobal = wxT("<global>");
+
+static const wxString* GetKindUnknown() { return clStringPool::Get().Intern(s_kindUnknown); }
+
+static const wxString* GetScopeGlobal() { return clStringPool::Get().Intern(s_scopeGlobal); }
+
+// Two pointers to pooled strings may come from the pools of different threads
+static bool IsSamePooled(const wxString* lhs, const wxString* rhs) { return lhs == rhs || *lhs == *rhs; }
+
+static wxString GetField(const std::map<wxString, wxString>& fields, const wxString& name)
+{
+    std::map<wxString, wxString>::const_iterator iter = fields.find(name);
+    if(iter == fields.end()) return wxEmptyString;
+    return iter->second;
+}
+
 TagEntry::TagEntry(const tagEntry& entry)
-    : m_isClangTag(false)
+    : m_file(clStringPool::Get().Empty())
+    , m_lineNumber(-1)
+    , m_kind(GetKindUnknown())
+    , m_parent(clStringPool::Get().Empty())
+    , m_access(clStringPool::Get().Empty())
+    , m_inherits(clStringPool::Get().Empty())
+    , m_typeref(clStringPool::Get().Empty())
+    , m_id(wxNOT_FOUND)
+    , m_scope(clStringPool::Get().Empty())
+    , m_differOnByLineNumber(false)
+    , m_isClangTag(false)
     , m_userData(NULL)
     , m_flags(0)
 {
@@ -57,14 +85,18 @@ TagEntry::TagEntry(const tagEntry& entry)
 
 TagEntry::TagEntry()
     : m_path(wxEmptyString)
-    , m_file(wxEmptyString)
+    , m_file(clStringPool::Get().Empty())
     , m_lineNumber(-1)
     , m_pattern(wxEmptyString)
-    , m_kind(wxT("<unknown>"))
-    , m_parent(wxEmptyString)
+    , m_kind(GetKindUnknown())
+    , m_parent(clStringPool::Get().Empty())
     , m_name(wxEmptyString)
+    , m_access(clStringPool::Get().Empty())
+    , m_signature(wxEmptyString)
+    , m_inherits(clStringPool::Get().Empty())
+    , m_typeref(clStringPool::Get().Empty())
     , m_id(wxNOT_FOUND)
-    , m_scope(wxEmptyString)
+    , m_scope(clStringPool::Get().Empty())
     , m_differOnByLineNumber(false)
     , m_isClangTag(false)
     , m_userData(NULL)
@@ -79,27 +111,28 @@ TagEntry::TagEntry(const TagEntry& rhs) { *this = rhs; }
 TagEntry& TagEntry::operator=(const TagEntry& rhs)
 {
     m_id = rhs.m_id;
-    m_file = rhs.m_file.c_str();
-    m_kind = rhs.m_kind.c_str();
-    m_parent = rhs.m_parent.c_str();
+    // the pooled strings are re-interned in the pool of this thread, they are only read here
+    clStringPool& pool = clStringPool::Get();
+    m_file = pool.Intern(*rhs.m_file);
+    m_kind = pool.Intern(*rhs.m_kind);
+    m_parent = pool.Intern(*rhs.m_parent);
+    // we use the c_str() method to force our own copy of the string and to avoid
+    // ref counting which may cause crash when sharing wxString among threads
     m_pattern = rhs.m_pattern.c_str();
     m_lineNumber = rhs.m_lineNumber;
     m_name = rhs.m_name.c_str();
     m_path = rhs.m_path.c_str();
     m_hti = rhs.m_hti;
-    m_scope = rhs.m_scope.c_str();
+    m_scope = pool.Intern(*rhs.m_scope);
     m_isClangTag = rhs.m_isClangTag;
     m_differOnByLineNumber = rhs.m_differOnByLineNumber;
     m_userData = rhs.m_userData;
     m_flags = rhs.m_flags;
-    // loop over the map and copy item by item
-    // we use the c_str() method to force our own copy of the string and to avoid
-    // ref counting which may cause crash when sharing wxString among threads
-    m_extFields.clear();
-    std::map<wxString, wxString>::const_iterator iter = rhs.m_extFields.begin();
-    for(; iter != rhs.m_extFields.end(); iter++) {
-        m_extFields[iter->first.c_str()] = iter->second.c_str();
-    }
+    m_access = pool.Intern(*rhs.m_access);
+    m_inherits = pool.Intern(*rhs.m_inherits);
+    m_typeref = pool.Intern(*rhs.m_typeref);
+    m_signature = rhs.m_signature.c_str();
+    m_returns = rhs.m_returns.c_str();
     m_comment = rhs.m_comment;
     return *this;
 }
@@ -107,16 +140,15 @@ TagEntry& TagEntry::operator=(const TagEntry& rhs)
 bool TagEntry::operator==(const TagEntry& rhs)
 {
     // Note: tree item id is not used in this function!
-    bool res = m_scope == rhs.m_scope && m_file == rhs.m_file && m_kind == rhs.m_kind && m_parent == rhs.m_parent &&
-               m_pattern == rhs.m_pattern && m_name == rhs.m_name && m_path == rhs.m_path &&
-               m_lineNumber == rhs.m_lineNumber && GetInheritsAsString() == rhs.GetInheritsAsString() &&
-               GetAccess() == rhs.GetAccess() && GetSignature() == rhs.GetSignature() &&
-               GetTyperef() == rhs.GetTyperef();
+    // Pooled strings are unique within a pool, comparing their pointers is usually enough.
+    // The signature has too many distinct values to be pooled and is compared by value
+    bool res2 = IsSamePooled(m_scope, rhs.m_scope) && IsSamePooled(m_file, rhs.m_file) &&
+                IsSamePooled(m_kind, rhs.m_kind) && IsSamePooled(m_parent, rhs.m_parent) && m_pattern == rhs.m_pattern &&
+                m_name == rhs.m_name && m_path == rhs.m_path && IsSamePooled(m_inherits, rhs.m_inherits) &&
+                IsSamePooled(m_access, rhs.m_access) && m_signature == rhs.m_signature &&
+                IsSamePooled(m_typeref, rhs.m_typeref);
 
-    bool res2 = m_scope == rhs.m_scope && m_file == rhs.m_file && m_kind == rhs.m_kind && m_parent == rhs.m_parent &&
-                m_pattern == rhs.m_pattern && m_name == rhs.m_name && m_path == rhs.m_path &&
-                GetInheritsAsString() == rhs.GetInheritsAsString() && GetAccess() == rhs.GetAccess() &&
-                GetSignature() == rhs.GetSignature() && GetTyperef() == rhs.GetTyperef();
+    bool res = res2 && m_lineNumber == rhs.m_lineNumber;
 
     if(res2 && !res) {
         // the entries are differs only in the line numbers
@@ -141,31 +173,35 @@ void TagEntry::Create(const wxString& fileName,
     SetPattern(pattern);
     SetFile(fileName);
     SetId(-1);
-    m_extFields = extFields;
+    SetAccess(GetField(extFields, wxT("access")));
+    SetSignature(GetField(extFields, wxT("signature")));
+    SetInherits(GetField(extFields, wxT("inherits")));
+    SetTyperef(GetField(extFields, wxT("typeref")));
+    SetReturnValue(GetField(extFields, wxT("returns")));
     wxString path;
 
     // Check if we can get full name (including path)
-    path = GetExtField(wxT("class"));
+    path = GetField(extFields, wxT("class"));
     if(!path.IsEmpty()) {
         UpdatePath(path);
     } else {
-        path = GetExtField(wxT("struct"));
+        path = GetField(extFields, wxT("struct"));
         if(!path.IsEmpty()) {
             UpdatePath(path);
         } else {
-            path = GetExtField(wxT("namespace"));
+            path = GetField(extFields, wxT("namespace"));
             if(!path.IsEmpty()) {
                 UpdatePath(path);
             } else {
-                path = GetExtField(wxT("interface"));
+                path = GetField(extFields, wxT("interface"));
                 if(!path.IsEmpty()) {
                     UpdatePath(path);
                 } else {
-                    path = GetExtField(wxT("enum"));
+                    path = GetField(extFields, wxT("enum"));
                     if(!path.IsEmpty()) {
                         UpdatePath(path);
                     } else {
-                        path = GetExtField(wxT("union"));
+                        path = GetField(extFields, wxT("union"));
                         wxString tmpname = path.AfterLast(wxT(':'));
                         if(!path.IsEmpty()) {
                             if(!tmpname.StartsWith(wxT("__anon"))) {
@@ -186,7 +222,7 @@ void TagEntry::Create(const wxString& fileName,
     if(!path.IsEmpty()) {
         SetScope(path);
     } else {
-        SetScope(wxT("<global>"));
+        m_scope = GetScopeGlobal();
     }
 
     // If there is no path, path is set to name
@@ -204,17 +240,18 @@ void TagEntry::Create(const tagEntry& entry)
 {
     m_isClangTag = false;
     // Get other information from the string data and store it into map
+    std::map<wxString, wxString> extFields;
     for(int i = 0; i < entry.fields.count; ++i) {
         wxString key = _U(entry.fields.list[i].key);
         wxString value = _U(entry.fields.list[i].value);
-        m_extFields[key] = value;
+        extFields[key] = value;
     }
     Create(_U(entry.file),
            _U(entry.name),
            entry.address.lineNumber,
            _U(entry.address.pattern),
            _U(entry.kind),
-           m_extFields);
+           extFields);
 }
 
 void TagEntry::Print()
@@ -228,9 +265,11 @@ void TagEntry::Print()
     std::cout << "Parent:\t\t" << GetParent() << std::endl;
 
     std::cout << " ---- Ext fields: ---- " << std::endl;
-    std::map<wxString, wxString>::const_iterator iter = m_extFields.begin();
-    for(; iter != m_extFields.end(); iter++)
-        std::cout << iter->first << ":\t\t" << iter->second << std::endl;
+    std::cout << "access:\t\t" << GetAccess() << std::endl;
+    std::cout << "signature:\t\t" << GetSignature() << std::endl;
+    std::cout << "inherits:\t\t" << GetInheritsAsString() << std::endl;
+    std::cout << "typeref:\t\t" << GetTyperef() << std::endl;
+    std::cout << "returns:\t\t" << m_returns << std::endl;
     std::cout << "======================================" << std::endl;
 }
 
@@ -271,13 +310,6 @@ wxString TagEntry::GetFullDisplayName() const
 
 wxString TagEntry::GetScopeName() const { return GetScope(); }
 
-wxString TagEntry::GetKind() const
-{
-    wxString kind(m_kind);
-    kind.Trim();
-    return kind;
-}
-
 const bool TagEntry::IsContainer() const
 {
     return GetKind() == wxT("class") || GetKind() == wxT("struct") || GetKind() == wxT("union") ||
@@ -595,7 +627,7 @@ bool TagEntry::IsDestructor() const
 
 wxString TagEntry::GetReturnValue() const
 {
-    wxString returnValue = GetExtField(_T("returns"));
+    wxString returnValue = m_returns;
     returnValue.Trim().Trim(false);
     returnValue.Replace(wxT("virtual"), wxT(""));
     return returnValue;
@@ -617,7 +649,15 @@ bool TagEntry::IsScopeGlobal() const { return GetScope().IsEmpty() || GetScope()
 
 bool TagEntry::IsTypedef() const { return GetKind() == wxT("typedef"); }
 
-wxString TagEntry::GetInheritsAsString() const { return GetExtField(_T("inherits")); }
+wxString TagEntry::GetExtField(const wxString& extField) const
+{
+    if(extField == wxT("access")) return GetAccess();
+    if(extField == wxT("signature")) return m_signature;
+    if(extField == wxT("inherits")) return GetInheritsAsString();
+    if(extField == wxT("typeref")) return GetTyperef();
+    if(extField == wxT("returns")) return m_returns;
+    return wxEmptyString;
+}
 
 wxArrayString TagEntry::GetInheritsAsArrayNoTemplates() const
 {
@@ -32,6 +32,7 @@
 #include <vector>
 #include "smart_ptr.h"
 #include "codelite_exports.h"
+#include "cl_string_pool.h"
 
 class TagEntry;
 typedef SmartPtr<TagEntry> TagEntryPtr;
@@ -53,17 +54,24 @@ typedef std::vector<TagEntryPtr> TagEntryPtrVector_t;
  */
 class WXDLLIMPEXP_CL TagEntry
 {
-    wxString m_path;                          ///< Tag full path
-    wxString m_file;                          ///< File this tag is found
-    int m_lineNumber;                         ///< Line number
-    wxString m_pattern;                       ///< A pattern that can be used to locate the tag in the file
-    wxString m_kind;                          ///< Member, function, class, typedef etc.
-    wxString m_parent;                        ///< Direct parent
-    wxTreeItemId m_hti;                       ///< Handle to tree item, not persistent item
-    wxString m_name;                          ///< Tag name (short name, excluding any scope names)
-    std::map<wxString, wxString> m_extFields; ///< Additional extension fields
+    // Values which repeat across many tags (file, kind, scope etc) point to
+    // strings owned by the clStringPool of the thread which set them. Copying
+    // a tag re-interns them in the pool of the copying thread
+    wxString m_path;              ///< Tag full path
+    const wxString* m_file;       ///< File this tag is found
+    int m_lineNumber;             ///< Line number
+    wxString m_pattern;           ///< A pattern that can be used to locate the tag in the file
+    const wxString* m_kind;       ///< Member, function, class, typedef etc.
+    const wxString* m_parent;     ///< Direct parent
+    wxTreeItemId m_hti;           ///< Handle to tree item, not persistent item
+    wxString m_name;              ///< Tag name (short name, excluding any scope names)
+    const wxString* m_access;     ///< Extension field: access
+    wxString m_signature;         ///< Extension field: signature
+    const wxString* m_inherits;   ///< Extension field: inherits
+    const wxString* m_typeref;    ///< Extension field: typeref
+    wxString m_returns;           ///< Extension field: returns
     long m_id;
-    wxString m_scope;
+    const wxString* m_scope;
     bool m_differOnByLineNumber;
     bool m_isClangTag;
     void* m_userData;   // This member is not saved into the database
@@ -223,8 +231,8 @@ public:
     const wxString& GetPath() const { return m_path; }
     void SetPath(const wxString& path) { m_path = path; }
 
-    const wxString& GetFile() const { return m_file; }
-    void SetFile(const wxString& file) { m_file = file; }
+    const wxString& GetFile() const { return *m_file; }
+    void SetFile(const wxString& file) { m_file = clStringPool::Get().Intern(file); }
 
     int GetLine() const { return m_lineNumber; }
     void SetLine(int line) { m_lineNumber = line; }
@@ -237,35 +245,35 @@ public:
     
     void SetPattern(const wxString& pattern) { m_pattern = pattern; }
 
-    wxString GetKind() const;
-    void SetKind(const wxString& kind) { m_kind = kind; }
+    const wxString& GetKind() const { return *m_kind; }
+    void SetKind(const wxString& kind) { m_kind = clStringPool::Get().Intern(wxString(kind).Trim()); }
 
-    const wxString& GetParent() const { return m_parent; }
-    void SetParent(const wxString& parent) { m_parent = parent; }
+    const wxString& GetParent() const { return *m_parent; }
+    void SetParent(const wxString& parent) { m_parent = clStringPool::Get().Intern(parent); }
 
     wxTreeItemId& GetTreeItemId() { return m_hti; }
     void SetTreeItemId(wxTreeItemId& hti) { m_hti = hti; }
 
-    wxString GetAccess() const { return GetExtField(_T("access")); }
-    void SetAccess(const wxString& access) { m_extFields[wxT("access")] = access; }
+    const wxString& GetAccess() const { return *m_access; }
+    void SetAccess(const wxString& access) { m_access = clStringPool::Get().Intern(access); }
 
-    wxString GetSignature() const { return GetExtField(_T("signature")); }
-    void SetSignature(const wxString& sig) { m_extFields[wxT("signature")] = sig; }
+    const wxString& GetSignature() const { return m_signature; }
+    void SetSignature(const wxString& sig) { m_signature = sig; }
 
-    void SetInherits(const wxString& inherits) { m_extFields[_T("inherits")] = inherits; }
-    void SetTyperef(const wxString& typeref) { m_extFields[_T("typeref")] = typeref; }
+    void SetInherits(const wxString& inherits) { m_inherits = clStringPool::Get().Intern(inherits); }
+    void SetTyperef(const wxString& typeref) { m_typeref = clStringPool::Get().Intern(typeref); }
 
-    wxString GetInheritsAsString() const;
+    const wxString& GetInheritsAsString() const { return *m_inherits; }
     wxArrayString GetInheritsAsArrayNoTemplates() const;
     wxArrayString GetInheritsAsArrayWithTemplates() const;
 
-    wxString GetTyperef() const { return GetExtField(_T("typeref")); }
+    const wxString& GetTyperef() const { return *m_typeref; }
 
-    void SetReturnValue(const wxString& retVal) { m_extFields[_T("returns")] = retVal; }
+    void SetReturnValue(const wxString& retVal) { m_returns = retVal; }
     wxString GetReturnValue() const;
 
-    const wxString& GetScope() const { return m_scope; }
-    void SetScope(const wxString& scope) { m_scope = scope; }
+    const wxString& GetScope() const { return *m_scope; }
+    void SetScope(const wxString& scope) { m_scope = clStringPool::Get().Intern(scope); }
 
     /**
      * \return Scope name of the tag.
@@ -307,12 +315,7 @@ public:
     //------------------------------------------
     // Extenstion fields
     //------------------------------------------
-    wxString GetExtField(const wxString& extField) const
-    {
-        std::map<wxString, wxString>::const_iterator iter = m_extFields.find(extField);
-        if(iter == m_extFields.end()) return wxEmptyString;
-        return iter->second;
-    }
+    wxString GetExtField(const wxString& extField) const;
 
     /**
      * @brief mark this tag has clang generated tag
@@ -137,6 +137,50 @@ FILE* fcFileOpener::try_open(const wxString &path, const wxString &name, wxStrin
     return NULL;
 }
 
+bool fcFileOpener::ResolveInclude(const wxString& include_path, const wxString& cwd, wxString& filepath) const
+{
+    filepath.Clear();
+
+    wxString mod_path ( include_path );
+
+    static wxString trimString("\"<> \t");
+
+    mod_path.erase(0, mod_path.find_first_not_of(trimString));
+    mod_path.erase(mod_path.find_last_not_of    (trimString)+1);
+
+    if ( mod_path.empty() ) {
+        return false;
+    }
+
+    if ( try_resolve(cwd, mod_path, filepath) ) {
+        return true;
+    }
+
+    for (size_t i=0; i<_searchPath.size(); ++i) {
+        if ( try_resolve(_searchPath.at(i), mod_path, filepath) ) return true;
+    }
+    return false;
+}
+
+bool fcFileOpener::try_resolve(const wxString &path, const wxString &name, wxString &filepath) const
+{
+    wxFileName fn( path + FC_PATH_SEP + name );
+    if ( !fn.FileExists() ) {
+        return false;
+    }
+
+    wxString pathPart = fn.GetPath();
+    for(size_t i=0; i<_excludePaths.size(); ++i) {
+        if ( pathPart.StartsWith(_excludePaths.at(i) ) ) {
+            return false;
+        }
+    }
+
+    fn.Normalize(wxPATH_NORM_DOTS | wxPATH_NORM_ABSOLUTE);
+    filepath = fn.GetFullPath();
+    return true;
+}
+
 void fcFileOpener::AddExcludePath(const wxString& path)
 {
     wxFileName fn( path, "" );
@@ -89,6 +89,16 @@ public:
      */
     FILE *OpenFile(const wxString &include_path, wxString &filepath);
 
+    /**
+     * @brief resolve an include statement to a full path without opening the file.
+     * The lookup order is the same as OpenFile(): the directory of the including file first and then the search paths
+     * @param include_path the string as appears inside the #include statement
+     * @param cwd the directory of the file containing the #include statement
+     * @param filepath [output] the resolved file
+     * @return true if the include was resolved to a file which is not excluded
+     */
+    bool ResolveInclude(const wxString &include_path, const wxString &cwd, wxString &filepath) const;
+
     void ClearResults() {
         _matchedfiles.clear();
         _scannedfiles.clear();
@@ -160,6 +170,7 @@ public:
         return _includeStatements;
     }
 private:
+    bool try_resolve(const wxString &path, const wxString &name, wxString &filepath) const;
     fcFileOpener();
     virtual ~fcFileOpener();
 
@@ -30,6 +30,58 @@
 #include <wx/log.h>
 #include <wx/crt.h>
 #include "cl_standard_paths.h"
+#include <wx/datetime.h>
+#include <string.h>
+#ifdef __WXMSW__
+#include <io.h>
+#define LOG_WRITE _write
+#else
+#include <unistd.h>
+#define LOG_WRITE write
+#endif
+
+// Number of lines the ring buffer can hold before it starts dropping lines
+#define LOG_RING_SIZE 4096
+// The writer thread is woken up once the buffer is this full
+#define LOG_RING_WAKEUP (LOG_RING_SIZE / 4)
+// and in any case every LOG_FLUSH_INTERVAL_MS
+#define LOG_FLUSH_INTERVAL_MS 250
+
+/// Formats and writes the queued log lines in batches
+class FileLoggerThread : public wxThread
+{
+    FileLogger* m_logger;
+    wxSemaphore m_wakeup;
+
+public:
+    FileLoggerThread(FileLogger* logger)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_logger(logger)
+    {
+    }
+    virtual ~FileLoggerThread() {}
+
+    void WakeUp() { m_wakeup.Post(); }
+
+    virtual void* Entry()
+    {
+        while(!TestDestroy()) {
+            m_wakeup.WaitTimeout(LOG_FLUSH_INTERVAL_MS);
+            m_logger->Flush();
+        }
+        m_logger->Flush();
+        return NULL;
+    }
+
+    void Stop()
+    {
+        if(IsAlive()) {
+            Delete(NULL, wxTHREAD_WAIT_BLOCK);
+        } else {
+            Wait(wxTHREAD_WAIT_BLOCK);
+        }
+    }
+};
 
 static FileLogger theLogger;
 static bool initialized = false;
@@ -37,59 +89,261 @@ static bool initialized = false;
 FileLogger::FileLogger()
     : m_verbosity(FileLogger::Error)
     , m_fp(NULL)
+    , m_fd(-1)
+    , m_timeOfDayOffset(0)
+    , m_first(0)
+    , m_count(0)
+    , m_dropped(0)
+    , m_thread(NULL)
 {
+    m_ring.resize(LOG_RING_SIZE);
 }
 
 FileLogger::~FileLogger()
 {
+    // The writer thread (if it is still around) was already stopped by the
+    // wxWidgets cleanup code, write whatever is left
+    Flush();
+    wxCriticalSectionLocker locker(m_writeLock);
     if(m_fp) {
         fclose(m_fp);
         m_fp = NULL;
+        m_fd = -1;
     }
 }
 
+bool FileLogger::CanLog(int verbosity) { return theLogger.m_fp && theLogger.m_verbosity >= verbosity; }
+
 void FileLogger::AddLogLine(const wxString& msg, int verbosity)
 {
     if(m_verbosity >= verbosity && m_fp) {
-        wxString formattedMsg;
-
+        // Only take the raw timestamp here, it is formatted by the writer
         timeval tim;
         gettimeofday(&tim, NULL);
-        int ms = (int)tim.tv_usec / 1000.0;
 
-        wxString msStr = wxString::Format(wxT("%03d"), ms);
+        bool wakeup = false;
+        FileLoggerThread* thread = NULL;
+        {
+            wxCriticalSectionLocker locker(m_lock);
+            if(m_count == m_ring.size()) {
+                ++m_dropped;
+                return;
+            }
+
+            Entry& entry = m_ring.at((m_first + m_count) % m_ring.size());
+            entry.m_seconds = tim.tv_sec;
+            entry.m_millis = (int)(tim.tv_usec / 1000);
+            entry.m_verbosity = verbosity;
+            entry.m_message = msg.c_str(); // deep copy, the string is consumed by another thread
+            ++m_count;
+            wakeup = (m_count == LOG_RING_WAKEUP);
+            thread = m_thread;
+        }
 
-        formattedMsg << wxT("[ ") << wxDateTime::Now().FormatISOTime() << wxT(":") << msStr;
+        if(!thread) {
+            // No writer thread (yet), write the line now
+            Flush();
 
-        switch(verbosity) {
-        case System:
-            formattedMsg << wxT(" SYS ] ");
-            break;
+        } else if(wakeup) {
+            thread->WakeUp();
+        }
+    }
+}
 
-        case Error:
-            formattedMsg << wxT(" ERR ] ");
-            break;
+static void FormatLogLine(const FileLogger::Entry& entry, wxString& formattedMsg)
+{
+    formattedMsg << wxT("[ ") << wxDateTime((time_t)entry.m_seconds).FormatISOTime() << wxT(":")
+                 << wxString::Format(wxT("%03d"), entry.m_millis);
 
-        case Warning:
-            formattedMsg << wxT(" WRN ] ");
-            break;
+    switch(entry.m_verbosity) {
+    case FileLogger::System:
+        formattedMsg << wxT(" SYS ] ");
+        break;
 
-        case Dbg:
-            formattedMsg << wxT(" DBG ] ");
-            break;
+    case FileLogger::Error:
+        formattedMsg << wxT(" ERR ] ");
+        break;
 
-        case Developer:
-            formattedMsg << wxT(" DVL ] ");
-            break;
+    case FileLogger::Warning:
+        formattedMsg << wxT(" WRN ] ");
+        break;
+
+    case FileLogger::Dbg:
+        formattedMsg << wxT(" DBG ] ");
+        break;
+
+    case FileLogger::Developer:
+        formattedMsg << wxT(" DVL ] ");
+        break;
+    }
+
+    wxString msg = entry.m_message;
+    msg.Trim().Trim(false);
+    formattedMsg << msg << wxT("\n");
+}
+
+void FileLogger::Flush()
+{
+    wxCriticalSectionLocker writeLocker(m_writeLock);
+
+    // Move the queued lines out of the ring so the loggers are not blocked while we format
+    std::vector<Entry> batch;
+    size_t dropped = 0;
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        if(m_count == 0 && m_dropped == 0) return;
+
+        batch.resize(m_count);
+        for(size_t i = 0; i < m_count; ++i) {
+            Entry& entry = m_ring.at((m_first + i) % m_ring.size());
+            batch.at(i) = entry;
+            entry.m_message.clear();
         }
+        m_first = (m_first + m_count) % m_ring.size();
+        m_count = 0;
+        dropped = m_dropped;
+        m_dropped = 0;
+    }
+
+    if(!m_fp) return;
+
+    wxString buffer;
+    for(size_t i = 0; i < batch.size(); ++i) {
+        FormatLogLine(batch.at(i), buffer);
+    }
+
+    if(dropped) {
+        timeval tim;
+        gettimeofday(&tim, NULL);
+        Entry entry;
+        entry.m_seconds = tim.tv_sec;
+        entry.m_millis = (int)(tim.tv_usec / 1000);
+        entry.m_verbosity = Warning;
+        entry.m_message << dropped << wxT(" log lines were dropped (log buffer is full)");
+        FormatLogLine(entry, buffer);
+    }
 
-        formattedMsg << msg;
-        formattedMsg.Trim().Trim(false);
-        formattedMsg << wxT("\n");
+    const wxCharBuffer cb = buffer.mb_str(wxConvUTF8);
+    if(cb.data()) {
+        fwrite(cb.data(), 1, strlen(cb.data()), m_fp);
+    }
+    fflush(m_fp);
+}
 
-        wxFprintf(m_fp, wxT("%s"), formattedMsg.c_str());
-        fflush(m_fp);
+// The helpers below are used from a signal handler: they only write to the given buffer
+// (no allocation, no locale) and return the new position
+static size_t AppendRaw(char* buf, size_t pos, size_t size, const char* str)
+{
+    while(*str && pos < size) {
+        buf[pos++] = *str++;
     }
+    return pos;
+}
+
+static size_t AppendNumber(char* buf, size_t pos, size_t size, unsigned long num, int width)
+{
+    char digits[32];
+    int count = 0;
+    do {
+        digits[count++] = '0' + (num % 10);
+        num /= 10;
+    } while(num && count < (int)sizeof(digits));
+
+    while(width-- > count && pos < size) {
+        buf[pos++] = '0';
+    }
+    while(count && pos < size) {
+        buf[pos++] = digits[--count];
+    }
+    return pos;
+}
+
+static size_t AppendUTF8(char* buf, size_t pos, size_t size, wxUint32 ch)
+{
+    char bytes[4];
+    int count;
+    if(ch < 0x80) {
+        bytes[0] = (char)ch;
+        count = 1;
+    } else if(ch < 0x800) {
+        bytes[0] = (char)(0xC0 | (ch >> 6));
+        bytes[1] = (char)(0x80 | (ch & 0x3F));
+        count = 2;
+    } else if(ch < 0x10000) {
+        bytes[0] = (char)(0xE0 | (ch >> 12));
+        bytes[1] = (char)(0x80 | ((ch >> 6) & 0x3F));
+        bytes[2] = (char)(0x80 | (ch & 0x3F));
+        count = 3;
+    } else {
+        bytes[0] = (char)(0xF0 | (ch >> 18));
+        bytes[1] = (char)(0x80 | ((ch >> 12) & 0x3F));
+        bytes[2] = (char)(0x80 | ((ch >> 6) & 0x3F));
+        bytes[3] = (char)(0x80 | (ch & 0x3F));
+        count = 4;
+    }
+
+    // don't cut a character in the middle
+    if(pos + count > size) return size;
+    for(int i = 0; i < count; ++i) {
+        buf[pos++] = bytes[i];
+    }
+    return pos;
+}
+
+static inline bool IsLogSpace(wxUint32 ch) { return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n'; }
+
+void FileLogger::FlushFromSignalHandler()
+{
+    // Never wait here: the thread holding the lock may be the one which crashed, or it
+    // may be stopped by the signal. In that case the queued lines are lost
+    if(!m_writeLock.TryEnter()) return;
+    if(!m_lock.TryEnter()) {
+        m_writeLock.Leave();
+        return;
+    }
+
+    if(m_fd != -1) {
+        // Each line is formatted like FormatLogLine() does (the time of day is computed by hand,
+        // localtime() is not safe here) and written directly to the descriptor. Flush() always
+        // empties the stdio buffer, so there is nothing pending in m_fp
+        static const char* levels[] = { " SYS ] ", " ERR ] ", " WRN ] ", " DBG ] ", " DVL ] " };
+        char line[2048];
+        for(size_t i = 0; i < m_count; ++i) {
+            const Entry& entry = m_ring.at((m_first + i) % m_ring.size());
+            unsigned long timeOfDay = (unsigned long)((entry.m_seconds % 86400 + m_timeOfDayOffset) % 86400);
+
+            size_t pos = AppendRaw(line, 0, sizeof(line), "[ ");
+            pos = AppendNumber(line, pos, sizeof(line), timeOfDay / 3600, 2);
+            pos = AppendRaw(line, pos, sizeof(line), ":");
+            pos = AppendNumber(line, pos, sizeof(line), (timeOfDay / 60) % 60, 2);
+            pos = AppendRaw(line, pos, sizeof(line), ":");
+            pos = AppendNumber(line, pos, sizeof(line), timeOfDay % 60, 2);
+            pos = AppendRaw(line, pos, sizeof(line), ":");
+            pos = AppendNumber(line, pos, sizeof(line), entry.m_millis, 3);
+            if(entry.m_verbosity >= System && entry.m_verbosity <= Developer) {
+                pos = AppendRaw(line, pos, sizeof(line), levels[entry.m_verbosity - System]);
+            }
+
+            // the message, trimmed. Iterating does not allocate
+            wxString::const_iterator first = entry.m_message.begin();
+            wxString::const_iterator last = entry.m_message.end();
+            while(first != last && IsLogSpace((*first).GetValue())) ++first;
+            while(last != first && IsLogSpace((*(last - 1)).GetValue())) --last;
+            for(; first != last && pos < sizeof(line) - 1; ++first) {
+                pos = AppendUTF8(line, pos, sizeof(line) - 1, (*first).GetValue());
+            }
+            line[pos++] = '\n';
+
+            if(LOG_WRITE(m_fd, line, pos) < 0) break;
+        }
+
+        // The entries are left in the ring: releasing their strings would free memory
+        m_first = (m_first + m_count) % m_ring.size();
+        m_count = 0;
+    }
+
+    m_lock.Leave();
+    m_writeLock.Leave();
 }
 
 FileLogger* FileLogger::Get()
@@ -159,6 +413,46 @@ void FileLogger::OpenLog(const wxString& fullName, int verbosity)
         theLogger.m_fp = wxFopen(filename, wxT("a+"));
         theLogger.m_verbosity = verbosity;
         initialized = true;
+
+        if(theLogger.m_fp) {
+            theLogger.m_fd = fileno(theLogger.m_fp);
+
+            // FlushFromSignalHandler() can't call localtime(), it uses this offset instead
+            wxDateTime now = wxDateTime::Now();
+            long localTimeOfDay = now.GetHour() * 3600 + now.GetMinute() * 60 + now.GetSecond();
+            long utcTimeOfDay = (long)(now.GetTicks() % 86400);
+            theLogger.m_timeOfDayOffset = ((localTimeOfDay - utcTimeOfDay) % 86400 + 86400) % 86400;
+
+            FileLoggerThread* thread = new FileLoggerThread(&theLogger);
+            if(thread->Create() == wxTHREAD_NO_ERROR && thread->Run() == wxTHREAD_NO_ERROR) {
+                theLogger.m_thread = thread;
+            } else {
+                delete thread;
+            }
+        }
+    }
+}
+
+void FileLogger::Close()
+{
+    FileLoggerThread* thread = NULL;
+    {
+        wxCriticalSectionLocker locker(theLogger.m_lock);
+        thread = theLogger.m_thread;
+        theLogger.m_thread = NULL;
+    }
+
+    if(thread) {
+        thread->Stop();
+        wxDELETE(thread);
+    }
+
+    theLogger.Flush();
+    wxCriticalSectionLocker locker(theLogger.m_writeLock);
+    if(theLogger.m_fp) {
+        fclose(theLogger.m_fp);
+        theLogger.m_fp = NULL;
+        theLogger.m_fd = -1;
     }
 }
 
@@ -29,15 +29,43 @@
 #include <wx/ffile.h>
 #include "codelite_exports.h"
 #include <wx/stopwatch.h>
+#include <wx/thread.h>
+#include <vector>
 
+class FileLoggerThread;
 class WXDLLIMPEXP_CL FileLogger
 {
 public:
     enum { System = -1, Error = 0, Warning = 1, Dbg = 2, Developer = 3 };
 
+    /**
+     * @brief a log line as it is queued by the logging thread. The timestamp
+     * is formatted by the writer thread
+     */
+    struct Entry {
+        long m_seconds;
+        int m_millis;
+        int m_verbosity;
+        wxString m_message;
+    };
+
 protected:
     int m_verbosity;
     FILE* m_fp;
+    int m_fd;               // m_fp's descriptor, for FlushFromSignalHandler()
+    long m_timeOfDayOffset; // local time of day - UTC time of day (seconds), taken when the log is opened
+
+    // Bounded ring buffer of lines waiting to be written. m_lock is only held while
+    // a line is copied in or out, never while formatting or writing
+    wxCriticalSection m_lock;
+    std::vector<Entry> m_ring;
+    size_t m_first;
+    size_t m_count;
+    size_t m_dropped;
+
+    // Serialises the writers (the writer thread and explicit Flush() calls)
+    wxCriticalSection m_writeLock;
+    FileLoggerThread* m_thread;
 
 public:
     FileLogger();
@@ -48,8 +76,30 @@ public:
      */
     static void OpenLog(const wxString& fullName, int verbosity);
 
+    /**
+     * @brief stop the writer thread, write all the queued lines and close the log file
+     */
+    static void Close();
+
     static FileLogger* Get();
 
+    /**
+     * @brief return true if a line with the given verbosity will be written to the log
+     */
+    static bool CanLog(int verbosity);
+
+    /**
+     * @brief write all the queued lines to the log file from the calling thread
+     */
+    void Flush();
+
+    /**
+     * @brief write the queued lines from a signal handler (e.g. on SIGSEGV). The lines are formatted
+     * on the stack and written with write(2): no allocation and no blocking. If a lock is held by another
+     * thread the lines are not written
+     */
+    void FlushFromSignalHandler();
+
     void AddLogLine(const wxString& msg, int verbosity);
     /**
      * @brief print array into the log file
@@ -67,13 +117,43 @@ public:
     static int GetVerbosityAsNumber(const wxString& verbosity);
 };
 
-#define CL_SYSTEM(...) FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::System);
-#define CL_ERROR(...) FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::Error);
-#define CL_WARNING(...) FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::Warning);
-#define CL_DEBUG(...) FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::Dbg);
-#define CL_DEBUGS(s) FileLogger::Get()->AddLogLine(s, FileLogger::Dbg);
-#define CL_DEBUG1(...) FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::Developer);
-#define CL_DEBUG_ARR(arr) FileLogger::Get()->AddLogLine(arr, FileLogger::Dbg);
-#define CL_DEBUG1_ARR(arr) FileLogger::Get()->AddLogLine(arr, FileLogger::Developer);
+// Each macro expands to a single statement so it can be used safely in an unbraced if/else
+#define CL_SYSTEM(...)                                                                                     \
+    do {                                                                                                   \
+        if(FileLogger::CanLog(FileLogger::System))                                                         \
+            FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::System);              \
+    } while(false)
+#define CL_ERROR(...)                                                                                      \
+    do {                                                                                                   \
+        if(FileLogger::CanLog(FileLogger::Error))                                                          \
+            FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::Error);               \
+    } while(false)
+#define CL_WARNING(...)                                                                                    \
+    do {                                                                                                   \
+        if(FileLogger::CanLog(FileLogger::Warning))                                                        \
+            FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::Warning);             \
+    } while(false)
+#define CL_DEBUG(...)                                                                                      \
+    do {                                                                                                   \
+        if(FileLogger::CanLog(FileLogger::Dbg))                                                            \
+            FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::Dbg);                 \
+    } while(false)
+#define CL_DEBUGS(s)                                                                                       \
+    do {                                                                                                   \
+        FileLogger::Get()->AddLogLine(s, FileLogger::Dbg);                                                 \
+    } while(false)
+#define CL_DEBUG1(...)                                                                                     \
+    do {                                                                                                   \
+        if(FileLogger::CanLog(FileLogger::Developer))                                                      \
+            FileLogger::Get()->AddLogLine(wxString::Format(__VA_ARGS__), FileLogger::Developer);           \
+    } while(false)
+#define CL_DEBUG_ARR(arr)                                                                                  \
+    do {                                                                                                   \
+        FileLogger::Get()->AddLogLine(arr, FileLogger::Dbg);                                               \
+    } while(false)
+#define CL_DEBUG1_ARR(arr)                                                                                 \
+    do {                                                                                                   \
+        FileLogger::Get()->AddLogLine(arr, FileLogger::Developer);                                         \
+    } while(false)
 
 #endif // FILELOGGER_H
@@ -101,3 +101,21 @@ bool FileUtils::ReadFileContent(const wxFileName& fn, wxString& data, const wxMB
     }
     return file.ReadAll(&data, conv);
 }
+
+wxUint64 FileUtils::Hash64(const wxString& str)
+{
+    const wxCharBuffer cb = str.mb_str(wxConvUTF8);
+    const char* p = cb.data();
+    wxUint64 hash = wxULL(14695981039346656037);
+    for(; p && *p; ++p) {
+        hash ^= (wxUint64)(unsigned char)(*p);
+        hash *= wxULL(1099511628211);
+    }
+    return hash;
+}
+
+wxString FileUtils::Hash(const wxString& str)
+{
+    wxUint64 hash = Hash64(str);
+    return wxString::Format(wxT("%08x%08x"), (unsigned int)(hash >> 32), (unsigned int)(hash & 0xFFFFFFFF));
+}
@@ -47,5 +47,15 @@ public:
      * @brief launch the OS default terminal at a given path
      */
     static void OpenTerminal(const wxString& path);
+
+    /**
+     * @brief return the 64 bit FNV-1a hash of the UTF-8 representation of str
+     */
+    static wxUint64 Hash64(const wxString& str);
+
+    /**
+     * @brief return Hash64(str) formatted as a 16 digits hex string
+     */
+    static wxString Hash(const wxString& str);
 };
 #endif // FILEUTILS_H
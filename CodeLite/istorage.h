@@ -81,6 +81,16 @@ public:
      */
     virtual void ClearCache() = 0;
 
+    /**
+     * @brief clear the cache entries affected by re-tagging 'filename'
+     */
+    virtual void ClearCache(const wxString& filename) = 0;
+
+    /**
+     * @brief return a human readable summary of the cache statistics
+     */
+    virtual wxString GetCacheStatistics() const = 0;
+
     /**
      * Return the currently opened database.
      * @return Currently open database
@@ -316,6 +326,18 @@ public:
      */
     virtual void GetTagsNames(const wxArrayString& kind, wxArrayString& names) = 0;
 
+    /**
+     * @brief return a unique list of names, unlike GetAllTagsNames() no limit is applied
+     * @param kinds when not empty, only tags of these kinds are considered
+     * @param names [output]
+     */
+    virtual void GetTagsNamesNoLimit(const wxArrayString& kinds, wxArrayString& names) = 0;
+
+    /**
+     * @brief return all the tags whose name is one of 'names' (exact match)
+     */
+    virtual void GetTagsByNames(const wxArrayString& names, std::vector<TagEntryPtr>& tags) = 0;
+
     /**
      * Store tree of tags into db.
      * @param tree Tags tree to store
@@ -324,6 +346,14 @@ public:
      */
     virtual void Store(TagTreePtr tree, const wxFileName& path, bool autoCommit = true) = 0;
 
+    /**
+     * Store list of tags into db.
+     * @param tags Tags to store
+     * @param path Database file name
+     * @param autoCommit handle the Store operation inside a transaction or let the user hadle it
+     */
+    virtual void Store(const std::vector<TagEntry>& tags, const wxFileName& path, bool autoCommit = true) = 0;
+
     /**
      * A very dengerous API call, which drops all tables from the database
      * and recreate the schema from fresh. It is used when upgrading database between different
@@ -473,6 +503,28 @@ public:
      */
     virtual void GetMacrosDefined(const std::set<std::string>& files, const std::set<wxString>& usedMacros, wxArrayString& defMacros) = 0;
 
+    /**
+     * @brief return the include graph entry of a file
+     * @param file the including file
+     * @param lastScanned [output] the time the file was last crawled
+     * @param pathsKey [output] identifies the search paths that were used to resolve the includes
+     * @param includes [output] the included files, resolved to their full path
+     * @param unresolved [output] the include statements that could not be resolved
+     * @return false if the file is not part of the include graph
+     */
+    virtual bool GetIncludeGraphEntry(const wxString& file, int& lastScanned, wxString& pathsKey, wxArrayString& includes, wxArrayString& unresolved) = 0;
+
+    /**
+     * @brief replace the include graph entry of a file. This method does not start a transaction
+     */
+    virtual void StoreIncludeGraphEntry(const wxString& file, int lastScanned, const wxString& pathsKey, const wxArrayString& includes, const wxArrayString& unresolved) = 0;
+
+    /**
+     * @brief remove files from the include graph. The files that include them are marked
+     * as out of date so their includes are resolved again on the next query
+     */
+    virtual void DeleteFromIncludeGraph(const wxArrayString& files) = 0;
+
     /**
      * @brief return list of tags for a given prefix
      */
@@ -549,3 +549,190 @@ JSONElement& JSONElement::addProperty(const wxString& name, const wxColour& colo
     }
     return addProperty(name, colourValue);
 }
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+JSONArrayReader::JSONArrayReader(const wxFileName& filename, size_t bufferSize)
+    : _pos(0)
+    , _len(0)
+    , _current(NULL)
+    , _isOk(false)
+    , _first(true)
+    , _eof(false)
+{
+    _buffer.resize(bufferSize ? bufferSize : 1);
+    if(!_fp.Open(filename.GetFullPath(), wxT("rb"))) {
+        setError(wxString() << "Could not open file: " << filename.GetFullPath());
+        return;
+    }
+
+    // Skip the UTF-8 BOM (if any)
+    char ch;
+    if(!readChar(ch)) {
+        setError("Empty file");
+        return;
+    }
+
+    if((unsigned char)ch == 0xEF) {
+        char bom1, bom2;
+        if(!readChar(bom1) || !readChar(bom2)) {
+            setError("Unexpected end of file");
+            return;
+        }
+    } else {
+        unreadChar();
+    }
+
+    if(!skipWhitespace(ch) || ch != '[') {
+        setError("The top level element is not an array");
+        return;
+    }
+    _isOk = true;
+}
+
+JSONArrayReader::~JSONArrayReader()
+{
+    if(_current) {
+        cJSON_Delete(_current);
+        _current = NULL;
+    }
+}
+
+void JSONArrayReader::setError(const wxString& err)
+{
+    _errorString = err;
+    _isOk = false;
+}
+
+bool JSONArrayReader::readChar(char& ch)
+{
+    if(_pos == _len) {
+        if(_eof) return false;
+        _len = _fp.Read(&_buffer[0], _buffer.size());
+        _pos = 0;
+        if(_len == 0) {
+            _eof = true;
+            return false;
+        }
+    }
+    ch = _buffer[_pos++];
+    return true;
+}
+
+void JSONArrayReader::unreadChar()
+{
+    // readChar() never refills the buffer before the previous character
+    // was consumed, so the previous character is still there
+    if(_pos) --_pos;
+}
+
+bool JSONArrayReader::skipWhitespace(char& ch)
+{
+    while(readChar(ch)) {
+        if(ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n') return true;
+    }
+    return false;
+}
+
+bool JSONArrayReader::readItem(char first)
+{
+    _item.clear();
+    _item += first;
+
+    int depth = 0;
+    bool inString = false;
+    bool escape = false;
+
+    if(first == '{' || first == '[') {
+        depth = 1;
+    } else if(first == '"') {
+        inString = true;
+    } else {
+        // scalar: read up to the next delimiter
+        char ch;
+        while(readChar(ch)) {
+            if(ch == ',' || ch == ']' || ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') {
+                unreadChar();
+                return true;
+            }
+            _item += ch;
+        }
+        return false;
+    }
+
+    char ch;
+    while(readChar(ch)) {
+        _item += ch;
+        if(inString) {
+            if(escape) {
+                escape = false;
+            } else if(ch == '\\') {
+                escape = true;
+            } else if(ch == '"') {
+                inString = false;
+                if(depth == 0) return true;
+            }
+            continue;
+        }
+
+        switch(ch) {
+        case '"':
+            inString = true;
+            break;
+        case '{':
+        case '[':
+            ++depth;
+            break;
+        case '}':
+        case ']':
+            if(--depth == 0) return true;
+            break;
+        default:
+            break;
+        }
+    }
+    return false;
+}
+
+bool JSONArrayReader::next()
+{
+    if(_current) {
+        cJSON_Delete(_current);
+        _current = NULL;
+    }
+
+    if(!_isOk) return false;
+
+    char ch;
+    if(!skipWhitespace(ch)) {
+        setError("Unexpected end of file");
+        return false;
+    }
+
+    if(ch == ']') {
+        // end of the array
+        _isOk = false;
+        return false;
+    }
+
+    if(!_first) {
+        if(ch != ',' || !skipWhitespace(ch)) {
+            setError("Expected ','");
+            return false;
+        }
+    }
+    _first = false;
+
+    if(!readItem(ch)) {
+        setError("Unexpected end of file");
+        return false;
+    }
+
+    _current = cJSON_Parse(_item.c_str());
+    if(!_current) {
+        setError("Invalid array item");
+        return false;
+    }
+    return true;
+}
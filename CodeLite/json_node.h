@@ -35,6 +35,9 @@
 #include <map>
 #include "cJSON.h"
 #include <wx/colour.h>
+#include <wx/ffile.h>
+#include <string>
+#include <vector>
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -182,5 +185,73 @@ private:
     JSONRoot& operator=(const JSONRoot& src);
 };
 
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+/**
+ * @class JSONArrayReader
+ * @brief a pull reader for files whose top level element is an array (e.g. compile_commands.json)
+ * Only the current array item is kept in memory, so the memory usage is bounded by the
+ * size of the largest item and not by the size of the file:
+ *
+ *  JSONArrayReader reader(fn);
+ *  while(reader.next()) {
+ *      JSONElement item = reader.current();
+ *      ...
+ *  }
+ */
+class WXDLLIMPEXP_CL JSONArrayReader
+{
+    wxFFile           _fp;
+    std::vector<char> _buffer;
+    size_t            _pos;
+    size_t            _len;
+    std::string       _item;
+    cJSON *           _current;
+    bool              _isOk;
+    bool              _first;
+    bool              _eof;
+    wxString          _errorString;
+
+protected:
+    bool readChar(char& ch);
+    void unreadChar();
+    bool skipWhitespace(char& ch);
+    bool readItem(char first);
+    void setError(const wxString& err);
+
+public:
+    JSONArrayReader(const wxFileName& filename, size_t bufferSize = 64 * 1024);
+    virtual ~JSONArrayReader();
+
+    /**
+     * @brief return true if the file was opened and its top level element is an array
+     */
+    bool isOk() const {
+        return _isOk;
+    }
+    wxString errorString() const {
+        return _errorString;
+    }
+
+    /**
+     * @brief advance to the next array item
+     * @return false when there are no more items (or on error)
+     */
+    bool next();
+
+    /**
+     * @brief return the current item. The element is valid until the next call to next()
+     */
+    JSONElement current() const {
+        return JSONElement(_current);
+    }
+
+private:
+    // Make this class not copyable
+    JSONArrayReader(const JSONArrayReader& src);
+    JSONArrayReader& operator=(const JSONArrayReader& src);
+};
+
 
 #endif // ZJSONNODE_H
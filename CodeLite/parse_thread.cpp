@@ -27,6 +27,7 @@
 #include "pp_include.h"
 #include "pptable.h"
 #include "file_logger.h"
+#include "fileutils.h"
 #include <wx/tokenzr.h>
 #include "crawler_include.h"
 #include "parse_thread.h"
@@ -37,6 +38,7 @@
 #include <wx/ffile.h>
 #include "cpp_scanner.h"
 #include <set>
+#include <list>
 #include "cl_command_event.h"
 #include <tags_options_data.h>
 
@@ -118,7 +120,7 @@ void ParseThread::ProcessRequest(ThreadRequest* request)
 void ParseThread::ParseIncludeFiles(ParseRequest* req, const wxString& filename, ITagsStoragePtr db)
 {
     wxArrayString arrFiles;
-    GetFileListToParse(filename, arrFiles);
+    GetFileListToParse(filename, arrFiles, db);
     int initalCount = arrFiles.GetCount();
 
     TEST_DESTROY();
@@ -130,17 +132,14 @@ void ParseThread::ParseIncludeFiles(ParseRequest* req, const wxString& filename,
     ParseAndStoreFiles(req, arrFiles, initalCount, db);
 }
 
-TagTreePtr ParseThread::DoTreeFromTags(const wxString& tags, int& count)
-{
-    return TagsManagerST::Get()->TreeFromTags(tags, count);
-}
-
 void ParseThread::DoStoreTags(const wxString& tags, const wxString& filename, int& count, ITagsStoragePtr db)
 {
-    TagTreePtr ttp = DoTreeFromTags(tags, count);
+    // The tags are only stored, so skip building a tree for them
+    std::vector<TagEntry> entries;
+    TagsManagerST::Get()->EntriesFromTags(tags, entries, count);
     db->Begin();
     db->DeleteByFileName(wxFileName(), filename, false);
-    db->Store(ttp, wxFileName(), false);
+    db->Store(entries, wxFileName(), false);
     db->Commit();
 }
 
@@ -252,7 +251,9 @@ void ParseThread::ProcessSimple(ParseRequest* req)
     // If there is no event handler set to handle this comaprison
     // results, then nothing more to be done
     if(req->_evtHandler) {
+        // only the cache entries affected by this file need to be cleared
         wxCommandEvent clearCacheEvent(wxEVT_PARSE_THREAD_CLEAR_TAGS_CACHE);
+        clearCacheEvent.SetString(file_name.c_str());
         req->_evtHandler->AddPendingEvent(clearCacheEvent);
 
         wxCommandEvent retaggingCompletedEvent(wxEVT_PARSE_THREAD_RETAGGING_COMPLETED);
@@ -261,50 +262,158 @@ void ParseThread::ProcessSimple(ParseRequest* req)
     }
 }
 
-void ParseThread::GetFileListToParse(const wxString& filename, wxArrayString& arrFiles)
+void ParseThread::GetFileListToParse(const wxString& filename, wxArrayString& arrFiles, ITagsStoragePtr db)
 {
     if(!this->IsCrawlerEnabled()) {
         return;
     }
 
-    {
-        wxCriticalSectionLocker locker(TagsManagerST::Get()->m_crawlerLocker);
+    // Skip binary files
+    if(TagsManagerST::Get()->IsBinaryFile(filename)) {
+        DEBUG_MESSAGE(wxString::Format(wxT("Skipping binary file %s"), filename.c_str()));
+        return;
+    }
 
-        wxArrayString includePaths, excludePaths;
-        GetSearchPaths(includePaths, excludePaths);
+    wxArrayString files;
+    files.Add(filename);
 
-        fcFileOpener::Get()->ClearResults();
-        fcFileOpener::Get()->ClearSearchPath();
-        for(size_t i = 0; i < includePaths.GetCount(); i++) {
-            fcFileOpener::Get()->AddSearchPath(includePaths.Item(i).mb_str(wxConvUTF8).data());
+    std::set<wxString> fileSet;
+    DoGetIncludeClosure(files, fileSet, db);
+
+    std::set<wxString>::iterator iter = fileSet.begin();
+    for(; iter != fileSet.end(); iter++) {
+        if(arrFiles.Index(*iter) == wxNOT_FOUND) {
+            arrFiles.Add(*iter);
         }
+    }
+}
 
-        for(size_t i = 0; i < excludePaths.GetCount(); i++) {
-            fcFileOpener::Get()->AddExcludePath(excludePaths.Item(i).mb_str(wxConvUTF8).data());
+/// Identifies the search paths that were used to resolve the includes of a file.
+/// A graph entry built with different search paths is crawled again
+static wxString DoGetSearchPathsKey(const wxArrayString& searchPaths, const wxArrayString& excludePaths)
+{
+    wxString paths;
+    for(size_t i = 0; i < searchPaths.GetCount(); ++i) {
+        paths << searchPaths.Item(i) << wxT(";");
+    }
+    paths << wxT("|");
+    for(size_t i = 0; i < excludePaths.GetCount(); ++i) {
+        paths << excludePaths.Item(i) << wxT(";");
+    }
+    return FileUtils::Hash(paths);
+}
+
+bool ParseThread::DoCrawlFile(const wxString& file, wxArrayString& includes, wxArrayString& unresolved)
+{
+    // Scan this file only: with a max depth of 0 the crawler collects the include
+    // statements without opening the included files
+    int maxDepth = fcFileOpener::Get()->getMaxDepth();
+    fcFileOpener::Get()->ClearResults();
+    fcFileOpener::Get()->setMaxDepth(0);
+    int rc = crawlerScan(file.mb_str(wxConvUTF8).data());
+    fcFileOpener::Get()->setMaxDepth(maxDepth);
+    if(rc < 0) {
+        return false;
+    }
+
+    wxString cwd = wxFileName(file).GetPath();
+    const fcFileOpener::List_t& statements = fcFileOpener::Get()->GetIncludeStatements();
+    fcFileOpener::List_t::const_iterator iter = statements.begin();
+    for(; iter != statements.end(); ++iter) {
+        wxString filepath;
+        if(fcFileOpener::Get()->ResolveInclude(*iter, cwd, filepath)) {
+            if(includes.Index(filepath) == wxNOT_FOUND) {
+                includes.Add(filepath);
+            }
+        } else {
+            unresolved.Add(*iter);
         }
+    }
+    return true;
+}
 
-        // Invoke the crawler
-        const wxCharBuffer cfile = filename.mb_str(wxConvUTF8);
+void ParseThread::DoGetIncludeClosure(const wxArrayString& files, std::set<wxString>& closure, ITagsStoragePtr db)
+{
+    wxArrayString searchPaths, excludePaths;
+    GetSearchPaths(searchPaths, excludePaths);
+    wxString pathsKey = DoGetSearchPathsKey(searchPaths, excludePaths);
 
-        // Skip binary files
-        if(TagsManagerST::Get()->IsBinaryFile(filename)) {
-            DEBUG_MESSAGE(wxString::Format(wxT("Skipping binary file %s"), filename.c_str()));
-            return;
+    std::set<wxString> visited;
+    std::list<wxString> queue;
+    for(size_t i = 0; i < files.GetCount(); ++i) {
+        if(visited.insert(files.Item(i)).second) {
+            queue.push_back(files.Item(i));
         }
+    }
+
+    // Before using the 'crawlerScan' we lock it, since it is not mt-safe
+    wxCriticalSectionLocker locker(TagsManagerST::Get()->m_crawlerLocker);
 
-        // Before using the 'crawlerScan' we lock it, since it is not mt-safe
-        crawlerScan(cfile.data());
+    fcFileOpener::Get()->ClearResults();
+    fcFileOpener::Get()->ClearSearchPath();
+    for(size_t i = 0; i < searchPaths.GetCount(); i++) {
+        fcFileOpener::Get()->AddSearchPath(searchPaths.Item(i));
     }
 
-    std::set<wxString> fileSet = fcFileOpener::Get()->GetResults();
-    std::set<wxString>::iterator iter = fileSet.begin();
-    for(; iter != fileSet.end(); iter++) {
-        wxFileName fn(*iter);
-        fn.MakeAbsolute();
-        if(arrFiles.Index(fn.GetFullPath()) == wxNOT_FOUND) {
-            arrFiles.Add(fn.GetFullPath());
+    for(size_t i = 0; i < excludePaths.GetCount(); i++) {
+        fcFileOpener::Get()->AddExcludePath(excludePaths.Item(i));
+    }
+
+    size_t crawled = 0;
+    db->Begin();
+    while(!queue.empty()) {
+        if(TestDestroy()) {
+            break;
+        }
+
+        wxString file = queue.front();
+        queue.pop_front();
+
+        wxFileName fn(file);
+        if(!fn.FileExists()) {
+            closure.erase(file);
+            continue;
+        }
+
+        int lastScanned(0);
+        wxString key;
+        wxArrayString includes, unresolved;
+        // the file timestamps have a one second resolution: a file modified during the second
+        // it was crawled in may have been read before the change, crawl it again
+        bool upToDate = db->GetIncludeGraphEntry(file, lastScanned, key, includes, unresolved) && key == pathsKey &&
+                        fn.GetModificationTime().GetTicks() < (time_t)lastScanned;
+
+        // an include that could not be resolved when the file was crawled may exist by now
+        wxString cwd = fn.GetPath();
+        for(size_t i = 0; upToDate && i < unresolved.GetCount(); ++i) {
+            wxString filepath;
+            upToDate = !fcFileOpener::Get()->ResolveInclude(unresolved.Item(i), cwd, filepath);
+        }
+
+        if(!upToDate) {
+            // take the time before reading the file so a change made while crawling is not missed
+            int scanned = (int)time(NULL);
+            includes.Clear();
+            unresolved.Clear();
+            if(!DoCrawlFile(file, includes, unresolved)) {
+                continue;
+            }
+            db->StoreIncludeGraphEntry(file, scanned, pathsKey, includes, unresolved);
+            ++crawled;
+        }
+
+        for(size_t i = 0; i < includes.GetCount(); ++i) {
+            closure.insert(includes.Item(i));
+            if(visited.insert(includes.Item(i)).second) {
+                queue.push_back(includes.Item(i));
+            }
         }
     }
+    db->Commit();
+
+    DEBUG_MESSAGE(wxString::Format(wxT("Include graph: visited %u files, crawled %u files"),
+                                   (unsigned int)visited.size(),
+                                   (unsigned int)crawled));
 }
 
 void
@@ -370,6 +479,7 @@ void ParseThread::ProcessDeleteTagsOfFiles(ParseRequest* req)
     }
 
     db->DeleteFromFiles(file_array);
+    db->DeleteFromIncludeGraph(file_array);
     db->Commit();
     DEBUG_MESSAGE(wxString(wxT("ParseThread::ProcessDeleteTagsOfFile - completed")));
 }
@@ -474,8 +584,7 @@ void ParseThread::ProcessParseAndStore(ParseRequest* req)
 
 void ParseThread::FindIncludedFiles(ParseRequest* req, std::set<wxString>* newSet)
 {
-    wxArrayString searchPaths, excludePaths, filteredFileList;
-    GetSearchPaths(searchPaths, excludePaths);
+    wxArrayString filteredFileList;
 
     DEBUG_MESSAGE(
         wxString::Format(wxT("Initial workspace files count is %u"), (unsigned int)req->_workspaceFiles.size()));
@@ -490,37 +599,10 @@ void ParseThread::FindIncludedFiles(ParseRequest* req, std::set<wxString>* newSe
         filteredFileList.Add(fn.GetFullPath());
     }
 
-    wxArrayString arrFiles;
-
-    // Clear the results once
-    {
-        // Before using the 'crawlerScan' we lock it, since it is not mt-safe
-        wxCriticalSectionLocker locker(TagsManagerST::Get()->m_crawlerLocker);
-
-        fcFileOpener::Get()->ClearResults();
-        fcFileOpener::Get()->ClearSearchPath();
-
-        for(size_t i = 0; i < searchPaths.GetCount(); i++) {
-            const wxCharBuffer path = _C(searchPaths.Item(i));
-            DEBUG_MESSAGE(wxString::Format(wxT("ParseThread: Using Search Path: %s "), searchPaths.Item(i).c_str()));
-            fcFileOpener::Get()->AddSearchPath(path.data());
-        }
-
-        for(size_t i = 0; i < excludePaths.GetCount(); i++) {
-            const wxCharBuffer path = _C(excludePaths.Item(i));
-            DEBUG_MESSAGE(wxString::Format(wxT("ParseThread: Using Exclude Path: %s "), excludePaths.Item(i).c_str()));
-            fcFileOpener::Get()->AddExcludePath(path.data());
-        }
-
-        for(size_t i = 0; i < filteredFileList.GetCount(); i++) {
-            const wxCharBuffer cfile = filteredFileList.Item(i).mb_str(wxConvUTF8);
-            crawlerScan(cfile.data());
-            if(TestDestroy()) {
-                return;
-            }
-        }
-        newSet->insert(fcFileOpener::Get()->GetResults().begin(), fcFileOpener::Get()->GetResults().end());
-    }
+    // Only the files that changed since the last scan are crawled, the rest is read from the include graph
+    ITagsStoragePtr db(new TagsStorageSQLite());
+    db->OpenDatabase(req->getDbfile());
+    DoGetIncludeClosure(filteredFileList, *newSet, db);
 }
 
 //--------------------------------------------------------------------------------------
@@ -169,7 +169,6 @@ private:
     virtual ~ParseThread();
 
     void DoStoreTags(const wxString& tags, const wxString& filename, int& count, ITagsStoragePtr db);
-    TagTreePtr DoTreeFromTags(const wxString& tags, int& count);
     void DoNotifyReady(wxEvtHandler* caller, int requestType);
 
 private:
@@ -194,10 +193,23 @@ private:
     void ProcessIncludeStatements(ParseRequest* req);
     void ProcessColourRequest(ParseRequest* req);
     void ProcessMacroRequest(ParseRequest* req);
-    void GetFileListToParse(const wxString& filename, wxArrayString& arrFiles);
+    void GetFileListToParse(const wxString& filename, wxArrayString& arrFiles, ITagsStoragePtr db);
     void ParseAndStoreFiles(ParseRequest* req, const wxArrayString& arrFiles, int initalCount, ITagsStoragePtr db);
 
     void FindIncludedFiles(ParseRequest* req, std::set<wxString>* newSet);
+
+    /**
+     * @brief collect the files included (directly or indirectly) by 'files'.
+     * The includes are read from the include graph stored in the database. Only files that were
+     * modified since they were last crawled (or that are not part of the graph yet) are crawled
+     */
+    void DoGetIncludeClosure(const wxArrayString& files, std::set<wxString>& closure, ITagsStoragePtr db);
+
+    /**
+     * @brief crawl a single file for its include statements (without following them)
+     * and resolve them using the search paths. Must be called while holding the crawler lock
+     */
+    bool DoCrawlFile(const wxString& file, wxArrayString& includes, wxArrayString& unresolved);
 };
 
 class WXDLLIMPEXP_CL ParseThreadST
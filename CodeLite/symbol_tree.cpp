@@ -195,15 +195,7 @@ void SymbolTree::BuildTree(const wxFileName &fileName, TagEntryPtrVector_t* tags
     }
     
     SortTree(m_sortItems);
-    if ( ItemHasChildren(m_globalsNode) == false ) {
-        Delete(m_globalsNode);
-    }
-    if ( ItemHasChildren(m_prototypesNode) == false ) {
-        Delete(m_prototypesNode);
-    }
-    if ( ItemHasChildren(m_macrosNode) == false ) {
-        Delete(m_macrosNode);
-    }
+    DeleteEmptyGroupNodes();
     Thaw();
 
     //select the root node by default
@@ -376,8 +368,17 @@ void SymbolTree::UpdateGuiItem(TagEntry& data, const wxString& key)
                 SetItemImage(node->GetData().GetTreeItemId(), iconIndex, wxTreeItemIcon_Selected);
 
             } // if(curIconIndex != iconIndex )
+            wxFont font = wxSystemSettings::GetFont(wxSYS_DEFAULT_GUI_FONT);
+            if (data.GetKind() == wxT("prototype")) {
+                font.SetStyle(wxFONTSTYLE_ITALIC);
+            }
+            if (data.GetAccess() == wxT("public")) {
+                font.SetWeight(wxFONTWEIGHT_BOLD);
+            }
+            SetItemFont(itemId, font);
+
             //update the linenumber and file
-            MyTreeItemData *item_data = new MyTreeItemData(data.GetFile(), data.GetPattern());
+            MyTreeItemData *item_data = new MyTreeItemData(data.GetFile(), data.GetPattern(), data.GetLine());
             wxTreeItemData *old_data = GetItemData(itemId);
             if (old_data)
                 delete old_data;
@@ -449,6 +450,98 @@ void SymbolTree::AddSymbols(const std::vector<std::pair<wxString, TagEntry> > &i
     Thaw();
 }
 
+bool SymbolTree::UpdateTree(const wxFileName& fileName, TagEntryPtrVector_t* tags)
+{
+    if ( !m_tree || !tags || m_fileName != fileName || !GetRootItem().IsOk() )
+        return false;
+
+    TagTreePtr newTree = TagsManagerST::Get()->Load(fileName, tags);
+    if ( !newTree )
+        return false;
+
+    // Diff the two trees by key (kind + path + signature)
+    std::vector<std::pair<wxString, TagEntry> > deletedItems, modifiedItems, newItems;
+    m_tree->Compare(newTree.Get(), deletedItems, modifiedItems, newItems);
+
+    wxWindowUpdateLocker locker(this);
+    Freeze();
+
+    // Remove the items that no longer exist, their children are part of 'deletedItems' as well
+    DeleteSymbols(deletedItems);
+
+    // From now on, work on the new tree. Nodes which are already in the gui
+    // keep their tree item id
+    m_tree = newTree;
+    TreeWalker<wxString, TagEntry> walker(m_tree->GetRoot());
+    for (; !walker.End(); walker++) {
+        TagNode* node = walker.GetNode();
+        if (node->IsRoot())
+            continue;
+
+        std::map<wxString, void*>::iterator iter = m_items.find(node->GetKey());
+        if (iter != m_items.end()) {
+            node->GetData().SetTreeItemId(wxTreeItemId(iter->second));
+        }
+    }
+
+    // Update the line numbers, icons etc of the modified items
+    for (size_t i=0; i<modifiedItems.size(); i++) {
+        UpdateGuiItem(modifiedItems.at(i).second, modifiedItems.at(i).first);
+    }
+
+    // Add the new items. The walker order guarantees that a parent is
+    // added before its children
+    m_sortItems.clear();
+    AddGroupNodes();
+    for (size_t i=0; i<newItems.size(); i++) {
+        TagNode* node = m_tree->Find(newItems.at(i).first);
+        if (node) {
+            AddItem(node);
+        }
+    }
+    SortTree(m_sortItems);
+    m_sortItems.clear();
+    DeleteEmptyGroupNodes();
+    Thaw();
+
+    m_currentTags.clear();
+    m_currentTags.insert(m_currentTags.end(), tags->begin(), tags->end());
+    return true;
+}
+
+void SymbolTree::AddGroupNodes()
+{
+    wxTreeItemId root = GetRootItem();
+    if (!root.IsOk())
+        return;
+
+    if (!m_macrosNode.IsOk()) {
+        m_macrosNode = PrependItem(root, wxT("Macros"), 2, 2, new MyTreeItemData(wxT("Macros"), wxEmptyString));
+    }
+    if (!m_prototypesNode.IsOk()) {
+        m_prototypesNode = PrependItem(root, wxT("Functions Prototypes"), 2, 2, new MyTreeItemData(wxT("Functions Prototypes"), wxEmptyString));
+    }
+    if (!m_globalsNode.IsOk()) {
+        m_globalsNode = PrependItem(root, wxT("Global Functions and Variables"), 2, 2, new MyTreeItemData(wxT("Global Functions and Variables"), wxEmptyString));
+    }
+}
+
+void SymbolTree::DeleteEmptyGroupNodes()
+{
+    if ( m_globalsNode.IsOk() && ItemHasChildren(m_globalsNode) == false ) {
+        Delete(m_globalsNode);
+        m_globalsNode = wxTreeItemId();
+    }
+    if ( m_prototypesNode.IsOk() && ItemHasChildren(m_prototypesNode) == false ) {
+        Delete(m_prototypesNode);
+        m_prototypesNode = wxTreeItemId();
+    }
+    if ( m_macrosNode.IsOk() && ItemHasChildren(m_macrosNode) == false ) {
+        Delete(m_macrosNode);
+        m_macrosNode = wxTreeItemId();
+    }
+}
+
 void SymbolTree::Clear()
 {
     // Clear the tree
@@ -132,6 +132,15 @@ public:
      */
     virtual void BuildTree(const wxFileName &fileName, TagEntryPtrVector_t* tags = NULL);
 
+    /**
+     * Update the tree of the currently displayed file by applying only the differences
+     * between the displayed tags and 'tags' (deleted, modified and new items).
+     * Existing tree items are kept, so the expand state and the scroll position are preserved
+     * \return false if the tree can not be updated incrementally (e.g. a different file is
+     * displayed) and BuildTree() should be called instead
+     */
+    virtual bool UpdateTree(const wxFileName &fileName, TagEntryPtrVector_t* tags);
+
     /**
      * User provided icons for the symbols tree.
      * The assignment is index based, in the following order:
@@ -186,6 +195,16 @@ protected:
      */
     void AddItem(TagNode* node);
 
+    /**
+     * Make sure that the 'globals', 'prototypes' and 'macros' nodes exist
+     */
+    void AddGroupNodes();
+
+    /**
+     * Delete the 'globals', 'prototypes' and 'macros' nodes if they have no children
+     */
+    void DeleteEmptyGroupNodes();
+
     /**
      * Return the icon index according to item kind and access.
      * \param kind Item kind (class, namespace etc)
@@ -34,7 +34,7 @@
 
 
 TagTree::TagTree(const wxString& key, const TagEntry& data)
-: Tree<wxString, TagEntry>(key, data)
+: Tree<wxString, TagEntry, TagNodeMap_t>(key, data)
 {
 }
 
@@ -30,8 +30,10 @@
 #include "tree.h"
 #include "codelite_exports.h"
 #include "entry.h"
+#include <wx/hashmap.h>
 
 typedef TreeNode<wxString, TagEntry> TagNode;
+WX_DECLARE_STRING_HASH_MAP(TagNode*, TagNodeMap_t);
 
 /**
  * Tree representation of tags.
@@ -41,7 +43,7 @@ typedef TreeNode<wxString, TagEntry> TagNode;
  * \author eran
  *
  */
-class WXDLLIMPEXP_CL TagTree : public Tree<wxString, TagEntry>
+class WXDLLIMPEXP_CL TagTree : public Tree<wxString, TagEntry, TagNodeMap_t>
 {
 public:
 	/**
@@ -27,6 +27,7 @@
 #include <wx/longlong.h>
 #include "tags_storage_sqlite3.h"
 #include <wx/tokenzr.h>
+#include <algorithm>
 
 //-------------------------------------------------
 // Tags database class implementation
@@ -177,6 +178,26 @@ void TagsStorageSQLite::CreateSchema()
         sql = wxT("CREATE INDEX IF NOT EXISTS SIMPLE_MACROS_FILE on SIMPLE_MACROS(file);");
         m_db->ExecuteUpdate(sql);
 
+        // The include graph: one row per crawled file and one row per #include statement found in it.
+        // An include that could not be resolved is kept with an empty 'include' column
+        sql = wxT("create  table if not exists INCLUDE_GRAPH_FILES (ID INTEGER PRIMARY KEY AUTOINCREMENT, file string, "
+                  "last_scanned integer, paths_key string);");
+        m_db->ExecuteUpdate(sql);
+
+        sql = wxT("create  table if not exists INCLUDE_GRAPH (ID INTEGER PRIMARY KEY AUTOINCREMENT, file string, "
+                  "include string, statement string);");
+        m_db->ExecuteUpdate(sql);
+
+        sql = wxT("CREATE UNIQUE INDEX IF NOT EXISTS INCLUDE_GRAPH_FILES_NAME on INCLUDE_GRAPH_FILES(file);");
+        m_db->ExecuteUpdate(sql);
+
+        sql = wxT("CREATE INDEX IF NOT EXISTS INCLUDE_GRAPH_FILE on INCLUDE_GRAPH(file);");
+        m_db->ExecuteUpdate(sql);
+
+        // the reverse edges: who includes a given file
+        sql = wxT("CREATE INDEX IF NOT EXISTS INCLUDE_GRAPH_INCLUDE on INCLUDE_GRAPH(include);");
+        m_db->ExecuteUpdate(sql);
+
         sql = wxT("create table if not exists tags_version (version string primary key);");
         m_db->ExecuteUpdate(sql);
 
@@ -215,6 +236,8 @@ void TagsStorageSQLite::RecreateDatabase()
             m_db->ExecuteUpdate(wxT("DROP TABLE IF EXISTS MACROS"));
             m_db->ExecuteUpdate(wxT("DROP TABLE IF EXISTS SIMPLE_MACROS"));
             m_db->ExecuteUpdate(wxT("DROP TABLE IF EXISTS GLOBAL_TAGS"));
+            m_db->ExecuteUpdate(wxT("DROP TABLE IF EXISTS INCLUDE_GRAPH_FILES"));
+            m_db->ExecuteUpdate(wxT("DROP TABLE IF EXISTS INCLUDE_GRAPH"));
 
             // drop indexes
             m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS FILES_NAME"));
@@ -231,6 +254,9 @@ void TagsStorageSQLite::RecreateDatabase()
             m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS SIMPLE_MACROS_FILE"));
             m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS GLOBAL_TAGS_IDX_1"));
             m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS GLOBAL_TAGS_IDX_2"));
+            m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS INCLUDE_GRAPH_FILES_NAME"));
+            m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS INCLUDE_GRAPH_FILE"));
+            m_db->ExecuteUpdate(wxT("DROP INDEX IF EXISTS INCLUDE_GRAPH_INCLUDE"));
 
             // Recreate the schema
             CreateSchema();
@@ -301,6 +327,33 @@ void TagsStorageSQLite::Store(TagTreePtr tree, const wxFileName& path, bool auto
     }
 }
 
+void TagsStorageSQLite::Store(const std::vector<TagEntry>& tags, const wxFileName& path, bool autoCommit)
+{
+    if(!path.IsOk() && !m_fileName.IsOk()) {
+        // An attempt is made to save the tags into db but no database
+        // is provided and none is currently opened to use
+        return;
+    }
+
+    OpenDatabase(path);
+    try {
+        if(autoCommit) m_db->Begin();
+
+        for(size_t i = 0; i < tags.size(); ++i) {
+            DoInsertTagEntry(tags.at(i));
+        }
+
+        if(autoCommit) m_db->Commit();
+
+    } catch(wxSQLite3Exception& e) {
+        try {
+            if(autoCommit) m_db->Rollback();
+        } catch(wxSQLite3Exception& WXUNUSED(e1)) {
+            wxUnusedVar(e);
+        }
+    }
+}
+
 void TagsStorageSQLite::SelectTagsByFile(const wxString& file, std::vector<TagEntryPtr>& tags, const wxFileName& path)
 {
     // Incase empty file path is provided, use the current file name
@@ -580,7 +633,8 @@ void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr
 
     CL_DEBUG1(wxT("[CACHED ITEMS] %s"), sql.c_str());
     // try the cache first
-    tags.reserve(500);
+    size_t firstNewTag = tags.size();
+    tags.reserve(firstNewTag + 500);
     try {
         wxSQLite3ResultSet ex_rs;
         ex_rs = Query(sql);
@@ -598,7 +652,8 @@ void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr
     }
 
     if(GetUseCache()) {
-        m_cache.Store(sql, tags);
+        // cache only the tags fetched by this query
+        m_cache.Store(sql, std::vector<TagEntryPtr>(tags.begin() + firstNewTag, tags.end()));
     }
 }
 
@@ -613,6 +668,7 @@ void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr
 
     CL_DEBUG1(wxT("[CACHED ITEMS] %s"), sql.c_str());
 
+    size_t firstNewTag = tags.size();
     try {
         wxSQLite3ResultSet ex_rs;
         ex_rs = Query(sql);
@@ -636,7 +692,8 @@ void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr
     }
 
     if(GetUseCache()) {
-        m_cache.Store(sql, kinds, tags);
+        // cache only the tags fetched by this query
+        m_cache.Store(sql, kinds, std::vector<TagEntryPtr>(tags.begin() + firstNewTag, tags.end()));
     }
 }
 
@@ -865,7 +922,10 @@ int TagsStorageSQLite::DoInsertTagEntry(const TagEntry& tag)
 
     // does not matter if we insert or update, the cache must be cleared for any related tags
     if(GetUseCache()) {
-        ClearCache();
+        std::vector<wxString> terms;
+        DoAddCacheTerms(tag, terms);
+        std::sort(terms.begin(), terms.end());
+        m_cache.Invalidate(tag.GetFile(), terms);
     }
 
     try {
@@ -1081,6 +1141,49 @@ void TagsStorageSQLite::GetAllTagsNames(wxArrayString& names)
     }
 }
 
+void TagsStorageSQLite::GetTagsNamesNoLimit(const wxArrayString& kinds, wxArrayString& names)
+{
+    try {
+        wxString query(wxT("SELECT distinct name FROM tags"));
+        if(!kinds.IsEmpty()) {
+            query << wxT(" WHERE kind IN (");
+            for(size_t i = 0; i < kinds.GetCount(); i++) {
+                query << wxT("'") << kinds.Item(i) << wxT("',");
+            }
+            query.RemoveLast();
+            query << wxT(")");
+        }
+
+        wxSQLite3ResultSet res = Query(query);
+        while(res.NextRow()) {
+            names.Add(res.GetString(0));
+        }
+
+    } catch(wxSQLite3Exception& e) {
+        CL_DEBUG(wxT("%s"), e.GetMessage().c_str());
+    }
+}
+
+void TagsStorageSQLite::GetTagsByNames(const wxArrayString& names, std::vector<TagEntryPtr>& tags)
+{
+    if(names.IsEmpty()) return;
+    try {
+        wxString sql;
+        sql << wxT("select * from tags where name in (");
+        for(size_t i = 0; i < names.GetCount(); i++) {
+            wxString name = names.Item(i);
+            name.Replace(wxT("'"), wxT("''"));
+            sql << wxT("'") << name << wxT("',");
+        }
+        sql.RemoveLast();
+        sql << wxT(")");
+        DoFetchTags(sql, tags);
+
+    } catch(wxSQLite3Exception& e) {
+        CL_DEBUG(wxT("%s"), e.GetMessage().c_str());
+    }
+}
+
 void TagsStorageSQLite::GetTagsNames(const wxArrayString& kind, wxArrayString& names)
 {
     if(kind.IsEmpty()) return;
@@ -1370,9 +1473,19 @@ void TagsStorageSQLite::GetSubscriptOperator(const wxString& scope, std::vector<
 //-----------------------------TagsStorageSQLiteCache -----------------
 //---------------------------------------------------------------------
 
-TagsStorageSQLiteCache::TagsStorageSQLiteCache() {}
+// the default (approximated) memory used by the cache
+#define TAGS_CACHE_DEFAULT_MAX_MEMORY (32 * 1024 * 1024)
+
+TagsStorageSQLiteCache::TagsStorageSQLiteCache()
+    : m_memory(0)
+    , m_maxMemory(TAGS_CACHE_DEFAULT_MAX_MEMORY)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+{
+}
 
-TagsStorageSQLiteCache::~TagsStorageSQLiteCache() { m_cache.clear(); }
+TagsStorageSQLiteCache::~TagsStorageSQLiteCache() { Clear(); }
 
 bool TagsStorageSQLiteCache::Get(const wxString& sql, std::vector<TagEntryPtr>& tags) { return DoGet(sql, tags); }
 
@@ -1393,6 +1506,8 @@ void TagsStorageSQLiteCache::Clear()
 {
     CL_DEBUG1(wxT("[CACHE CLEARED]"));
     m_cache.clear();
+    m_lru.clear();
+    m_memory = 0;
 }
 
 void TagsStorageSQLiteCache::Store(const wxString& sql, const wxArrayString& kind, const std::vector<TagEntryPtr>& tags)
@@ -1407,23 +1522,229 @@ void TagsStorageSQLiteCache::Store(const wxString& sql, const wxArrayString& kin
 
 bool TagsStorageSQLiteCache::DoGet(const wxString& key, std::vector<TagEntryPtr>& tags)
 {
-    std::map<wxString, std::vector<TagEntryPtr> >::iterator iter = m_cache.find(key);
+    Map_t::iterator iter = m_cache.find(key);
     if(iter != m_cache.end()) {
         // Append the results to the output tags
-        tags.insert(tags.end(), iter->second.begin(), iter->second.end());
+        tags.insert(tags.end(), iter->second.tags.begin(), iter->second.tags.end());
+
+        // Move the entry to the head of the LRU list
+        m_lru.splice(m_lru.begin(), m_lru, iter->second.lruIter);
+        ++m_hits;
         return true;
     }
+    ++m_misses;
     return false;
 }
 
 void TagsStorageSQLiteCache::DoStore(const wxString& key, const std::vector<TagEntryPtr>& tags)
 {
-    m_cache[key].reserve(tags.size());
-    m_cache[key] = tags;
+    Map_t::iterator iter = m_cache.find(key);
+    if(iter != m_cache.end()) {
+        DoErase(iter);
+    }
+
+    Entry entry;
+    entry.tags = tags;
+    entry.size = (key.length() * sizeof(wxChar)) + sizeof(Entry);
+    for(size_t i = 0; i < tags.size(); ++i) {
+        entry.files.insert(tags.at(i)->GetFile());
+        entry.size += DoGetTagSize(tags.at(i));
+    }
+    DoExtractLiterals(key, entry);
+
+    // an entry larger than the whole cache is not kept
+    if(entry.size > m_maxMemory) return;
+
+    m_lru.push_front(key);
+    entry.lruIter = m_lru.begin();
+    m_memory += entry.size;
+    m_cache.insert(std::make_pair(key, entry));
+
+    // Evict the least recently used entries
+    while(m_memory > m_maxMemory && !m_lru.empty()) {
+        DoErase(m_cache.find(m_lru.back()));
+        ++m_evictions;
+    }
+}
+
+void TagsStorageSQLiteCache::DoErase(TagsStorageSQLiteCache::Map_t::iterator iter)
+{
+    if(iter == m_cache.end()) return;
+    m_memory -= iter->second.size;
+    m_lru.erase(iter->second.lruIter);
+    m_cache.erase(iter);
+}
+
+size_t TagsStorageSQLiteCache::DoGetTagSize(TagEntryPtr tag)
+{
+    // an approximation: the object itself and its main strings
+    size_t chars = tag->GetName().length() + tag->GetPath().length() + tag->GetFile().length() +
+                   tag->GetPattern().length() + tag->GetScope().length() + tag->GetParent().length();
+    return sizeof(TagEntry) + (chars * sizeof(wxChar));
+}
+
+void TagsStorageSQLiteCache::DoExtractLiterals(const wxString& key, TagsStorageSQLiteCache::Entry& entry)
+{
+    // Collect the quoted literals of the query and the kinds appended to the key ("@kind").
+    // LIKE patterns are reduced to their prefix, a pattern starting with a wildcard can match anything
+    entry.matchAll = false;
+    entry.literals.clear();
+
+    wxString lowerKey = key.Lower();
+    if(lowerKey.Contains(wxT("!=")) || lowerKey.Contains(wxT("<>")) || lowerKey.Contains(wxT(" not "))) {
+        // negative conditions: a tag can match the query without matching any of its literals
+        entry.matchAll = true;
+        return;
+    }
+    size_t i = 0;
+    while(i < lowerKey.length()) {
+        wxChar ch = lowerKey.GetChar(i);
+        if(ch == wxT('@')) {
+            size_t end = lowerKey.find(wxT('@'), i + 1);
+            if(end == wxString::npos) end = lowerKey.length();
+            entry.literals.push_back(lowerKey.Mid(i + 1, end - i - 1));
+            i = end;
+            continue;
+        }
+
+        if(ch != wxT('\'')) {
+            ++i;
+            continue;
+        }
+
+        // read the literal, '' is an escaped quote
+        wxString literal;
+        size_t j = i + 1;
+        for(; j < lowerKey.length(); ++j) {
+            wxChar c = lowerKey.GetChar(j);
+            if(c == wxT('\'')) {
+                if(j + 1 < lowerKey.length() && lowerKey.GetChar(j + 1) == wxT('\'')) {
+                    literal << c;
+                    ++j;
+                    continue;
+                }
+                break;
+            }
+            literal << c;
+        }
+        i = j + 1;
+
+        // the escape character of our LIKE statements
+        if(literal == wxT("^")) continue;
+
+        literal.Replace(wxT("^_"), wxT("_"));
+        int wildcard = literal.Find(wxT('%'));
+        if(wildcard != wxNOT_FOUND) {
+            literal.Truncate(wildcard);
+        }
+
+        if(literal.IsEmpty()) {
+            entry.matchAll = true;
+            continue;
+        }
+        entry.literals.push_back(literal);
+    }
+
+    if(entry.literals.empty()) {
+        entry.matchAll = true;
+    }
+}
+
+void TagsStorageSQLiteCache::Invalidate(const wxString& filename, const std::vector<wxString>& terms)
+{
+    size_t count(0);
+    Map_t::iterator iter = m_cache.begin();
+    while(iter != m_cache.end()) {
+        const Entry& entry = iter->second;
+        bool affected = entry.matchAll || entry.files.count(filename);
+
+        // does any of the new tags start with one of the query literals?
+        for(size_t i = 0; !affected && i < entry.literals.size(); ++i) {
+            std::vector<wxString>::const_iterator where =
+                std::lower_bound(terms.begin(), terms.end(), entry.literals.at(i));
+            affected = (where != terms.end() && where->StartsWith(entry.literals.at(i)));
+        }
+
+        if(affected) {
+            Map_t::iterator next = iter;
+            ++next;
+            DoErase(iter);
+            iter = next;
+            ++count;
+
+        } else {
+            ++iter;
+        }
+    }
+    CL_DEBUG1(wxT("[CACHE] %u entries invalidated by %s"), (unsigned int)count, filename.c_str());
+}
+
+void TagsStorageSQLiteCache::SetMaxMemory(size_t maxMemory)
+{
+    m_maxMemory = maxMemory;
+    while(m_memory > m_maxMemory && !m_lru.empty()) {
+        DoErase(m_cache.find(m_lru.back()));
+        ++m_evictions;
+    }
+}
+
+wxString TagsStorageSQLiteCache::GetStatistics() const
+{
+    size_t total = m_hits + m_misses;
+    wxString stats;
+    stats << wxT("Tags cache: ") << m_cache.size() << wxT(" entries, ") << (m_memory / 1024) << wxT("KB, hits: ")
+          << m_hits << wxT(", misses: ") << m_misses << wxT(" (")
+          << (total ? (m_hits * 100 / total) : 0) << wxT("% hit rate), evictions: ") << m_evictions;
+    return stats;
 }
 
 void TagsStorageSQLite::ClearCache() { m_cache.Clear(); }
 
+void TagsStorageSQLite::ClearCache(const wxString& filename)
+{
+    // Collect the fields of the file's current tags
+    std::vector<wxString> terms;
+    try {
+        wxString sql;
+        sql << wxT("select * from tags where file='") << filename << wxT("'");
+        wxSQLite3ResultSet rs = Query(sql);
+        while(rs.NextRow()) {
+            TagEntryPtr tag(FromSQLite3ResultSet(rs));
+            DoAddCacheTerms(*tag, terms);
+        }
+        rs.Finalize();
+
+    } catch(wxSQLite3Exception& e) {
+        wxUnusedVar(e);
+        m_cache.Clear();
+        return;
+    }
+
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    m_cache.Invalidate(filename, terms);
+}
+
+void TagsStorageSQLite::DoAddCacheTerms(const TagEntry& tag, std::vector<wxString>& terms)
+{
+    terms.push_back(tag.GetName().Lower());
+    terms.push_back(tag.GetScope().Lower());
+    terms.push_back(tag.GetPath().Lower());
+    terms.push_back(tag.GetParent().Lower());
+    terms.push_back(tag.GetKind().Lower());
+    terms.push_back(tag.GetAccess().Lower());
+    terms.push_back(tag.GetTyperef().Lower());
+    terms.push_back(tag.GetReturnValue().Lower());
+    terms.push_back(tag.GetFile().Lower());
+
+    wxArrayString inherits = tag.GetInheritsAsArrayNoTemplates();
+    for(size_t i = 0; i < inherits.GetCount(); ++i) {
+        terms.push_back(inherits.Item(i).Lower());
+    }
+}
+
+wxString TagsStorageSQLite::GetCacheStatistics() const { return m_cache.GetStatistics(); }
+
 void TagsStorageSQLite::SetUseCache(bool useCache) { ITagsStorage::SetUseCache(useCache); }
 
 PPToken TagsStorageSQLite::GetMacro(const wxString& name)
@@ -1531,6 +1852,116 @@ void TagsStorageSQLite::GetMacrosDefined(const std::set<std::string>& files,
     }
 }
 
+bool TagsStorageSQLite::GetIncludeGraphEntry(const wxString& file,
+                                             int& lastScanned,
+                                             wxString& pathsKey,
+                                             wxArrayString& includes,
+                                             wxArrayString& unresolved)
+{
+    try {
+        wxSQLite3Statement stmnt =
+            m_db->GetPrepareStatement(wxT("select last_scanned, paths_key from INCLUDE_GRAPH_FILES where file=?"));
+        stmnt.Bind(1, file);
+        wxSQLite3ResultSet res = stmnt.ExecuteQuery();
+        if(!res.NextRow()) {
+            return false;
+        }
+        lastScanned = res.GetInt(0);
+        pathsKey = res.GetString(1);
+
+        wxSQLite3Statement edges =
+            m_db->GetPrepareStatement(wxT("select include, statement from INCLUDE_GRAPH where file=?"));
+        edges.Bind(1, file);
+        res = edges.ExecuteQuery();
+        while(res.NextRow()) {
+            wxString include = res.GetString(0);
+            if(include.IsEmpty()) {
+                unresolved.Add(res.GetString(1));
+            } else {
+                includes.Add(include);
+            }
+        }
+        return true;
+
+    } catch(wxSQLite3Exception& exc) {
+        CL_DEBUG(wxT("%s"), exc.GetMessage().c_str());
+    }
+    return false;
+}
+
+void TagsStorageSQLite::StoreIncludeGraphEntry(const wxString& file,
+                                               int lastScanned,
+                                               const wxString& pathsKey,
+                                               const wxArrayString& includes,
+                                               const wxArrayString& unresolved)
+{
+    try {
+        wxSQLite3Statement stmntDelete = m_db->GetPrepareStatement(wxT("delete from INCLUDE_GRAPH where file=?"));
+        stmntDelete.Bind(1, file);
+        stmntDelete.ExecuteUpdate();
+
+        wxSQLite3Statement stmntEdge =
+            m_db->GetPrepareStatement(wxT("insert into INCLUDE_GRAPH values(NULL, ?, ?, ?)"));
+        for(size_t i = 0; i < includes.GetCount(); ++i) {
+            stmntEdge.Bind(1, file);
+            stmntEdge.Bind(2, includes.Item(i));
+            stmntEdge.Bind(3, wxEmptyString);
+            stmntEdge.ExecuteUpdate();
+            stmntEdge.Reset();
+        }
+
+        for(size_t i = 0; i < unresolved.GetCount(); ++i) {
+            stmntEdge.Bind(1, file);
+            stmntEdge.Bind(2, wxEmptyString);
+            stmntEdge.Bind(3, unresolved.Item(i));
+            stmntEdge.ExecuteUpdate();
+            stmntEdge.Reset();
+        }
+
+        wxSQLite3Statement stmntFile =
+            m_db->GetPrepareStatement(wxT("insert or replace into INCLUDE_GRAPH_FILES values(NULL, ?, ?, ?)"));
+        stmntFile.Bind(1, file);
+        stmntFile.Bind(2, lastScanned);
+        stmntFile.Bind(3, pathsKey);
+        stmntFile.ExecuteUpdate();
+
+    } catch(wxSQLite3Exception& exc) {
+        CL_DEBUG(wxT("%s"), exc.GetMessage().c_str());
+    }
+}
+
+void TagsStorageSQLite::DeleteFromIncludeGraph(const wxArrayString& files)
+{
+    if(files.IsEmpty()) {
+        return;
+    }
+
+    wxString fileList;
+    for(size_t i = 0; i < files.GetCount(); i++) {
+        fileList << wxT("'") << files.Item(i) << wxT("',");
+    }
+    fileList.RemoveLast();
+
+    try {
+        // Follow the reverse edges and force the includers to be crawled again
+        wxString sql;
+        sql << wxT("update INCLUDE_GRAPH_FILES set last_scanned=0 where file in (select file from INCLUDE_GRAPH where "
+                   "include in (") << fileList << wxT("))");
+        m_db->ExecuteUpdate(sql);
+
+        sql.Clear();
+        sql << wxT("delete from INCLUDE_GRAPH where file in (") << fileList << wxT(")");
+        m_db->ExecuteUpdate(sql);
+
+        sql.Clear();
+        sql << wxT("delete from INCLUDE_GRAPH_FILES where file in (") << fileList << wxT(")");
+        m_db->ExecuteUpdate(sql);
+
+    } catch(wxSQLite3Exception& exc) {
+        CL_DEBUG(wxT("%s"), exc.GetMessage().c_str());
+    }
+}
+
 void TagsStorageSQLite::GetTagsByName(const wxString& prefix, std::vector<TagEntryPtr>& tags, bool exactMatch)
 {
     try {
@@ -32,6 +32,10 @@
 #include "istorage.h"
 #include <wx/wxsqlite3.h>
 #include "codelite_exports.h"
+#include <map>
+#include <set>
+#include <list>
+#include <vector>
 
 const wxString gTagsDatabaseVersion(wxT("CodeLite Version 3.0"));
 
@@ -88,12 +92,43 @@ const wxString gTagsDatabaseVersion(wxT("CodeLite Version 3.0"));
  * @ingroup CodeLite
  */
 
+/**
+ * @class TagsStorageSQLiteCache
+ * @brief a query cache keyed by the SQL statement. The cache is bounded in memory (least recently
+ * used entries are evicted first) and each entry remembers the files its tags came from and the
+ * literals used by its query, so re-tagging a file only evicts the entries that can be affected by it
+ */
 class TagsStorageSQLiteCache
 {
-    std::map<wxString, std::vector<TagEntryPtr> > m_cache;
+public:
+    struct Entry {
+        std::vector<TagEntryPtr>       tags;
+        std::set<wxString>             files;
+        // lower case literals found in the SQL. A tag can only match the query if
+        // one of its fields starts with one of them
+        std::vector<wxString>          literals;
+        // the query has no usable literals, any change may affect it
+        bool                           matchAll;
+        size_t                         size;
+        std::list<wxString>::iterator  lruIter;
+    };
+
+protected:
+    typedef std::map<wxString, Entry> Map_t;
+    Map_t               m_cache;
+    std::list<wxString> m_lru; // most recently used first
+    size_t              m_memory;
+    size_t              m_maxMemory;
+    size_t              m_hits;
+    size_t              m_misses;
+    size_t              m_evictions;
+
 protected:
     bool DoGet  (const wxString &key, std::vector<TagEntryPtr> &tags);
     void DoStore(const wxString &key, const std::vector<TagEntryPtr> &tags);
+    void DoErase(Map_t::iterator iter);
+    static void DoExtractLiterals(const wxString &key, Entry &entry);
+    static size_t DoGetTagSize(TagEntryPtr tag);
 
 public:
     TagsStorageSQLiteCache();
@@ -104,6 +139,40 @@ public:
     void Store(const wxString &sql, const std::vector<TagEntryPtr> &tags);
     void Store(const wxString &sql, const wxArrayString &kind, const std::vector<TagEntryPtr> &tags);
     void Clear();
+
+    /**
+     * @brief evict the entries affected by re-tagging 'filename': entries holding tags from this file
+     * and entries whose query may match one of the file's new tags
+     * @param terms the lower case field values (name, scope, kind...) of the file's new tags, sorted
+     */
+    void Invalidate(const wxString &filename, const std::vector<wxString> &terms);
+
+    /**
+     * @brief set the (approximated) maximum memory used by the cache, in bytes
+     */
+    void SetMaxMemory(size_t maxMemory);
+    size_t GetMaxMemory() const {
+        return m_maxMemory;
+    }
+    size_t GetMemory() const {
+        return m_memory;
+    }
+    size_t GetCount() const {
+        return m_cache.size();
+    }
+    size_t GetHits() const {
+        return m_hits;
+    }
+    size_t GetMisses() const {
+        return m_misses;
+    }
+    size_t GetEvictions() const {
+        return m_evictions;
+    }
+    /**
+     * @brief return a human readable summary of the cache statistics
+     */
+    wxString GetStatistics() const;
 };
 
 class WXDLLIMPEXP_CL clSqliteDB : public wxSQLite3Database
@@ -147,6 +216,10 @@ private:
     void DoFetchTags ( const wxString &sql, std::vector<TagEntryPtr> &tags, const wxArrayString &kinds);
 
     void DoAddNamePartToQuery(wxString &sql, const wxString &name, bool partial, bool prependAnd);
+    /**
+     * @brief add the lower case fields of 'tag' used to invalidate the cache entries
+     */
+    static void DoAddCacheTerms(const TagEntry &tag, std::vector<wxString> &terms);
     void DoAddLimitPartToQuery(wxString &sql, const std::vector<TagEntryPtr> &tags);
     int  DoInsertTagEntry( const TagEntry &tag );
 
@@ -205,6 +278,14 @@ public:
      */
     void Store(TagTreePtr tree, const wxFileName& path, bool autoCommit = true);
 
+    /**
+     * Store list of tags into db.
+     * @param tags Tags to store
+     * @param path Database file name
+     * @param autoCommit handle the Store operation inside a transaction or let the user hadle it
+     */
+    void Store(const std::vector<TagEntry>& tags, const wxFileName& path, bool autoCommit = true);
+
     /**
      * Return a result set of tags according to file name.
      * @param file Source file name
@@ -531,6 +612,19 @@ public:
      */
     virtual void ClearCache();
 
+    /**
+     * @brief evict from the cache only the entries affected by re-tagging 'filename'
+     */
+    virtual void ClearCache(const wxString& filename);
+    virtual wxString GetCacheStatistics() const;
+
+    /**
+     * @brief return the query cache (e.g. for its statistics)
+     */
+    const TagsStorageSQLiteCache& GetCache() const {
+        return m_cache;
+    }
+
     /**
      * @brief
      * @param fileName
@@ -543,6 +637,10 @@ public:
 
     virtual void GetTagsNames(const wxArrayString& kind, wxArrayString& names);
 
+    virtual void GetTagsNamesNoLimit(const wxArrayString& kinds, wxArrayString& names);
+
+    virtual void GetTagsByNames(const wxArrayString& names, std::vector<TagEntryPtr>& tags);
+
     /**
      * @brief
      * @param files
@@ -593,6 +691,21 @@ public:
      */
     virtual void GetMacrosDefined(const std::set<std::string>& files, const std::set<wxString>& usedMacros, wxArrayString& defMacros);
 
+    /**
+     * @copydoc ITagStorage::GetIncludeGraphEntry
+     */
+    virtual bool GetIncludeGraphEntry(const wxString& file, int& lastScanned, wxString& pathsKey, wxArrayString& includes, wxArrayString& unresolved);
+
+    /**
+     * @copydoc ITagStorage::StoreIncludeGraphEntry
+     */
+    virtual void StoreIncludeGraphEntry(const wxString& file, int lastScanned, const wxString& pathsKey, const wxArrayString& includes, const wxArrayString& unresolved);
+
+    /**
+     * @copydoc ITagStorage::DeleteFromIncludeGraph
+     */
+    virtual void DeleteFromIncludeGraph(const wxArrayString& files);
+
     /**
      * @brief search for a single match in the database for an entry with a given name
      */
@@ -28,10 +28,11 @@
 
 #include "tree_node.h"
 
-template <typename TKey, typename TData>
+// TIndex is the container used to find nodes by key (e.g. a hash map)
+template <typename TKey, typename TData, typename TIndex = std::map<TKey, TreeNode<TKey, TData>*> >
 class Tree
 {
-	std::map<TKey, TreeNode<TKey, TData>*> m_nodes;
+	TIndex m_nodes; // key -> node index
 	TreeNode<TKey, TData>* m_root;
 public:
 	/**
@@ -101,29 +102,29 @@ public:
 	void ToVector(std::vector<std::pair<TKey, TData> >& vec);
 };
 
-template <typename TKey, typename TData>
-Tree<TKey, TData>::Tree(const TKey& key, const TData& data)
+template <typename TKey, typename TData, typename TIndex>
+Tree<TKey, TData, TIndex>::Tree(const TKey& key, const TData& data)
 {
 	m_root = new TreeNode<TKey, TData>(key, data);
 }
 
-template <typename TKey, typename TData>
-Tree<TKey, TData>::~Tree()
+template <typename TKey, typename TData, typename TIndex>
+Tree<TKey, TData, TIndex>::~Tree()
 {
 	delete m_root;
 }
 
-template <typename TKey, typename TData>
-TreeNode<TKey, TData>* Tree<TKey, TData>::Find(const TKey& key)
+template <typename TKey, typename TData, typename TIndex>
+TreeNode<TKey, TData>* Tree<TKey, TData, TIndex>::Find(const TKey& key)
 {
-	typename std::map<TKey, TreeNode<TKey, TData>*>::const_iterator iter = m_nodes.find(key);
+	typename TIndex::iterator iter = m_nodes.find(key);
 	if(iter == m_nodes.end())
 		return NULL;
 	return iter->second;
 }
 
-template <typename TKey, typename TData>
-TreeNode<TKey, TData>* Tree<TKey, TData>::AddChild(const TKey& key, const TData& data, TreeNode<TKey, TData>* parent /*NULL*/)
+template <typename TKey, typename TData, typename TIndex>
+TreeNode<TKey, TData>* Tree<TKey, TData, TIndex>::AddChild(const TKey& key, const TData& data, TreeNode<TKey, TData>* parent /*NULL*/)
 {
 	TreeNode<TKey, TData>* parentNode;
 	(parent == NULL) ? parentNode = m_root : parentNode = parent;
@@ -132,10 +133,10 @@ TreeNode<TKey, TData>* Tree<TKey, TData>::AddChild(const TKey& key, const TData&
 	return node;
 }
 
-template <typename TKey, typename TData>
-TreeNode<TKey, TData>* Tree<TKey, TData>::Remove(const TKey& key)
+template <typename TKey, typename TData, typename TIndex>
+TreeNode<TKey, TData>* Tree<TKey, TData, TIndex>::Remove(const TKey& key)
 {
-	typename std::map<TKey, TreeNode<TKey, TData>*>::const_iterator iter = m_nodes.find(key);
+	typename TIndex::iterator iter = m_nodes.find(key);
 	if(iter == m_nodes.end())
 		return NULL;
 
@@ -144,20 +145,20 @@ TreeNode<TKey, TData>* Tree<TKey, TData>::Remove(const TKey& key)
 
 	for(; !walker.End(); walker++)
 	{
-		typename std::map<TKey, TreeNode<TKey, TData>*>::iterator it = m_nodes.find(walker.GetNode()->GetKey());
+		typename TIndex::iterator it = m_nodes.find(walker.GetNode()->GetKey());
 		if(it != m_nodes.end())
 			m_nodes.erase(it);
 	}
 	return m_root->Remove(key);
 }
-template <typename TKey, typename TData>
-void Tree<TKey, TData>::Print(std::ostream& stream , int depth)
+template <typename TKey, typename TData, typename TIndex>
+void Tree<TKey, TData, TIndex>::Print(std::ostream& stream , int depth)
 {
 	m_root->Print(stream, depth);
 }
 
-template <typename TKey, typename TData>
-void Tree<TKey, TData>::ToVector(std::vector<std::pair<TKey, TData> >& vec)
+template <typename TKey, typename TData, typename TIndex>
+void Tree<TKey, TData, TIndex>::ToVector(std::vector<std::pair<TKey, TData> >& vec)
 {
 	TreeWalker<TKey, TData> walker(GetRoot());
 	for(; !walker.End(); walker++)
@@ -172,8 +173,8 @@ void Tree<TKey, TData>::ToVector(std::vector<std::pair<TKey, TData> >& vec)
 	}
 }
 
-template <typename TKey, typename TData>
-void Tree<TKey, TData>::Compare(Tree* targetTree, std::vector<std::pair<TKey, TData> >& deletedItems, std::vector<std::pair<TKey, TData> >& modifiedItems, std::vector<std::pair<TKey, TData> >& newItems, TreeNode<TKey, TData>* fromNode)
+template <typename TKey, typename TData, typename TIndex>
+void Tree<TKey, TData, TIndex>::Compare(Tree* targetTree, std::vector<std::pair<TKey, TData> >& deletedItems, std::vector<std::pair<TKey, TData> >& modifiedItems, std::vector<std::pair<TKey, TData> >& newItems, TreeNode<TKey, TData>* fromNode)
 {
 	// we break generic for the sake of thread safety:
 	// we explicitly calling TKey.c_str(), which means that we assume that TKey has such member
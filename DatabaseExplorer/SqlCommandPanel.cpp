@@ -38,6 +38,8 @@
 #include "lexer_configuration.h"
 #include "editor_config.h"
 #include "db_explorer_settings.h"
+#include "SqlResultTable.h"
+#include <wx/stopwatch.h>
 #include <algorithm>
 
 #if CL_USE_NATIVEBOOK
@@ -52,6 +54,195 @@
 
 const wxEventType wxEVT_EXECUTE_SQL = XRCID("wxEVT_EXECUTE_SQL");
 
+// ----------------------------------------------------------------
+// SqlQueryThread - runs the query and streams the rows into the
+// result table. The panel is notified with CallAfter() so the grid
+// is only ever touched from the main thread
+// ----------------------------------------------------------------
+class SqlQueryThread : public wxThread
+{
+    SQLCommandPanel* m_panel;
+    DatabaseLayerPtr m_pDbLayer;
+    wxString         m_useDb;
+    wxString         m_sql;
+    bool             m_isSqlite;
+    SqlResultTable*  m_table;
+    int              m_generation;
+    volatile bool    m_cancelled;
+    std::set<int>    m_textCols;
+    std::set<int>    m_blobCols;
+
+public:
+    wxString m_errorMessage;
+
+protected:
+    bool IsBlobColumn(const wxString& str) const {
+        for(size_t i=0; i<str.Len(); i++) {
+            if(!wxIsprint(str.GetChar(i))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    wxString GetValue(DatabaseResultSet* pResultSet, int i) {
+        wxString value;
+        switch (pResultSet->GetMetaData()->GetColumnType(i)) {
+        case ResultSetMetaData::COLUMN_INTEGER:
+            if(m_isSqlite) {
+                value = pResultSet->GetResultString(i);
+
+            } else {
+                value = wxString::Format(wxT("%i"),pResultSet->GetResultInt(i));
+            }
+            break;
+
+        case ResultSetMetaData::COLUMN_STRING:
+            value =  pResultSet->GetResultString(i);
+            break;
+
+        case ResultSetMetaData::COLUMN_UNKNOWN:
+            value = pResultSet->GetResultString(i);
+            break;
+
+        case ResultSetMetaData::COLUMN_BLOB: {
+            if(m_textCols.find(i) != m_textCols.end()) {
+                // this column should be displayed as TEXT rather than BLOB
+                value = pResultSet->GetResultString(i);
+
+            } else if(m_blobCols.find(i) != m_blobCols.end()) {
+                // this column should be displayed as BLOB
+                wxMemoryBuffer buffer;
+                pResultSet->GetResultBlob(i, buffer);
+                value = wxString::Format(wxT("BLOB (Size:%u)"), buffer.GetDataLen());
+
+            } else {
+                // first time
+                wxString strCol = pResultSet->GetResultString(i);
+                if(IsBlobColumn(strCol)) {
+                    m_blobCols.insert(i);
+                    wxMemoryBuffer buffer;
+                    pResultSet->GetResultBlob(i, buffer);
+                    value = wxString::Format(wxT("BLOB (Size:%u)"), buffer.GetDataLen());
+
+                } else {
+                    m_textCols.insert(i);
+                    value = strCol;
+                }
+            }
+            break;
+        }
+        case ResultSetMetaData::COLUMN_BOOL:
+            value = wxString::Format(wxT("%b"),pResultSet->GetResultBool(i));
+            break;
+
+        case ResultSetMetaData::COLUMN_DATE: {
+            wxDateTime dt = pResultSet->GetResultDate(i);
+            if(dt.IsValid()) {
+                value = dt.Format();
+            } else {
+                value.Clear();
+            }
+        }
+        break;
+
+        case ResultSetMetaData::COLUMN_DOUBLE:
+            value = wxString::Format(wxT("%f"),pResultSet->GetResultDouble(i));
+            break;
+
+        case ResultSetMetaData::COLUMN_NULL:
+            value = wxT("NULL");
+            break;
+
+        default:
+            value = pResultSet->GetResultString(i);
+            break;
+        }
+        return value;
+    }
+
+    void Fetch(DatabaseResultSet* pResultSet) {
+        int cols = pResultSet->GetMetaData()->GetColumnCount();
+
+        // create table header
+        wxArrayString columns;
+        for (int i = 1; i<= cols; i++) {
+            columns.Add(pResultSet->GetMetaData()->GetColumnName(i));
+        }
+        m_table->SetColumns(columns);
+
+        // fill table data, let the panel know as soon as the first page is
+        // available and then a few times a second
+        wxStopWatch sw;
+        int rows = 0;
+        wxArrayString row;
+        row.Alloc(cols);
+        while (!m_cancelled && pResultSet->Next()) {
+            row.Clear();
+            for (int i = 1; i<= cols; i++) {
+                row.Add(GetValue(pResultSet, i));
+            }
+            m_table->AddRow(row);
+            ++rows;
+
+            if(rows == SqlResultTable::PAGE_SIZE || sw.Time() > 250) {
+                m_panel->CallAfter(&SQLCommandPanel::OnQueryProgress, m_generation);
+                sw.Start();
+            }
+        }
+    }
+
+public:
+    SqlQueryThread(SQLCommandPanel* panel, DatabaseLayerPtr pDbLayer, const wxString& useDb, const wxString& sql,
+                   bool isSqlite, SqlResultTable* table, int generation)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_panel(panel)
+        , m_pDbLayer(pDbLayer)
+        , m_useDb(useDb)
+        , m_sql(sql)
+        , m_isSqlite(isSqlite)
+        , m_table(table)
+        , m_generation(generation)
+        , m_cancelled(false)
+    {}
+
+    virtual ~SqlQueryThread() {}
+
+    void Cancel() {
+        m_cancelled = true;
+    }
+
+    virtual void* Entry() {
+        try {
+            if (!m_useDb.IsEmpty()) m_pDbLayer->RunQuery(m_useDb);
+            // run query
+            DatabaseResultSet* pResultSet = m_pDbLayer->RunQueryWithResults(m_sql);
+            if( !pResultSet ) {
+                m_errorMessage = _("Unknown SQL error.");
+
+            } else {
+                Fetch(pResultSet);
+                m_pDbLayer->CloseResultSet(pResultSet);
+            }
+
+        } catch (DatabaseLayerException& e) {
+            // for some reason an exception is thrown even if the error code is 0...
+            if(e.GetErrorCode() != 0) {
+                m_errorMessage = wxString::Format(_("Error (%d): %s"), e.GetErrorCode(), e.GetErrorMessage().c_str());
+            }
+
+        } catch( ... ) {
+            m_errorMessage = _("Unknown error.");
+        }
+
+        // Release the connection from this thread, the panel only
+        // joins us once it got our completion notification
+        m_pDbLayer.Reset(NULL);
+        m_panel->CallAfter(&SQLCommandPanel::OnQueryCompleted, m_generation);
+        return NULL;
+    }
+};
+
 BEGIN_EVENT_TABLE(SQLCommandPanel, _SqlCommandPanel)
     EVT_COMMAND(wxID_ANY, wxEVT_EXECUTE_SQL, SQLCommandPanel::OnExecuteSQL)
 END_EVENT_TABLE()
@@ -70,6 +261,12 @@ SQLCommandPanel::SQLCommandPanel(wxWindow *parent,IDbAdapter* dbAdapter,  const
     m_pDbAdapter = dbAdapter;
     m_dbName = dbName;
     m_dbTable = dbTable;
+    m_resultTable = NULL;
+    m_queryThread = NULL;
+    m_queryGeneration = 0;
+
+    // the results are read-only
+    m_gridTable->EnableEditing(false);
 
     wxTheApp->Connect(wxID_SELECTALL, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(SQLCommandPanel::OnEdit),   NULL, this);
     wxTheApp->Connect(wxID_COPY,      wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(SQLCommandPanel::OnEdit),   NULL, this);
@@ -92,6 +289,7 @@ SQLCommandPanel::SQLCommandPanel(wxWindow *parent,IDbAdapter* dbAdapter,  const
 
 SQLCommandPanel::~SQLCommandPanel()
 {
+    DoCancelQuery();
     wxTheApp->Disconnect(wxID_SELECTALL, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(SQLCommandPanel::OnEdit),   NULL, this);
     wxTheApp->Disconnect(wxID_COPY,      wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(SQLCommandPanel::OnEdit),   NULL, this);
     wxTheApp->Disconnect(wxID_PASTE,     wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(SQLCommandPanel::OnEdit),   NULL, this);
@@ -116,181 +314,94 @@ void SQLCommandPanel::OnScintilaKeyDown(wxKeyEvent& event)
 
 void SQLCommandPanel::ExecuteSql()
 {
-    wxBusyInfo infoDlg(_("Executing sql..."), wxTheApp->GetTopWindow());
-    
-    clWindowUpdateLocker locker(this);
-    std::set<int> textCols;
-    std::set<int> blobCols;
-    DatabaseLayerPtr m_pDbLayer = m_pDbAdapter->GetDatabaseLayer(m_dbName);
-    if (m_pDbLayer->IsOpen()) {
-        // test for empty command string
-        wxArrayString arrCmdLines = wxStringTokenize( m_scintillaSQL->GetText(), wxT("\n"), wxTOKEN_STRTOK );
-        int cmdLines = 0;
-        for( size_t i = 0; i < arrCmdLines.GetCount(); i++) {
-            if( ! arrCmdLines[i].Trim(false).StartsWith( wxT("--") ) ) cmdLines++;
-        }
-        
-        // save the history
-        SaveSqlHistory();
-        
-        if ( cmdLines > 0 ) {
-            try {
-                m_colsMetaData.clear();
-                if (!m_pDbAdapter->GetUseDb(m_dbName).IsEmpty()) m_pDbLayer->RunQuery(m_pDbAdapter->GetUseDb(m_dbName));
-                // run query
-                DatabaseResultSet* pResultSet = m_pDbLayer->RunQueryWithResults(m_scintillaSQL->GetText());
-
-                // clear variables
-                if(m_gridTable->GetNumberCols()) {
-                    m_gridTable->DeleteCols(0, m_gridTable->GetNumberCols());
-
-                }
+    // test for empty command string
+    wxArrayString arrCmdLines = wxStringTokenize( m_scintillaSQL->GetText(), wxT("\n"), wxTOKEN_STRTOK );
+    int cmdLines = 0;
+    for( size_t i = 0; i < arrCmdLines.GetCount(); i++) {
+        if( ! arrCmdLines[i].Trim(false).StartsWith( wxT("--") ) ) cmdLines++;
+    }
 
-                if(m_gridTable->GetNumberRows()) {
-                    m_gridTable->DeleteRows(0, m_gridTable->GetNumberRows());
-                }
+    // a query which is still fetching rows is replaced by the new one
+    DoCancelQuery();
 
-                m_gridValues.clear();
+    DatabaseLayerPtr pDbLayer = m_pDbAdapter->GetDatabaseLayer(m_dbName);
+    if (!pDbLayer->IsOpen()) {
+        wxMessageBox(_("Cant connect!"));
+        return;
+    }
 
-                if( !pResultSet ) {
-                    wxMessageBox( _("Unknown SQL error."), _("DB Error"), wxOK | wxICON_ERROR );
-                    return;
-                }
+    // save the history
+    SaveSqlHistory();
 
-                int rows = 0;
-                int cols = pResultSet->GetMetaData()->GetColumnCount();
-                m_colsMetaData.resize(cols);
-                
-                // create table header
-                m_gridTable->AppendCols(cols);
-                for (int i = 1; i<= pResultSet->GetMetaData()->GetColumnCount(); i++) {
-                    m_gridTable->SetColLabelValue(i-1,pResultSet->GetMetaData()->GetColumnName(i));
-                    m_colsMetaData.at(i-1) = ColumnInfo(pResultSet->GetMetaData()->GetColumnType(i), pResultSet->GetMetaData()->GetColumnName(i) );
-                }
+    if ( cmdLines == 0 ) {
+        return;
+    }
 
-                m_gridTable->BeginBatch();
-                // fill table data
-                while (pResultSet->Next()) {
-                    wxString value;
-                    m_gridTable->AppendRows();
-                    for (int i = 1; i<= pResultSet->GetMetaData()->GetColumnCount(); i++) {
-
-                        switch (pResultSet->GetMetaData()->GetColumnType(i)) {
-                        case ResultSetMetaData::COLUMN_INTEGER:
-                            if(m_pDbAdapter->GetAdapterType() == IDbAdapter::atSQLITE) {
-                                value = pResultSet->GetResultString(i);
-
-                            } else {
-                                value = wxString::Format(wxT("%i"),pResultSet->GetResultInt(i));
-                            }
-                            break;
-
-                        case ResultSetMetaData::COLUMN_STRING:
-                            value =  pResultSet->GetResultString(i);
-                            break;
-
-                        case ResultSetMetaData::COLUMN_UNKNOWN:
-                            value = pResultSet->GetResultString(i);
-                            break;
-
-                        case ResultSetMetaData::COLUMN_BLOB: {
-                            if(textCols.find(i) != textCols.end()) {
-                                // this column should be displayed as TEXT rather than BLOB
-                                value = pResultSet->GetResultString(i);
-
-                            } else if(blobCols.find(i) != blobCols.end()) {
-                                // this column should be displayed as BLOB
-                                wxMemoryBuffer buffer;
-                                pResultSet->GetResultBlob(i, buffer);
-                                value = wxString::Format(wxT("BLOB (Size:%u)"), buffer.GetDataLen());
-
-                            } else {
-                                // first time
-                                wxString strCol = pResultSet->GetResultString(i);
-                                if(IsBlobColumn(strCol)) {
-                                    blobCols.insert(i);
-                                    wxMemoryBuffer buffer;
-                                    pResultSet->GetResultBlob(i, buffer);
-                                    value = wxString::Format(wxT("BLOB (Size:%u)"), buffer.GetDataLen());
-
-                                } else {
-                                    textCols.insert(i);
-                                    value = strCol;
-                                }
-                            }
-                            break;
-                        }
-                        case ResultSetMetaData::COLUMN_BOOL:
-                            value = wxString::Format(wxT("%b"),pResultSet->GetResultBool(i));
-                            break;
-
-                        case ResultSetMetaData::COLUMN_DATE: {
-                            wxDateTime dt = pResultSet->GetResultDate(i);
-                            if(dt.IsValid()) {
-                                value = dt.Format();
-                            } else {
-                                value.Clear();
-                            }
-                        }
-                        break;
-
-                        case ResultSetMetaData::COLUMN_DOUBLE:
-                            value = wxString::Format(wxT("%f"),pResultSet->GetResultDouble(i));
-                            break;
-
-                        case ResultSetMetaData::COLUMN_NULL:
-                            value = wxT("NULL");
-                            break;
-
-                        default:
-                            value = pResultSet->GetResultString(i);
-                            break;
-                        }
-
-                        m_gridValues[std::make_pair(rows,  i-1)] = value;
-
-                        // truncate the string to a reasonable string
-                        if(value.Length() > 100) {
-                            value = value.Mid(0, 100);
-                            value.Append(wxT("..."));
-                        }
-
-                        // Convert all whitespace chars into visible ones
-                        value.Replace(wxT("\n"), wxT("\\n"));
-                        value.Replace(wxT("\r"), wxT("\\r"));
-                        value.Replace(wxT("\t"), wxT("\\t"));
-                        m_gridTable->SetCellValue(rows, i-1, value);
-                    }
-                    rows++;
-                }
+    // The grid takes ownership of the table and deletes the previous one
+    m_resultTable = new SqlResultTable();
+    m_gridTable->SetTable(m_resultTable, true);
+    m_gridTable->ForceRefresh();
+
+    m_labelStatus->SetLabel(_("Executing sql..."));
+    Layout();
+
+    m_queryThread = new SqlQueryThread(this,
+                                       pDbLayer,
+                                       m_pDbAdapter->GetUseDb(m_dbName),
+                                       m_scintillaSQL->GetText(),
+                                       m_pDbAdapter->GetAdapterType() == IDbAdapter::atSQLITE,
+                                       m_resultTable,
+                                       ++m_queryGeneration);
+    // The thread owns the connection from now on
+    pDbLayer.Reset(NULL);
+    if ( m_queryThread->Create() != wxTHREAD_NO_ERROR || m_queryThread->Run() != wxTHREAD_NO_ERROR ) {
+        // deleting the thread releases the connection
+        wxDELETE(m_queryThread);
+        m_labelStatus->SetLabel(_("Failed to start the query thread"));
+        Layout();
+        wxMessageBox(_("Failed to start the query thread"), _("DB Error"), wxOK | wxCENTER | wxICON_ERROR);
+    }
+}
 
-                m_gridTable->EndBatch();
+void SQLCommandPanel::DoCancelQuery()
+{
+    if ( m_queryThread ) {
+        // The statement itself can not be interrupted, but no more rows are fetched
+        m_queryThread->Cancel();
+        m_queryThread->Wait();
+        wxDELETE(m_queryThread);
+    }
+}
 
-                m_pDbLayer->CloseResultSet(pResultSet);
+void SQLCommandPanel::OnQueryProgress(int generation)
+{
+    if ( generation != m_queryGeneration || !m_resultTable )
+        return;
 
-                // show result status
-                m_labelStatus->SetLabel(wxString::Format(_("Result: %i rows"),rows));
-                Layout();
+    m_resultTable->SyncView();
+    m_labelStatus->SetLabel(wxString::Format(_("Fetching: %i rows"), m_resultTable->GetNumberRows()));
+    Layout();
+}
 
-                GetParent()->Layout();
+void SQLCommandPanel::OnQueryCompleted(int generation)
+{
+    if ( generation != m_queryGeneration || !m_queryThread )
+        return;
 
-            } catch (DatabaseLayerException& e) {
-                // for some reason an exception is thrown even if the error code is 0...
-                if(e.GetErrorCode() != 0) {
-                    wxString errorMessage = wxString::Format(_("Error (%d): %s"), e.GetErrorCode(), e.GetErrorMessage().c_str());
-                    wxMessageDialog dlg(this,errorMessage,_("DB Error"),wxOK | wxCENTER | wxICON_ERROR);
-                    dlg.ShowModal();
-                }
+    m_queryThread->Wait();
+    wxString errorMessage = m_queryThread->m_errorMessage;
+    wxDELETE(m_queryThread);
 
-            } catch( ... ) {
-                wxMessageDialog dlg(this,_("Unknown error."),_("DB Error"),wxOK | wxCENTER | wxICON_ERROR);
-                dlg.ShowModal();
+    m_resultTable->SyncView();
 
-            }
-        }
+    // show result status
+    m_labelStatus->SetLabel(wxString::Format(_("Result: %i rows"), m_resultTable->GetNumberRows()));
+    Layout();
+    GetParent()->Layout();
 
-    } else {
-        wxMessageBox(_("Cant connect!"));
+    if ( !errorMessage.IsEmpty() ) {
+        wxMessageDialog dlg(this,errorMessage,_("DB Error"),wxOK | wxCENTER | wxICON_ERROR);
+        dlg.ShowModal();
     }
 }
 
@@ -381,13 +492,10 @@ void SQLCommandPanel::OnGridCellRightClick(wxGridEvent& event)
 {
     event.Skip();
 
-    // Keep the current cell's value (taken from the map and NOT from the UI)
-    std::map<std::pair<int, int>, wxString >::const_iterator iter = m_gridValues.find(std::make_pair<int, int>(event.GetRow(), event.GetCol()));
-    if(iter == m_gridValues.end())
+    // Keep the current cell's value (taken from the table and NOT from the UI)
+    if(!m_resultTable || !m_resultTable->GetFullValue(event.GetRow(), event.GetCol(), m_cellValue))
         return;
 
-    m_cellValue = iter->second;
-
     wxMenu menu;
     menu.Append (XRCID("db_copy_cell_value"), _("Copy value to clipboard"));
     menu.Connect(XRCID("db_copy_cell_value"), wxEVT_COMMAND_MENU_SELECTED,  wxCommandEventHandler(SQLCommandPanel::OnCopyCellValue), NULL, this);
@@ -483,16 +591,6 @@ void SQLCommandPanel::OnGridLabelRightClick(wxGridEvent& event)
     event.Skip();
 }
 
-bool SQLCommandPanel::IsBlobColumn(const wxString &str)
-{
-    for(size_t i=0; i<str.Len(); i++) {
-        if(!wxIsprint(str.GetChar(i))) {
-            return true;
-        }
-    }
-    return false;
-}
-
 void SQLCommandPanel::SetDefaultSelect()
 {
     m_scintillaSQL->ClearAll();
@@ -40,39 +40,8 @@
 
 #include <map>
 
-// ----------------------------------------------------------------
-class ColumnInfo
-{
-    int m_type;
-    wxString m_name;
-public:
-    typedef std::vector<ColumnInfo> Vector_t;
-    
-public:
-    ColumnInfo()
-    {}
-
-    ColumnInfo(int type, const wxString &name)
-        : m_type(type)
-        , m_name(name)
-    {}
-
-    virtual ~ColumnInfo()
-    {}
-
-    void SetName(const wxString& name) {
-        this->m_name = name;
-    }
-    void SetType(int type) {
-        this->m_type = type;
-    }
-    const wxString& GetName() const {
-        return m_name;
-    }
-    int GetType() const {
-        return m_type;
-    }
-};
+class SqlResultTable;
+class SqlQueryThread;
 
 // ----------------------------------------------------------------
 class SQLCommandPanel : public _SqlCommandPanel
@@ -84,13 +53,14 @@ protected:
     wxString                                 m_dbName;
     wxString                                 m_dbTable;
     wxString                                 m_cellValue;
-    std::map<std::pair<int, int>, wxString > m_gridValues;
-    ColumnInfo::Vector_t                     m_colsMetaData;
+    SqlResultTable*                          m_resultTable;
+    SqlQueryThread*                          m_queryThread;
+    int                                      m_queryGeneration;
 
 protected:
-    bool IsBlobColumn(const wxString &str);
     wxArrayString ParseSql(const wxString &sql) const;
     void SaveSqlHistory();
+    void DoCancelQuery();
 
 public:
     SQLCommandPanel(wxWindow *parent,IDbAdapter* dbAdapter, const wxString& dbName,const wxString& dbTable);
@@ -108,6 +78,8 @@ public:
     void SetDefaultSelect();
 
     void OnGridCellRightClick(wxGridEvent& event);
+    void OnQueryProgress(int generation);
+    void OnQueryCompleted(int generation);
     void OnCopyCellValue(wxCommandEvent &e);
 
     virtual void OnGridLabelRightClick(wxGridEvent& event);
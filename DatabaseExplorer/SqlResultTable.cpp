@@ -0,0 +1,280 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : SqlResultTable.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+
+#include "SqlResultTable.h"
+#include <wx/filename.h>
+#include <wx/mstream.h>
+#include <wx/datstrm.h>
+#include <wx/log.h>
+
+SqlResultTable::SqlResultTable()
+    : m_rows(0)
+    , m_loadedPages(0)
+    , m_clock(0)
+    , m_spillFailed(false)
+    , m_gridRows(0)
+    , m_gridCols(0)
+{
+}
+
+SqlResultTable::~SqlResultTable()
+{
+    if(m_spill.IsOpened()) {
+        m_spill.Close();
+    }
+
+    if(!m_spillFile.IsEmpty()) {
+        wxLogNull noLog;
+        ::wxRemoveFile(m_spillFile);
+    }
+}
+
+void SqlResultTable::SetColumns(const wxArrayString& columns)
+{
+    wxCriticalSectionLocker locker(m_lock);
+    m_columns = columns;
+}
+
+void SqlResultTable::AddRow(const wxArrayString& row)
+{
+    wxCriticalSectionLocker locker(m_lock);
+    if(m_pages.empty() || m_pages.back().rows == PAGE_SIZE) {
+        m_pages.push_back(Page());
+        m_pages.back().cells.Alloc(PAGE_SIZE * m_columns.GetCount());
+        m_pages.back().lastUsed = ++m_clock;
+        ++m_loadedPages;
+        DoEvictPages();
+    }
+
+    Page& page = m_pages.back();
+    for(size_t i = 0; i < m_columns.GetCount(); ++i) {
+        page.cells.Add(i < row.GetCount() ? row.Item(i) : wxString());
+    }
+    ++page.rows;
+    ++m_rows;
+}
+
+int SqlResultTable::GetRowCount()
+{
+    wxCriticalSectionLocker locker(m_lock);
+    return m_rows;
+}
+
+void SqlResultTable::SyncView()
+{
+    int rows, cols;
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        rows = m_rows;
+        cols = (int)m_columns.GetCount();
+    }
+
+    wxGrid* grid = GetView();
+    if(cols > m_gridCols) {
+        int count = cols - m_gridCols;
+        m_gridCols = cols;
+        if(grid) {
+            wxGridTableMessage msg(this, wxGRIDTABLE_NOTIFY_COLS_APPENDED, count);
+            grid->ProcessTableMessage(msg);
+        }
+    }
+
+    if(rows > m_gridRows) {
+        int count = rows - m_gridRows;
+        m_gridRows = rows;
+        if(grid) {
+            wxGridTableMessage msg(this, wxGRIDTABLE_NOTIFY_ROWS_APPENDED, count);
+            grid->ProcessTableMessage(msg);
+        }
+    }
+}
+
+bool SqlResultTable::GetFullValue(int row, int col, wxString& value)
+{
+    wxCriticalSectionLocker locker(m_lock);
+    return DoGetCell(row, col, value);
+}
+
+int SqlResultTable::GetNumberRows()
+{
+    return m_gridRows;
+}
+
+int SqlResultTable::GetNumberCols()
+{
+    return m_gridCols;
+}
+
+wxString SqlResultTable::GetValue(int row, int col)
+{
+    wxString value;
+    if(!GetFullValue(row, col, value)) {
+        return wxEmptyString;
+    }
+
+    // truncate the string to a reasonable string
+    if(value.Length() > MAX_DISPLAY_LEN) {
+        value = value.Mid(0, MAX_DISPLAY_LEN);
+        value.Append(wxT("..."));
+    }
+
+    // Convert all whitespace chars into visible ones
+    value.Replace(wxT("\n"), wxT("\\n"));
+    value.Replace(wxT("\r"), wxT("\\r"));
+    value.Replace(wxT("\t"), wxT("\\t"));
+    return value;
+}
+
+void SqlResultTable::SetValue(int row, int col, const wxString& value)
+{
+    // The result set is read-only
+    wxUnusedVar(row);
+    wxUnusedVar(col);
+    wxUnusedVar(value);
+}
+
+bool SqlResultTable::IsEmptyCell(int row, int col)
+{
+    wxString value;
+    return !GetFullValue(row, col, value) || value.IsEmpty();
+}
+
+wxString SqlResultTable::GetColLabelValue(int col)
+{
+    wxCriticalSectionLocker locker(m_lock);
+    if(col < 0 || col >= (int)m_columns.GetCount()) {
+        return wxEmptyString;
+    }
+    return m_columns.Item(col);
+}
+
+bool SqlResultTable::DoGetCell(int row, int col, wxString& value)
+{
+    if(row < 0 || row >= m_rows || col < 0 || col >= (int)m_columns.GetCount()) {
+        return false;
+    }
+
+    Page& page = m_pages.at(row / PAGE_SIZE);
+    if(!page.loaded && !DoLoadPage(page)) {
+        return false;
+    }
+
+    page.lastUsed = ++m_clock;
+    // deep copy: the page strings must not share their buffer with the caller, the page
+    // may be evicted or reloaded by another thread once the lock is released
+    value = page.cells.Item((row % PAGE_SIZE) * m_columns.GetCount() + col).c_str();
+
+    // Loading a page may have pushed us over the limit
+    DoEvictPages();
+    return true;
+}
+
+void SqlResultTable::DoEvictPages()
+{
+    // The last page is still being filled by the worker thread, never evict it
+    while(m_loadedPages > MAX_CACHED_PAGES && !m_spillFailed) {
+        Page* victim = NULL;
+        for(size_t i = 0; i + 1 < m_pages.size(); ++i) {
+            if(m_pages.at(i).loaded && (!victim || m_pages.at(i).lastUsed < victim->lastUsed)) {
+                victim = &m_pages.at(i);
+            }
+        }
+
+        if(!victim) {
+            break;
+        }
+
+        // A page never changes once it is full, so it is written only once
+        if(victim->offset == wxInvalidOffset && !DoWritePage(*victim)) {
+            // keep everything in memory from now on
+            m_spillFailed = true;
+            break;
+        }
+
+        victim->cells.Clear();
+        victim->loaded = false;
+        --m_loadedPages;
+    }
+}
+
+bool SqlResultTable::DoWritePage(Page& page)
+{
+    wxLogNull noLog;
+    if(!m_spill.IsOpened()) {
+        m_spillFile = wxFileName::CreateTempFileName(wxT("dbe"));
+        if(m_spillFile.IsEmpty() || !m_spill.Open(m_spillFile, wxFile::read_write)) {
+            return false;
+        }
+    }
+
+    wxMemoryOutputStream mos;
+    wxDataOutputStream dos(mos);
+    dos.Write32(page.cells.GetCount());
+    for(size_t i = 0; i < page.cells.GetCount(); ++i) {
+        dos.WriteString(page.cells.Item(i));
+    }
+
+    size_t length = mos.GetSize();
+    wxMemoryBuffer buffer(length);
+    mos.CopyTo(buffer.GetWriteBuf(length), length);
+    buffer.UngetWriteBuf(length);
+
+    wxFileOffset offset = m_spill.SeekEnd();
+    if(offset == wxInvalidOffset || m_spill.Write(buffer.GetData(), length) != length) {
+        return false;
+    }
+
+    page.offset = offset;
+    page.length = length;
+    return true;
+}
+
+bool SqlResultTable::DoLoadPage(Page& page)
+{
+    wxLogNull noLog;
+    if(!m_spill.IsOpened() || page.offset == wxInvalidOffset) {
+        return false;
+    }
+
+    wxMemoryBuffer buffer(page.length);
+    if(m_spill.Seek(page.offset) == wxInvalidOffset ||
+       m_spill.Read(buffer.GetWriteBuf(page.length), page.length) != (ssize_t)page.length) {
+        return false;
+    }
+    buffer.UngetWriteBuf(page.length);
+
+    wxMemoryInputStream mis(buffer.GetData(), page.length);
+    wxDataInputStream dis(mis);
+    size_t count = dis.Read32();
+    page.cells.Alloc(count);
+    for(size_t i = 0; i < count; ++i) {
+        page.cells.Add(dis.ReadString());
+    }
+
+    page.loaded = true;
+    ++m_loadedPages;
+    return true;
+}
@@ -0,0 +1,122 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : SqlResultTable.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SQLRESULTTABLE_H
+#define SQLRESULTTABLE_H
+
+#include <wx/grid.h>
+#include <wx/file.h>
+#include <wx/thread.h>
+#include <vector>
+
+/**
+ * @class SqlResultTable
+ * @brief a virtual grid table which holds the rows of a query result.
+ *
+ * Rows are appended by the query worker thread and are kept in fixed
+ * size pages. Only MAX_CACHED_PAGES pages are kept in memory, the
+ * least recently used ones are written into a temporary file and read
+ * back when the grid scrolls to them. The grid itself only asks for
+ * the visible cells, so large result sets cost neither memory nor
+ * painting time.
+ */
+class SqlResultTable : public wxGridTableBase
+{
+public:
+    enum {
+        PAGE_SIZE        = 256,
+        MAX_CACHED_PAGES = 32,
+        MAX_DISPLAY_LEN  = 100,
+    };
+
+protected:
+    struct Page {
+        wxArrayString cells;    // PAGE_SIZE * columns cells, row by row
+        size_t        rows;
+        wxFileOffset  offset;   // offset in the spill file, wxInvalidOffset if never written
+        size_t        length;
+        unsigned long lastUsed;
+        bool          loaded;
+
+        Page()
+            : rows(0)
+            , offset(wxInvalidOffset)
+            , length(0)
+            , lastUsed(0)
+            , loaded(true)
+        {}
+    };
+
+    wxCriticalSection  m_lock;
+    wxArrayString      m_columns;
+    std::vector<Page>  m_pages;
+    int                m_rows;      // rows added by the worker thread
+    size_t             m_loadedPages;
+    unsigned long      m_clock;
+    wxFile             m_spill;
+    wxString           m_spillFile;
+    bool               m_spillFailed;
+
+    // What the grid currently knows about, main thread only
+    int                m_gridRows;
+    int                m_gridCols;
+
+protected:
+    bool DoWritePage(Page& page);
+    bool DoLoadPage(Page& page);
+    void DoEvictPages();
+    bool DoGetCell(int row, int col, wxString& value);
+
+public:
+    SqlResultTable();
+    virtual ~SqlResultTable();
+
+    // Worker thread API
+    void SetColumns(const wxArrayString& columns);
+    void AddRow(const wxArrayString& row);
+    int GetRowCount();
+
+    /**
+     * @brief tell the grid about the rows that were added since the last
+     * call. Must be called from the main thread
+     */
+    void SyncView();
+
+    /**
+     * @brief return the complete (untruncated) value of a cell
+     */
+    bool GetFullValue(int row, int col, wxString& value);
+
+    // wxGridTableBase
+    virtual int GetNumberRows();
+    virtual int GetNumberCols();
+    virtual wxString GetValue(int row, int col);
+    virtual void SetValue(int row, int col, const wxString& value);
+    virtual bool IsEmptyCell(int row, int col);
+    virtual wxString GetColLabelValue(int col);
+};
+
+#endif // SQLRESULTTABLE_H
@@ -201,6 +201,10 @@ static void CodeLiteBlockSigChild()
 //-------------------------------------------
 static void WaitForDebugger(int signo)
 {
+    // Make sure that the queued log lines make it to the disk. Flush() allocates and
+    // may block, which is not safe in a signal handler
+    FileLogger::Get()->FlushFromSignalHandler();
+
     wxString msg;
     wxString where;
 
@@ -697,6 +701,10 @@ int CodeLiteApp::OnExit()
     CL_DEBUG(wxT("Bye"));
     EditorConfigST::Free();
     ConfFileLocator::Release();
+
+    // Write the pending settings now, while the log is still open to report a failure
+    clConfig::Get().Flush();
+    FileLogger::Close();
     return 0;
 }
 
@@ -719,6 +727,7 @@ bool CodeLiteApp::CopySettings(const wxString& destDir, wxString& installPath)
 
 void CodeLiteApp::OnFatalException()
 {
+    FileLogger::Get()->Flush();
 #if wxUSE_STACKWALKER
     wxString startdir;
     startdir << clStandardPaths::Get().GetUserDataDir() << wxT("/crash.log");
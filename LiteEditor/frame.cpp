@@ -5193,8 +5193,14 @@ void clMainFrame::SelectBestEnvSet()
 void clMainFrame::OnClearTagsCache(wxCommandEvent& e)
 {
     e.Skip();
-    TagsManagerST::Get()->ClearTagsCache();
-    SetStatusMessage(_("Tags cache cleared"), 0);
+    if(e.GetString().IsEmpty()) {
+        TagsManagerST::Get()->ClearTagsCache();
+        SetStatusMessage(_("Tags cache cleared"), 0);
+
+    } else {
+        // a single file was re-tagged
+        TagsManagerST::Get()->ClearTagsCache(e.GetString());
+    }
 }
 
 void clMainFrame::OnUpdateNumberOfBuildProcesses(wxCommandEvent& e)
@@ -55,6 +55,10 @@
 #include "debugger.h"
 #include "cl_standard_paths.h"
 #include "new_build_tab.h"
+#include "event_notifier.h"
+#include "codelite_events.h"
+#include <wx/stopwatch.h>
+#include <wx/thread.h>
 
 PluginManager* PluginManager::Get()
 {
@@ -81,6 +85,14 @@ void PluginManager::UnLoad()
 
     m_dl.clear();
     m_plugins.clear();
+    m_deferredPlugins.clear();
+    EventNotifier::Get()->Disconnect(
+        wxEVT_FILE_LOADED, clCommandEventHandler(PluginManager::OnFileLoaded), NULL, this);
+    EventNotifier::Get()->Disconnect(
+        wxEVT_WORKSPACE_LOADED, wxCommandEventHandler(PluginManager::OnWorkspaceLoaded), NULL, this);
+    if(clMainFrame::Get()) {
+        clMainFrame::Get()->Disconnect(wxEVT_MENU_OPEN, wxMenuEventHandler(PluginManager::OnMenuOpen), NULL, this);
+    }
 }
 
 PluginManager::~PluginManager() {}
@@ -96,6 +108,46 @@ PluginManager::PluginManager()
     m_menusToBeHooked.insert(MenuTypeEditor);
 }
 
+/// Reads the plugins' shared objects so they are in the OS file cache by the time they are loaded.
+/// The libraries themselves are loaded on the main thread: running their static initialisers
+/// (event tables, XRCIDs) from several threads at once is not safe
+class PluginPrefetchThread : public wxThread
+{
+    wxArrayString m_files;
+
+public:
+    PluginPrefetchThread(const wxArrayString& files)
+        : wxThread(wxTHREAD_JOINABLE)
+    {
+        for(size_t i = 0; i < files.GetCount(); ++i) {
+            m_files.Add(files.Item(i).c_str());
+        }
+    }
+
+    virtual void* Entry()
+    {
+        char buffer[16 * 1024];
+        for(size_t i = 0; i < m_files.GetCount() && !TestDestroy(); ++i) {
+            FILE* fp = wxFopen(m_files.Item(i), wxT("rb"));
+            if(!fp) continue;
+            while(fread(buffer, 1, sizeof(buffer), fp) == sizeof(buffer)) {
+            }
+            fclose(fp);
+        }
+        return NULL;
+    }
+};
+
+static bool MatchesFileSpec(const wxString& filename, const wxString& fileSpec)
+{
+    wxString fullname = wxFileName(filename).GetFullName().Lower();
+    wxArrayString masks = ::wxStringTokenize(fileSpec.Lower(), wxT(";"), wxTOKEN_STRTOK);
+    for(size_t i = 0; i < masks.GetCount(); ++i) {
+        if(::wxMatchWild(masks.Item(i), fullname)) return true;
+    }
+    return false;
+}
+
 void PluginManager::Load()
 {
     wxString ext;
@@ -133,14 +185,14 @@ void PluginManager::Load()
     wxString pluginsDir = clStandardPaths::Get().GetPluginsDirectory();
     if(wxDir::Exists(pluginsDir)) {
         // get list of dlls
-        wxArrayString files;
-        wxDir::GetAllFiles(pluginsDir, &files, fileSpec, wxDIR_FILES);
+        wxArrayString allFiles, files;
+        wxDir::GetAllFiles(pluginsDir, &allFiles, fileSpec, wxDIR_FILES);
 
         // Sort the plugins by A-Z
-        std::sort(files.begin(), files.end());
-        for(size_t i = 0; i < files.GetCount(); i++) {
+        std::sort(allFiles.begin(), allFiles.end());
+        for(size_t i = 0; i < allFiles.GetCount(); i++) {
 
-            wxString fileName(files.Item(i));
+            wxString fileName(allFiles.Item(i));
 #if defined(__WXMSW__) && !defined(NDEBUG)
 
             // Under MSW loading a release plugin while in debug mode will cause a crash
@@ -154,6 +206,59 @@ void PluginManager::Load()
                 continue;
             }
 #endif
+            files.Add(fileName);
+        }
+
+        // Read the shared objects ahead of the loop below. Each thread starts at a different
+        // offset and walks the list in the same order as the main thread
+        std::vector<PluginPrefetchThread*> prefetchers;
+        size_t threadsCount = (size_t)wxMax(1, wxMin(wxThread::GetCPUCount(), 4));
+        for(size_t t = 0; t < threadsCount && t < files.GetCount(); ++t) {
+            wxArrayString chunk;
+            for(size_t i = t; i < files.GetCount(); i += threadsCount) {
+                chunk.Add(files.Item(i));
+            }
+            PluginPrefetchThread* thr = new PluginPrefetchThread(chunk);
+            if(thr->Create() == wxTHREAD_NO_ERROR && thr->Run() == wxTHREAD_NO_ERROR) {
+                prefetchers.push_back(thr);
+            } else {
+                delete thr;
+            }
+        }
+
+        // Load time per plugin (in ms), reported once all plugins are loaded
+        std::vector<std::pair<long, wxString> > report;
+        wxStopWatch swTotal;
+
+        for(size_t i = 0; i < files.GetCount(); i++) {
+
+            wxString fileName(files.Item(i));
+            wxString timestamp;
+            timestamp << wxFileName(fileName).GetModificationTime().GetTicks();
+            wxStopWatch sw;
+
+            // A plugin with activation triggers that did not change since the last run
+            // is not loaded at all until one of its triggers fires
+            const PluginInfo* knownPlugin = m_pluginsData.FindByLibrary(fileName);
+            if(knownPlugin && knownPlugin->IsLazy() && knownPlugin->GetLibraryTimestamp() == timestamp) {
+                wxString pname = knownPlugin->GetName();
+                pname.MakeLower().Trim().Trim(false);
+                if(pp == CodeLiteApp::PP_FromList && allowedPlugins.Index(pname) == wxNOT_FOUND) {
+                    continue;
+                }
+
+                if(!m_pluginsData.CanLoad(knownPlugin->GetName())) {
+                    CL_WARNING(wxT("Plugin ") + knownPlugin->GetName() + wxT(" is not enabled"));
+                    continue;
+                }
+
+                DeferredPlugin deferred;
+                deferred.info = *knownPlugin;
+                deferred.dl = NULL;
+                m_deferredPlugins.push_back(deferred);
+                report.push_back(std::make_pair(sw.Time(), knownPlugin->GetName() + wxT(" (deferred, not loaded)")));
+                continue;
+            }
 
             clDynamicLibrary* dl = new clDynamicLibrary();
             if(!dl->Load(fileName)) {
@@ -195,6 +300,7 @@ void PluginManager::Load()
 
             // Check if this dll can be loaded
             PluginInfo pluginInfo = pfnGetPluginInfo();
+            pluginInfo.SetLibrary(fileName, timestamp);
 
             wxString pname = pluginInfo.GetName();
             pname.MakeLower().Trim().Trim(false);
@@ -227,59 +333,189 @@ void PluginManager::Load()
                 continue;
             }
 
-            // Construct the plugin
-            IPlugin* plugin = pfn((IManager*)this);
-            CL_DEBUG(wxT("Loaded plugin: ") + plugin->GetLongName());
-            m_plugins[plugin->GetShortName()] = plugin;
-
-            // Load the toolbar
-            clToolBar* tb = plugin->CreateToolBar((wxWindow*)clMainFrame::Get());
-            if(tb) {
-#if USE_AUI_TOOLBAR
-                // When using AUI toolbars, use our own custom art-provider
-                tb->SetArtProvider(new CLMainAuiTBArt());
-#endif
-                clMainFrame::Get()->GetDockingManager().AddPane(tb,
-                                                                wxAuiPaneInfo()
-                                                                    .Name(plugin->GetShortName())
-                                                                    .LeftDockable(true)
-                                                                    .RightDockable(true)
-                                                                    .Caption(plugin->GetShortName())
-                                                                    .ToolbarPane()
-                                                                    .Top()
-                                                                    .Row(0));
-
-                // Add menu entry at the 'View->Toolbars' menu for this toolbar
-                wxMenuItem* item = clMainFrame::Get()->GetMenuBar()->FindItem(XRCID("toolbars_menu"));
-                if(item) {
-                    wxMenu* submenu = NULL;
-                    submenu = item->GetSubMenu();
-                    // add the new toolbar entry at the end of this menu
-
-                    int id = wxNewId();
-                    wxString text(plugin->GetShortName());
-                    text << _(" ToolBar");
-                    wxMenuItem* newItem = new wxMenuItem(submenu, id, text, wxEmptyString, wxITEM_CHECK);
-                    submenu->Append(newItem);
-                    clMainFrame::Get()->RegisterToolbar(id, plugin->GetShortName());
-                }
+            long loadTime = sw.Time();
+            if(pluginInfo.IsLazy()) {
+                // Keep the library loaded, the plugin is created when one of its triggers fires
+                DeferredPlugin deferred;
+                deferred.info = pluginInfo;
+                deferred.dl = dl;
+                m_deferredPlugins.push_back(deferred);
+                report.push_back(std::make_pair(loadTime, pluginInfo.GetName() + wxT(" (deferred)")));
+                continue;
             }
 
-            // Let the plugin plug its menu in the 'Plugins' menu at the menu bar
-            // the create menu will be placed as a sub menu of the 'Plugin' menu
-            wxMenu* pluginsMenu = NULL;
-            wxMenuItem* menuitem = clMainFrame::Get()->GetMenuBar()->FindItem(XRCID("manage_plugins"), &pluginsMenu);
-            if(menuitem && pluginsMenu) {
-                plugin->CreatePluginMenu(pluginsMenu);
-            }
+            // Construct the plugin
+            sw.Start();
+            DoCreatePlugin(pfn);
+            long createTime = sw.Time();
+            report.push_back(std::make_pair(
+                loadTime + createTime,
+                wxString::Format(wxT("%s (load: %ld ms, create: %ld ms)"), pluginInfo.GetName(), loadTime, createTime)));
 
             // Keep the dynamic load library
             m_dl.push_back(dl);
         }
+
+        for(size_t i = 0; i < prefetchers.size(); ++i) {
+            prefetchers.at(i)->Wait();
+            delete prefetchers.at(i);
+        }
+
         clMainFrame::Get()->GetDockingManager().Update();
 
         // save the plugins data
         conf.WriteItem(&m_pluginsData);
+
+        // Report where the startup time went, slowest first
+        std::sort(report.begin(), report.end());
+        CL_DEBUG("Loaded %u plugins in %ld ms (%u deferred)",
+                 (unsigned int)files.GetCount(),
+                 swTotal.Time(),
+                 (unsigned int)m_deferredPlugins.size());
+        std::vector<std::pair<long, wxString> >::reverse_iterator iter = report.rbegin();
+        for(; iter != report.rend(); ++iter) {
+            CL_DEBUG("    %5ld ms %s", iter->first, iter->second);
+        }
+
+        if(!m_deferredPlugins.empty()) {
+            EventNotifier::Get()->Connect(
+                wxEVT_FILE_LOADED, clCommandEventHandler(PluginManager::OnFileLoaded), NULL, this);
+            EventNotifier::Get()->Connect(
+                wxEVT_WORKSPACE_LOADED, wxCommandEventHandler(PluginManager::OnWorkspaceLoaded), NULL, this);
+            clMainFrame::Get()->Connect(wxEVT_MENU_OPEN, wxMenuEventHandler(PluginManager::OnMenuOpen), NULL, this);
+        }
+    }
+}
+
+void PluginManager::DoCreatePlugin(GET_PLUGIN_CREATE_FUNC pfn)
+{
+    // Construct the plugin
+    IPlugin* plugin = pfn((IManager*)this);
+    CL_DEBUG(wxT("Loaded plugin: ") + plugin->GetLongName());
+    m_plugins[plugin->GetShortName()] = plugin;
+
+    // Load the toolbar
+    clToolBar* tb = plugin->CreateToolBar((wxWindow*)clMainFrame::Get());
+    if(tb) {
+#if USE_AUI_TOOLBAR
+        // When using AUI toolbars, use our own custom art-provider
+        tb->SetArtProvider(new CLMainAuiTBArt());
+#endif
+        clMainFrame::Get()->GetDockingManager().AddPane(tb,
+                                                        wxAuiPaneInfo()
+                                                            .Name(plugin->GetShortName())
+                                                            .LeftDockable(true)
+                                                            .RightDockable(true)
+                                                            .Caption(plugin->GetShortName())
+                                                            .ToolbarPane()
+                                                            .Top()
+                                                            .Row(0));
+
+        // Add menu entry at the 'View->Toolbars' menu for this toolbar
+        wxMenuItem* item = clMainFrame::Get()->GetMenuBar()->FindItem(XRCID("toolbars_menu"));
+        if(item) {
+            wxMenu* submenu = NULL;
+            submenu = item->GetSubMenu();
+            // add the new toolbar entry at the end of this menu
+
+            int id = wxNewId();
+            wxString text(plugin->GetShortName());
+            text << _(" ToolBar");
+            wxMenuItem* newItem = new wxMenuItem(submenu, id, text, wxEmptyString, wxITEM_CHECK);
+            submenu->Append(newItem);
+            clMainFrame::Get()->RegisterToolbar(id, plugin->GetShortName());
+        }
+    }
+
+    // Let the plugin plug its menu in the 'Plugins' menu at the menu bar
+    // the create menu will be placed as a sub menu of the 'Plugin' menu
+    wxMenu* pluginsMenu = NULL;
+    wxMenuItem* menuitem = clMainFrame::Get()->GetMenuBar()->FindItem(XRCID("manage_plugins"), &pluginsMenu);
+    if(menuitem && pluginsMenu) {
+        plugin->CreatePluginMenu(pluginsMenu);
+    }
+}
+
+bool PluginManager::DoActivatePlugin(const DeferredPlugin& deferred)
+{
+    wxStopWatch sw;
+    const wxString& fileName = deferred.info.GetLibraryFile();
+    clDynamicLibrary* dl = deferred.dl;
+    if(!dl) {
+        dl = new clDynamicLibrary();
+        if(!dl->Load(fileName)) {
+            CL_ERROR(wxT("Failed to load plugin's dll: ") + fileName);
+            if(!dl->GetError().IsEmpty()) {
+                CL_ERROR(dl->GetError());
+            }
+            delete dl;
+            return false;
+        }
+
+        // The library was not checked during startup
+        bool success(false);
+        GET_PLUGIN_INTERFACE_VERSION_FUNC pfnInterfaceVersion =
+            (GET_PLUGIN_INTERFACE_VERSION_FUNC)dl->GetSymbol(wxT("GetPluginInterfaceVersion"), &success);
+        if(!success || pfnInterfaceVersion() != PLUGIN_INTERFACE_VERSION) {
+            CL_WARNING(wxT("Version interface mismatch error for plugin: ") + fileName);
+            delete dl;
+            return false;
+        }
+    }
+
+    bool success(false);
+    GET_PLUGIN_CREATE_FUNC pfn = (GET_PLUGIN_CREATE_FUNC)dl->GetSymbol(wxT("CreatePlugin"), &success);
+    if(!success) {
+        CL_WARNING(wxT("Failed to find CreatePlugin() in dll: ") + fileName);
+        delete dl;
+        return false;
+    }
+
+    DoCreatePlugin(pfn);
+    m_dl.push_back(dl);
+    clMainFrame::Get()->GetDockingManager().Update();
+    CL_DEBUG("Activated plugin %s in %ld ms", deferred.info.GetName(), sw.Time());
+    return true;
+}
+
+void PluginManager::DoActivatePlugins(const wxString& fileName, const wxString& workspaceFile, bool pluginsMenu)
+{
+    size_t i = 0;
+    while(i < m_deferredPlugins.size()) {
+        const PluginInfo& info = m_deferredPlugins.at(i).info;
+        bool activate = (pluginsMenu && info.IsActivateOnMenu()) ||
+                        (!fileName.IsEmpty() && MatchesFileSpec(fileName, info.GetActivateOnFiles())) ||
+                        (!workspaceFile.IsEmpty() && MatchesFileSpec(workspaceFile, info.GetActivateOnWorkspace()));
+        if(!activate) {
+            ++i;
+            continue;
+        }
+
+        DeferredPlugin deferred = m_deferredPlugins.at(i);
+        m_deferredPlugins.erase(m_deferredPlugins.begin() + i);
+        DoActivatePlugin(deferred);
+    }
+}
+
+void PluginManager::OnFileLoaded(clCommandEvent& event)
+{
+    event.Skip();
+    DoActivatePlugins(event.GetFileName(), wxEmptyString, false);
+}
+
+void PluginManager::OnWorkspaceLoaded(wxCommandEvent& event)
+{
+    event.Skip();
+    DoActivatePlugins(wxEmptyString, event.GetString(), false);
+}
+
+void PluginManager::OnMenuOpen(wxMenuEvent& event)
+{
+    event.Skip();
+    wxMenu* pluginsMenu = NULL;
+    wxMenuItem* menuitem = clMainFrame::Get()->GetMenuBar()->FindItem(XRCID("manage_plugins"), &pluginsMenu);
+    if(menuitem && pluginsMenu && event.GetMenu() == pluginsMenu) {
+        DoActivatePlugins(wxEmptyString, wxEmptyString, true);
     }
 }
 
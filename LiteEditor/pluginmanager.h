@@ -38,6 +38,8 @@
 #include <set>
 #include <map>
 #include "plugindata.h"
+#include "cl_command_event.h"
+#include <wx/event.h>
 
 class wxBookCtrlBase;
 class EnvironmentConfig;
@@ -46,8 +48,15 @@ class BuildSettingsConfig;
 class BuildManager;
 class BitmapLoader;
 
-class PluginManager : public IManager
+class PluginManager : public wxEvtHandler, public IManager
 {
+    // A plugin that declared activation triggers and was not created yet
+    struct DeferredPlugin {
+        PluginInfo info;
+        clDynamicLibrary* dl; // NULL if the shared object was not loaded yet
+    };
+    typedef std::vector<DeferredPlugin> DeferredPluginVec_t;
+
     std::map<wxString, IPlugin*> m_plugins;
     std::list<clDynamicLibrary*> m_dl;
     PluginInfoArray m_pluginsData;
@@ -55,11 +64,27 @@ class PluginManager : public IManager
     BitmapLoader* m_bmpLoader;
     std::set<MenuType> m_menusToBeHooked;
     std::map<wxString, wxString> m_backticks;
+    DeferredPluginVec_t m_deferredPlugins;
 
 private:
     PluginManager();
     virtual ~PluginManager();
 
+    /**
+     * @brief construct the plugin and add its toolbar and menu
+     */
+    void DoCreatePlugin(GET_PLUGIN_CREATE_FUNC pfn);
+
+    /**
+     * @brief create the deferred plugins whose triggers match. Empty arguments do not match anything
+     */
+    void DoActivatePlugins(const wxString& fileName, const wxString& workspaceFile, bool pluginsMenu);
+    bool DoActivatePlugin(const DeferredPlugin& deferred);
+
+    void OnFileLoaded(clCommandEvent& event);
+    void OnWorkspaceLoaded(wxCommandEvent& event);
+    void OnMenuOpen(wxMenuEvent& event);
+
 public:
     static PluginManager* Get();
 
@@ -29,7 +29,7 @@ public:
      * @param settings reference to global plugin setting, each processor uses what part it needs
      */
     IMemCheckProcessor(MemCheckSettings * const settings): m_settings(settings),
-        m_outputLogFileName(wxEmptyString), m_errorList() {
+        m_outputLogFileName(wxEmptyString), m_errorList(), m_frames() {
     };
     
     virtual ~IMemCheckProcessor() {}
@@ -38,6 +38,7 @@ protected:
     MemCheckSettings * m_settings;
     wxString m_outputLogFileName;
     ErrorList m_errorList;
+    MemCheckFramePool m_frames; ///< stack frames the locations of m_errorList point to, cleared with the list
 
 public:
     /**
@@ -73,6 +74,20 @@ public:
      * @brief Processes data from external tool (log file) to ErrorList.
      */
     virtual bool Process(const wxString & outputLogFileName = wxEmptyString) = 0;
+
+    /**
+     * @brief Prepares incremental processing of the log which is about to be written by external tool.
+     *
+     * Called just before the tool is launched, GetExecutionCommand must be called first (it names the log file).
+     */
+    virtual void StartIncremental() = 0;
+
+    /**
+     * @brief Processes part of the log written so far. It is called periodically while external tool runs, so when
+     * the tool finishes Process() has only the tail of the log to parse.
+     * @return false if log is broken
+     */
+    virtual bool ProcessIncremental() = 0;
 };
 
 #endif //_IMEMCHECKPROCESSOR_H_
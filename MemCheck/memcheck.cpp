@@ -51,12 +51,14 @@ extern "C" EXPORT int GetPluginInterfaceVersion() { return PLUGIN_INTERFACE_VERS
 BEGIN_EVENT_TABLE(MemCheckPlugin, wxEvtHandler)
 EVT_COMMAND(wxID_ANY, wxEVT_PROC_DATA_READ, MemCheckPlugin::OnProcessOutput)
 EVT_COMMAND(wxID_ANY, wxEVT_PROC_TERMINATED, MemCheckPlugin::OnProcessTerminated)
+EVT_TIMER(wxID_ANY, MemCheckPlugin::OnIncrementalTimer)
 END_EVENT_TABLE()
 
 MemCheckPlugin::MemCheckPlugin(IManager* manager)
     : IPlugin(manager)
     , m_memcheckProcessor(NULL)
     , m_process(NULL)
+    , m_incrementalTimer(this)
 {
     // CL_DEBUG1(PLUGIN_PREFIX("MemCheckPlugin constructor"));
     m_longName = wxT("Detects memory management problems. Uses Valgrind - memcheck skin.");
@@ -503,7 +505,15 @@ void MemCheckPlugin::CheckProject(const wxString& projectName)
     m_mgr->AppendOutputTabText(kOutputTab_Output,
                                wxString() << "MemCheck command: " << m_memcheckProcessor->GetExecutionCommand(command)
                                           << "\n");
+
+    // errors of previous run are going to be released, view must not refer them any more
+    m_memcheckProcessor->StartIncremental();
+    m_outputView->LoadErrors();
+
     m_process = ::CreateAsyncProcess(this, m_memcheckProcessor->GetExecutionCommand(command));
+    if(m_process) {
+        m_incrementalTimer.Start(MEMCHECK_INCREMENTAL_INTERVAL);
+    }
 }
 
 void MemCheckPlugin::OnImportLog(wxCommandEvent& event)
@@ -564,6 +574,7 @@ void MemCheckPlugin::OnProcessTerminated(wxCommandEvent& event)
     ProcessEventData* ped = (ProcessEventData*)event.GetClientData();
     wxDELETE(ped);
     wxDELETE(m_process);
+    m_incrementalTimer.Stop();
 
     m_mgr->AppendOutputTabText(kOutputTab_Output, _("\n-- MemCheck process completed\n"));
     wxWindowDisabler disableAll;
@@ -575,6 +586,17 @@ void MemCheckPlugin::OnProcessTerminated(wxCommandEvent& event)
     SwitchToMyPage();
 }
 
+void MemCheckPlugin::OnIncrementalTimer(wxTimerEvent& event)
+{
+    if(!m_process)
+        return;
+
+    if(!m_memcheckProcessor->ProcessIncremental()) {
+        CL_WARNING(PLUGIN_PREFIX("Output log can't be processed while test is running."));
+        m_incrementalTimer.Stop();
+    }
+}
+
 void MemCheckPlugin::OnStopProcess(wxCommandEvent& event)
 {
     wxUnusedVar(event);
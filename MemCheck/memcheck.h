@@ -9,6 +9,7 @@
 #define _MEMCHECK_H_
 
 #include <wx/process.h>
+#include <wx/timer.h>
 
 #include "plugin.h"
 
@@ -64,6 +65,7 @@ protected:
     IMemCheckProcessor* m_memcheckProcessor;
     MemCheckSettings* m_settings;
     IProcess* m_process;              ///< Test is run as external tool.
+    wxTimer m_incrementalTimer;       ///< While test runs, log is processed periodically.
     MemCheckOutputView* m_outputView; ///< Main plugin UI pane.
 
     void OnWorkspaceLoaded(wxCommandEvent& event);
@@ -113,6 +115,12 @@ protected:
     void OnProcessOutput(wxCommandEvent& event);
     void OnProcessTerminated(wxCommandEvent& event);
 
+    /**
+     * @brief Processes log written so far, so there is less work when test ends.
+     * @param event
+     */
+    void OnIncrementalTimer(wxTimerEvent& event);
+
     /**
      * @brief Analyse can be made independent of CodeLite and log can be load from file.
      * @param event
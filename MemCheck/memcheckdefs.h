@@ -16,5 +16,6 @@
 #define FILTER_NONWORKSPACE_PLACEHOLDER "<nonworkspace_errors>"
 #define WAIT_UPDATE_PER_ITEMS 1000
 #define ITEMS_FOR_WAIT_DIALOG 5000
+#define MEMCHECK_INCREMENTAL_INTERVAL 500 // ms, how often log is processed while test runs
 
 #endif
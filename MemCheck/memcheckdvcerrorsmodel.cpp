@@ -166,6 +166,13 @@ wxDataViewItem MemCheckDVCErrorsModel::AppendItem(const wxDataViewItem &parent,
     return ch;
 }
 
+wxDataViewItem MemCheckDVCErrorsModel::AppendContainer(const wxDataViewItem &parent, const wxVector<wxVariant>& data, wxClientData *clientData)
+{
+    wxDataViewItem ch = DoAppendItem(parent, data, true, clientData);
+    ItemAdded(parent, ch);
+    return ch;
+}
+
 wxDataViewItemArray MemCheckDVCErrorsModel::AppendItems(const wxDataViewItem &parent, const wxVector<wxVector<wxVariant> >& data)
 {
     wxDataViewItemArray items;
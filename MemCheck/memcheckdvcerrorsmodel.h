@@ -203,6 +203,12 @@ public:
      */
     virtual wxDataViewItem AppendItem(const wxDataViewItem& parent, const wxVector<wxVariant>& data, wxClientData *clientData = NULL);
 
+    /**
+     * @brief Append a container to the model. Its children can be added later (e.g. when the item is expanded)
+     * clientData will be owned by the model once added
+     */
+    virtual wxDataViewItem AppendContainer(const wxDataViewItem& parent, const wxVector<wxVariant>& data, wxClientData *clientData = NULL);
+
     /**
      * @brief Append a lines to the model
      */
@@ -9,9 +9,20 @@
 
 #include "memcheckerror.h"
 
+bool MemCheckFrame::operator<(const MemCheckFrame & other) const
+{
+    if (line != other.line) return line < other.line;
+    int cmp = func.Cmp(other.func);
+    if (cmp != 0) return cmp < 0;
+    cmp = file.Cmp(other.file);
+    if (cmp != 0) return cmp < 0;
+    return obj.Cmp(other.obj) < 0;
+}
+
 bool MemCheckErrorLocation::operator==(const MemCheckErrorLocation & other) const
 {
-    return func == other.func && file == other.file && line == other.line;
+    if (frame == other.frame) return true;
+    return frame->func == other.frame->func && frame->file == other.frame->file && frame->line == other.frame->line;
 }
 
 bool MemCheckErrorLocation::operator!=(const MemCheckErrorLocation & other) const
@@ -21,19 +32,19 @@ bool MemCheckErrorLocation::operator!=(const MemCheckErrorLocation & other) cons
 
 const wxString MemCheckErrorLocation::toString() const
 {
-    return wxString::Format(wxT("%s\t%s\t%i\t%s"), func, file, line, obj);
+    return wxString::Format(wxT("%s\t%s\t%i\t%s"), frame->func, frame->file, frame->line, frame->obj);
 }
 
 const wxString MemCheckErrorLocation::toText(const wxString & workspacePath) const
 {
-    return wxString::Format(wxT("%s   ( %s: %i )"), func, getFile(workspacePath), line);
+    return wxString::Format(wxT("%s   ( %s: %i )"), frame->func, getFile(workspacePath), frame->line);
 }
 
 const wxString MemCheckErrorLocation::getFile(const wxString & workspacePath) const
 {
     wxString localPath;
-    if (workspacePath.IsEmpty() || !file.StartsWith(workspacePath, &localPath)) {
-        return file;
+    if (workspacePath.IsEmpty() || !frame->file.StartsWith(workspacePath, &localPath)) {
+        return frame->file;
     } else {
         return localPath;
     }
@@ -42,8 +53,8 @@ const wxString MemCheckErrorLocation::getFile(const wxString & workspacePath) co
 const wxString MemCheckErrorLocation::getObj(const wxString & workspacePath) const
 {
     wxString localPath;
-    if (workspacePath.IsEmpty() || !obj.StartsWith(workspacePath, &localPath)) {
-        return obj;
+    if (workspacePath.IsEmpty() || !frame->obj.StartsWith(workspacePath, &localPath)) {
+        return frame->obj;
     } else {
         return localPath;
     }
@@ -51,12 +62,12 @@ const wxString MemCheckErrorLocation::getObj(const wxString & workspacePath) con
 
 const bool MemCheckErrorLocation::isOutOfWorkspace(const wxString & workspacePath) const
 {
-    return !file.StartsWith(workspacePath);
+    return !frame->file.StartsWith(workspacePath);
 }
 
 
 
-MemCheckError::MemCheckError(): suppressed(false) {}
+MemCheckError::MemCheckError(): suppressed(false), count(1) {}
 
 const wxString MemCheckError::toString() const
 {
@@ -113,7 +124,7 @@ const wxString MemCheckError::getSuppression()
 const bool MemCheckError::hasPath(const wxString & path) const
 {
     for (LocationList::const_iterator it = locations.begin(); it != locations.end(); ++it)
-        if (it->file.StartsWith(path)) return true;
+        if (it->frame->file.StartsWith(path)) return true;
     for (ErrorList::const_iterator it = nestedErrors.begin(); it != nestedErrors.end(); ++it)
         if (it->hasPath(path)) return true;
     return false;
@@ -15,12 +15,15 @@
 #include <wx/tokenzr.h>
 
 #include <list>
+#include <set>
 
 #include "memcheckdefs.h"
 
+struct MemCheckFrame;
 class MemCheckErrorLocation;
 class MemCheckError;
 
+typedef std::set<MemCheckFrame> MemCheckFramePool;
 typedef std::list<MemCheckErrorLocation> LocationList;
 typedef std::list<MemCheckError> ErrorList;
 typedef MemCheckError* MemCheckErrorPtr;
@@ -59,11 +62,30 @@ public:
 };
 
 
+/**
+ * @class MemCheckFrame
+ * @brief One stack frame (function, file, line and object file).
+ *
+ * Frames are deduplicated in a MemCheckFramePool owned by the processor, all locations of all errors which show the
+ * same frame point to one record. The pool lives as long as the error list.
+ */
+struct MemCheckFrame {
+    MemCheckFrame() : line(-1) {}
+    bool operator<(const MemCheckFrame & other) const;
+
+    wxString func;
+    wxString file;
+    int line;
+    wxString obj;
+};
+
 /**
  * @class MemCheckErrorLocation
  * @brief Represents on record from error stacktrace.
  */
 struct MemCheckErrorLocation {
+    MemCheckErrorLocation(const MemCheckFrame * frame = NULL) : frame(frame) {}
+
     bool operator==(const MemCheckErrorLocation & other) const;
     bool operator!=(const MemCheckErrorLocation & other) const;
     
@@ -102,10 +124,7 @@ struct MemCheckErrorLocation {
      */
     const bool isOutOfWorkspace(const wxString & workspacePath) const;
 
-    wxString func;
-    wxString file;
-    int line;
-    wxString obj;
+    const MemCheckFrame * frame; ///< record in the processor's frame pool
 };
 
 
@@ -153,6 +172,7 @@ struct MemCheckError {
 
     Type type;
     bool suppressed;
+    unsigned int count; ///< how many times the same error (same label and stack trace) was reported
     wxString label;
     wxString suppression;
     LocationList locations;
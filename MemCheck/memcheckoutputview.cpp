@@ -55,6 +55,10 @@ MemCheckOutputView::MemCheckOutputView(wxWindow* parent, MemCheckPlugin* plugin,
                           wxUpdateUIEventHandler(MemCheckOutputView::OnSuppPanelUI),
                           NULL,
                           this);
+    m_dataViewCtrlErrors->Connect(wxEVT_COMMAND_DATAVIEW_ITEM_EXPANDING,
+                                  wxDataViewEventHandler(MemCheckOutputView::OnItemExpanding),
+                                  NULL,
+                                  this);
 }
 
 MemCheckOutputView::~MemCheckOutputView()
@@ -79,6 +83,10 @@ MemCheckOutputView::~MemCheckOutputView()
                              wxUpdateUIEventHandler(MemCheckOutputView::OnSuppPanelUI),
                              NULL,
                              this);
+    m_dataViewCtrlErrors->Disconnect(wxEVT_COMMAND_DATAVIEW_ITEM_EXPANDING,
+                                     wxDataViewEventHandler(MemCheckOutputView::OnItemExpanding),
+                                     NULL,
+                                     this);
 }
 
 void MemCheckOutputView::LoadErrors()
@@ -108,13 +116,7 @@ void MemCheckOutputView::ResetItemsView()
 {
     ErrorList& errorList = m_plugin->GetProcessor()->GetErrors();
 
-    unsigned int flags = 0;
-    if(m_plugin->GetSettings()->GetOmitNonWorkspace())
-        flags |= MC_IT_OMIT_NONWORKSPACE;
-    if(m_plugin->GetSettings()->GetOmitDuplications())
-        flags |= MC_IT_OMIT_DUPLICATIONS;
-    if(m_plugin->GetSettings()->GetOmitSuppressed())
-        flags |= MC_IT_OMIT_SUPPRESSED;
+    unsigned int flags = GetIterFlags();
 
     m_totalErrorsView = 0;
     for(MemCheckIterTools::ErrorListIterator it = MemCheckIterTools::Factory(errorList, m_workspacePath, flags);
@@ -174,6 +176,7 @@ void MemCheckOutputView::ShowPageView(size_t page)
     m_currentItem = wxDataViewItem(0);
     m_onValueChangedLocked = false;
     m_markedErrorsCount = 0;
+    m_lazyErrors.clear();
     m_dataViewCtrlErrorsModel->Clear();
 
     if(m_totalErrorsView == 0)
@@ -193,13 +196,7 @@ void MemCheckOutputView::ShowPageView(size_t page)
     wxBusyInfo wait(wxT(BUSY_MESSAGE));
     m_mgr->GetTheApp()->Yield();
 
-    unsigned int flags = 0;
-    if(m_plugin->GetSettings()->GetOmitNonWorkspace())
-        flags |= MC_IT_OMIT_NONWORKSPACE;
-    if(m_plugin->GetSettings()->GetOmitDuplications())
-        flags |= MC_IT_OMIT_DUPLICATIONS;
-    if(m_plugin->GetSettings()->GetOmitSuppressed())
-        flags |= MC_IT_OMIT_SUPPRESSED;
+    unsigned int flags = GetIterFlags();
     size_t i = 0;
     MemCheckIterTools::ErrorListIterator it = MemCheckIterTools::Factory(errorList, m_workspacePath, flags);
     for(; i < iStart && it != errorList.end(); ++i, ++it)
@@ -217,59 +214,103 @@ void MemCheckOutputView::ShowPageView(size_t page)
     }
 }
 
-void MemCheckOutputView::AddTree(const wxDataViewItem& parentItem, MemCheckError& error)
+void MemCheckOutputView::AddTree(const wxDataViewItem& parentItem, MemCheckError& error, bool checked)
 {
     // CL_DEBUG1(PLUGIN_PREFIX("error #\t'%s'", error.label));
 
     wxVariant variantBitmap;
     variantBitmap << wxXmlResource::Get()->LoadBitmap(wxT("memcheck_transparent"));
 
+    wxString label = error.label;
+    if(error.count > 1)
+        label << wxString::Format(wxT("  (%u times)"), error.count);
+
     wxVector<wxVariant> cols;
     cols.push_back(variantBitmap);
-    cols.push_back(wxVariant(false));
+    cols.push_back(wxVariant(checked));
     cols.push_back(MemCheckDVCErrorsModel::CreateIconTextVariant(
-        error.label,
+        label,
         (error.type == MemCheckError::TYPE_AUXILIARY ? wxXmlResource::Get()->LoadBitmap(wxT("memcheck_auxiliary")) :
                                                        wxXmlResource::Get()->LoadBitmap(wxT("memcheck_error")))));
     cols.push_back(wxString());
     cols.push_back(wxString());
     cols.push_back(wxString());
-    wxDataViewItem errorItem =
+
+    // nested errors and locations are added when the item is expanded for the first time
+    bool hasChildren = !error.nestedErrors.empty() ||
+                       MemCheckIterTools::Factory(error.locations, m_workspacePath, GetIterFlags()) !=
+                           error.locations.end();
+    if(!hasChildren) {
         m_dataViewCtrlErrorsModel->AppendItem(parentItem, cols, new MemCheckErrorReferrer(error));
+        return;
+    }
+
+    wxDataViewItem errorItem =
+        m_dataViewCtrlErrorsModel->AppendContainer(parentItem, cols, new MemCheckErrorReferrer(error));
+    m_lazyErrors[errorItem.GetID()] = &error;
+}
+
+void MemCheckOutputView::AddChildren(const wxDataViewItem& errorItem)
+{
+    std::map<void*, MemCheckError*>::iterator lazy = m_lazyErrors.find(errorItem.GetID());
+    if(lazy == m_lazyErrors.end())
+        return; // already added
+    MemCheckError& error = *(lazy->second);
+    m_lazyErrors.erase(lazy);
+
+    // children inherit mark of the error, it could be (un)checked before it was expanded
+    wxVariant variantChecked;
+    m_dataViewCtrlErrorsModel->GetValue(variantChecked, errorItem, GetColumnByName(wxT("Suppress")));
+    bool checked = variantChecked.GetBool();
 
     for(ErrorList::iterator it = error.nestedErrors.begin(); it != error.nestedErrors.end(); ++it) {
-        AddTree(errorItem, *it);
+        AddTree(errorItem, *it, checked);
     }
 
-    unsigned int flags = 0;
-    if(m_plugin->GetSettings()->GetOmitNonWorkspace())
-        flags |= MC_IT_OMIT_NONWORKSPACE;
-    if(m_plugin->GetSettings()->GetOmitDuplications())
-        flags |= MC_IT_OMIT_DUPLICATIONS;
-    if(m_plugin->GetSettings()->GetOmitSuppressed())
-        flags |= MC_IT_OMIT_SUPPRESSED;
-
+    wxVariant variantBitmap;
+    variantBitmap << wxXmlResource::Get()->LoadBitmap(wxT("memcheck_transparent"));
     wxBitmap bmpLocation = wxXmlResource::Get()->LoadBitmap(wxT("memcheck_location"));
-    MemCheckIterTools::LocationListIterator it = MemCheckIterTools::Factory(error.locations, m_workspacePath, flags);
+
+    wxVector<wxVariant> cols;
+    MemCheckIterTools::LocationListIterator it =
+        MemCheckIterTools::Factory(error.locations, m_workspacePath, GetIterFlags());
     for(; it != error.locations.end(); ++it) {
         MemCheckErrorLocation& location = *it;
         cols.clear();
         cols.push_back(variantBitmap);
-        cols.push_back(wxVariant(false));
-        cols.push_back(MemCheckDVCErrorsModel::CreateIconTextVariant(location.func, bmpLocation));
+        cols.push_back(wxVariant(checked));
+        cols.push_back(MemCheckDVCErrorsModel::CreateIconTextVariant(location.frame->func, bmpLocation));
         cols.push_back(wxVariant(location.getFile(m_workspacePath)));
 
         wxString strLine;
-        strLine << location.line;
+        strLine << location.frame->line;
         cols.push_back(strLine);
         cols.push_back(wxVariant(location.getObj(m_workspacePath)));
         m_dataViewCtrlErrorsModel->AppendItem(
             errorItem,
             cols,
-            ((location.line > 0 && !location.file.IsEmpty()) ? new MemCheckErrorLocationReferrer(location) : NULL));
+            ((location.frame->line > 0 && !location.frame->file.IsEmpty()) ? new MemCheckErrorLocationReferrer(location) : NULL));
     }
 }
 
+unsigned int MemCheckOutputView::GetIterFlags()
+{
+    unsigned int flags = 0;
+    if(m_plugin->GetSettings()->GetOmitNonWorkspace())
+        flags |= MC_IT_OMIT_NONWORKSPACE;
+    if(m_plugin->GetSettings()->GetOmitDuplications())
+        flags |= MC_IT_OMIT_DUPLICATIONS;
+    if(m_plugin->GetSettings()->GetOmitSuppressed())
+        flags |= MC_IT_OMIT_SUPPRESSED;
+    return flags;
+}
+
+void MemCheckOutputView::OnItemExpanding(wxDataViewEvent& event)
+{
+    AddChildren(event.GetItem());
+    event.Skip();
+}
+
 void MemCheckOutputView::OnPageFirst(wxCommandEvent& event) { ShowPageView(1); }
 
 void MemCheckOutputView::OnPagePrev(wxCommandEvent& event) { ShowPageView(m_currentPage - 1); }
@@ -303,7 +344,7 @@ void MemCheckOutputView::JumpToLocation(const wxDataViewItem& item)
     if(!locationRef)
         return;
 
-    int line = locationRef->Get().line - 1;
+    int line = locationRef->Get().frame->line - 1;
     wxString fileName = locationRef->Get().getFile();
 
     if(line < 0 || fileName.IsEmpty())
@@ -344,6 +385,7 @@ wxDataViewItem MemCheckOutputView::GetLeaf(const wxDataViewItem& item, bool firs
     // CL_DEBUG1(PLUGIN_PREFIX("MemCheckOutputView::GetLeaf()"));
 
     if(m_dataViewCtrlErrorsModel->IsContainer(item)) {
+        AddChildren(item);
         m_dataViewCtrlErrors->Expand(item);
         wxDataViewItemArray subItems;
         m_dataViewCtrlErrorsModel->GetChildren(item, subItems);
@@ -366,6 +408,8 @@ void MemCheckOutputView::ExpandAll(const wxDataViewItem& item)
 {
     // CL_DEBUG1(PLUGIN_PREFIX("MemCheckOutputView::ExpandAll()"));
 
+    if(item.IsOk())
+        AddChildren(item);
     m_dataViewCtrlErrors->Expand(item);
     wxDataViewItemArray subItems;
     m_dataViewCtrlErrorsModel->GetChildren(item, subItems);
@@ -10,6 +10,7 @@
 
 #include <wx/valnum.h>
 #include <wx/tipwin.h>
+#include <map>
 
 #include "memcheck.h"
 #include "memcheckui.h"
@@ -109,7 +110,11 @@ protected:
     unsigned int GetColumnByName(const wxString & name); ///< Finds index of an wxDVC column by its caption
     void JumpToLocation(const wxDataViewItem &item); ///< Opens file specifieed in particular ErrorLocation in editor
     void ShowPageView(size_t page); ///< Item could be more than is good for wxDVC. So paging is implementetd. This method fills wxDVC with portion of errors.
-    void AddTree(const wxDataViewItem & parentItem, MemCheckError & error); ///< Adds one error and all its location into wxDVC as tree
+    void AddTree(const wxDataViewItem & parentItem, MemCheckError & error, bool checked = false); ///< Adds one error into wxDVC, its nested errors and locations are added on first expand
+    void AddChildren(const wxDataViewItem & errorItem); ///< Adds nested errors and locations of an error item if they were not added yet
+    unsigned int GetIterFlags(); ///< MemCheckIterTools flags according to settings
+    void OnItemExpanding(wxDataViewEvent & event); ///< Children of error are created when it is expanded
+    std::map<void *, MemCheckError *> m_lazyErrors; ///< Error items on current page whose children were not added yet
     void OnJumpToLocation(wxCommandEvent & event); ///< Callback from wxDVC popupmenu
     void OnUnmarkAllErrors(wxCommandEvent & event); ///< Callback from wxDVC popupmenu
     void OnSuppressError(wxCommandEvent & event); ///< Callback from wxDVC popupmenu
@@ -7,16 +7,26 @@
 
 #include <wx/textfile.h>
 #include <wx/stdpaths.h>
+#include <wx/ffile.h>
+#include <wx/mstream.h>
+#include <vector>
 
 #include "file_logger.h"
+#include "fileutils.h"
 #include "workspace.h"
 
 #include "memcheckdefs.h"
 #include "valgrindprocessor.h"
 #include "memchecksettings.h"
 
+#define VALGRIND_READ_CHUNK (64 * 1024)
+#define VALGRIND_INCREMENTAL_MAX (4 * 1024 * 1024)
+#define VALGRIND_ROOT "<valgrindoutput>"
+#define VALGRIND_ERROR_BEGIN "<error>"
+#define VALGRIND_ERROR_END "</error>"
 
-ValgrindMemcheckProcessor::ValgrindMemcheckProcessor(MemCheckSettings * const settings): IMemCheckProcessor(settings)
+ValgrindMemcheckProcessor::ValgrindMemcheckProcessor(MemCheckSettings * const settings): IMemCheckProcessor(settings),
+    m_incremental(false), m_offset(0), m_rootFound(false)
 {
     //CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor created"));
 }
@@ -71,34 +81,150 @@ bool ValgrindMemcheckProcessor::Process(const wxString & outputLogFileName)
 {
     //CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::Process()"));
 
-    if (!outputLogFileName.IsEmpty())
+    if (!outputLogFileName.IsEmpty()) {
         m_outputLogFileName = outputLogFileName;
+        m_incremental = false;
+    }
 
     CL_DEBUG(PLUGIN_PREFIX("Processing file '%s'", m_outputLogFileName));
 
-    wxXmlDocument doc;
-    if (!doc.Load(m_outputLogFileName) || doc.GetRoot()->GetName() != wxT("valgrindoutput")) {
+    // continue where incremental processing stopped, otherwise start from scratch
+    if (!m_incremental)
+        ResetStream();
+    m_incremental = false;
+
+    bool ok = wxFileName::FileExists(m_outputLogFileName) && ProcessStream(0, true) && m_rootFound;
+
+    // lookup structures are needed only while reading
+    m_buffer.clear();
+    m_signatures.clear();
+
+    if (!ok) {
         CL_WARNING("Error while loading file '%s'", m_outputLogFileName);
         return false;
     }
+
+    CL_DEBUG(PLUGIN_PREFIX("%lu unique errors found", (unsigned long)m_errorList.size()));
+    return true;
+}
+
+void ValgrindMemcheckProcessor::StartIncremental()
+{
+    ResetStream();
+    if (wxFileName::FileExists(m_outputLogFileName))
+        wxRemoveFile(m_outputLogFileName);
+    m_incremental = true;
+}
+
+bool ValgrindMemcheckProcessor::ProcessIncremental()
+{
+    if (!m_incremental || !wxFileName::FileExists(m_outputLogFileName))
+        return true; // nothing to do or Valgrind did not create the log yet
+
+    // limit work done at once, UI must stay responsive while test runs
+    if (!ProcessStream(VALGRIND_INCREMENTAL_MAX, false)) {
+        m_incremental = false; // Process() will start again from the beginning and report the problem
+        return false;
+    }
+    return true;
+}
+
+void ValgrindMemcheckProcessor::ResetStream()
+{
     m_errorList.clear();
+    m_frames.clear();
+    m_signatures.clear();
+    m_buffer.clear();
+    m_offset = 0;
+    m_rootFound = false;
+}
 
+bool ValgrindMemcheckProcessor::ProcessStream(size_t maxBytes, bool yield)
+{
+    wxFFile fp(m_outputLogFileName, wxT("rb"));
+    if (!fp.IsOpened() || (m_offset > 0 && !fp.Seek(m_offset)))
+        return false;
+
+    const size_t beginLen = strlen(VALGRIND_ERROR_BEGIN);
+    const size_t endLen = strlen(VALGRIND_ERROR_END);
+    std::vector<char> chunk(VALGRIND_READ_CHUNK);
+    size_t total = 0;
     int i = 0;
-    wxXmlNode *errorNode = doc.GetRoot()->GetChildren();
-    while (errorNode) {
-        if (errorNode->GetName() == wxT("error")) {
-            m_errorList.push_back(ProcessError(doc, errorNode));
+
+    while (maxBytes == 0 || total < maxBytes) {
+        size_t bytes = fp.Read(&chunk[0], chunk.size());
+        if (bytes == 0)
+            break;
+        m_offset += bytes;
+        total += bytes;
+        m_buffer.append(&chunk[0], bytes);
+
+        if (!m_rootFound) {
+            size_t pos = m_buffer.find(VALGRIND_ROOT);
+            if (pos == std::string::npos) {
+                // root element is at the very beginning of the log, do not read whole file looking for it
+                if (m_buffer.length() > VALGRIND_READ_CHUNK)
+                    return false;
+                continue;
+            }
+            m_rootFound = true;
+            m_buffer.erase(0, pos + strlen(VALGRIND_ROOT));
         }
-        errorNode = errorNode->GetNext();
-
-        if (i < 1000)
-            i++;
-        else {
-            i = 0;
-            //ATTN  m_mgr->GetTheApp()
-            wxTheApp->Yield();
+
+        size_t start = 0;
+        while (true) {
+            size_t begin = m_buffer.find(VALGRIND_ERROR_BEGIN, start);
+            if (begin == std::string::npos) {
+                // keep the tail, opening tag could be split between two chunks
+                if (m_buffer.length() > start + beginLen)
+                    start = m_buffer.length() - beginLen;
+                break;
+            }
+            size_t end = m_buffer.find(VALGRIND_ERROR_END, begin + beginLen);
+            if (end == std::string::npos) {
+                start = begin; // incomplete element, wait for more data
+                break;
+            }
+            end += endLen;
+            if (!ProcessErrorElement(m_buffer.data() + begin, end - begin))
+                return false;
+            start = end;
+
+            if (yield && ++i >= 1000) {
+                i = 0;
+                //ATTN  m_mgr->GetTheApp()
+                wxTheApp->Yield();
+            }
+        }
+        m_buffer.erase(0, start);
+    }
+    return true;
+}
+
+bool ValgrindMemcheckProcessor::ProcessErrorElement(const char * data, size_t len)
+{
+    wxMemoryInputStream stream(data, len);
+    wxXmlDocument doc;
+    if (!doc.Load(stream, wxT("UTF-8")) || !doc.GetRoot())
+        return false;
+
+    MemCheckError error = ProcessError(doc, doc.GetRoot());
+
+    // merge with the same error reported before (same label and same stack traces)
+    wxString signature = error.toString();
+    wxUint64 hash = FileUtils::Hash64(signature);
+
+    std::pair<SignatureMap_t::iterator, SignatureMap_t::iterator> range = m_signatures.equal_range(hash);
+    for (; range.first != range.second; ++range.first) {
+        MemCheckError & other = *(range.first->second);
+        if (other.toString() == signature) {
+            ++other.count;
+            return true;
         }
     }
+
+    m_errorList.push_back(error);
+    m_signatures.insert(std::make_pair(hash, --m_errorList.end()));
     return true;
 }
 
@@ -177,8 +303,7 @@ MemCheckErrorLocation ValgrindMemcheckProcessor::ProcessLocation(wxXmlDocument &
 {
     //CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::ProcessLocation()"));
 
-    MemCheckErrorLocation result;
-    result.line = -1;
+    MemCheckFrame result;
     wxString file;
     wxString dir;
 
@@ -206,5 +331,5 @@ MemCheckErrorLocation ValgrindMemcheckProcessor::ProcessLocation(wxXmlDocument &
     result.file = dir + file;
 
     //TODO ? add checkout ?
-    return result;
+    return MemCheckErrorLocation(&(*m_frames.insert(result).first));
 }
@@ -9,6 +9,8 @@
 #define _VALGRINDPROCESSOR_H_
 
 #include <wx/xml/xml.h>
+#include <map>
+#include <string>
 #include "imemcheckprocessor.h"
 
 /**
@@ -16,6 +18,10 @@
  * @brief Implementation of valgrind's memcheck tool parser
  *
  * Settings for this parset is implemented in global settings. It could be moved here or to own file.
+ *
+ * Log is not loaded as whole document. It is read by chunks and only one <error> element at a time is turned to
+ * wxXmlDocument, so even huge logs of long runs fit to memory. Same errors are merged (MemCheckError::count) and
+ * stack frames are stored once in the frame pool, locations of all errors point to the shared records.
  */
 class ValgrindMemcheckProcessor:public IMemCheckProcessor
 {
@@ -48,11 +54,50 @@ public:
      * @param outputLogFileName
      * @return 
      *
-     * Loads Valgrind's xml log to wxXmlDocument, and goes trought nodes
+     * Reads Valgrind's xml log error by error. If incremental processing was started, only the rest of log is read.
      */
     virtual bool Process(const wxString & outputLogFileName = wxEmptyString);
 
+    /**
+     * @brief interface implementation
+     *
+     * Clears errors and removes old log, so stale content is not read before Valgrind rewrites the file.
+     */
+    virtual void StartIncremental();
+
+    /**
+     * @brief interface implementation
+     * @return false if log is broken
+     */
+    virtual bool ProcessIncremental();
+
 protected:
+    typedef std::multimap<wxUint64, ErrorList::iterator> SignatureMap_t;
+
+    bool m_incremental;           ///< incremental processing is running, Process() continues from m_offset
+    wxFileOffset m_offset;        ///< how many bytes of log were already read
+    std::string m_buffer;         ///< bytes read but not processed yet (incomplete <error> element)
+    bool m_rootFound;             ///< <valgrindoutput> was seen
+    SignatureMap_t m_signatures;  ///< errors by hash of their stack signature, used to merge same errors
+
+    /**
+     * @brief clears errors and all the state of reading
+     */
+    void ResetStream();
+
+    /**
+     * @brief reads new data from the log and processes all complete errors
+     * @param maxBytes stop after reading this amount of data, 0 means read to the end of file
+     * @param yield whether to yield UI (only when it is not called from timer)
+     * @return false if log is broken
+     */
+    bool ProcessStream(size_t maxBytes, bool yield);
+
+    /**
+     * @brief parses one <error> element and adds it to error list or increments count of the same error
+     */
+    bool ProcessErrorElement(const char * data, size_t len);
+
     /**
      * @brief creates one MemCheckError object
      * @param doc whole log document
@@ -67,7 +112,7 @@ protected:
      * @brief creates one MemCheckErrorLocation object
      * @param doc whole log document
      * @param locationNode reference to current processed node in that doc file
-     * @return MemCheckErrorLocation object
+     * @return MemCheckErrorLocation object pointing to the pooled frame
      */
     MemCheckErrorLocation ProcessLocation(wxXmlDocument & doc, wxXmlNode * locationNode);
 };
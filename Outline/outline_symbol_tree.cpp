@@ -247,17 +247,16 @@ void svSymbolTree::BuildTree(const wxFileName& fn)
     if ( TagsManagerST::Get()->AreTheSame(newTags, m_currentTags) )
         return;
     
+    // The same file is still displayed: apply only the changes to the existing items
+    // instead of rebuilding the whole tree (which also collapses it)
+    if ( UpdateTree(fn, &newTags) ) {
+        DoRequestIncludeFiles(fn);
+        return;
+    }
+    
     wxWindowUpdateLocker locker(this);
     SymbolTree::BuildTree(fn, &newTags);
-    
-    // Request from the parsing thread list of include files
-    ++m_uid;
-    
-    ParseRequest *req = new ParseRequest(this);
-    req->setFile(fn.GetFullPath());
-    req->setType(ParseRequest::PR_PARSE_INCLUDE_STATEMENTS);
-    req->_uid = m_uid; // Identifies this request
-    ParseThreadST::Get()->Add( req );
+    DoRequestIncludeFiles(fn);
     
     wxTreeItemId root = GetRootItem();
     if( root.IsOk() && ItemHasChildren(root) ) {
@@ -270,6 +269,18 @@ void svSymbolTree::BuildTree(const wxFileName& fn)
     }
 }
 
+void svSymbolTree::DoRequestIncludeFiles(const wxFileName& fn)
+{
+    // Request from the parsing thread list of include files
+    ++m_uid;
+    
+    ParseRequest *req = new ParseRequest(this);
+    req->setFile(fn.GetFullPath());
+    req->setType(ParseRequest::PR_PARSE_INCLUDE_STATEMENTS);
+    req->_uid = m_uid; // Identifies this request
+    ParseThreadST::Get()->Add( req );
+}
+
 wxTreeItemId svSymbolTree::DoAddIncludeFiles(const wxFileName& fn, const fcFileOpener::List_t& includes)
 {
     wxTreeItemId root = GetRootItem();
@@ -284,6 +295,10 @@ wxTreeItemId svSymbolTree::DoAddIncludeFiles(const wxFileName& fn, const fcFileO
 
             // Dont add duplicate items
             if ( GetItemText(child) == INCLUDE_FILES_NODE_TEXT) {
+                if ( IsSameIncludeFiles(child, includes) ) {
+                    // Nothing has changed, keep the current node
+                    return wxTreeItemId();
+                }
                 Delete(child);
                 break;
             }
@@ -311,6 +326,22 @@ wxTreeItemId svSymbolTree::DoAddIncludeFiles(const wxFileName& fn, const fcFileO
     return item;
 }
 
+bool svSymbolTree::IsSameIncludeFiles(const wxTreeItemId& item, const fcFileOpener::List_t& includes)
+{
+    if ( GetChildrenCount(item, false) != includes.size() )
+        return false;
+
+    wxTreeItemIdValue cookie;
+    wxTreeItemId child = GetFirstChild(item, cookie);
+    fcFileOpener::List_t::const_iterator iter = includes.begin();
+    for(; iter != includes.end() && child.IsOk(); ++iter) {
+        if ( GetItemText(child) != wxString(*iter) )
+            return false;
+        child = GetNextChild(item, cookie);
+    }
+    return true;
+}
+
 bool svSymbolTree::IsSelectedItemIncludeFile()
 {
     wxTreeItemId item = GetSelection();
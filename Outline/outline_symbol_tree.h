@@ -78,6 +78,8 @@ protected:
     bool DoItemActivated(wxTreeItemId item, wxEvent &event, bool notify);
     void FindAndSelect(IEditor *editor, wxString &pattern, const wxString &name);
     wxTreeItemId DoAddIncludeFiles(const wxFileName &fn, const fcFileOpener::List_t& includes);
+    void DoRequestIncludeFiles(const wxFileName &fn);
+    bool IsSameIncludeFiles(const wxTreeItemId& item, const fcFileOpener::List_t& includes);
 
     wxTreeItemId TryGetPrevItem(wxTreeItemId item);
 
@@ -0,0 +1,400 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : main.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+// Checks that clDTL::Diff (dtl over interned line IDs, common prefix matched up front)
+// returns exactly what the previous implementation (dtl over the wxString lines)
+// returned. The corpus is a set of generated file pairs plus, optionally, the pairs
+// found in a directory given on the command line: <name>.left / <name>.right
+//
+// Usage: DTLTest [corpus-dir]
+
+#include "clDTL.h"
+#include "dtl/dtl.hpp"
+#include <wx/init.h>
+#include <wx/ffile.h>
+#include <wx/dir.h>
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+#include <wx/stopwatch.h>
+#include <wx/crt.h>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// The previous clDTL::Diff, kept verbatim as the reference
+//----------------------------------------------------------------------------
+static void ReferenceDiff(const wxFileName& fnLeft,
+                          const wxFileName& fnRight,
+                          clDTL::DiffMode mode,
+                          clDTL::LineInfoVec_t& m_resultLeft,
+                          clDTL::LineInfoVec_t& m_resultRight,
+                          clDTL::SeqLinePair_t& m_sequences)
+{
+    wxString leftFile, rightFile;
+
+    {
+        wxFFile fp1(fnLeft.GetFullPath(), "rb");
+        wxFFile fp2(fnRight.GetFullPath(), "rb");
+
+        if ( !fp1.IsOpened() || !fp2.IsOpened() )
+            return;
+
+        // Read the file content
+        fp1.ReadAll(&leftFile);
+        fp2.ReadAll(&rightFile);
+    }
+
+    m_resultLeft.clear();
+    m_resultRight.clear();
+    m_sequences.clear();
+
+    typedef wxString elem;
+    typedef std::pair<elem, dtl::elemInfo> sesElem;
+
+    wxArrayString leftLines = wxStringTokenize(leftFile, "\n", wxTOKEN_RET_DELIMS);
+    wxArrayString rightLines = wxStringTokenize(rightFile, "\n", wxTOKEN_RET_DELIMS);
+
+    std::vector<elem> leftLinesVec;
+    std::vector<elem> rightLinesVec;
+    leftLinesVec.insert(leftLinesVec.end(), leftLines.begin(), leftLines.end());
+    rightLinesVec.insert(rightLinesVec.end(), rightLines.begin(), rightLines.end());
+
+    dtl::Diff<elem, std::vector<elem> > diff(leftLinesVec, rightLinesVec);
+    diff.onHuge();
+    diff.compose();
+
+    if ( 0 == diff.getEditDistance() ) {
+        // nothing to be done - files are identical
+        return;
+    }
+
+    const int LINE_COMMON  = clDTL::LINE_COMMON;
+    const int LINE_ADDED   = clDTL::LINE_ADDED;
+    const int LINE_REMOVED = clDTL::LINE_REMOVED;
+
+    if ( mode & clDTL::kTwoPanes ) {
+        std::vector<sesElem> seq = diff.getSes().getSequence();
+        m_resultLeft.reserve( seq.size() );
+        m_resultRight.reserve( seq.size() );
+
+        const int STATE_NONE   = 0;
+        const int STATE_IN_SEQ = 1;
+
+        int state = STATE_NONE;
+        int seqStartLine = wxNOT_FOUND;
+        size_t seqSize      = 0;
+
+        clDTL::LineInfoVec_t tmpSeqLeft;
+        clDTL::LineInfoVec_t tmpSeqRight;
+
+        for(size_t i=0; i<seq.size(); ++i) {
+            switch(seq.at(i).second.type) {
+            case dtl::SES_COMMON: {
+                if ( state == STATE_IN_SEQ ) {
+                    seqSize = ::wxMax(tmpSeqLeft.size(), tmpSeqRight.size() );
+
+                    m_sequences.push_back( std::make_pair(seqStartLine, seqStartLine + seqSize) );
+                    seqStartLine = wxNOT_FOUND;
+                    state = STATE_NONE;
+
+                    tmpSeqLeft.resize(seqSize);
+                    tmpSeqRight.resize(seqSize);
+
+                    m_resultLeft.insert(m_resultLeft.end(), tmpSeqLeft.begin(), tmpSeqLeft.end());
+                    m_resultRight.insert(m_resultRight.end(), tmpSeqRight.begin(), tmpSeqRight.end());
+
+                    tmpSeqLeft.clear();
+                    tmpSeqRight.clear();
+                    seqSize = 0;
+                }
+                clDTL::LineInfo line(seq.at(i).first, LINE_COMMON);
+                m_resultLeft.push_back( line );
+                m_resultRight.push_back( line );
+                break;
+
+            }
+            case dtl::SES_ADD: {
+                clDTL::LineInfo lineRight(seq.at(i).first, LINE_ADDED);
+                tmpSeqRight.push_back( lineRight );
+
+                if ( state == STATE_NONE ) {
+                    seqStartLine = m_resultLeft.size();
+                    state = STATE_IN_SEQ;
+                }
+                break;
+
+            }
+            case dtl::SES_DELETE: {
+                clDTL::LineInfo lineLeft(seq.at(i).first, LINE_REMOVED);
+                tmpSeqLeft.push_back( lineLeft );
+
+                if ( state == STATE_NONE ) {
+                    seqStartLine = m_resultLeft.size();
+                    state = STATE_IN_SEQ;
+                }
+                break;
+            }
+            }
+        }
+
+        if ( state == STATE_IN_SEQ ) {
+            seqSize = ::wxMax(tmpSeqLeft.size(), tmpSeqRight.size() );
+            if ( seqSize ) {
+                m_sequences.push_back( std::make_pair(seqStartLine, seqStartLine + seqSize) );
+                tmpSeqLeft.resize(seqSize);
+                tmpSeqRight.resize(seqSize);
+
+                m_resultLeft.insert(m_resultLeft.end(), tmpSeqLeft.begin(), tmpSeqLeft.end());
+                m_resultRight.insert(m_resultRight.end(), tmpSeqRight.begin(), tmpSeqRight.end());
+            }
+        }
+    } else {
+        std::vector<sesElem> seq = diff.getSes().getSequence();
+        m_resultLeft.reserve( seq.size() );
+        int seqStartLine = wxNOT_FOUND;
+        for(size_t i=0; i<seq.size(); ++i) {
+            switch(seq.at(i).second.type) {
+            case dtl::SES_COMMON: {
+                if ( seqStartLine != wxNOT_FOUND ) {
+                    m_sequences.push_back( std::make_pair(seqStartLine, m_resultLeft.size()) );
+                    seqStartLine = wxNOT_FOUND;
+                }
+                clDTL::LineInfo line(seq.at(i).first, LINE_COMMON);
+                m_resultLeft.push_back( line );
+                break;
+            }
+            case dtl::SES_ADD: {
+                if ( seqStartLine == wxNOT_FOUND ) {
+                    seqStartLine = m_resultLeft.size();
+                }
+                clDTL::LineInfo line(seq.at(i).first, LINE_ADDED);
+                m_resultLeft.push_back( line );
+                break;
+
+            }
+            case dtl::SES_DELETE: {
+                if ( seqStartLine == wxNOT_FOUND ) {
+                    seqStartLine = m_resultLeft.size();
+                }
+                clDTL::LineInfo line(seq.at(i).first, LINE_REMOVED);
+                m_resultLeft.push_back( line );
+                break;
+            }
+            }
+        }
+
+        if ( seqStartLine != wxNOT_FOUND ) {
+            m_sequences.push_back( std::make_pair(seqStartLine, m_resultLeft.size()) );
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Comparison
+//----------------------------------------------------------------------------
+static bool IsSame(const clDTL::LineInfoVec_t& expected, const clDTL::LineInfoVec_t& actual, wxString& err)
+{
+    if ( expected.size() != actual.size() ) {
+        err << "result size " << actual.size() << ", expected " << expected.size();
+        return false;
+    }
+    for(size_t i=0; i<expected.size(); ++i) {
+        if ( expected.at(i).m_type != actual.at(i).m_type || expected.at(i).m_line != actual.at(i).m_line ) {
+            err << "line " << i << " differs";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool CheckPair(const wxFileName& left, const wxFileName& right, wxString& err)
+{
+    static const clDTL::DiffMode modes[] = { clDTL::kTwoPanes, clDTL::kOnePane };
+    for(size_t m=0; m<sizeof(modes)/sizeof(modes[0]); ++m) {
+        clDTL::LineInfoVec_t expLeft, expRight;
+        clDTL::SeqLinePair_t expSeq;
+        ReferenceDiff(left, right, modes[m], expLeft, expRight, expSeq);
+
+        clDTL d;
+        d.Diff(left, right, modes[m]);
+
+        wxString where = (modes[m] == clDTL::kTwoPanes) ? "two panes, " : "one pane, ";
+        wxString msg;
+        if ( !IsSame(expLeft, d.GetResultLeft(), msg) ) {
+            err << where << "left: " << msg;
+            return false;
+        }
+        if ( !IsSame(expRight, d.GetResultRight(), msg) ) {
+            err << where << "right: " << msg;
+            return false;
+        }
+        if ( expSeq != d.GetSequences() ) {
+            err << where << "sequences differ";
+            return false;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// Generated corpus
+//----------------------------------------------------------------------------
+static unsigned int s_seed = 1;
+static unsigned int Random(unsigned int range)
+{
+    // a fixed LCG so every run checks the same corpus
+    s_seed = s_seed * 1103515245 + 12345;
+    return range ? ((s_seed >> 16) & 0x7fff) % range : 0;
+}
+
+static wxString MakeLine(unsigned int vocabulary, const wxString& eol)
+{
+    // a small vocabulary produces many repeated lines, which is where the
+    // placement of the insertions could differ
+    return wxString::Format("line %u", Random(vocabulary)) + eol;
+}
+
+static void GeneratePair(size_t index, wxString& left, wxString& right)
+{
+    unsigned int vocabulary = 2 + Random(index % 3 == 0 ? 500 : 8);
+    size_t lines = Random(index % 10 == 0 ? 5000 : 200);
+    wxString eol = (index % 7 == 0) ? "\r\n" : "\n";
+
+    std::vector<wxString> l;
+    for(size_t i=0; i<lines; ++i) {
+        l.push_back( MakeLine(vocabulary, eol) );
+    }
+
+    std::vector<wxString> r = l;
+    size_t edits = Random(12);
+    for(size_t e=0; e<edits; ++e) {
+        size_t where = Random(r.size() + 1);
+        size_t count = 1 + Random(5);
+        switch(Random(3)) {
+        case 0:
+            for(size_t i=0; i<count; ++i) {
+                r.insert(r.begin() + where, MakeLine(vocabulary, eol));
+            }
+            break;
+        case 1:
+            if ( where < r.size() ) {
+                r.erase(r.begin() + where, r.begin() + wxMin(r.size(), where + count));
+            }
+            break;
+        default:
+            for(size_t i=where; i<r.size() && i<where + count; ++i) {
+                r.at(i) = MakeLine(vocabulary, eol);
+            }
+            break;
+        }
+    }
+
+    left.clear();
+    right.clear();
+    for(size_t i=0; i<l.size(); ++i) left << l.at(i);
+    for(size_t i=0; i<r.size(); ++i) right << r.at(i);
+
+    // files which do not end with a new line
+    if ( index % 5 == 0 && !left.IsEmpty() )  left.RemoveLast();
+    if ( index % 6 == 0 && !right.IsEmpty() ) right.RemoveLast();
+    if ( index % 2 == 0 ) left.swap(right);
+}
+
+static bool WriteFile(const wxFileName& fn, const wxString& content)
+{
+    wxFFile fp(fn.GetFullPath(), "w+b");
+    return fp.IsOpened() && fp.Write(content);
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer(argc, argv);
+    if ( !initializer.IsOk() ) {
+        return 1;
+    }
+
+    size_t checked = 0, failed = 0;
+    wxStopWatch sw;
+
+    // Edge cases and generated pairs
+    wxFileName left(wxFileName::CreateTempFileName("dtlleft"));
+    wxFileName right(wxFileName::CreateTempFileName("dtlright"));
+
+    const char* fixed[][2] = {
+        { "", "" },
+        { "", "a\n" },
+        { "a\n", "" },
+        { "a\nb\nc\n", "a\nb\nc\n" },
+        { "a\nb\nc", "a\nb\nc\n" },
+        { "a\nb\na\nb\n", "b\na\nb\na\n" },
+        { "\n\n\n", "\n\n" },
+        { "a\r\nb\r\n", "a\nb\n" },
+    };
+    size_t generated = 2000;
+    for(size_t i=0; i<sizeof(fixed)/sizeof(fixed[0]) + generated; ++i) {
+        wxString l, r;
+        if ( i < sizeof(fixed)/sizeof(fixed[0]) ) {
+            l = fixed[i][0];
+            r = fixed[i][1];
+        } else {
+            GeneratePair(i, l, r);
+        }
+
+        if ( !WriteFile(left, l) || !WriteFile(right, r) ) {
+            wxPrintf("Failed to write the temporary files\n");
+            return 1;
+        }
+
+        wxString err;
+        ++checked;
+        if ( !CheckPair(left, right, err) ) {
+            ++failed;
+            wxPrintf("generated pair %u: %s\n", (unsigned int)i, err);
+        }
+    }
+    wxRemoveFile(left.GetFullPath());
+    wxRemoveFile(right.GetFullPath());
+
+    // Pairs from the corpus directory
+    if ( argc > 1 ) {
+        wxArrayString files;
+        wxDir::GetAllFiles(argv[1], &files, "*.left");
+        for(size_t i=0; i<files.GetCount(); ++i) {
+            wxFileName fnLeft(files.Item(i));
+            wxFileName fnRight(fnLeft);
+            fnRight.SetExt("right");
+            if ( !fnRight.FileExists() ) continue;
+
+            wxString err;
+            ++checked;
+            if ( !CheckPair(fnLeft, fnRight, err) ) {
+                ++failed;
+                wxPrintf("%s: %s\n", fnLeft.GetFullPath(), err);
+            }
+        }
+    }
+
+    wxPrintf("%u pairs checked in %ldms, %u mismatches\n", (unsigned int)checked, sw.Time(), (unsigned int)failed);
+    return failed ? 1 : 0;
+}
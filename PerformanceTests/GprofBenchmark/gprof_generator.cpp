@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : gprof_generator.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include "gprof_generator.h"
+#include <stdio.h>
+#include <vector>
+
+static unsigned int s_seed = 1;
+static unsigned int Random(unsigned int range)
+{
+	s_seed = s_seed * 1103515245 + 12345;
+	return range ? ((s_seed >> 16) & 0x7fff) % range : 0;
+}
+
+static std::string FunctionName(size_t i)
+{
+	char buf[128];
+	switch(i % 4) {
+	case 0:
+		snprintf(buf, sizeof(buf), "func%u(int)", (unsigned int)i);
+		break;
+	case 1:
+		snprintf(buf, sizeof(buf), "ns%u::Class%u::Method%u(std::string const&, int)", (unsigned int)(i % 16), (unsigned int)(i % 128), (unsigned int)i);
+		break;
+	case 2:
+		snprintf(buf, sizeof(buf), "std::vector<int, std::allocator<int> >::push_back%u(int const&)", (unsigned int)i);
+		break;
+	default:
+		snprintf(buf, sizeof(buf), "helper_%u", (unsigned int)i);
+		break;
+	}
+	return buf;
+}
+
+void GenerateGprofOutput(size_t functions, size_t callsPerFunction, std::string& output)
+{
+	s_seed = 1;
+	output.clear();
+	output.reserve(functions * (callsPerFunction + 3) * 80);
+
+	if(functions == 0) functions = 1;
+
+	// total time (%) of every function, main() is 100% and the rest decays so that only
+	// a few functions pass the node threshold, like in real profiles
+	std::vector<double> time(functions);
+	time[0] = 100.0;
+	for(size_t i = 1; i < functions; ++i) {
+		time[i] = 100.0 / (1.0 + i * 0.05 + Random(100) / 10.0);
+	}
+
+	char line[512];
+	output += "Flat profile:\n\n";
+	output += "Each sample counts as 0.01 seconds.\n";
+	output += "  %   cumulative   self              self     total\n";
+	output += " time   seconds   seconds    calls  ms/call  ms/call  name\n";
+	for(size_t i = 0; i < functions && i < 20; ++i) {
+		snprintf(line, sizeof(line), " %5.2f      %5.2f     %5.2f     %4u     0.00     0.00  %s\n",
+		         time[i] / 10, time[i] / 50, time[i] / 100, Random(1000), FunctionName(i).c_str());
+		output += line;
+	}
+
+	output += "\n\t\t     Call graph (explanation follows)\n\n\n";
+	output += "granularity: each sample hit covers 2 byte(s) for 0.52% of 1.93 seconds\n\n";
+	output += "index % time    self  children    called     name\n";
+
+	for(size_t i = 0; i < functions; ++i) {
+		unsigned int index = (unsigned int)i + 1;
+		std::string name = FunctionName(i);
+
+		// parent line, skipped by the parser
+		if(i == 0) {
+			output += "                                                 <spontaneous>\n";
+		} else {
+			size_t parent = Random((unsigned int)i);
+			snprintf(line, sizeof(line), "                0.00    0.01       1/1           %s [%u]\n",
+			         FunctionName(parent).c_str(), (unsigned int)parent + 1);
+			output += line;
+		}
+
+		// primary line: plain, recursive ("1+5") or member of a cycle
+		char called[32];
+		if(i == 0)
+			called[0] = 0;
+		else if(i % 50 == 0)
+			snprintf(called, sizeof(called), "%u+%u", Random(100) + 1, Random(10) + 1);
+		else
+			snprintf(called, sizeof(called), "%u", Random(1000) + 1);
+
+		std::string cycle;
+		if(i % 97 == 0 && i > 0) cycle = " <cycle 1>";
+
+		double self = time[i] / 200;
+		double children = time[i] / 60;
+		snprintf(line, sizeof(line), "[%u]%*s%5.1f    %4.2f    %5.2f %7s         %s%s [%u]\n",
+		         index, (int)(index < 10 ? 5 : index < 100 ? 4 : index < 1000 ? 3 : 2), "",
+		         time[i], self, children, called, name.c_str(), cycle.c_str(), index);
+		output += line;
+
+		// child lines
+		for(size_t c = 0; c < callsPerFunction; ++c) {
+			size_t callee = Random((unsigned int)functions);
+			unsigned int count = Random(100) + 1;
+			snprintf(line, sizeof(line), "                %4.2f    %4.2f    %4u/%-4u       %s [%u]\n",
+			         self / (c + 2), children / (c + 2), count, count + Random(100),
+			         FunctionName(callee).c_str(), (unsigned int)callee + 1);
+			output += line;
+		}
+		output += "-----------------------------------------------\n";
+	}
+
+	output += "\n This table describes the call tree of the program, and was sorted by\n";
+	output += " the total amount of time spent in each function and its children.\n";
+}
@@ -0,0 +1,41 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : gprof_generator.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef GPROF_GENERATOR_H
+#define GPROF_GENERATOR_H
+
+#include <string>
+
+/**
+ * @brief Write a synthetic gprof report (a short flat profile followed by the call graph) to 'output'.
+ * Every function has a primary line, a parent line and 'callsPerFunction' child lines. Some functions
+ * are recursive or members of a cycle. The same arguments always produce the same report.
+ * @param functions number of functions in the call graph
+ * @param callsPerFunction number of calls made by every function
+ * @param output the report
+ */
+void GenerateGprofOutput(size_t functions, size_t callsPerFunction, std::string& output);
+
+#endif // GPROF_GENERATOR_H
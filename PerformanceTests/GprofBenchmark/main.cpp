@@ -0,0 +1,128 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : main.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+// Times the CallGraph plugin on a synthetic gprof report: GprofParser::GprofParserStream(),
+// GprofCallGraph::Prune() and DotWriter::WriteToDotLanguage(), the last two both with the
+// suggested node threshold and with the whole graph (thresholds 0).
+//
+// Usage: GprofBenchmark [functions] [calls-per-function] [iterations] [file-to-write-the-report-to]
+
+#include "gprof_generator.h"
+#include "gprofparser.h"
+#include "dotwriter.h"
+#include <wx/init.h>
+#include <wx/mstream.h>
+#include <wx/ffile.h>
+#include <wx/stopwatch.h>
+#include <wx/crt.h>
+
+static void Report(const char* what, long best)
+{
+	wxPrintf("%-32s: %6ldms\n", what, best);
+}
+
+static void Keep(long t, long& best)
+{
+	if(best == -1 || t < best) best = t;
+}
+
+int main(int argc, char** argv)
+{
+	wxInitializer initializer(argc, argv);
+	if(!initializer.IsOk()) {
+		return 1;
+	}
+
+	long functions = 60000, calls = 4, iterations = 5;
+	if(argc > 1) wxString(argv[1]).ToLong(&functions);
+	if(argc > 2) wxString(argv[2]).ToLong(&calls);
+	if(argc > 3) wxString(argv[3]).ToLong(&iterations);
+
+	std::string report;
+	GenerateGprofOutput(functions, calls, report);
+	if(argc > 4) {
+		wxFFile fp(argv[4], "wb");
+		if(!fp.IsOpened() || fp.Write(report.c_str(), report.length()) != report.length()) {
+			wxPrintf("Failed to write %s\n", argv[4]);
+			return 1;
+		}
+	}
+	wxPrintf("%ld functions, %ld calls per function, %u bytes, %ld iterations (best time)\n",
+	         functions, calls, (unsigned int)report.length(), iterations);
+
+	long parse = -1, pruneSuggested = -1, pruneAll = -1, dotSuggested = -1, dotAll = -1;
+	size_t parsedFunctions = 0, parsedCalls = 0, selectedNodes = 0, selectedEdges = 0;
+	int threshold = 0;
+
+	for(long i = 0; i < iterations; ++i) {
+		GprofParser parser;
+		wxMemoryInputStream is(report.c_str(), report.length());
+
+		wxStopWatch sw;
+		parser.GprofParserStream(&is);
+		Keep(sw.Time(), parse);
+
+		parsedFunctions = parser.callgraph.functions.size();
+		parsedCalls = parser.callgraph.edges.size();
+		threshold = parser.GetSuggestedNodeThreshold();
+		if(threshold < 0) threshold = 0;
+
+		std::vector<size_t> nodes, edges;
+		sw.Start();
+		parser.callgraph.Prune(threshold, 0, nodes, edges);
+		Keep(sw.Time(), pruneSuggested);
+		selectedNodes = nodes.size();
+		selectedEdges = edges.size();
+
+		nodes.clear();
+		edges.clear();
+		sw.Start();
+		parser.callgraph.Prune(0, 0, nodes, edges);
+		Keep(sw.Time(), pruneAll);
+
+		DotWriter dw;
+		dw.SetCallGraph(&parser.callgraph);
+		dw.SetDotWriterFromDetails(5, 5, threshold, 0, false, false, false);
+		sw.Start();
+		dw.WriteToDotLanguage();
+		Keep(sw.Time(), dotSuggested);
+
+		dw.SetDotWriterFromDetails(5, 5, 0, 0, false, false, false);
+		sw.Start();
+		dw.WriteToDotLanguage();
+		Keep(sw.Time(), dotAll);
+	}
+
+	wxPrintf("parsed %u functions, %u calls; suggested node threshold %d%% selects %u functions, %u calls\n",
+	         (unsigned int)parsedFunctions, (unsigned int)parsedCalls, threshold,
+	         (unsigned int)selectedNodes, (unsigned int)selectedEdges);
+	Report("GprofParserStream", parse);
+	Report("Prune (suggested threshold)", pruneSuggested);
+	Report("Prune (whole graph)", pruneAll);
+	Report("WriteToDotLanguage (suggested)", dotSuggested);
+	Report("WriteToDotLanguage (whole graph)", dotAll);
+
+	return (parsedFunctions == (size_t)functions && parsedCalls == (size_t)(functions * calls)) ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : main.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+// Times the ways of turning the output of the indexer into tags for the database:
+//
+// - std::map tree  : TreeFromTags() as it was, a tree indexed with std::map
+// - hash map tree  : TagsManager::TreeFromTags(), the TagTree is now indexed with a hash map
+// - entries vector : TagsManager::EntriesFromTags(), used by the parser thread to store tags
+//
+// The input is a synthetic ctags output of namespaces / classes / members.
+//
+// Usage: TagTreeBenchmark [number-of-classes] [iterations]
+
+#include "ctags_manager.h"
+#include "tag_tree.h"
+#include "tokenizer.h"
+#include <wx/init.h>
+#include <wx/tokenzr.h>
+#include <wx/stopwatch.h>
+#include <wx/crt.h>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// The tag tree as it was: std::map index, same AddEntry()
+//----------------------------------------------------------------------------
+typedef Tree<wxString, TagEntry> MapTagTree;
+
+static TagNode* MapTreeAddEntry(MapTagTree* tree, TagEntry& tag)
+{
+    wxString key(tag.Key());
+
+    TagNode* newNode = tree->Find(key);
+    if( newNode ) {
+        if( tag.IsOk() )
+            newNode->SetData(tag);
+        return newNode;
+    }
+
+    wxString name = tag.GetPath();
+    StringTokenizer tok(name, wxT("::"));
+
+    wxString parentPath;
+    TagNode* node = tree->GetRoot();
+    TagNode* lastFoundNode = tree->GetRoot();
+    for(int i=0; i<tok.Count()-1; i++) {
+        parentPath += tok[i];
+        node = tree->Find(parentPath);
+        if( !node ) {
+            TagEntry ee;
+            ee.SetPath(parentPath);
+            ee.SetName(tok[i]);
+            node = tree->AddChild(parentPath, ee, lastFoundNode);
+        }
+
+        lastFoundNode = node;
+        if(i < tok.Count()-2)
+            parentPath += wxT("::");
+    }
+    return tree->AddChild(key, tag, node);
+}
+
+static MapTagTree* MapTreeFromTags(const wxString& tags, int& count)
+{
+    TagEntry root;
+    root.SetName(wxT("<ROOT>"));
+
+    MapTagTree* tree = new MapTagTree(wxT("<ROOT>"), root);
+
+    wxStringTokenizer tkz(tags, wxT("\n"));
+    while (tkz.HasMoreTokens()) {
+        TagEntry tag;
+        wxString line = tkz.NextToken();
+
+        line = line.Trim();
+        line = line.Trim(false);
+        if (line.IsEmpty())
+            continue;
+
+        tag.FromLine(line);
+
+        count++;
+        if ( tag.GetKind() != wxT("local") )
+            MapTreeAddEntry(tree, tag);
+    }
+    return tree;
+}
+
+//----------------------------------------------------------------------------
+// Synthetic indexer output
+//----------------------------------------------------------------------------
+static wxString GenerateTags(size_t classes)
+{
+    static const size_t NAMESPACES = 20;
+    static const size_t MEMBERS    = 12;
+
+    wxString tags;
+    size_t line = 1;
+    for(size_t c=0; c<classes; ++c) {
+        wxString file  = wxString::Format("/home/user/project/src/file%u.h", (unsigned int)(c / 4));
+        wxString ns    = wxString::Format("ns%u", (unsigned int)(c % NAMESPACES));
+        wxString klass = wxString::Format("Class%u", (unsigned int)c);
+        wxString scope = ns + "::" + klass;
+
+        if ( c < NAMESPACES ) {
+            tags << ns << "\t" << file << "\t/^namespace " << ns << " {$/;\"\tnamespace\tline:" << line++ << "\n";
+        }
+        tags << klass << "\t" << file << "\t/^class " << klass << " {$/;\"\tclass\tline:" << line++
+             << "\tnamespace:" << ns << "\n";
+
+        for(size_t m=0; m<MEMBERS; ++m) {
+            wxString member    = wxString::Format("Method%u", (unsigned int)m);
+            wxString signature = wxString::Format("(int arg%u, const wxString& str)", (unsigned int)m);
+
+            // the declaration, the definition and a local of the definition
+            tags << member << "\t" << file << "\t/^    void " << member << signature << ";$/;\"\tprototype\tline:" << line++
+                 << "\tclass:" << scope << "\taccess:public\tsignature:" << signature << "\treturns:void\n";
+            tags << member << "\t" << file << "\t/^void " << scope << "::" << member << signature << "$/;\"\tfunction\tline:" << line++
+                 << "\tclass:" << scope << "\tsignature:" << signature << "\treturns:void\n";
+            tags << "local" << m << "\t" << file << "\t/^    int local" << m << ";$/;\"\tlocal\tline:" << line++ << "\n";
+
+            wxString var = wxString::Format("m_member%u", (unsigned int)m);
+            tags << var << "\t" << file << "\t/^    int " << var << ";$/;\"\tmember\tline:" << line++
+                 << "\tclass:" << scope << "\taccess:private\n";
+        }
+    }
+    return tags;
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer(argc, argv);
+    if ( !initializer.IsOk() ) {
+        return 1;
+    }
+
+    long classes = 5000, iterations = 5;
+    if ( argc > 1 ) wxString(argv[1]).ToLong(&classes);
+    if ( argc > 2 ) wxString(argv[2]).ToLong(&iterations);
+
+    wxString tags = GenerateTags(classes);
+    wxPrintf("%ld classes, %u bytes of tags, %ld iterations (best time)\n", classes, (unsigned int)tags.length(), iterations);
+
+    long bestMap = -1, bestHash = -1, bestVec = -1;
+    int countMap = 0, countHash = 0, countVec = 0;
+    size_t entries = 0;
+    for(long i=0; i<iterations; ++i) {
+        wxStopWatch sw;
+        {
+            countMap = 0;
+            MapTagTree* tree = MapTreeFromTags(tags, countMap);
+            delete tree;
+        }
+        long t = sw.Time();
+        if ( bestMap == -1 || t < bestMap ) bestMap = t;
+
+        sw.Start();
+        {
+            countHash = 0;
+            TagTreePtr tree = TagsManagerST::Get()->TreeFromTags(tags, countHash);
+        }
+        t = sw.Time();
+        if ( bestHash == -1 || t < bestHash ) bestHash = t;
+
+        sw.Start();
+        {
+            countVec = 0;
+            std::vector<TagEntry> vec;
+            TagsManagerST::Get()->EntriesFromTags(tags, vec, countVec);
+            entries = vec.size();
+        }
+        t = sw.Time();
+        if ( bestVec == -1 || t < bestVec ) bestVec = t;
+    }
+
+    wxPrintf("std::map tree  : %6ldms (%d tags)\n", bestMap,  countMap);
+    wxPrintf("hash map tree  : %6ldms (%d tags)\n", bestHash, countHash);
+    wxPrintf("entries vector : %6ldms (%d tags, %u stored)\n", bestVec, countVec, (unsigned int)entries);
+
+    TagsManagerST::Free();
+    return (countMap == countHash && countHash == countVec) ? 0 : 1;
+}
@@ -16,6 +16,13 @@
 #include <wx/settings.h>
 #include <wx/tokenzr.h>
 #include "EclipseThemeImporterManager.h"
+#include <wx/ffile.h>
+#include <wx/datstrm.h>
+#include <wx/mstream.h>
+#include <wx/stopwatch.h>
+
+// Bump this whenever LexerConf::ToBinary() changes
+#define LEXERS_CACHE_VERSION 1
 
 class clCommandEvent;
 ColoursAndFontsManager::ColoursAndFontsManager()
@@ -49,7 +56,9 @@ void ColoursAndFontsManager::Load()
     wxFileName defaultLexersPath(clStandardPaths::Get().GetDataDir(), "");
 #endif
     defaultLexersPath.AppendDir("lexers");
-    LoadNewXmls(defaultLexersPath.GetPath());
+
+    wxArrayString xmlFiles;
+    wxDir::GetAllFiles(defaultLexersPath.GetPath(), &xmlFiles, "lexer_*.xml");
 
     //+++----------------------------------
     // Now handle user lexers
@@ -64,6 +73,7 @@ void ColoursAndFontsManager::Load()
     if(cppLexerDefault.FileExists()) {
         // We found the old lexer style here (single XML file for all the lexers)
         // Merge them with the installation lexers
+        LoadNewXmls(xmlFiles);
         CL_DEBUG("Migrating old lexers XML files ...");
         LoadOldXmls(cppLexerDefault.GetPath());
 
@@ -72,9 +82,21 @@ void ColoursAndFontsManager::Load()
         cppLexerDefault.SetName("lexer_c++_default");
         if(cppLexerDefault.FileExists()) {
             CL_DEBUG("Using user lexer XML files from %s ...", cppLexerDefault.GetPath());
-            // this function loads and delete the old xml files so they won't be located
-            // next time we search for them
-            LoadNewXmls(cppLexerDefault.GetPath());
+            wxDir::GetAllFiles(cppLexerDefault.GetPath(), &xmlFiles, "lexer_*.xml");
+        }
+
+        // The XML files are the authoring format, the cache is used as long as they are not modified
+        wxStopWatch sw;
+        if(LoadCache(xmlFiles)) {
+            CL_DEBUG("Loaded %u lexers from cache in %ld ms", (unsigned int)m_allLexers.size(), sw.Time());
+
+        } else {
+            LoadNewXmls(xmlFiles);
+            CL_DEBUG("Loaded %u lexers from %u XML files in %ld ms",
+                     (unsigned int)m_allLexers.size(),
+                     (unsigned int)xmlFiles.GetCount(),
+                     sw.Time());
+            SaveCache(xmlFiles);
         }
     }
 
@@ -88,12 +110,8 @@ void ColoursAndFontsManager::Load()
     }
 }
 
-void ColoursAndFontsManager::LoadNewXmls(const wxString& path)
+void ColoursAndFontsManager::LoadNewXmls(const wxArrayString& files)
 {
-    // load all XML files
-    wxArrayString files;
-    wxDir::GetAllFiles(path, &files, "lexer_*.xml");
-
     // Each XMl represents a single lexer
     for(size_t i = 0; i < files.GetCount(); ++i) {
         wxXmlDocument doc;
@@ -164,6 +182,13 @@ LexerConf::Ptr_t ColoursAndFontsManager::DoAddLexer(wxXmlNode* node)
         lexer->SetFileSpec("*.java");
     }
 
+    DoAddLexer(lexer);
+    return lexer;
+}
+
+void ColoursAndFontsManager::DoAddLexer(LexerConf::Ptr_t lexer)
+{
+    wxString lexerName = lexer->GetName();
     if(m_lexersMap.count(lexerName) == 0) {
         m_lexersMap.insert(std::make_pair(lexerName, ColoursAndFontsManager::Vec_t()));
     }
@@ -185,7 +210,78 @@ LexerConf::Ptr_t ColoursAndFontsManager::DoAddLexer(wxXmlNode* node)
     }
     vec.push_back(lexer);
     m_allLexers.push_back(lexer);
-    return lexer;
+}
+
+bool ColoursAndFontsManager::LoadCache(const wxArrayString& xmlFiles)
+{
+    wxFileName fnCache = GetCacheFile();
+    if(!fnCache.FileExists()) return false;
+
+    wxMemoryBuffer buffer;
+    {
+        wxFFile fp(fnCache.GetFullPath(), "rb");
+        if(!fp.IsOpened()) return false;
+
+        // read the entire cache at once
+        size_t len = (size_t)fp.Length();
+        size_t bytesRead = fp.Read(buffer.GetWriteBuf(len), len);
+        buffer.UngetWriteBuf(bytesRead);
+    }
+
+    wxMemoryInputStream mem(buffer.GetData(), buffer.GetDataLen());
+    wxDataInputStream in(mem);
+    if(in.Read32() != LEXERS_CACHE_VERSION) return false;
+
+    // Make sure that the cache was built from the same files
+    wxUint32 count = in.Read32();
+    if(!in.IsOk() || count != xmlFiles.GetCount()) return false;
+
+    for(size_t i = 0; i < xmlFiles.GetCount(); ++i) {
+        wxString filename = in.ReadString();
+        wxUint64 lastModified = in.Read64();
+        if(!in.IsOk() || filename != xmlFiles.Item(i)) return false;
+        if(lastModified != (wxUint64)wxFileName(filename).GetModificationTime().GetTicks()) return false;
+    }
+
+    ColoursAndFontsManager::Vec_t lexers;
+    count = in.Read32();
+    for(wxUint32 i = 0; i < count && in.IsOk(); ++i) {
+        LexerConf::Ptr_t lexer(new LexerConf);
+        if(!lexer->FromBinary(in)) return false;
+        lexers.push_back(lexer);
+    }
+
+    if(lexers.size() != count) return false;
+    for(size_t i = 0; i < lexers.size(); ++i) {
+        DoAddLexer(lexers.at(i));
+    }
+    return true;
+}
+
+void ColoursAndFontsManager::SaveCache(const wxArrayString& xmlFiles) const
+{
+    wxMemoryOutputStream mem;
+    {
+        wxDataOutputStream out(mem);
+        out.Write32(LEXERS_CACHE_VERSION);
+        out.Write32((wxUint32)xmlFiles.GetCount());
+        for(size_t i = 0; i < xmlFiles.GetCount(); ++i) {
+            out.WriteString(xmlFiles.Item(i));
+            out.Write64((wxUint64)wxFileName(xmlFiles.Item(i)).GetModificationTime().GetTicks());
+        }
+
+        out.Write32((wxUint32)m_allLexers.size());
+        for(size_t i = 0; i < m_allLexers.size(); ++i) {
+            m_allLexers.at(i)->ToBinary(out);
+        }
+    }
+
+    wxLogNull noLog;
+    wxFFile fp(GetCacheFile().GetFullPath(), "wb");
+    if(fp.IsOpened()) {
+        fp.Write(mem.GetOutputStreamBuffer()->GetBufferStart(), mem.GetLength());
+        fp.Close();
+    }
 }
 
 wxArrayString ColoursAndFontsManager::GetAvailableThemesForLexer(const wxString& lexerName) const
@@ -349,6 +445,10 @@ void ColoursAndFontsManager::Save(LexerConf::Ptr_t lexer)
     wxFileName xmlFile(clStandardPaths::Get().GetUserDataDir(), filename);
     xmlFile.AppendDir("lexers");
     ::SaveXmlToFile(&doc, xmlFile.GetFullPath());
+
+    // The XML files changed, the cache will be re-created on the next load
+    wxLogNull noLog;
+    ::wxRemoveFile(GetCacheFile().GetFullPath());
 }
 
 void ColoursAndFontsManager::SetActiveTheme(const wxString& lexerName, const wxString& themeName)
@@ -370,6 +470,13 @@ wxFileName ColoursAndFontsManager::GetConfigFile() const
     return fnSettings;
 }
 
+wxFileName ColoursAndFontsManager::GetCacheFile() const
+{
+    wxFileName fnCache(clStandardPaths::Get().GetUserDataDir(), "lexers.cache");
+    fnCache.AppendDir("config");
+    return fnCache;
+}
+
 void ColoursAndFontsManager::SaveGlobalSettings()
 {
     // save the global settings
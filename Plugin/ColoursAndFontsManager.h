@@ -24,11 +24,20 @@ private:
     ColoursAndFontsManager();
     virtual ~ColoursAndFontsManager();
 
-    void LoadNewXmls(const wxString& path);
+    void LoadNewXmls(const wxArrayString& files);
     void LoadOldXmls(const wxString& path);
     LexerConf::Ptr_t DoAddLexer(wxXmlNode* node);
+    void DoAddLexer(LexerConf::Ptr_t lexer);
     void Clear();
     wxFileName GetConfigFile() const;
+    wxFileName GetCacheFile() const;
+
+    /**
+     * @brief load the lexers from the binary cache. The cache is used only if it was
+     * created from the exact same list of XML files and none of them was modified since
+     */
+    bool LoadCache(const wxArrayString& xmlFiles);
+    void SaveCache(const wxArrayString& xmlFiles) const;
     void SaveGlobalSettings();
 
 public:
@@ -44,6 +44,7 @@ public:
         kViewVerticalSplit      = 0x00000002,
         kViewHorizontalSplit    = 0x00000004,
         kAllViewModes           = (kViewSingle|kViewVerticalSplit|kViewHorizontalSplit),
+        kViewFoldUnchanged      = 0x00000008, // not a view mode, can be combined with any of the above
     };
     
 protected:
@@ -81,6 +82,19 @@ public:
         return m_viewFlags & kViewSingle;
     }
     
+    DiffConfig& SetFoldUnchanged(bool b) {
+        if ( b ) {
+            m_viewFlags |= kViewFoldUnchanged;
+        } else {
+            m_viewFlags &= ~kViewFoldUnchanged;
+        }
+        return *this;
+    }
+    
+    bool IsFoldUnchanged() const {
+        return m_viewFlags & kViewFoldUnchanged;
+    }
+    
     void SetFlags(size_t flags) {
         this->m_flags = flags;
     }
@@ -35,6 +35,9 @@
 #include "art_metro.h"
 #include "DiffConfig.h"
 #include <wx/menu.h>
+#include <wx/thread.h>
+#include <wx/artprov.h>
+#include <algorithm>
 
 #define RED_MARKER          5
 #define GREEN_MARKER        6
@@ -46,10 +49,56 @@
 
 #define MARKER_SEQUENCE          8
 #define MARKER_SEQUENCE_VERTICAL 9
+#define MARKER_FOLDED_BLOCK      10
+
+// Number of unchanged lines kept visible around each diff sequence when folding
+#define DIFF_CONTEXT_LINES 3
+
+/// Runs clDTL::Diff() away from the UI thread
+class DiffSideBySidePanelThread : public wxThread
+{
+    DiffSideBySidePanel* m_panel;
+    wxString m_left;
+    wxString m_right;
+    clDTL::DiffMode m_mode;
+    int m_generation;
+    clDTL m_dtl;
+
+public:
+    DiffSideBySidePanelThread(DiffSideBySidePanel* panel, const wxString& left, const wxString& right, clDTL::DiffMode mode, int generation)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_panel(panel)
+        , m_left(left.c_str())
+        , m_right(right.c_str())
+        , m_mode(mode)
+        , m_generation(generation)
+    {
+    }
+    virtual ~DiffSideBySidePanelThread() {}
+
+    virtual void* Entry()
+    {
+        m_dtl.Diff(m_left, m_right, m_mode);
+        if ( !m_dtl.IsCancelled() ) {
+            m_panel->CallAfter( &DiffSideBySidePanel::OnDiffCompleted, m_generation );
+        }
+        return NULL;
+    }
+
+    void Cancel() {
+        m_dtl.Cancel();
+    }
+    const clDTL& GetDTL() const {
+        return m_dtl;
+    }
+};
 
 DiffSideBySidePanel::DiffSideBySidePanel(wxWindow* parent)
     : DiffSideBySidePanelBase(parent)
     , m_flags(0)
+    , m_diffThread(NULL)
+    , m_diffGeneration(0)
+    , m_markedSequence(wxNOT_FOUND, wxNOT_FOUND)
 {
     m_config.Load();
 
@@ -62,11 +111,22 @@ DiffSideBySidePanel::DiffSideBySidePanel(wxWindow* parent)
     Connect(ID_COPY_LEFT_TO_RIGHT_AND_MOVE, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(DiffSideBySidePanel::OnMenuCopyLeft2Right));
     Connect(ID_COPY_RIGHT_TO_LEFT, wxEVT_COMMAND_MENU_SELECTED,          wxCommandEventHandler(DiffSideBySidePanel::OnMenuCopyRight2Left));
     Connect(ID_COPY_RIGHT_TO_LEFT_AND_MOVE, wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(DiffSideBySidePanel::OnMenuCopyRight2Left));
+
+    // "Fold unchanged lines" toggle
+    m_ribbonButtonBar123->AddToggleButton(ID_VIEW_FOLD_UNCHANGED, _("Fold"), wxArtProvider::GetBitmap(wxART_LIST_VIEW, wxART_TOOLBAR, wxSize(32, 32)), _("Fold unchanged lines"));
+    m_ribbonButtonBar123->Realize();
+    m_ribbonBar->Realize();
+    m_ribbonButtonBar123->Connect(ID_VIEW_FOLD_UNCHANGED, wxEVT_COMMAND_RIBBONBUTTON_CLICKED, wxRibbonButtonBarEventHandler(DiffSideBySidePanel::OnFoldUnchanged), NULL, this);
+    m_ribbonButtonBar123->Connect(ID_VIEW_FOLD_UNCHANGED, wxEVT_UPDATE_UI, wxUpdateUIEventHandler(DiffSideBySidePanel::OnFoldUnchangedUI), NULL, this);
+    m_stcLeft->Connect(wxEVT_STC_MARGINCLICK, wxStyledTextEventHandler(DiffSideBySidePanel::OnMarginClick), NULL, this);
+    m_stcRight->Connect(wxEVT_STC_MARGINCLICK, wxStyledTextEventHandler(DiffSideBySidePanel::OnMarginClick), NULL, this);
     CallAfter( &DiffSideBySidePanel::DoLayout );
 }
 
 DiffSideBySidePanel::~DiffSideBySidePanel()
 {
+    DoCancelDiff();
+    
     if ( m_flags & kDeleteLeftOnExit ) {
         ::wxRemoveFile( m_filePickerLeft->GetPath() );
     }
@@ -95,15 +155,49 @@ void DiffSideBySidePanel::Diff()
         return;
     }
 
+    // Stop any diff which is still running
+    DoCancelDiff();
+
     // Cleanup
     DoClean();
 
     // Prepare the views
     PrepareViews();
 
-    // Prepare the diff
-    clDTL d;
-    d.Diff(m_filePickerLeft->GetPath(), m_filePickerRight->GetPath(), m_config.IsSingleViewMode() ? clDTL::kOnePane : clDTL::kTwoPanes);
+    // Prepare the diff in the background, the views are updated by OnDiffCompleted()
+    m_diffThread = new DiffSideBySidePanelThread(this, m_filePickerLeft->GetPath(), m_filePickerRight->GetPath(), m_config.IsSingleViewMode() ? clDTL::kOnePane : clDTL::kTwoPanes, ++m_diffGeneration);
+    if ( m_diffThread->Create() != wxTHREAD_NO_ERROR || m_diffThread->Run() != wxTHREAD_NO_ERROR ) {
+        wxDELETE(m_diffThread);
+        ::wxMessageBox(_("Failed to start the diff thread"), "CodeLite", wxICON_ERROR|wxCENTER|wxOK);
+    }
+}
+
+void DiffSideBySidePanel::DoCancelDiff()
+{
+    if ( m_diffThread ) {
+        m_diffThread->Cancel();
+        m_diffThread->Wait();
+        wxDELETE(m_diffThread);
+    }
+}
+
+void DiffSideBySidePanel::OnDiffCompleted(int generation)
+{
+    if ( !m_diffThread || generation != m_diffGeneration ) {
+        // a result of a cancelled diff
+        return;
+    }
+    
+    m_diffThread->Wait();
+    DoShowDiff( m_diffThread->GetDTL() );
+    wxDELETE(m_diffThread);
+}
+
+void DiffSideBySidePanel::DoShowDiff(const clDTL& d)
+{
+    wxFileName fnLeft (m_filePickerLeft->GetPath());
+    wxFileName fnRIght(m_filePickerRight->GetPath());
+
     const clDTL::LineInfoVec_t &resultLeft  = d.GetResultLeft();
     const clDTL::LineInfoVec_t &resultRight = d.GetResultRight();
     m_sequences = d.GetSequences();
@@ -173,6 +267,10 @@ void DiffSideBySidePanel::Diff()
     m_stcLeft->SetSavePoint();
     m_stcRight->SetSavePoint();
 
+    if ( m_config.IsFoldUnchanged() ) {
+        DoFoldUnchangedLines();
+    }
+
     // Select the first diff
     wxRibbonButtonBarEvent dummy;
     m_cur_sequence = -1;
@@ -245,6 +343,10 @@ void DiffSideBySidePanel::DefineMarkers(wxStyledTextCtrl* ctrl)
 
     ctrl->MarkerDefine(MARKER_SEQUENCE_VERTICAL, wxSTC_MARK_VLINE);
     ctrl->MarkerSetBackground(MARKER_SEQUENCE_VERTICAL, sideMarker);
+
+    ctrl->MarkerDefine(MARKER_FOLDED_BLOCK, wxSTC_MARK_BOXPLUS);
+    ctrl->MarkerSetForeground(MARKER_FOLDED_BLOCK, *wxWHITE);
+    ctrl->MarkerSetBackground(MARKER_FOLDED_BLOCK, sideMarker);
 }
 
 void DiffSideBySidePanel::UpdateViews(const wxString& left, const wxString& right)
@@ -348,6 +450,7 @@ void DiffSideBySidePanel::OnNextDiffSequence(wxRibbonButtonBarEvent& event)
     int lastLine  = m_sequences.at(m_cur_sequence).second;
     DoDrawSequenceMarkers(firstLine, lastLine, m_stcLeft);
     DoDrawSequenceMarkers(firstLine, lastLine, m_stcRight);
+    m_markedSequence = m_sequences.at(m_cur_sequence);
 }
 
 void DiffSideBySidePanel::OnPrevDiffSequence(wxRibbonButtonBarEvent& event)
@@ -357,6 +460,7 @@ void DiffSideBySidePanel::OnPrevDiffSequence(wxRibbonButtonBarEvent& event)
     int lastLine  = m_sequences.at(m_cur_sequence).second;
     DoDrawSequenceMarkers(firstLine, lastLine, m_stcLeft);
     DoDrawSequenceMarkers(firstLine, lastLine, m_stcRight);
+    m_markedSequence = m_sequences.at(m_cur_sequence);
 }
 
 void DiffSideBySidePanel::OnRefreshDiff(wxRibbonButtonBarEvent& event)
@@ -381,6 +485,8 @@ void DiffSideBySidePanel::DoClean()
     m_rightRedMarkers.clear();
     m_rightPlaceholdersMarkers.clear();
     m_sequences.clear();
+    m_foldedBlocks.clear();
+    m_markedSequence = std::make_pair(wxNOT_FOUND, wxNOT_FOUND);
 
     m_stcLeft->SetReadOnly(false);
     m_stcRight->SetReadOnly(false);
@@ -395,9 +501,11 @@ void DiffSideBySidePanel::DoClean()
 
 void DiffSideBySidePanel::DoDrawSequenceMarkers(int firstLine, int lastLine, wxStyledTextCtrl* ctrl)
 {
-    // delete old markers
-    ctrl->MarkerDeleteAll(MARKER_SEQUENCE);
-    ctrl->MarkerDeleteAll(MARKER_SEQUENCE_VERTICAL);
+    // delete the markers of the previously selected sequence. Only these lines are
+    // visited, so moving between sequences does not depend on the file size
+    for(int i=m_markedSequence.first; i<m_markedSequence.second; ++i) {
+        ctrl->MarkerDelete(i, MARKER_SEQUENCE);
+    }
 
     int line1 = firstLine;
     int line2 = lastLine;
@@ -412,7 +520,9 @@ void DiffSideBySidePanel::DoDrawSequenceMarkers(int firstLine, int lastLine, wxS
         visibleLine = 0;
     }
 
-    ctrl->ScrollToLine(visibleLine);
+    // ScrollToLine() works with display lines, which differ from the document lines
+    // when unchanged lines are folded
+    ctrl->ScrollToLine( ctrl->VisibleFromDocLine(visibleLine) );
 }
 
 void DiffSideBySidePanel::OnNextDiffUI(wxUpdateUIEvent& event)
@@ -589,6 +699,12 @@ void DiffSideBySidePanel::OnCopyFileLeftToRight(wxRibbonButtonBarEvent& event)
 
 void DiffSideBySidePanel::DoCopyFileContent(wxStyledTextCtrl* from, wxStyledTextCtrl* to)
 {
+    // Replacing the whole text drops the folding. The sequences no longer match
+    // the text, so they can't be folded again: turn the option off (the user can turn
+    // it on again after refreshing the diff)
+    DoUnfoldAll();
+    m_config.SetFoldUnchanged(false);
+
     to->SetReadOnly(false);
     wxString newContent = DoGetContentNoPlaceholders( from );
     to->SetText( newContent );
@@ -753,3 +869,97 @@ void DiffSideBySidePanel::DoLayout()
     GetSizer()->Layout();
     Refresh();
 }
+
+void DiffSideBySidePanel::DoFoldUnchangedLines()
+{
+    DoUnfoldAll();
+    if ( m_sequences.empty() )
+        return;
+
+    // Collect the unchanged lines between the sequences, minus some context
+    int lineCount = m_stcLeft->GetLineCount();
+    for(size_t i=0; i<=m_sequences.size(); ++i) {
+        int first = (i == 0) ? 0 : m_sequences.at(i-1).second + DIFF_CONTEXT_LINES;
+        int last  = (i == m_sequences.size()) ? lineCount - 1 : m_sequences.at(i).first - DIFF_CONTEXT_LINES - 1;
+        
+        // folding just a few lines is not worth it
+        if ( (last - first) >= DIFF_CONTEXT_LINES ) {
+            m_foldedBlocks.push_back( std::make_pair(first, last) );
+        }
+    }
+
+    wxStyledTextCtrl* ctrls[] = { m_stcLeft, m_stcRight };
+    for(size_t c=0; c<2; ++c) {
+        wxStyledTextCtrl* ctrl = ctrls[c];
+        if ( ctrl == m_stcRight && m_config.IsSingleViewMode() )
+            continue;
+        
+        for(size_t i=0; i<m_foldedBlocks.size(); ++i) {
+            const std::pair<int, int>& block = m_foldedBlocks.at(i);
+            if ( block.second >= ctrl->GetLineCount() )
+                break;
+            ctrl->HideLines(block.first + 1, block.second);
+            ctrl->MarkerAdd(block.first, MARKER_FOLDED_BLOCK);
+            ctrl->AnnotationSetText(block.first, wxString::Format(_("%d unchanged lines"), block.second - block.first));
+        }
+        ctrl->AnnotationSetVisible(wxSTC_ANNOTATION_BOXED);
+    }
+}
+
+void DiffSideBySidePanel::DoUnfoldAll()
+{
+    while ( !m_foldedBlocks.empty() ) {
+        DoExpandBlock( m_foldedBlocks.size() - 1 );
+    }
+}
+
+void DiffSideBySidePanel::DoExpandBlock(size_t index)
+{
+    const std::pair<int, int> block = m_foldedBlocks.at(index);
+    m_foldedBlocks.erase( m_foldedBlocks.begin() + index );
+
+    wxStyledTextCtrl* ctrls[] = { m_stcLeft, m_stcRight };
+    for(size_t c=0; c<2; ++c) {
+        wxStyledTextCtrl* ctrl = ctrls[c];
+        if ( block.second >= ctrl->GetLineCount() )
+            continue;
+        ctrl->ShowLines(block.first + 1, block.second);
+        ctrl->MarkerDelete(block.first, MARKER_FOLDED_BLOCK);
+        ctrl->AnnotationSetText(block.first, wxEmptyString);
+    }
+}
+
+void DiffSideBySidePanel::OnFoldUnchanged(wxRibbonButtonBarEvent& event)
+{
+    m_config.SetFoldUnchanged( !m_config.IsFoldUnchanged() );
+    if ( m_config.IsFoldUnchanged() ) {
+        DoFoldUnchangedLines();
+    } else {
+        DoUnfoldAll();
+    }
+}
+
+void DiffSideBySidePanel::OnFoldUnchangedUI(wxUpdateUIEvent& event)
+{
+    event.Check( m_config.IsFoldUnchanged() );
+}
+
+void DiffSideBySidePanel::OnMarginClick(wxStyledTextEvent& event)
+{
+    wxStyledTextCtrl* ctrl = dynamic_cast<wxStyledTextCtrl*>(event.GetEventObject());
+    if ( !ctrl ) {
+        event.Skip();
+        return;
+    }
+
+    // The blocks are sorted by their first line
+    int line = ctrl->LineFromPosition( event.GetPosition() );
+    std::vector< std::pair<int, int> >::iterator iter =
+        std::lower_bound(m_foldedBlocks.begin(), m_foldedBlocks.end(), std::make_pair(line, wxNOT_FOUND));
+    if ( iter != m_foldedBlocks.end() && iter->first == line ) {
+        DoExpandBlock( iter - m_foldedBlocks.begin() );
+
+    } else {
+        event.Skip();
+    }
+}
@@ -32,6 +32,7 @@
 #include "clDTL.h"
 #include "DiffConfig.h"
 
+class DiffSideBySidePanelThread;
 class WXDLLIMPEXP_SDK DiffSideBySidePanel : public DiffSideBySidePanelBase
 {
     enum {
@@ -39,6 +40,7 @@ class WXDLLIMPEXP_SDK DiffSideBySidePanel : public DiffSideBySidePanelBase
         ID_COPY_LEFT_TO_RIGHT_AND_MOVE,
         ID_COPY_RIGHT_TO_LEFT,
         ID_COPY_RIGHT_TO_LEFT_AND_MOVE,
+        ID_VIEW_FOLD_UNCHANGED,
     };
 
     typedef std::vector< int > Markers_t;
@@ -82,11 +84,19 @@ protected:
 
     std::vector< std::pair<int, int> > m_sequences; // start-line - end-line pairs
     int m_cur_sequence;
+    
+    // Folded runs of unchanged lines, sorted by line. The first line of each block
+    // stays visible and carries the "expand" marker, the rest are hidden
+    std::vector< std::pair<int, int> > m_foldedBlocks; // first-line - last-line pairs
+    // The lines currently marked with the MARKER_SEQUENCE marker
+    std::pair<int, int> m_markedSequence;
 
     size_t m_flags;
     wxString m_leftCaption;
     wxString m_rightCaption;
     DiffConfig m_config;
+    DiffSideBySidePanelThread* m_diffThread;
+    int m_diffGeneration;
     
 protected:
     wxString DoGetContentNoPlaceholders(wxStyledTextCtrl *stc) const;
@@ -137,6 +147,19 @@ protected:
     void DoCopyFileContent(wxStyledTextCtrl* from, wxStyledTextCtrl* to);
     void DoGetPositionsToCopy(wxStyledTextCtrl* stc, int& startPos, int& endPos, int& placeHolderMarkerFirstLine, int& placeHolderMarkerLastLine);
     void DoSave(wxStyledTextCtrl* stc, const wxFileName& fn);
+    void DoCancelDiff();
+    void DoShowDiff(const clDTL& d);
+    /**
+     * @brief hide the unchanged lines between the sequences. The lines are only hidden:
+     * both editors keep the whole text since saving and copying work on it
+     */
+    void DoFoldUnchangedLines();
+    void DoUnfoldAll();
+    void DoExpandBlock(size_t index);
+    
+    void OnFoldUnchanged(wxRibbonButtonBarEvent& event);
+    void OnFoldUnchangedUI(wxUpdateUIEvent& event);
+    void OnMarginClick(wxStyledTextEvent& event);
 
     bool CanNextDiff();
     bool CanPrevDiff();
@@ -151,6 +174,11 @@ public:
      * @brief display a diff view for 2 files left and right
      */
     void Diff();
+    
+    /**
+     * @brief called on the main thread once the diff thread is done
+     */
+    void OnDiffCompleted(int generation);
 
     /**
      * @brief mark the current diff origin from source control
@@ -27,13 +27,21 @@
 #include <wx/tokenzr.h>
 #include <wx/stdpaths.h>
 #include <wx/ffile.h>
+#include <wx/wfstream.h>
+#include <wx/mstream.h>
+#include <wx/image.h>
+#include <wx/zipstrm.h>
+#include <wx/stopwatch.h>
+#include <memory>
 #include "globals.h"
 #include "editor_config.h"
 #include "optionsconfig.h"
 #include "cl_standard_paths.h"
+#include "file_logger.h"
 
 std::map<wxString, wxBitmap> BitmapLoader::m_toolbarsBitmaps;
 std::map<wxString, wxString> BitmapLoader::m_manifest;
+std::map<wxString, wxMemoryBuffer> BitmapLoader::m_archive;
 
 BitmapLoader::~BitmapLoader()
 {
@@ -70,11 +78,16 @@ BitmapLoader::BitmapLoader()
 #   endif
 #endif
 
-    if(m_manifest.empty() || m_toolbarsBitmaps.empty()) {
+    if(m_manifest.empty()) {
         m_zipPath = fn;
         if(m_zipPath.FileExists()) {
+            wxStopWatch sw;
+            doLoadArchive();
             doLoadManifest();
-            doLoadBitmaps();
+            CL_DEBUG("BitmapLoader: indexed %u archive entries (%u images) in %ld ms",
+                     (unsigned int)m_archive.size(),
+                     (unsigned int)m_manifest.size(),
+                     sw.Time());
         }
     }
 }
@@ -85,83 +98,101 @@ const wxBitmap& BitmapLoader::LoadBitmap(const wxString& name)
     if(iter != m_toolbarsBitmaps.end())
         return iter->second;
 
-    return wxNullBitmap;
+    // Not decoded yet
+    std::map<wxString, wxString>::const_iterator manifestIter = m_manifest.find(name);
+    if(manifestIter == m_manifest.end())
+        return wxNullBitmap;
+
+    wxString key = name.BeforeLast(wxT('/'));
+    wxBitmap bmp = doLoadBitmap(wxString::Format(wxT("%s/%s"), key.c_str(), manifestIter->second.c_str()));
+    return m_toolbarsBitmaps.insert(std::make_pair(name, bmp)).first->second;
 }
 
-void BitmapLoader::doLoadManifest()
+void BitmapLoader::doLoadArchive()
 {
-    wxString targetFile;
-    if(ExtractFileFromZip(m_zipPath.GetFullPath(), wxT("manifest.ini"), clStandardPaths::Get().GetUserDataDir(), targetFile)) {
-        // we got the file extracted, read it
-        wxFileName manifest(targetFile);
-        wxFFile fp(manifest.GetFullPath(), wxT("r"));
-        if(fp.IsOpened())  {
-
-            wxString content;
-            fp.ReadAll(&content);
-
-            m_manifest.clear();
-            wxArrayString entries = wxStringTokenize(content, wxT("\n"), wxTOKEN_STRTOK);
-            for(size_t i=0; i<entries.size(); i++) {
-                wxString entry = entries[i];
-                entry.Trim().Trim(false);
-
-                // empty?
-                if(entry.empty())
-                    continue;
-
-                // comment?
-                if(entry.StartsWith(wxT(";")))
-                    continue;
-
-                wxString key = entry.BeforeFirst(wxT('='));
-                wxString val = entry.AfterFirst (wxT('='));
-                key.Trim().Trim(false);
-                val.Trim().Trim(false);
-
-                wxString key16, key24;
-                key16 = key;
-                key24 = key;
-
-                key16.Replace(wxT("<size>"), wxT("16"));
-                key24.Replace(wxT("<size>"), wxT("24"));
-
-                key16.Replace(wxT("."), wxT("/"));
-                key24.Replace(wxT("."), wxT("/"));
-
-                m_manifest[key16] = val;
-                m_manifest[key24] = val;
+    // Read the archive once and keep its entries in memory, keyed by their lower case name
+    m_archive.clear();
+    wxFFileInputStream in(m_zipPath.GetFullPath());
+    if(!in.IsOk())
+        return;
+
+    wxZipInputStream zip(in);
+    std::auto_ptr<wxZipEntry> entry(zip.GetNextEntry());
+    while(entry.get()) {
+        if(!entry->IsDir()) {
+            wxString name = entry->GetName();
+            name.MakeLower();
+            name.Replace(wxT("\\"), wxT("/"));
+
+            wxMemoryBuffer buffer;
+            char chunk[4096];
+            while(zip.Read(chunk, sizeof(chunk)).LastRead()) {
+                buffer.AppendData(chunk, zip.LastRead());
             }
-
-            fp.Close();
-            wxRemoveFile( manifest.GetFullPath() );
+            m_archive[name] = buffer;
         }
-        wxRemoveFile( targetFile );
+        entry.reset(zip.GetNextEntry());
     }
 }
 
-wxBitmap BitmapLoader::doLoadBitmap(const wxString& filepath)
+void BitmapLoader::doLoadManifest()
 {
-    wxString bitmapFile;
-    if(ExtractFileFromZip(m_zipPath.GetFullPath(), filepath, clStandardPaths::Get().GetUserDataDir(), bitmapFile)) {
-        wxBitmap bmp;
-        if(bmp.LoadFile(bitmapFile, wxBITMAP_TYPE_PNG)) {
-            wxRemoveFile(bitmapFile);
-            return bmp;
-        }
-        wxRemoveFile(bitmapFile);
+    std::map<wxString, wxMemoryBuffer>::const_iterator iter = m_archive.find(wxT("manifest.ini"));
+    if(iter == m_archive.end())
+        return;
+
+    const wxMemoryBuffer& buffer = iter->second;
+    wxString content((const char*)buffer.GetData(), wxConvUTF8, buffer.GetDataLen());
+
+    m_manifest.clear();
+    wxArrayString entries = wxStringTokenize(content, wxT("\n"), wxTOKEN_STRTOK);
+    for(size_t i=0; i<entries.size(); i++) {
+        wxString entry = entries[i];
+        entry.Trim().Trim(false);
+
+        // empty?
+        if(entry.empty())
+            continue;
+
+        // comment?
+        if(entry.StartsWith(wxT(";")))
+            continue;
+
+        wxString key = entry.BeforeFirst(wxT('='));
+        wxString val = entry.AfterFirst (wxT('='));
+        key.Trim().Trim(false);
+        val.Trim().Trim(false);
+
+        wxString key16, key24;
+        key16 = key;
+        key24 = key;
+
+        key16.Replace(wxT("<size>"), wxT("16"));
+        key24.Replace(wxT("<size>"), wxT("24"));
+
+        key16.Replace(wxT("."), wxT("/"));
+        key24.Replace(wxT("."), wxT("/"));
+
+        m_manifest[key16] = val;
+        m_manifest[key24] = val;
     }
-    return wxNullBitmap;
 }
 
-void BitmapLoader::doLoadBitmaps()
+wxBitmap BitmapLoader::doLoadBitmap(const wxString& filepath)
 {
-    std::map<wxString, wxString>::iterator iter = m_manifest.begin();
-    for(; iter != m_manifest.end(); iter++) {
-        wxString key = iter->first;
-        key = key.BeforeLast(wxT('/'));
-        m_toolbarsBitmaps[iter->first] = doLoadBitmap( wxString::Format(wxT("%s/%s"), key.c_str(), iter->second.c_str()) );
+    wxString name(filepath);
+    name.MakeLower();
+
+    std::map<wxString, wxMemoryBuffer>::const_iterator iter = m_archive.find(name);
+    if(iter != m_archive.end()) {
+        // decode the image straight from the archive content
+        wxMemoryInputStream is(iter->second.GetData(), iter->second.GetDataLen());
+        wxImage img(is, wxBITMAP_TYPE_PNG);
+        if(img.IsOk()) {
+            return wxBitmap(img);
+        }
     }
+    return wxNullBitmap;
 }
 
 int BitmapLoader::GetMimeImageId(FileExtManager::FileType type) const
@@ -29,6 +29,7 @@
 #include <wx/filename.h>
 #include <wx/bitmap.h>
 #include <wx/imaglist.h>
+#include <wx/buffer.h>
 #include <map>
 #include "fileextmanager.h"
 #include "codelite_exports.h"
@@ -43,6 +44,7 @@ protected:
     wxFileName                              m_zipPath;
     static std::map<wxString, wxBitmap>     m_toolbarsBitmaps;
     static std::map<wxString, wxString>     m_manifest;
+    static std::map<wxString, wxMemoryBuffer> m_archive; // zip entry name (lower case) -> content
     std::map<FileExtManager::FileType, int> m_fileIndexMap;
     bool                                    m_bMapPopulated;
     
@@ -75,11 +77,15 @@ public:
     int GetMimeImageId(FileExtManager::FileType type) const;
 
 protected:
+    void            doLoadArchive();
     void            doLoadManifest();
-    void            doLoadBitmaps();
     wxBitmap        doLoadBitmap(const wxString &filepath);
 
 public:
+    /**
+     * @brief return the bitmap for a given manifest key (e.g. "mime/16/cpp").
+     * The bitmap is decoded from the archive the first time it is requested
+     */
     const wxBitmap& LoadBitmap(const wxString &name);
 
 };
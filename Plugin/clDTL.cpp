@@ -28,8 +28,13 @@
 #include <wx/ffile.h>
 #include <wx/tokenzr.h>
 #include <wx/utils.h>
+#include <wx/hashmap.h>
+
+// Maps a line to its unique ID
+WX_DECLARE_STRING_HASH_MAP(int, clDTLLineIds_t);
 
 clDTL::clDTL()
+    : m_cancelled(false)
 {
 }
 
@@ -57,26 +62,85 @@ void clDTL::Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode m
     m_resultRight.clear();
     m_sequences.clear();
 
-    typedef wxString elem;
+    // The diff runs on line IDs: identical lines share the same ID, so comparing
+    // 2 lines is an integer comparison and the edit script holds no string copies
+    typedef int elem;
     typedef std::pair<elem, dtl::elemInfo> sesElem;
 
-    wxArrayString leftLines = wxStringTokenize(leftFile, "\n", wxTOKEN_RET_DELIMS);
-    wxArrayString rightLines = wxStringTokenize(rightFile, "\n", wxTOKEN_RET_DELIMS);
+    std::vector<wxString> leftLines, rightLines;
+    DoSplitLines(leftFile, leftLines);
+    DoSplitLines(rightFile, rightLines);
+    leftFile.clear();
+    rightFile.clear();
+    
+    // uniqueLines[id] is the text of the line with the given ID
+    std::vector<wxString> uniqueLines;
+    clDTLLineIds_t lineIds;
+    std::vector<elem> leftLinesVec, rightLinesVec;
+    leftLinesVec.reserve( leftLines.size() );
+    rightLinesVec.reserve( rightLines.size() );
+    for(int side = 0; side < 2; ++side) {
+        const std::vector<wxString>& lines = (side == 0) ? leftLines : rightLines;
+        std::vector<elem>& ids = (side == 0) ? leftLinesVec : rightLinesVec;
+        for(size_t i=0; i<lines.size(); ++i) {
+            clDTLLineIds_t::iterator iter = lineIds.find( lines.at(i) );
+            if ( iter == lineIds.end() ) {
+                int id = (int)uniqueLines.size();
+                lineIds.insert( std::make_pair(lines.at(i), id) );
+                uniqueLines.push_back( lines.at(i) );
+                ids.push_back( id );
+            } else {
+                ids.push_back( iter->second );
+            }
+        }
+    }
+    lineIds.clear();
+    leftLines.clear();
+    rightLines.clear();
+    
+    if ( m_cancelled )
+        return;
 
-    std::vector<elem> leftLinesVec;
-    std::vector<elem> rightLinesVec;
-    leftLinesVec.insert(leftLinesVec.end(), leftLines.begin(), leftLines.end());
-    rightLinesVec.insert(rightLinesVec.end(), rightLines.begin(), rightLines.end());
+    // The common prefix is always matched by the first "snake" of the O(NP) algorithm,
+    // so diffing without it yields the same edit script. (A common suffix can not be
+    // stripped the same way: it may change where the algorithm places insertions)
+    size_t prefixLen = 0;
+    while ( prefixLen < leftLinesVec.size() && prefixLen < rightLinesVec.size() &&
+            leftLinesVec.at(prefixLen) == rightLinesVec.at(prefixLen) ) {
+        ++prefixLen;
+    }
+    
+    if ( prefixLen == leftLinesVec.size() && prefixLen == rightLinesVec.size() ) {
+        // nothing to be done - files are identical
+        return;
+    }
+    
+    std::vector<elem> leftTail (leftLinesVec.begin()  + prefixLen, leftLinesVec.end());
+    std::vector<elem> rightTail(rightLinesVec.begin() + prefixLen, rightLinesVec.end());
 
-    dtl::Diff<elem, std::vector<elem> > diff(leftLinesVec, rightLinesVec);
+    dtl::Diff<elem, std::vector<elem> > diff(leftTail, rightTail);
     diff.onHuge();
+    diff.setCancelFlag( &m_cancelled );
     diff.compose();
 
-    if ( 0 == diff.getEditDistance() ) {
-        // nothing to be done - files are identical
+    if ( m_cancelled ) {
         return;
     }
 
+    // Put back the common prefix
+    std::vector<sesElem> seq;
+    {
+        const std::vector<sesElem>& tailSeq = diff.getSes().getSequence();
+        seq.reserve( prefixLen + tailSeq.size() );
+        for(size_t i=0; i<prefixLen; ++i) {
+            dtl::elemInfo info;
+            info.beforeIdx = info.afterIdx = i + 1;
+            info.type = dtl::SES_COMMON;
+            seq.push_back( std::make_pair(leftLinesVec.at(i), info) );
+        }
+        seq.insert(seq.end(), tailSeq.begin(), tailSeq.end());
+    }
+
     if ( mode & clDTL::kTwoPanes ) {
 
         ///////////////////////////////////////////////////////////////////
@@ -86,7 +150,6 @@ void clDTL::Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode m
         ///////////////////////////////////////////////////////////////////
 
         // Loop over the diff and check if it is a whitespace only diff
-        std::vector<sesElem> seq = diff.getSes().getSequence();
         m_resultLeft.reserve( seq.size() );
         m_resultRight.reserve( seq.size() );
 
@@ -123,14 +186,14 @@ void clDTL::Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode m
                     tmpSeqRight.clear();
                     seqSize = 0;
                 }
-                clDTL::LineInfo line(seq.at(i).first, LINE_COMMON);
+                clDTL::LineInfo line(uniqueLines.at(seq.at(i).first), LINE_COMMON);
                 m_resultLeft.push_back( line );
                 m_resultRight.push_back( line );
                 break;
 
             }
             case dtl::SES_ADD: {
-                clDTL::LineInfo lineRight(seq.at(i).first, LINE_ADDED);
+                clDTL::LineInfo lineRight(uniqueLines.at(seq.at(i).first), LINE_ADDED);
                 tmpSeqRight.push_back( lineRight );
 
                 if ( state == STATE_NONE ) {
@@ -141,7 +204,7 @@ void clDTL::Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode m
 
             }
             case dtl::SES_DELETE: {
-                clDTL::LineInfo lineLeft(seq.at(i).first, LINE_REMOVED);
+                clDTL::LineInfo lineLeft(uniqueLines.at(seq.at(i).first), LINE_REMOVED);
                 tmpSeqLeft.push_back( lineLeft );
 
                 if ( state == STATE_NONE ) {
@@ -178,7 +241,6 @@ void clDTL::Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode m
         // One pane diff view
         // designed for displayed on a single editor
         ///////////////////////////////////////////////////////////////////
-        std::vector<sesElem> seq = diff.getSes().getSequence();
         m_resultLeft.reserve( seq.size() );
         int seqStartLine = wxNOT_FOUND;
         for(size_t i=0; i<seq.size(); ++i) {
@@ -188,7 +250,7 @@ void clDTL::Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode m
                     m_sequences.push_back( std::make_pair(seqStartLine, m_resultLeft.size()) );
                     seqStartLine = wxNOT_FOUND;
                 }
-                clDTL::LineInfo line(seq.at(i).first, LINE_COMMON);
+                clDTL::LineInfo line(uniqueLines.at(seq.at(i).first), LINE_COMMON);
                 m_resultLeft.push_back( line );
                 break;
             }
@@ -196,7 +258,7 @@ void clDTL::Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode m
                 if ( seqStartLine == wxNOT_FOUND ) {
                     seqStartLine = m_resultLeft.size();
                 }
-                clDTL::LineInfo line(seq.at(i).first, LINE_ADDED);
+                clDTL::LineInfo line(uniqueLines.at(seq.at(i).first), LINE_ADDED);
                 m_resultLeft.push_back( line );
                 break;
 
@@ -205,7 +267,7 @@ void clDTL::Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode m
                 if ( seqStartLine == wxNOT_FOUND ) {
                     seqStartLine = m_resultLeft.size();
                 }
-                clDTL::LineInfo line(seq.at(i).first, LINE_REMOVED);
+                clDTL::LineInfo line(uniqueLines.at(seq.at(i).first), LINE_REMOVED);
                 m_resultLeft.push_back( line );
                 break;
             }
@@ -218,3 +280,18 @@ void clDTL::Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode m
         }
     }
 }
+
+void clDTL::DoSplitLines(const wxString& content, std::vector<wxString>& lines) const
+{
+    // Same as wxStringTokenize(content, "\n", wxTOKEN_RET_DELIMS) without the wxArrayString
+    size_t start = 0;
+    while ( start < content.length() ) {
+        size_t where = content.find('\n', start);
+        if ( where == wxString::npos ) {
+            lines.push_back( content.Mid(start) );
+            break;
+        }
+        lines.push_back( content.Mid(start, where - start + 1) );
+        start = where + 1;
+    }
+}
@@ -88,6 +88,10 @@ private:
     LineInfoVec_t m_resultLeft;
     LineInfoVec_t m_resultRight;
     SeqLinePair_t m_sequences;
+    volatile bool m_cancelled;
+
+protected:
+    void DoSplitLines(const wxString& content, std::vector<wxString>& lines) const;
 
 public:
     clDTL();
@@ -99,6 +103,16 @@ public:
      */
     void Diff(const wxFileName& fnLeft, const wxFileName& fnRight, DiffMode mode);
 
+    /**
+     * @brief abort a Diff() running in another thread. The result is left empty
+     */
+    void Cancel() {
+        m_cancelled = true;
+    }
+    bool IsCancelled() const {
+        return m_cancelled;
+    }
+
     const LineInfoVec_t& GetResultLeft() const {
         return m_resultLeft;
     }
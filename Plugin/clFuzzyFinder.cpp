@@ -0,0 +1,220 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : clFuzzyFinder.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include "clFuzzyFinder.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <wx/wxcrt.h>
+
+// the worst match is kept on top of the heap so it can be replaced
+struct clFuzzyFinderWorseMatch {
+    const std::vector<wxString>* m_names;
+    clFuzzyFinderWorseMatch(const std::vector<wxString>* names)
+        : m_names(names)
+    {
+    }
+
+    // returns true if 'a' ranks better than 'b'
+    bool operator()(const clFuzzyFinder::Match& a, const clFuzzyFinder::Match& b) const
+    {
+        if(a.m_score != b.m_score) return a.m_score > b.m_score;
+        size_t lenA = m_names->at(a.m_index).length();
+        size_t lenB = m_names->at(b.m_index).length();
+        if(lenA != lenB) return lenA < lenB;
+        return a.m_index < b.m_index;
+    }
+};
+
+clFuzzyFinder::clFuzzyFinder()
+    : m_lastCandidatesValid(false)
+{
+}
+
+clFuzzyFinder::~clFuzzyFinder() {}
+
+wxUint64 clFuzzyFinder::GetCharMask(wxChar ch)
+{
+    // one bit per letter / digit, the rest share a few buckets
+    if(ch >= 'a' && ch <= 'z') return ((wxUint64)1) << (ch - 'a');
+    if(ch >= 'A' && ch <= 'Z') return ((wxUint64)1) << (ch - 'A');
+    if(ch >= '0' && ch <= '9') return ((wxUint64)1) << (26 + ch - '0');
+    if(ch == '_') return ((wxUint64)1) << 36;
+    if(ch < 128) return ((wxUint64)1) << (37 + (ch % 16));
+    return ((wxUint64)1) << 53;
+}
+
+wxUint64 clFuzzyFinder::GetMask(const wxString& str)
+{
+    wxUint64 mask = 0;
+    wxString::const_iterator iter = str.begin();
+    for(; iter != str.end(); ++iter) {
+        mask |= GetCharMask(*iter);
+    }
+    return mask;
+}
+
+size_t clFuzzyFinder::Add(const wxString& name, size_t userData)
+{
+    m_names.push_back(name);
+    m_userData.push_back(userData);
+    m_masks.push_back(GetMask(name));
+    m_lastCandidatesValid = false;
+    return m_names.size() - 1;
+}
+
+void clFuzzyFinder::Reserve(size_t count)
+{
+    m_names.reserve(count);
+    m_userData.reserve(count);
+    m_masks.reserve(count);
+}
+
+void clFuzzyFinder::Clear()
+{
+    m_names.clear();
+    m_userData.clear();
+    m_masks.clear();
+    m_lastQuery.Clear();
+    m_lastCandidates.clear();
+    m_lastCandidatesValid = false;
+}
+
+bool clFuzzyFinder::IsRefinementOf(const wxArrayString& query) const
+{
+    // every name matching 'query' also matches m_lastQuery if each of the previous
+    // words is a prefix of the word at the same position
+    if(!m_lastCandidatesValid || m_lastQuery.IsEmpty() || query.GetCount() < m_lastQuery.GetCount()) return false;
+    for(size_t i = 0; i < m_lastQuery.GetCount(); ++i) {
+        if(!query.Item(i).StartsWith(m_lastQuery.Item(i))) return false;
+    }
+    return true;
+}
+
+int clFuzzyFinder::Score(const wxString& word, const wxString& name)
+{
+    if(word.IsEmpty()) return 0;
+    if(word.length() > name.length()) return wxNOT_FOUND;
+
+    int score = 0;
+    size_t wordPos = 0;
+    size_t lastMatch = wxString::npos;
+    wxChar prev = 0;
+    size_t namePos = 0;
+
+    wxString::const_iterator iter = name.begin();
+    for(; iter != name.end() && wordPos < word.length(); ++iter, ++namePos) {
+        wxChar ch = *iter;
+        if((wxChar)wxTolower(ch) == word[wordPos]) {
+            int bonus = 1;
+            // start of a word: the first char, after a separator or a camelCase hump
+            if(namePos == 0) {
+                bonus += 12;
+            } else if(!wxIsalnum(prev) || (wxIsupper(ch) && wxIslower(prev))) {
+                bonus += 8;
+            }
+            // consecutive characters
+            if(lastMatch != wxString::npos && lastMatch + 1 == namePos) {
+                bonus += 5;
+            }
+            score += bonus;
+            lastMatch = namePos;
+            ++wordPos;
+        }
+        prev = ch;
+    }
+
+    if(wordPos < word.length()) return wxNOT_FOUND;
+
+    if(name.length() == word.length() && name.CmpNoCase(word) == 0) {
+        // exact match
+        score += 100;
+    }
+
+    // prefer shorter names
+    score -= (int)((name.length() - word.length()) / 4);
+    return score < 0 ? 0 : score;
+}
+
+void clFuzzyFinder::Find(const wxArrayString& query, size_t maxResults, clFuzzyFinder::Vec_t& matches)
+{
+    matches.clear();
+    if(query.IsEmpty() || maxResults == 0) return;
+
+    wxUint64 queryMask = 0;
+    for(size_t i = 0; i < query.GetCount(); ++i) {
+        queryMask |= GetMask(query.Item(i));
+    }
+
+    // when the user keeps typing, only the previous matches can still match
+    bool refine = IsRefinementOf(query);
+    std::vector<size_t> candidates;
+    size_t count = refine ? m_lastCandidates.size() : m_names.size();
+
+    clFuzzyFinderWorseMatch better(&m_names);
+    std::priority_queue<Match, std::vector<Match>, clFuzzyFinderWorseMatch> heap(better);
+
+    for(size_t i = 0; i < count; ++i) {
+        size_t index = refine ? m_lastCandidates[i] : i;
+
+        // cheap pre-filter: the name must contain all the characters of the query
+        if((m_masks[index] & queryMask) != queryMask) continue;
+
+        const wxString& name = m_names[index];
+        int score = 0;
+        bool matched = true;
+        for(size_t w = 0; w < query.GetCount(); ++w) {
+            int wordScore = Score(query.Item(w), name);
+            if(wordScore == wxNOT_FOUND) {
+                matched = false;
+                break;
+            }
+            score += wordScore;
+        }
+
+        if(!matched) continue;
+        candidates.push_back(index);
+
+        Match match(index, score);
+        if(heap.size() < maxResults) {
+            heap.push(match);
+        } else if(better(match, heap.top())) {
+            heap.pop();
+            heap.push(match);
+        }
+    }
+
+    m_lastQuery = query;
+    m_lastCandidates.swap(candidates);
+    m_lastCandidatesValid = true;
+
+    matches.reserve(heap.size());
+    while(!heap.empty()) {
+        matches.push_back(heap.top());
+        heap.pop();
+    }
+    // the heap pops the worst match first
+    std::reverse(matches.begin(), matches.end());
+}
@@ -0,0 +1,108 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : clFuzzyFinder.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef CLFUZZYFINDER_H
+#define CLFUZZYFINDER_H
+
+#include "codelite_exports.h"
+#include <wx/string.h>
+#include <wx/arrstr.h>
+#include <vector>
+
+/**
+ * @class clFuzzyFinder
+ * @brief an in-memory index of names (files, symbols) searchable with a fuzzy (subsequence) matcher.
+ * A name matches a query when every query word appears in it as a case insensitive subsequence,
+ * e.g. "opdlg" matches "OpenResourceDialog". Matches are ranked (word starts, consecutive
+ * characters and shorter names score higher) and only the best 'maxResults' are kept.
+ * When a query extends the previous one, only the previous matches are re-scanned.
+ */
+class WXDLLIMPEXP_SDK clFuzzyFinder
+{
+public:
+    struct Match {
+        size_t m_index; // the entry index as returned by Add()
+        int m_score;
+
+        Match()
+            : m_index(0)
+            , m_score(0)
+        {
+        }
+        Match(size_t index, int score)
+            : m_index(index)
+            , m_score(score)
+        {
+        }
+    };
+    typedef std::vector<Match> Vec_t;
+
+protected:
+    std::vector<wxString> m_names;
+    std::vector<size_t> m_userData;
+    std::vector<wxUint64> m_masks; // kept apart from the names so the pre-filter scans a contiguous array
+
+    // state for incremental refinement
+    wxArrayString m_lastQuery;
+    std::vector<size_t> m_lastCandidates;
+    bool m_lastCandidatesValid;
+
+protected:
+    static wxUint64 GetCharMask(wxChar ch);
+    static wxUint64 GetMask(const wxString& str);
+    bool IsRefinementOf(const wxArrayString& query) const;
+
+public:
+    clFuzzyFinder();
+    virtual ~clFuzzyFinder();
+
+    /**
+     * @brief add a name to the index, returns its index
+     * @param userData opaque value returned by GetUserData()
+     */
+    size_t Add(const wxString& name, size_t userData);
+    void Reserve(size_t count);
+    void Clear();
+    size_t GetCount() const { return m_names.size(); }
+
+    const wxString& GetName(size_t index) const { return m_names.at(index); }
+    size_t GetUserData(size_t index) const { return m_userData.at(index); }
+
+    /**
+     * @brief find the best matches for 'query'
+     * @param query list of lower case words, all of them must match
+     * @param maxResults the number of matches to keep
+     * @param matches [output] sorted by score, best first
+     */
+    void Find(const wxArrayString& query, size_t maxResults, clFuzzyFinder::Vec_t& matches);
+
+    /**
+     * @brief score 'name' against a single lower case 'word'.
+     * @return wxNOT_FOUND if 'word' is not a subsequence of 'name', a non-negative score otherwise
+     */
+    static int Score(const wxString& word, const wxString& name);
+};
+
+#endif // CLFUZZYFINDER_H
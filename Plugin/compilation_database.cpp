@@ -36,9 +36,131 @@
 #include <wx/dir.h>
 #include <algorithm>
 #include "file_logger.h"
+#include <wx/thread.h>
+#include <wx/msgqueue.h>
+#include <vector>
 
 const wxString DB_VERSION = "2.0";
 
+// number of rows passed from the reader thread to the inserting thread at once
+#define COMPILE_COMMANDS_BATCH_SIZE 500
+// maximum number of batches waiting to be inserted (bounds the memory used)
+#define COMPILE_COMMANDS_MAX_PENDING 8
+
+struct CompileCommandsRow {
+    wxString file;
+    wxString path;
+    wxString cwd;
+    wxString cmd;
+};
+typedef std::vector<CompileCommandsRow> CompileCommandsBatch_t;
+
+/**
+ * @brief read the next valid row from compile_commands.json
+ */
+static bool ReadCompileCommandsRow(JSONArrayReader& reader, CompileCommandsRow& row)
+{
+    while(reader.next()) {
+        // Each object has 3 properties:
+        // directory, command, file
+        JSONElement element = reader.current();
+        if(element.hasNamedObject("file") && element.hasNamedObject("directory") && element.hasNamedObject("command")) {
+            row.cmd = element.namedObject("command").toString();
+            row.file = element.namedObject("file").toString();
+            row.path = wxFileName(row.file).GetPath();
+            row.cwd = element.namedObject("directory").toString();
+
+            row.cwd = wxFileName(row.cwd, "").GetPath();
+            row.file = wxFileName(row.file).GetFullPath();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @class CompileCommandsReaderThread
+ * @brief parse compile_commands.json on a secondary thread while the calling thread inserts
+ * the rows into the database. Rows are passed in batches, a NULL batch marks the end
+ */
+class CompileCommandsReaderThread : public wxThread
+{
+    JSONArrayReader& m_reader;
+    wxMessageQueue<CompileCommandsBatch_t*> m_queue;
+    wxSemaphore m_slots;
+    bool m_cancelled;
+    bool m_done;
+
+public:
+    CompileCommandsReaderThread(JSONArrayReader& reader)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_reader(reader)
+        , m_slots(COMPILE_COMMANDS_MAX_PENDING, COMPILE_COMMANDS_MAX_PENDING)
+        , m_cancelled(false)
+        , m_done(false)
+    {
+    }
+    virtual ~CompileCommandsReaderThread() {}
+
+    /**
+     * @brief return the next batch of rows or NULL when there are no more rows.
+     * The caller takes ownership of the batch
+     */
+    CompileCommandsBatch_t* Pop()
+    {
+        if(m_done) return NULL;
+        CompileCommandsBatch_t* batch = NULL;
+        m_queue.Receive(batch);
+        m_slots.Post();
+        if(!batch) m_done = true;
+        return batch;
+    }
+
+    /**
+     * @brief stop the thread and wait for it to exit
+     */
+    void Stop()
+    {
+        m_cancelled = true;
+        // drain the queue so the thread is not blocked waiting for a free slot
+        CompileCommandsBatch_t* batch = NULL;
+        while((batch = Pop())) {
+            delete batch;
+        }
+        Wait();
+    }
+
+protected:
+    void* Entry()
+    {
+        CompileCommandsBatch_t* batch = new CompileCommandsBatch_t();
+        batch->reserve(COMPILE_COMMANDS_BATCH_SIZE);
+
+        CompileCommandsRow row;
+        while(!m_cancelled && ReadCompileCommandsRow(m_reader, row)) {
+            batch->push_back(row);
+            if(batch->size() == COMPILE_COMMANDS_BATCH_SIZE) {
+                m_slots.Wait();
+                m_queue.Post(batch);
+                batch = new CompileCommandsBatch_t();
+                batch->reserve(COMPILE_COMMANDS_BATCH_SIZE);
+            }
+        }
+
+        if(!batch->empty()) {
+            m_slots.Wait();
+            m_queue.Post(batch);
+        } else {
+            delete batch;
+        }
+
+        // mark the end
+        m_slots.Wait();
+        m_queue.Post(NULL);
+        return NULL;
+    }
+};
+
 struct wxFileNameSorter
 {
     bool operator()(const wxFileName& one, const wxFileName& two) const
@@ -318,9 +440,22 @@ FileNameVector_t CompilationDatabase::GetCompileCommandsFiles() const
 
 void CompilationDatabase::ProcessCMakeCompilationDatabase(const wxFileName& compile_commands)
 {
-    JSONRoot root(compile_commands);
-    JSONElement arr = root.toElement();
+    // compile_commands.json can be huge: read it one array item at a time instead of
+    // loading the whole DOM
+    JSONArrayReader reader(compile_commands);
+    if(!reader.isOk()) {
+        CL_DEBUG("Could not read compilation database %s: %s", compile_commands.GetFullPath(), reader.errorString());
+        return;
+    }
 
+    CompileCommandsReaderThread* readerThread = new CompileCommandsReaderThread(reader);
+    if(readerThread->Create() != wxTHREAD_NO_ERROR || readerThread->Run() != wxTHREAD_NO_ERROR) {
+        // no secondary thread, parse and insert on this thread
+        delete readerThread;
+        readerThread = NULL;
+    }
+
+    CompileCommandsBatch_t* batch = NULL;
     try {
 
         wxString sql;
@@ -328,25 +463,18 @@ void CompilationDatabase::ProcessCMakeCompilationDatabase(const wxFileName& comp
         wxSQLite3Statement st = m_db->PrepareStatement(sql);
         m_db->ExecuteUpdate("BEGIN");
 
-        for(int i = 0; i < arr.arraySize(); ++i) {
-            // Each object has 3 properties:
-            // directory, command, file
-            JSONElement element = arr.arrayItem(i);
-            if(element.hasNamedObject("file") && element.hasNamedObject("directory") &&
-               element.hasNamedObject("command")) {
-                wxString cmd = element.namedObject("command").toString();
-                wxString file = element.namedObject("file").toString();
-                wxString path = wxFileName(file).GetPath();
-                wxString cwd = element.namedObject("directory").toString();
-
-                cwd = wxFileName(cwd, "").GetPath();
-                file = wxFileName(file).GetFullPath();
-
-                st.Bind(1, file);
-                st.Bind(2, path);
-                st.Bind(3, cwd);
-                st.Bind(4, cmd);
-                st.ExecuteUpdate();
+        if(readerThread) {
+            while((batch = readerThread->Pop())) {
+                for(size_t i = 0; i < batch->size(); ++i) {
+                    DoInsertCompilationRow(st, batch->at(i).file, batch->at(i).path, batch->at(i).cwd, batch->at(i).cmd);
+                }
+                wxDELETE(batch);
+            }
+
+        } else {
+            CompileCommandsRow row;
+            while(ReadCompileCommandsRow(reader, row)) {
+                DoInsertCompilationRow(st, row.file, row.path, row.cwd, row.cmd);
             }
         }
 
@@ -355,6 +483,25 @@ void CompilationDatabase::ProcessCMakeCompilationDatabase(const wxFileName& comp
     } catch(wxSQLite3Exception& e) {
         wxUnusedVar(e);
     }
+
+    wxDELETE(batch);
+    if(readerThread) {
+        readerThread->Stop();
+        delete readerThread;
+    }
+}
+
+void CompilationDatabase::DoInsertCompilationRow(wxSQLite3Statement& st,
+                                                 const wxString& file,
+                                                 const wxString& path,
+                                                 const wxString& cwd,
+                                                 const wxString& cmd)
+{
+    st.Bind(1, file);
+    st.Bind(2, path);
+    st.Bind(3, cwd);
+    st.Bind(4, cmd);
+    st.ExecuteUpdate();
 }
 
 wxFileName CompilationDatabase::ConvertCodeLiteCompilationDatabaseToCMake(const wxFileName& compile_file)
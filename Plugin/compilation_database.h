@@ -45,6 +45,7 @@ protected:
      * @brief create our compilation database out of CMake's compile_commands.json file
      */
     void ProcessCMakeCompilationDatabase( const wxFileName &compile_commands );
+    void DoInsertCompilationRow(wxSQLite3Statement& st, const wxString& file, const wxString& path, const wxString& cwd, const wxString& cmd);
     
     wxFileName ConvertCodeLiteCompilationDatabaseToCMake( const wxFileName &compile_file );
     
@@ -92,6 +92,7 @@ namespace dtl {
         bool               editDistanceOnly;
         uniHunkVec         uniHunks;
         comparator         cmp;
+        const volatile bool* cancelled;
     public :
         Diff () {}
         
@@ -141,6 +142,18 @@ namespace dtl {
             return uniHunks;
         }
         
+        /**
+         * set a flag polled by compose(). Once it becomes true compose() returns
+         * without recording any sequence
+         */
+        void setCancelFlag (const volatile bool* flag) {
+            cancelled = flag;
+        }
+        
+        bool isCancelled () const {
+            return cancelled && *cancelled;
+        }
+        
         /* These should be deprecated */
         bool isHuge () const {
             return huge;
@@ -301,7 +314,12 @@ namespace dtl {
                     fp[k+offset] = snake(k, fp[k-1+offset]+1, fp[k+1+offset]);
                 }
                 fp[delta+offset] = snake(static_cast<long long>(delta), fp[delta-1+offset]+1, fp[delta+1+offset]);
-            } while (fp[delta+offset] != static_cast<long long>(N) && pathCordinates.size() < MAX_CORDINATES_SIZE);
+            } while (fp[delta+offset] != static_cast<long long>(N) && pathCordinates.size() < MAX_CORDINATES_SIZE && !isCancelled());
+            
+            if (isCancelled()) {
+                delete[] this->fp;
+                return;
+            }
             
             editDistance += static_cast<long long>(delta) + 2 * p;
             long long r = path[delta+offset];
@@ -574,6 +592,7 @@ namespace dtl {
             trivial          = false;
             editDistanceOnly = false;
             fp               = NULL;
+            cancelled        = NULL;
         }
         
         /**
@@ -31,6 +31,8 @@
 #include "wx_xml_compatibility.h"
 #include "drawingutils.h"
 #include <algorithm>
+#include <wx/datstrm.h>
+#include <wx/mstream.h>
 
 #ifdef __WXMSW__
 #define DEFAULT_FACE_NAME "Consolas"
@@ -167,6 +169,102 @@ void LexerConf::FromXml(wxXmlNode* element)
 
 LexerConf::~LexerConf() {}
 
+void LexerConf::ToBinary(wxDataOutputStream& out) const
+{
+    out.WriteString(m_name);
+    out.WriteString(m_themeName);
+    out.WriteString(m_extension);
+    out.Write32((wxUint32)m_lexerId);
+    out.Write8(m_isActive ? 1 : 0);
+    out.Write8(m_styleWithinPreProcessor ? 1 : 0);
+    out.Write8(m_useCustomTextSelectionFgColour ? 1 : 0);
+
+    // The keywords and the styles are written as a single block (prefixed by its size)
+    // so FromBinary() can keep it aside without decoding it
+    wxMemoryOutputStream bodyStream;
+    {
+        wxDataOutputStream body(bodyStream);
+        const StyleProperty::List_t& styles = GetLexerProperties();
+        for(int i = 0; i < 10; ++i) {
+            body.WriteString(m_keyWords[i]);
+        }
+
+        body.Write32((wxUint32)styles.size());
+        StyleProperty::List_t::const_iterator iter = styles.begin();
+        for(; iter != styles.end(); ++iter) {
+            body.Write32((wxUint32)iter->GetId());
+            body.WriteString(iter->GetFgColour());
+            body.WriteString(iter->GetBgColour());
+            body.Write32((wxUint32)iter->GetFontSize());
+            body.WriteString(iter->GetName());
+            body.WriteString(iter->GetFaceName());
+            body.Write8(iter->IsBold() ? 1 : 0);
+            body.Write8(iter->GetItalic() ? 1 : 0);
+            body.Write8(iter->GetUnderlined() ? 1 : 0);
+            body.Write8(iter->GetEolFilled() ? 1 : 0);
+            body.Write32((wxUint32)iter->GetAlpha());
+        }
+    }
+
+    size_t bodyLen = bodyStream.GetLength();
+    out.Write32((wxUint32)bodyLen);
+    if(bodyLen) {
+        out.Write8((const wxUint8*)bodyStream.GetOutputStreamBuffer()->GetBufferStart(), bodyLen);
+    }
+}
+
+bool LexerConf::FromBinary(wxDataInputStream& in)
+{
+    m_name = in.ReadString();
+    m_themeName = in.ReadString();
+    m_extension = in.ReadString();
+    m_lexerId = (wxInt32)in.Read32();
+    m_isActive = in.Read8() != 0;
+    m_styleWithinPreProcessor = in.Read8() != 0;
+    m_useCustomTextSelectionFgColour = in.Read8() != 0;
+
+    m_properties.clear();
+    m_pendingBody = wxMemoryBuffer();
+    wxUint32 bodyLen = in.Read32();
+    if(bodyLen && in.IsOk()) {
+        in.Read8((wxUint8*)m_pendingBody.GetWriteBuf(bodyLen), bodyLen);
+        m_pendingBody.UngetWriteBuf(bodyLen);
+    }
+    return in.IsOk();
+}
+
+void LexerConf::DoDecodeBody() const
+{
+    LexerConf* self = const_cast<LexerConf*>(this);
+    {
+        wxMemoryInputStream bodyStream(m_pendingBody.GetData(), m_pendingBody.GetDataLen());
+        wxDataInputStream body(bodyStream);
+        for(int i = 0; i < 10; ++i) {
+            self->m_keyWords[i] = body.ReadString();
+        }
+
+        self->m_properties.clear();
+        wxUint32 count = body.Read32();
+        for(wxUint32 i = 0; i < count && body.IsOk(); ++i) {
+            int id = (wxInt32)body.Read32();
+            wxString fgColour = body.ReadString();
+            wxString bgColour = body.ReadString();
+            int fontSize = (wxInt32)body.Read32();
+            wxString name = body.ReadString();
+            wxString face = body.ReadString();
+            bool bold = body.Read8() != 0;
+            bool italic = body.Read8() != 0;
+            bool underline = body.Read8() != 0;
+            bool eolFilled = body.Read8() != 0;
+            int alpha = (wxInt32)body.Read32();
+            self->m_properties.push_back(
+                StyleProperty(id, fgColour, bgColour, fontSize, name, face, bold, italic, underline, eolFilled, alpha));
+        }
+    }
+    // Don't modify the buffer in place: copies of this lexer may still share it
+    m_pendingBody = wxMemoryBuffer();
+}
+
 wxXmlNode* LexerConf::ToXml() const
 {
     // convert the lexer back xml node
@@ -210,8 +308,9 @@ wxXmlNode* LexerConf::ToXml() const
 
     // set the properties
     wxXmlNode* properties = new wxXmlNode(NULL, wxXML_ELEMENT_NODE, wxT("Properties"));
-    std::list<StyleProperty>::const_iterator iter = m_properties.begin();
-    for(; iter != m_properties.end(); iter++) {
+    const StyleProperty::List_t& styles = GetLexerProperties();
+    std::list<StyleProperty>::const_iterator iter = styles.begin();
+    for(; iter != styles.end(); iter++) {
         StyleProperty p = (*iter);
         wxXmlNode* property = new wxXmlNode(NULL, wxXML_ELEMENT_NODE, wxT("Property"));
 
@@ -242,6 +341,7 @@ wxXmlNode* LexerConf::ToXml() const
 
 wxFont LexerConf::GetFontForSyle(int styleId) const
 {
+    DoLoadPendingBody();
     StyleProperty::List_t::const_iterator iter = m_properties.begin();
     for(; iter != m_properties.end(); ++iter) {
         if(iter->GetId() == styleId) {
@@ -477,6 +577,7 @@ void LexerConf::Apply(wxStyledTextCtrl* ctrl, bool applyKeywords)
 
 StyleProperty& LexerConf::GetProperty(int propertyId)
 {
+    DoLoadPendingBody();
     StyleProperty::List_t::iterator iter =
         std::find_if(m_properties.begin(), m_properties.end(), StyleProperty::FindByID(propertyId));
     if(iter == m_properties.end()) {
@@ -33,8 +33,12 @@
 #include "codelite_exports.h"
 #include <wx/stc/stc.h>
 #include <wx/sharedptr.h>
+#include <wx/buffer.h>
 #include <smart_ptr.h>
 
+class wxDataInputStream;
+class wxDataOutputStream;
+
 class WXDLLIMPEXP_SDK LexerConf
 {
     StyleProperty::List_t m_properties;
@@ -46,6 +50,16 @@ class WXDLLIMPEXP_SDK LexerConf
     wxString m_themeName;
     bool m_isActive;
     bool m_useCustomTextSelectionFgColour;
+    // A lexer restored with FromBinary() keeps its keywords and styles
+    // serialized here until they are needed for the first time
+    mutable wxMemoryBuffer m_pendingBody;
+
+private:
+    void DoLoadPendingBody() const
+    {
+        if(m_pendingBody.GetDataLen()) DoDecodeBody();
+    }
+    void DoDecodeBody() const;
 
 public:
     typedef SmartPtr<LexerConf> Ptr_t;
@@ -74,6 +88,12 @@ public:
     // Parse lexer object from xml node
     void FromXml(wxXmlNode* node);
 
+    // Write this object into the binary lexers cache
+    void ToBinary(wxDataOutputStream& out) const;
+
+    // Read an object written by ToBinary(). The keywords and styles are decoded on first use
+    bool FromBinary(wxDataInputStream& in);
+
 public:
     LexerConf();
     virtual ~LexerConf();
@@ -120,9 +140,17 @@ public:
      * Return the lexer keywords
      * \return
      */
-    const wxString& GetKeyWords(int set) const { return m_keyWords[set]; }
+    const wxString& GetKeyWords(int set) const
+    {
+        DoLoadPendingBody();
+        return m_keyWords[set];
+    }
 
-    void SetKeyWords(const wxString& keywords, int set) { m_keyWords[set] = keywords; }
+    void SetKeyWords(const wxString& keywords, int set)
+    {
+        DoLoadPendingBody();
+        m_keyWords[set] = keywords;
+    }
 
     /**
      * File patterns that this lexer should apply to
@@ -132,13 +160,21 @@ public:
      * Return a list of the lexer properties
      * \return
      */
-    const StyleProperty::List_t& GetLexerProperties() const { return m_properties; }
+    const StyleProperty::List_t& GetLexerProperties() const
+    {
+        DoLoadPendingBody();
+        return m_properties;
+    }
 
     /**
      * Return a list of the lexer properties
      * \return
      */
-    StyleProperty::List_t& GetLexerProperties() { return m_properties; }
+    StyleProperty::List_t& GetLexerProperties()
+    {
+        DoLoadPendingBody();
+        return m_properties;
+    }
 
     /**
      * @brief return property. Check for IsNull() to make sure we got a valid property
@@ -151,7 +187,11 @@ public:
      * Set the lexer properties
      * \param &properties
      */
-    void SetProperties(StyleProperty::List_t& properties) { m_properties = properties; }
+    void SetProperties(StyleProperty::List_t& properties)
+    {
+        DoLoadPendingBody();
+        m_properties = properties;
+    }
     /**
      * Set file spec for the lexer
      * \param &spec
@@ -41,16 +41,101 @@
 #include <vector>
 #include <codelite_events.h>
 
-BEGIN_EVENT_TABLE(OpenResourceDialog, OpenResourceDialogBase)
-    EVT_TIMER(XRCID("OR_TIMER"), OpenResourceDialog::OnTimer)
-END_EVENT_TABLE()
+// the number of names we keep from the fuzzy finder
+#define OR_MAX_MATCHES 300
+// the maximum number of rows displayed (a single name can expand to many tags)
+#define OR_MAX_ROWS    1000
+
+// the user data stored in the fuzzy finder: the lowest bit marks a tag name,
+// the rest is an index into m_files (workspace files only)
+#define OR_IS_TAG(userData)     ((userData) & 1)
+#define OR_FILE_INDEX(userData) ((userData) >> 1)
+
+//-------------------------------------------------------------
+// OpenResourceListCtrl
+//-------------------------------------------------------------
+
+OpenResourceListCtrl::OpenResourceListCtrl(wxWindow* parent)
+    : wxListView(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_HRULES|wxLC_REPORT|wxLC_SINGLE_SEL|wxLC_VRULES|wxLC_VIRTUAL)
+{
+}
+
+OpenResourceListCtrl::~OpenResourceListCtrl()
+{
+}
+
+void OpenResourceListCtrl::SetRows(std::vector<OpenResourceDialogRow>& rows)
+{
+    m_rows.swap(rows);
+    SetItemCount(m_rows.size());
+    Refresh();
+}
+
+void OpenResourceListCtrl::ClearRows()
+{
+    m_rows.clear();
+    SetItemCount(0);
+    Refresh();
+}
+
+const OpenResourceDialogRow* OpenResourceListCtrl::GetRowAt(long item) const
+{
+    if ( item < 0 || item >= (long)m_rows.size() )
+        return NULL;
+    return &m_rows.at(item);
+}
+
+const OpenResourceDialogItemData* OpenResourceListCtrl::GetItemDataAt(long item) const
+{
+    const OpenResourceDialogRow* row = GetRowAt(item);
+    return row ? &row->m_data : NULL;
+}
+
+wxString OpenResourceListCtrl::OnGetItemText(long item, long column) const
+{
+    const OpenResourceDialogRow* row = GetRowAt(item);
+    if ( !row )
+        return wxEmptyString;
+    return column == 0 ? row->m_name : row->m_fullname;
+}
+
+int OpenResourceListCtrl::OnGetItemImage(long item) const
+{
+    const OpenResourceDialogRow* row = GetRowAt(item);
+    return row ? row->m_imgId : wxNOT_FOUND;
+}
+
+wxListItemAttr* OpenResourceListCtrl::OnGetItemAttr(long item) const
+{
+    // Mark implementations with bold font
+    const OpenResourceDialogRow* row = GetRowAt(item);
+    if ( !row || !row->m_bold )
+        return NULL;
+
+    wxFont font = wxSystemSettings::GetFont(wxSYS_DEFAULT_GUI_FONT);
+    font.SetWeight(wxFONTWEIGHT_BOLD);
+    m_attr.SetFont(font);
+    return &m_attr;
+}
+
+//-------------------------------------------------------------
+// OpenResourceDialog
+//-------------------------------------------------------------
 
 OpenResourceDialog::OpenResourceDialog( wxWindow* parent, IManager *manager)
     : OpenResourceDialogBase( parent )
     , m_manager(manager)
-    , m_needRefresh(false)
+    , m_indexBuilt(false)
+    , m_list(NULL)
 {
     Hide();
+
+    // Replace the list generated by the designer with a virtual one
+    m_list = new OpenResourceListCtrl(this);
+    GetSizer()->Replace(m_listOptions, m_list);
+    m_listOptions->Destroy();
+    m_listOptions = m_list;
+
     // Create an image list
     wxImageList *li = new wxImageList(16, 16, true);
     BitmapLoader *bmpLoader = m_manager->GetStdIcons();
@@ -74,12 +159,11 @@ OpenResourceDialog::OpenResourceDialog( wxWindow* parent, IManager *manager)
     m_tagImgMap[wxT("wxfb")]               = li->Add(bmpLoader->LoadBitmap(wxT("mime/16/wxfb")));
     m_tagImgMap[wxT("wxcp")]               = li->Add(bmpLoader->LoadBitmap(wxT("mime/16/wxcp")));
 
-    m_listOptions->AssignImageList(li, wxIMAGE_LIST_SMALL);
+    m_list->AssignImageList(li, wxIMAGE_LIST_SMALL);
 
-    m_timer = new wxTimer(this, XRCID("OR_TIMER"));
-    MSWSetNativeTheme(m_listOptions);
-    m_listOptions->InsertColumn(0, wxT("Name"));
-    m_listOptions->InsertColumn(1, wxT("Full path"));
+    MSWSetNativeTheme(m_list);
+    m_list->InsertColumn(0, wxT("Name"), wxLIST_FORMAT_LEFT, 200);
+    m_list->InsertColumn(1, wxT("Full path"), wxLIST_FORMAT_LEFT, 600);
 
     m_textCtrlResourceName->SetFocus();
     SetLabel(_("Open resource..."));
@@ -98,31 +182,24 @@ OpenResourceDialog::OpenResourceDialog( wxWindow* parent, IManager *manager)
 
             if ( p ) {
                 p->GetFiles(fileNames, true);
-
-                //convert std::vector to wxArrayString
                 for ( std::vector<wxFileName>::iterator it = fileNames.begin(); it != fileNames.end(); it ++ ) {
-                    wxString name = it->GetFullName().MakeLower();
-                    m_files.insert(std::make_pair(name, it->GetFullPath()) );
+                    m_files.push_back( it->GetFullPath() );
                 }
             }
         }
     }
-    m_listOptions->Connect( wxEVT_COMMAND_LIST_ITEM_ACTIVATED, wxListEventHandler( OpenResourceDialog::OnItemActivated ), NULL, this );
-    m_listOptions->Connect( wxEVT_COMMAND_LIST_ITEM_SELECTED,  wxListEventHandler( OpenResourceDialog::OnItemSelected ), NULL, this );
+    m_list->Connect( wxEVT_COMMAND_LIST_ITEM_ACTIVATED, wxListEventHandler( OpenResourceDialog::OnItemActivated ), NULL, this );
+    m_list->Connect( wxEVT_COMMAND_LIST_ITEM_SELECTED,  wxListEventHandler( OpenResourceDialog::OnItemSelected ), NULL, this );
 }
 
 OpenResourceDialog::~OpenResourceDialog()
 {
-    m_timer->Stop();
-    delete m_timer;
     WindowAttrManager::Save(this, wxT("OpenResourceDialog"), m_manager->GetConfigTool());
 }
 
 void OpenResourceDialog::OnText( wxCommandEvent& event )
 {
     event.Skip();
-    m_timer->Stop();
-    m_timer->Start(200, true);
 
     wxString filter = m_textCtrlResourceName->GetValue();
     filter.Trim().Trim(false);
@@ -130,10 +207,10 @@ void OpenResourceDialog::OnText( wxCommandEvent& event )
     if(filter.IsEmpty()) {
         // The filter content is cleared, delete all entries
         Clear();
-        m_needRefresh = false;
 
     } else {
-        m_needRefresh = true;
+        // searching the in-memory index is fast enough to be done on every key stroke
+        DoPopulateList();
 
     }
 }
@@ -148,9 +225,9 @@ void OpenResourceDialog::OnUsePartialMatching( wxCommandEvent& event )
 void OpenResourceDialog::OnEnter(wxCommandEvent& event)
 {
     wxUnusedVar(event);
-    int sel = m_listOptions->GetFirstSelected();
+    int sel = m_list->GetFirstSelected();
     if (sel != wxNOT_FOUND) {
-        OpenResourceDialogItemData *data = (OpenResourceDialogItemData *) m_listOptions->GetItemData(sel);
+        const OpenResourceDialogItemData *data = m_list->GetItemDataAt(sel);
         if (data) {
             m_selection = *data;
             EndModal(wxID_OK);
@@ -162,7 +239,7 @@ void OpenResourceDialog::OnItemActivated(wxListEvent& event)
 {
     int sel = event.m_itemIndex;
     if (sel != wxNOT_FOUND) {
-        OpenResourceDialogItemData *data = (OpenResourceDialogItemData *) m_listOptions->GetItemData(sel);
+        const OpenResourceDialogItemData *data = m_list->GetItemDataAt(sel);
         if (data) {
             m_selection = *data;
             EndModal(wxID_OK);
@@ -170,6 +247,32 @@ void OpenResourceDialog::OnItemActivated(wxListEvent& event)
     }
 }
 
+void OpenResourceDialog::DoBuildIndex()
+{
+    // The filters are set by the caller after the dialog is constructed,
+    // so the index is built the first time the user types something
+    if ( m_indexBuilt )
+        return;
+    m_indexBuilt = true;
+
+    wxArrayString names;
+    m_manager->GetTagsManager()->GetTagsNamesNoLimit(m_filters, names);
+
+    bool includeFiles = m_filters.IsEmpty() || m_filters.Index(TagEntry::KIND_FILE) != wxNOT_FOUND;
+    m_finder.Reserve(names.GetCount() + (includeFiles ? m_files.size() : 0));
+
+    if ( includeFiles ) {
+        for(size_t i=0; i<m_files.size(); ++i) {
+            wxFileName fn(m_files.at(i));
+            m_finder.Add(fn.GetFullName(), (i << 1));
+        }
+    }
+
+    for(size_t i=0; i<names.GetCount(); ++i) {
+        m_finder.Add(names.Item(i), 1);
+    }
+}
+
 void OpenResourceDialog::DoPopulateList()
 {
     wxString name = m_textCtrlResourceName->GetValue();
@@ -178,141 +281,129 @@ void OpenResourceDialog::DoPopulateList()
         return;
 
     Clear();
+    DoBuildIndex();
 
-    wxWindowUpdateLocker locker(m_listOptions);
-
-    // First add the workspace files
-    
     // Prepare the user filter
-    m_userFilters.Clear();
     m_userFilters = ::wxStringTokenize(name, " \t", wxTOKEN_STRTOK);
     for(size_t i=0; i<m_userFilters.GetCount(); ++i) {
         m_userFilters.Item(i).MakeLower();
     }
-    
-    DoPopulateWorkspaceFile();
-    DoPopulateTags();
 
-    if(m_listOptions->GetItemCount()) {
-        m_listOptions->SetColumnWidth(0, wxLIST_AUTOSIZE);
-        m_listOptions->SetColumnWidth(1, wxLIST_AUTOSIZE);
-    } else {
-        m_listOptions->SetColumnWidth(0, wxLIST_AUTOSIZE_USEHEADER);
-        m_listOptions->SetColumnWidth(1, wxLIST_AUTOSIZE_USEHEADER);
-    }
-}
+    clFuzzyFinder::Vec_t matches;
+    m_finder.Find(m_userFilters, OR_MAX_MATCHES, matches);
 
-void OpenResourceDialog::DoPopulateTags()
-{
-    bool gotExactMatch(false);
+    // Fetch the tags of all the matched names with a single query
+    wxArrayString tagNames;
+    for(size_t i=0; i<matches.size(); ++i) {
+        if ( OR_IS_TAG(m_finder.GetUserData(matches.at(i).m_index)) ) {
+            tagNames.Add( m_finder.GetName(matches.at(i).m_index) );
+        }
+    }
 
-    // Next, add the tags
-    TagEntryPtrVector_t tags;
-    if ( m_userFilters.IsEmpty() )
-        return;
-    
-    m_manager->GetTagsManager()->GetTagsByPartialName(m_userFilters.Item(0), tags);
+    std::map<wxString, TagEntryPtrVector_t> tagsByName;
+    if ( !tagNames.IsEmpty() ) {
+        TagEntryPtrVector_t tags;
+        m_manager->GetTagsManager()->GetTagsByNames(tagNames, tags);
+        for(size_t i=0; i<tags.size(); ++i) {
+            tagsByName[tags.at(i)->GetName()].push_back( tags.at(i) );
+        }
+    }
 
-    for (size_t i=0; i<tags.size(); i++) {
-        TagEntryPtr tag = tags.at(i);
-        
-        // Filter out non relevanting entries
-        if ( !m_filters.IsEmpty() && m_filters.Index(tag->GetKind()) == wxNOT_FOUND )
-            continue;
-        
-        if ( !MatchesFilter( tag->GetName()) )
+    // Build the rows, keeping the fuzzy finder ranking
+    std::vector<OpenResourceDialogRow> rows;
+    for(size_t i=0; i<matches.size() && rows.size() < OR_MAX_ROWS; ++i) {
+        size_t userData = m_finder.GetUserData(matches.at(i).m_index);
+        if ( !OR_IS_TAG(userData) ) {
+            DoAddFileRow(m_files.at(OR_FILE_INDEX(userData)), rows);
             continue;
-            
-        wxString name(tag->GetName());
-
-        // keep the fullpath
-        int index(0);
-        wxString fullname;
-        if(tag->GetKind() == wxT("function") || tag->GetKind() == wxT("prototype")) {
-            fullname = wxString::Format(wxT("%s::%s%s"), tag->GetScope().c_str(), tag->GetName().c_str(), tag->GetSignature().c_str());
-            index = DoAppendLine(tag->GetName(),
-                                 fullname,
-                                 (tag->GetKind() == wxT("function")),
-                                 new OpenResourceDialogItemData(tag->GetFile(), tag->GetLine(), tag->GetPattern(), tag->GetName(), tag->GetScope()),
-                                 DoGetTagImgId(tag));
-        } else {
+        }
 
-            fullname = wxString::Format(wxT("%s::%s"), tag->GetScope().c_str(), tag->GetName().c_str());
-            index = DoAppendLine(tag->GetName(),
-                                 fullname,
-                                 false,
-                                 new OpenResourceDialogItemData(tag->GetFile(), tag->GetLine(), tag->GetPattern(), tag->GetName(), tag->GetScope()),
-                                 DoGetTagImgId(tag));
+        std::map<wxString, TagEntryPtrVector_t>::iterator iter = tagsByName.find( m_finder.GetName(matches.at(i).m_index) );
+        if ( iter == tagsByName.end() )
+            continue;
 
+        for(size_t j=0; j<iter->second.size() && rows.size() < OR_MAX_ROWS; ++j) {
+            TagEntryPtr tag = iter->second.at(j);
+            // Filter out non relevanting entries
+            if ( !m_filters.IsEmpty() && m_filters.Index(tag->GetKind()) == wxNOT_FOUND )
+                continue;
+            DoAddTagRow(tag, rows);
         }
-        
-        if ((m_userFilters.GetCount() == 1) && (m_userFilters.Item(0).CmpNoCase(name) == 0) && !gotExactMatch) {
-            gotExactMatch = true;
-            DoSelectItem(index);
+    }
+
+    // Select the first exact match (if any)
+    int exactMatch = wxNOT_FOUND;
+    if ( m_userFilters.GetCount() == 1 ) {
+        for(size_t i=0; i<rows.size(); ++i) {
+            if ( m_userFilters.Item(0).CmpNoCase(rows.at(i).m_name) == 0 ) {
+                exactMatch = i;
+                break;
+            }
         }
     }
 
-    if (!gotExactMatch && m_listOptions->GetItemCount()) {
-        DoSelectItem(0);
+    m_list->SetRows(rows);
+    if ( m_list->GetItemCount() ) {
+        DoSelectItem(exactMatch == wxNOT_FOUND ? 0 : exactMatch);
     }
 }
 
-void OpenResourceDialog::DoPopulateWorkspaceFile()
+void OpenResourceDialog::DoAddTagRow(TagEntryPtr tag, std::vector<OpenResourceDialogRow>& rows)
 {
-    // do we need to include files?
-    if ( !m_filters.IsEmpty() && m_filters.Index(TagEntry::KIND_FILE) == wxNOT_FOUND)
-        return;
-    
-    if ( !m_userFilters.IsEmpty() ) {
+    OpenResourceDialogRow row;
+    row.m_name = tag->GetName();
+    row.m_imgId = DoGetTagImgId(tag);
+    row.m_data = OpenResourceDialogItemData(tag->GetFile(), tag->GetLine(), tag->GetPattern(), tag->GetName(), tag->GetScope());
 
-        std::multimap<wxString, wxString>::iterator iter  = m_files.begin();
-        for(; iter != m_files.end(); iter++) {
-            
-            if ( !MatchesFilter( iter->first ) )
-                continue;
-            
-            wxFileName fn(iter->second);
-            FileExtManager::FileType type = FileExtManager::GetType(fn.GetFullName());
-            int imgId = m_tagImgMap[wxT("text")];
-            switch(type) {
-            case FileExtManager::TypeSourceC:
-                imgId = m_tagImgMap[wxT("c")];
-                break;
+    // keep the fullpath
+    if(tag->GetKind() == wxT("function") || tag->GetKind() == wxT("prototype")) {
+        row.m_fullname = wxString::Format(wxT("%s::%s%s"), tag->GetScope().c_str(), tag->GetName().c_str(), tag->GetSignature().c_str());
+        row.m_bold = (tag->GetKind() == wxT("function"));
+
+    } else {
+        row.m_fullname = wxString::Format(wxT("%s::%s"), tag->GetScope().c_str(), tag->GetName().c_str());
 
-            case FileExtManager::TypeSourceCpp:
-                imgId = m_tagImgMap[wxT("cpp")];
-                break;
-            case FileExtManager::TypeHeader:
-                imgId = m_tagImgMap[wxT("h")];
-                break;
-            case FileExtManager::TypeFormbuilder:
-                imgId = m_tagImgMap[wxT("wxfb")];
-                break;
-            case FileExtManager::TypeWxCrafter:
-                imgId = m_tagImgMap[wxT("wxcp")];
-                break;
-            default:
-                break;
-            }
-            DoAppendLine(fn.GetFullName(),
-                         fn.GetFullPath(),
-                         false,
-                         new OpenResourceDialogItemData(fn.GetFullPath(), -1, wxT(""), fn.GetFullName(), wxT("")),
-                         imgId);
-        }
     }
+    rows.push_back(row);
 }
 
-void OpenResourceDialog::Clear()
+void OpenResourceDialog::DoAddFileRow(const wxString& fullpath, std::vector<OpenResourceDialogRow>& rows)
 {
-    // list control does not own the client data, we need to free it ourselves
-    for(int i=0; i<m_listOptions->GetItemCount(); i++) {
-        OpenResourceDialogItemData *data = (OpenResourceDialogItemData *) m_listOptions->GetItemData(i);
-        if (data) {
-            delete data;
-        }
+    wxFileName fn(fullpath);
+    FileExtManager::FileType type = FileExtManager::GetType(fn.GetFullName());
+    int imgId = m_tagImgMap[wxT("text")];
+    switch(type) {
+    case FileExtManager::TypeSourceC:
+        imgId = m_tagImgMap[wxT("c")];
+        break;
+
+    case FileExtManager::TypeSourceCpp:
+        imgId = m_tagImgMap[wxT("cpp")];
+        break;
+    case FileExtManager::TypeHeader:
+        imgId = m_tagImgMap[wxT("h")];
+        break;
+    case FileExtManager::TypeFormbuilder:
+        imgId = m_tagImgMap[wxT("wxfb")];
+        break;
+    case FileExtManager::TypeWxCrafter:
+        imgId = m_tagImgMap[wxT("wxcp")];
+        break;
+    default:
+        break;
     }
-    m_listOptions->DeleteAllItems();
+
+    OpenResourceDialogRow row;
+    row.m_name = fn.GetFullName();
+    row.m_fullname = fn.GetFullPath();
+    row.m_imgId = imgId;
+    row.m_data = OpenResourceDialogItemData(fn.GetFullPath(), -1, wxT(""), fn.GetFullName(), wxT(""));
+    rows.push_back(row);
+}
+
+void OpenResourceDialog::Clear()
+{
+    m_list->ClearRows();
     m_userFilters.Clear();
 }
 
@@ -335,13 +426,13 @@ void OpenResourceDialog::OpenSelection(const OpenResourceDialogItemData& selecti
 
 void OpenResourceDialog::OnKeyDown(wxKeyEvent& event)
 {
-    if (event.GetKeyCode() == WXK_DOWN && m_listOptions->GetItemCount()> 0) {
+    if (event.GetKeyCode() == WXK_DOWN && m_list->GetItemCount()> 0) {
         //up key
-        int cursel = m_listOptions->GetFirstSelected();
+        int cursel = m_list->GetFirstSelected();
         if (cursel != wxNOT_FOUND) {
             //there is a selection in the listbox
             cursel++;
-            if (cursel >= (int)m_listOptions->GetItemCount()) {
+            if (cursel >= (int)m_list->GetItemCount()) {
                 //already at last item, cant scroll anymore
                 return;
             }
@@ -353,9 +444,9 @@ void OpenResourceDialog::OnKeyDown(wxKeyEvent& event)
         }
         return;
 
-    } else if (event.GetKeyCode() == WXK_UP && m_listOptions->GetItemCount() > 0) {
+    } else if (event.GetKeyCode() == WXK_UP && m_list->GetItemCount() > 0) {
         //up key
-        int cursel = m_listOptions->GetFirstSelected();
+        int cursel = m_list->GetFirstSelected();
         if (cursel != wxNOT_FOUND) {
             //there is a selection in the listbox
             cursel--;
@@ -394,18 +485,19 @@ bool OpenResourceDialogItemData::IsOk() const
 void OpenResourceDialog::DoSelectItem(int selection, bool makeFirst)
 {
     // Unselect current item first
-    int currentSelection = m_listOptions->GetFirstSelected();
+    int currentSelection = m_list->GetFirstSelected();
     if(currentSelection != wxNOT_FOUND) {
-        m_listOptions->Select(currentSelection, false);
+        m_list->Select(currentSelection, false);
     }
 
-    m_listOptions->Select(selection);
+    m_list->Select(selection);
     if(makeFirst)
-        m_listOptions->EnsureVisible(selection);
+        m_list->EnsureVisible(selection);
 
     // display the full name at the bottom static text control
-    OpenResourceDialogItemData *data = (OpenResourceDialogItemData *) m_listOptions->GetItemData(selection);
-    m_selection = *data;
+    const OpenResourceDialogItemData *data = m_list->GetItemDataAt(selection);
+    if(data)
+        m_selection = *data;
 }
 
 void OpenResourceDialog::OnItemSelected(wxListEvent& event)
@@ -413,35 +505,12 @@ void OpenResourceDialog::OnItemSelected(wxListEvent& event)
     event.Skip();
     if(event.m_itemIndex != wxNOT_FOUND) {
         // display the full name at the bottom static text control
-        OpenResourceDialogItemData *data = (OpenResourceDialogItemData *) m_listOptions->GetItemData(event.m_itemIndex );
-        m_selection = *data;
+        const OpenResourceDialogItemData *data = m_list->GetItemDataAt(event.m_itemIndex);
+        if(data)
+            m_selection = *data;
     }
 }
 
-int OpenResourceDialog::DoAppendLine(const wxString& name, const wxString& fullname, bool boldFont, OpenResourceDialogItemData* clientData, int imgId)
-{
-    int index = AppendListCtrlRow(m_listOptions);
-    SetColumnText(m_listOptions, index, 0, name, imgId);
-    SetColumnText(m_listOptions, index, 1, fullname);
-
-    m_listOptions->SetItemPtrData(index, (wxUIntPtr)(clientData));
-
-    // Mark implementations with bold font
-    wxFont font = wxSystemSettings::GetFont(wxSYS_DEFAULT_GUI_FONT);
-    if(boldFont)
-        font.SetWeight(wxFONTWEIGHT_BOLD);
-    m_listOptions->SetItemFont(index, font);
-    return index;
-}
-
-void OpenResourceDialog::OnTimer(wxTimerEvent& event)
-{
-    if(m_needRefresh)
-        DoPopulateList();
-
-    m_needRefresh = false;
-}
-
 int OpenResourceDialog::DoGetTagImgId(TagEntryPtr tag)
 {
     wxString kind   = tag->GetKind();
@@ -494,19 +563,3 @@ int OpenResourceDialog::DoGetTagImgId(TagEntryPtr tag)
 
     return imgId;
 }
-
-bool OpenResourceDialog::MatchesFilter(const wxString& name)
-{
-    wxString tmpname = name;
-    tmpname.MakeLower();
-    
-    if ( m_userFilters.IsEmpty() )
-        return false;
-    
-    
-    for(size_t i=0; i<m_userFilters.GetCount(); ++i) {
-        if ( !tmpname.Contains(m_userFilters.Item(i)) ) 
-            return false;
-    }
-    return true;
-}
@@ -33,13 +33,14 @@ Subclass of OpenResourceDialogBase, which is generated by wxFormBuilder.
 
 #include "openresourcedialogbase.h"
 #include <vector>
+#include <map>
 #include "entry.h"
 #include <wx/arrstr.h>
-#include <wx/timer.h>
+#include <wx/listctrl.h>
+#include "clFuzzyFinder.h"
 #include "codelite_exports.h"
 
 class IManager;
-class wxTimer;
 
 class WXDLLIMPEXP_SDK OpenResourceDialogItemData : public wxClientData
 {
@@ -68,26 +69,69 @@ public:
     bool IsOk() const;
 };
 
+/**
+ * @class OpenResourceDialogRow
+ * @brief a single row of the results list
+ */
+class WXDLLIMPEXP_SDK OpenResourceDialogRow
+{
+public:
+    wxString                   m_name;
+    wxString                   m_fullname;
+    int                        m_imgId;
+    bool                       m_bold;
+    OpenResourceDialogItemData m_data;
+
+    OpenResourceDialogRow() : m_imgId(wxNOT_FOUND), m_bold(false) {
+    }
+};
+
+/**
+ * @class OpenResourceListCtrl
+ * @brief a virtual list control: only the visible rows are ever rendered
+ */
+class WXDLLIMPEXP_SDK OpenResourceListCtrl : public wxListView
+{
+    std::vector<OpenResourceDialogRow> m_rows;
+    mutable wxListItemAttr             m_attr;
+
+public:
+    OpenResourceListCtrl(wxWindow* parent);
+    virtual ~OpenResourceListCtrl();
+
+    /**
+     * @brief replace the content of the list. 'rows' is swapped with the list content
+     */
+    void SetRows(std::vector<OpenResourceDialogRow>& rows);
+    void ClearRows();
+    const OpenResourceDialogItemData* GetItemDataAt(long item) const;
+    const OpenResourceDialogRow* GetRowAt(long item) const;
+
+    virtual wxString OnGetItemText(long item, long column) const;
+    virtual int OnGetItemImage(long item) const;
+    virtual wxListItemAttr* OnGetItemAttr(long item) const;
+};
+
 /** Implementing OpenResourceDialogBase */
 class WXDLLIMPEXP_SDK OpenResourceDialog : public OpenResourceDialogBase
 {
     IManager *                        m_manager;
-    std::multimap<wxString, wxString> m_files;
-    wxTimer*                          m_timer;
+    std::vector<wxString>             m_files;
+    clFuzzyFinder                     m_finder;
+    bool                              m_indexBuilt;
+    OpenResourceListCtrl*             m_list;
     OpenResourceDialogItemData        m_selection;
-    bool                              m_needRefresh;
     std::map<wxString, int>           m_tagImgMap;
     wxArrayString                     m_filters;
     wxArrayString                     m_userFilters;
     
 protected:
+    void DoBuildIndex();
     void DoPopulateList();
-    void DoPopulateWorkspaceFile();
-    bool MatchesFilter( const wxString &name );
-    void DoPopulateTags();
     void DoSelectItem(int selection, bool makeFirst = true);
     void Clear();
-    int  DoAppendLine(const wxString &name, const wxString &fullname, bool boldFont, OpenResourceDialogItemData *clientData, int imgId);
+    void DoAddFileRow(const wxString &fullpath, std::vector<OpenResourceDialogRow>& rows);
+    void DoAddTagRow(TagEntryPtr tag, std::vector<OpenResourceDialogRow>& rows);
     int  DoGetTagImgId(TagEntryPtr tag);
 
 protected:
@@ -100,9 +144,6 @@ protected:
     void OnOK( wxCommandEvent& event );
     void OnOKUI( wxUpdateUIEvent& event );
     void OnItemSelected( wxListEvent& event );
-    void OnTimer(wxTimerEvent &event);
-
-    DECLARE_EVENT_TABLE()
 
 public:
     /** Constructor */
@@ -113,6 +154,10 @@ public:
         return m_selection;
     }
 
+    /**
+     * @brief the tag kinds to display (e.g. "class", TagEntry::KIND_FILE), when empty everything is displayed.
+     * Must be set before the dialog is shown
+     */
     wxArrayString& GetFilters() {
         return m_filters;
     }
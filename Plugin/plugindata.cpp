@@ -25,6 +25,7 @@
 #include "plugindata.h"
 
 PluginInfo::PluginInfo()
+    : activateOnMenu(false)
 {
 }
 
@@ -38,6 +39,11 @@ void PluginInfo::FromJSON(const JSONElement& json)
     author = json.namedObject("author").toString();
     description = json.namedObject("description").toString();
     version = json.namedObject("version").toString();
+    activateOnFiles = json.namedObject("activateOnFiles").toString();
+    activateOnWorkspace = json.namedObject("activateOnWorkspace").toString();
+    activateOnMenu = json.namedObject("activateOnMenu").toBool(false);
+    libraryFile = json.namedObject("libraryFile").toString();
+    libraryTimestamp = json.namedObject("libraryTimestamp").toString();
 }
 
 JSONElement PluginInfo::ToJSON() const
@@ -47,6 +53,11 @@ JSONElement PluginInfo::ToJSON() const
     e.addProperty("author", author);
     e.addProperty("description", description);
     e.addProperty("version", version);
+    e.addProperty("activateOnFiles", activateOnFiles);
+    e.addProperty("activateOnWorkspace", activateOnWorkspace);
+    e.addProperty("activateOnMenu", activateOnMenu);
+    e.addProperty("libraryFile", libraryFile);
+    e.addProperty("libraryTimestamp", libraryTimestamp);
     return e;
 }
 
@@ -107,6 +118,16 @@ void PluginInfoArray::AddPlugin(const PluginInfo& plugin)
     m_plugins.insert(std::make_pair(plugin.GetName(), plugin));
 }
 
+const PluginInfo* PluginInfoArray::FindByLibrary(const wxString& libraryFile) const
+{
+    PluginInfo::PluginMap_t::const_iterator iter = m_plugins.begin();
+    for( ; iter != m_plugins.end(); ++iter ) {
+        if ( iter->second.GetLibraryFile() == libraryFile )
+            return &(iter->second);
+    }
+    return NULL;
+}
+
 void PluginInfoArray::DisablePlugin(const wxString& plugin)
 {
     if ( m_disabledPlugins.Index(plugin) == wxNOT_FOUND )
@@ -39,6 +39,16 @@ class WXDLLIMPEXP_SDK PluginInfo
     wxString description;
     wxString version;
 
+    // Activation triggers. A plugin that declares any of them is not created during
+    // startup, but the first time one of them fires
+    wxString activateOnFiles;     // e.g. "*.sql;*.erd": a matching file was opened
+    wxString activateOnWorkspace; // e.g. "*.workspace": a matching workspace was loaded
+    bool activateOnMenu;          // the 'Plugins' menu was opened
+
+    // Set by the plugin manager: the shared object this information was read from
+    wxString libraryFile;
+    wxString libraryTimestamp;
+
 public:
     typedef std::map<wxString, PluginInfo> PluginMap_t;
 
@@ -60,6 +70,19 @@ public:
     void SetVersion(const wxString& version) {
         this->version = version;
     }
+    void SetActivateOnFiles(const wxString& activateOnFiles) {
+        this->activateOnFiles = activateOnFiles;
+    }
+    void SetActivateOnWorkspace(const wxString& activateOnWorkspace) {
+        this->activateOnWorkspace = activateOnWorkspace;
+    }
+    void SetActivateOnMenu(bool activateOnMenu) {
+        this->activateOnMenu = activateOnMenu;
+    }
+    void SetLibrary(const wxString& libraryFile, const wxString& libraryTimestamp) {
+        this->libraryFile = libraryFile;
+        this->libraryTimestamp = libraryTimestamp;
+    }
 
     //Getters
     const wxString& GetAuthor() const {
@@ -74,6 +97,28 @@ public:
     const wxString& GetVersion() const {
         return version;
     }
+    const wxString& GetActivateOnFiles() const {
+        return activateOnFiles;
+    }
+    const wxString& GetActivateOnWorkspace() const {
+        return activateOnWorkspace;
+    }
+    bool IsActivateOnMenu() const {
+        return activateOnMenu;
+    }
+    const wxString& GetLibraryFile() const {
+        return libraryFile;
+    }
+    const wxString& GetLibraryTimestamp() const {
+        return libraryTimestamp;
+    }
+
+    /**
+     * @brief does this plugin declare any activation trigger?
+     */
+    bool IsLazy() const {
+        return !activateOnFiles.IsEmpty() || !activateOnWorkspace.IsEmpty() || activateOnMenu;
+    }
 
     JSONElement ToJSON() const;
     void FromJSON(const JSONElement& json);
@@ -96,6 +141,12 @@ public:
         return m_plugins;
     }
     void AddPlugin(const PluginInfo& plugin);
+
+    /**
+     * @brief find the information of the plugin that was read from a given shared object
+     * @return NULL if no such plugin is known
+     */
+    const PluginInfo* FindByLibrary(const wxString& libraryFile) const;
     bool CanLoad(const wxString &plugin) const;
     void DisablePugins(const wxArrayString& plugins);
     void DisablePlugin(const wxString& plugin);
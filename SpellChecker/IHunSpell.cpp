@@ -51,8 +51,50 @@
 #include "IHunSpell.h"
 #include "CorrectSpellingDlg.h"
 #include "spellcheck.h"
+#include "SpellCheckerThread.h"
+#include <algorithm>
 // ------------------------------------------------------------
 #define MIN_TOKEN_LEN 3
+#define SC_USER_INDICATOR 3 // the editor's user indicator
+// ------------------------------------------------------------
+// maps a lexer style to the scanner type flag, 0 if the style is not spell checked
+static int StyleToScannerType(int style)
+{
+    switch(style) {
+    case IHunSpell::SCT_STRING:
+        return IHunSpell::kString;
+    case IHunSpell::SCT_CPP_COM:
+        return IHunSpell::kCppComment;
+    case IHunSpell::SCT_C_COM:
+        return IHunSpell::kCComment;
+    case IHunSpell::SCT_DOX_1:
+        return IHunSpell::kDox1;
+    case IHunSpell::SCT_DOX_2:
+        return IHunSpell::kDox2;
+    default:
+        return 0;
+    }
+}
+// ------------------------------------------------------------
+// sort the ranges and merge the overlapping / adjacent ones
+static void MergeLineRanges(lineRanges& ranges)
+{
+    if(ranges.size() < 2) return;
+
+    std::sort(ranges.begin(), ranges.end());
+    lineRanges merged;
+    merged.push_back(ranges.at(0));
+
+    for(size_t i = 1; i < ranges.size(); ++i) {
+        lineRange& last = merged.back();
+        if(ranges.at(i).first <= last.second + 1) {
+            last.second = wxMax(last.second, ranges.at(i).second);
+        } else {
+            merged.push_back(ranges.at(i));
+        }
+    }
+    ranges.swap(merged);
+}
 // ------------------------------------------------------------
 IHunSpell::IHunSpell()
 {
@@ -63,10 +105,17 @@ IHunSpell::IHunSpell()
     m_pSpellDlg = NULL;
     InitLanguageList();
     m_scanners = 0;
+    m_thread = NULL;
+    m_generation = 0;
+    m_incEditor = NULL;
+    m_incFirstLine = -1;
+    m_incLastLine = -1;
+    m_session = 0;
 }
 // ------------------------------------------------------------
 IHunSpell::~IHunSpell()
 {
+    StopThread();
     CloseEngine();
 
     if(m_pSpellDlg != NULL) m_pSpellDlg->Destroy();
@@ -101,7 +150,10 @@ bool IHunSpell::InitEngine()
         return false;
     }
     // so far ok, init engine
-    m_pSpell = Hunspell_create(affBuffer, dicBuffer);
+    {
+        wxCriticalSectionLocker locker(m_spellLock);
+        m_pSpell = Hunspell_create(affBuffer, dicBuffer);
+    }
 
     return true;
 
@@ -111,20 +163,42 @@ bool IHunSpell::InitEngine()
 // ------------------------------------------------------------
 void IHunSpell::CloseEngine()
 {
+    wxCriticalSectionLocker locker(m_spellLock);
     if(m_pSpell != NULL) {
         Hunspell_destroy(m_pSpell);
         SaveUserDict(m_userDictPath + s_userDict);
     }
     m_pSpell = NULL;
+
+    // the cached verdicts belong to the old dictionary
+    m_cache.Clear();
+    ++m_generation;
+    ResetIncrementalState();
 }
 // ------------------------------------------------------------
-int IHunSpell::CheckWord(const wxString& word) { return Hunspell_spell(m_pSpell, word); }
+int IHunSpell::CheckWord(const wxString& word)
+{
+    bool correct;
+    if(m_cache.Get(word, correct)) return correct ? 1 : 0;
+
+    int res = CheckWordNoCache(word);
+    m_cache.Set(word, res != 0);
+    return res;
+}
+// ------------------------------------------------------------
+int IHunSpell::CheckWordNoCache(const wxString& word)
+{
+    wxCriticalSectionLocker locker(m_spellLock);
+    if(m_pSpell == NULL) return 1;
+    return Hunspell_spell(m_pSpell, word.mb_str().data());
+}
 // ------------------------------------------------------------
 wxArrayString IHunSpell::GetSuggestions(const wxString& misspelled)
 {
     wxArrayString suggestions;
     suggestions.Empty();
 
+    wxCriticalSectionLocker locker(m_spellLock);
     if(m_pSpell) {
         char** wlst;
 
@@ -162,57 +236,7 @@ void IHunSpell::CheckCppSpelling(const wxString& check)
 
         m_pSpellDlg->SetPHs(this);
     }
-    posLen query;
-
-    for(int i = 0; i < pEditor->GetLength(); i++) {
-        switch(pTextCtrl->GetStyleAt(i)) {
-        case SCT_STRING: {
-            query.first = i;
-
-            while(pTextCtrl->GetStyleAt(i++) == SCT_STRING)
-                ;
-            query.second = i;
-
-            if(IsScannerType(kString)) m_parseValues.push_back(make_pair(query, kString));
-        } break;
-        case SCT_CPP_COM: {
-            query.first = i;
-
-            while(pTextCtrl->GetStyleAt(i++) == SCT_CPP_COM)
-                ;
-            query.second = i;
-
-            if(IsScannerType(kCppComment)) m_parseValues.push_back(make_pair(query, kCppComment));
-        } break;
-        case SCT_C_COM: {
-            query.first = i;
-
-            while(pTextCtrl->GetStyleAt(i++) == SCT_C_COM)
-                ;
-            query.second = i;
-
-            if(IsScannerType(kCComment)) m_parseValues.push_back(make_pair(query, kCComment));
-        } break;
-        case SCT_DOX_1: {
-            query.first = i;
-
-            while(pTextCtrl->GetStyleAt(i++) == SCT_DOX_1)
-                ;
-            query.second = i;
-
-            if(IsScannerType(kDox1)) m_parseValues.push_back(make_pair(query, kDox1));
-        } break;
-        case SCT_DOX_2: {
-            query.first = i;
-
-            while(pTextCtrl->GetStyleAt(i++) == SCT_DOX_2)
-                ;
-            query.second = i;
-
-            if(IsScannerType(kDox2)) m_parseValues.push_back(make_pair(query, kDox2));
-        } break;
-        }
-    }
+    FindStyleRuns(pTextCtrl, 0, pEditor->GetLength());
     int errors = 0;
 
     if(!m_pPlugIn->GetCheckContinuous()) {
@@ -316,6 +340,7 @@ void IHunSpell::AddWordToIgnoreList(const wxString& word)
     if(word.IsEmpty()) return;
 
     if(m_ignoreList.Index(word) == wxNOT_FOUND) m_ignoreList.Add(word);
+    ResetIncrementalState();
 }
 // ------------------------------------------------------------
 void IHunSpell::AddWordToUserDict(const wxString& word)
@@ -323,6 +348,7 @@ void IHunSpell::AddWordToUserDict(const wxString& word)
     if(word.IsEmpty()) return;
 
     if(m_userDict.Index(word) == wxNOT_FOUND) m_userDict.Add(word);
+    ResetIncrementalState();
 }
 // ------------------------------------------------------------
 bool IHunSpell::LoadUserDict(const wxString& filename)
@@ -473,6 +499,7 @@ void IHunSpell::EnableScannerType(int type, bool state)
         m_scanners |= type;
     else
         m_scanners &= ~type;
+    ResetIncrementalState();
 }
 // ------------------------------------------------------------
 int IHunSpell::CheckCppType(IEditor* pEditor)
@@ -613,13 +640,256 @@ int IHunSpell::MarkErrors(IEditor* pEditor)
     return counter;
 }
 
-void IHunSpell::AddWord(const wxString& word) 
-{ 
+void IHunSpell::AddWord(const wxString& word)
+{
+    wxCriticalSectionLocker locker(m_spellLock);
 #if wxUSE_STL
     // Implict conversions are disabled when building with wxUSE_STL=1
-    Hunspell_add(m_pSpell, word.mb_str().data()); 
+    Hunspell_add(m_pSpell, word.mb_str().data());
 #else
     Hunspell_add(m_pSpell, word);
 #endif
+    m_cache.Set(word, true);
+}
+// ------------------------------------------------------------
+void IHunSpell::FindStyleRuns(wxStyledTextCtrl* pTextCtrl, int startPos, int endPos)
+{
+    m_parseValues.clear();
+    if(endPos <= startPos) return;
+
+    // fetch the styles of the whole range at once instead of calling GetStyleAt() per character
+    wxMemoryBuffer styled = pTextCtrl->GetStyledText(startPos, endPos);
+    const unsigned char* data = (const unsigned char*)styled.GetData();
+    int count = styled.GetDataLen() / 2;
+
+    int i = 0;
+    while(i < count) {
+        int style = data[i * 2 + 1];
+        int runStart = i;
+        while(i < count && data[i * 2 + 1] == style)
+            ++i;
+
+        int type = StyleToScannerType(style);
+        if(type && IsScannerType(type)) {
+            // include the character following the run, the tokenizer positions rely on it
+            m_parseValues.push_back(std::make_pair(posLen(startPos + runStart, startPos + i + 1), type));
+        }
+    }
+}
+// ------------------------------------------------------------
+void IHunSpell::CheckCppSpellingIncremental(IEditor* pEditor)
+{
+    if(!pEditor) return;
+
+    // check if engine is initialized, if not do so
+    if(!InitEngine()) return;
+
+    if(m_thread == NULL) {
+        m_thread = new SpellCheckerThread(this);
+        m_thread->Start();
+    }
+
+    if(pEditor != m_incEditor) {
+        // new editor (or the settings / word lists have changed): start over
+        ResetIncrementalState();
+        m_incEditor = pEditor;
+        pEditor->ClearUserIndicators();
+    }
+
+    wxStyledTextCtrl* pTextCtrl = pEditor->GetSTC();
+    int lastDocLine = pTextCtrl->GetLineCount() - 1;
+    int firstLine = pTextCtrl->DocLineFromVisible(pTextCtrl->GetFirstVisibleLine());
+    int lastLine = pTextCtrl->DocLineFromVisible(pTextCtrl->GetFirstVisibleLine() + pTextCtrl->LinesOnScreen());
+    lastLine = wxMin(lastLine, lastDocLine);
+
+    // check only the lines that became visible since the last check, and the modified ones
+    lineRanges ranges;
+    if(m_incFirstLine == wxNOT_FOUND) {
+        ranges.push_back(lineRange(firstLine, lastLine));
+    } else {
+        if(firstLine < m_incFirstLine) ranges.push_back(lineRange(firstLine, wxMin(lastLine, m_incFirstLine - 1)));
+        if(lastLine > m_incLastLine) ranges.push_back(lineRange(wxMax(firstLine, m_incLastLine + 1), lastLine));
+    }
+    m_incFirstLine = firstLine;
+    m_incLastLine = lastLine;
+
+    ranges.insert(ranges.end(), m_dirtyLines.begin(), m_dirtyLines.end());
+    m_dirtyLines.clear();
+    if(ranges.empty()) return;
+
+    MergeLineRanges(ranges);
+
+    std::set<wxString> unknownWords;
+    lineRanges pendingLines;
+    for(size_t i = 0; i < ranges.size(); ++i) {
+        size_t count = unknownWords.size();
+        MarkRange(pEditor, ranges.at(i), unknownWords);
+        if(unknownWords.size() != count) pendingLines.push_back(ranges.at(i));
+    }
+
+    if(!unknownWords.empty()) SendRequest(unknownWords, pendingLines);
+}
+// ------------------------------------------------------------
+void IHunSpell::MarkRange(IEditor* pEditor, const lineRange& lines, std::set<wxString>& unknownWords)
+{
+    wxStyledTextCtrl* pTextCtrl = pEditor->GetSTC();
+    int lineCount = pTextCtrl->GetLineCount();
+    if(lines.first < 0 || lines.first >= lineCount) return;
+
+    int startPos = pTextCtrl->PositionFromLine(lines.first);
+    int endPos = pTextCtrl->GetLineEndPosition(wxMin(lines.second, lineCount - 1));
+
+    pTextCtrl->SetIndicatorCurrent(SC_USER_INDICATOR);
+    pTextCtrl->IndicatorClearRange(startPos, endPos - startPos);
+
+    wxMemoryBuffer styled = pTextCtrl->GetStyledText(startPos, endPos);
+    const unsigned char* data = (const unsigned char*)styled.GetData();
+    int count = styled.GetDataLen() / 2;
+
+    bool commentDelimiters[256] = { false };
+    bool cppDelimiters[256] = { false };
+    for(size_t i = 0; i < s_commentDelimiters.length(); ++i)
+        commentDelimiters[(unsigned char)s_commentDelimiters[i]] = true;
+    for(size_t i = 0; i < s_cppDelimiters.length(); ++i)
+        cppDelimiters[(unsigned char)s_cppDelimiters[i]] = true;
+
+    int i = 0;
+    while(i < count) {
+        int style = data[i * 2 + 1];
+        int runStart = i;
+        while(i < count && data[i * 2 + 1] == style)
+            ++i;
+        int runEnd = i;
+
+        int type = StyleToScannerType(style);
+        if(!type || !IsScannerType(type)) continue;
+
+        const bool* delimiters = commentDelimiters;
+        if(type == kString) {
+            // ignore filenames in #include
+            wxString line = pTextCtrl->GetLine(pTextCtrl->LineFromPosition(startPos + runStart));
+            if(line.Find(s_include) != wxNOT_FOUND) continue;
+
+            // strings with escape sequences are tokenized like code, e.g. '\nNext line'
+            for(int j = runStart; j < runEnd; ++j) {
+                if(data[j * 2] == '\\') {
+                    delimiters = cppDelimiters;
+                    break;
+                }
+            }
+        }
+
+        int j = runStart;
+        while(j < runEnd) {
+            unsigned char ch = data[j * 2];
+            if(ch == '\\' && type == kString) {
+                j += 2; // skip the escape sequence
+                continue;
+            }
+            if(delimiters[ch]) {
+                ++j;
+                continue;
+            }
+
+            int tokenStart = j;
+            std::string bytes;
+            while(j < runEnd && !delimiters[data[j * 2]] && !(type == kString && data[j * 2] == '\\')) {
+                bytes += (char)data[j * 2];
+                ++j;
+            }
+
+            wxString token = wxString::FromUTF8(bytes.c_str(), bytes.length());
+            if(token.Len() <= MIN_TOKEN_LEN) continue;
+
+            bool correct;
+            if(!m_cache.Get(token, correct)) {
+                unknownWords.insert(token);
+                continue;
+            }
+            if(correct) continue;
+
+            // look in ignore list
+            if(m_ignoreList.Index(token) != wxNOT_FOUND) continue;
+
+            // look in user list
+            if(m_userDict.Index(token) != wxNOT_FOUND) continue;
+
+            pEditor->SetUserIndicator(startPos + tokenStart, j - tokenStart);
+        }
+    }
+}
+// ------------------------------------------------------------
+void IHunSpell::SendRequest(const std::set<wxString>& words, const lineRanges& lines)
+{
+    SpellCheckRequest* req = new SpellCheckRequest();
+    req->m_owner = m_pPlugIn;
+    req->m_generation = m_generation;
+    req->m_session = m_session;
+    req->m_lines = lines;
+    req->m_words.reserve(words.size());
+
+    std::set<wxString>::const_iterator iter = words.begin();
+    for(; iter != words.end(); ++iter) {
+        // make a deep copy, the strings are used by another thread
+        req->m_words.push_back(wxString(iter->c_str()));
+    }
+    m_thread->Add(req);
+}
+// ------------------------------------------------------------
+void IHunSpell::OnWordsChecked(SpellCheckResult* result)
+{
+    if(result->m_generation == m_generation) {
+        for(size_t i = 0; i < result->m_verdicts.size(); ++i) {
+            m_cache.Set(result->m_verdicts.at(i).first, result->m_verdicts.at(i).second);
+        }
+
+        if(m_incEditor && result->m_session == m_session) {
+            // re-mark the lines that were waiting for these words. Words that are still
+            // unknown (evicted or typed meanwhile) are picked up by the next check
+            std::set<wxString> unknownWords;
+            for(size_t i = 0; i < result->m_lines.size(); ++i) {
+                MarkRange(m_incEditor, result->m_lines.at(i), unknownWords);
+            }
+        }
+    }
+    delete result;
+}
+// ------------------------------------------------------------
+void IHunSpell::MarkLinesDirty(int line, int linesAdded)
+{
+    if(m_incEditor == NULL) return;
+
+    if(linesAdded != 0) {
+        // keep the pending ranges on the same text. Ranges inside removed lines collapse onto 'line'
+        for(size_t i = 0; i < m_dirtyLines.size(); ++i) {
+            lineRange& range = m_dirtyLines.at(i);
+            if(range.first > line) range.first = wxMax(line, range.first + linesAdded);
+            if(range.second > line) range.second = wxMax(line, range.second + linesAdded);
+        }
+
+        // the line numbers sent with the requests in flight are stale now: drop their
+        // re-marking and check the whole visible range again on the next pass
+        ++m_session;
+        m_incFirstLine = wxNOT_FOUND;
+        m_incLastLine = wxNOT_FOUND;
+    }
+    m_dirtyLines.push_back(lineRange(line, line + wxMax(linesAdded, 0)));
+}
+// ------------------------------------------------------------
+void IHunSpell::ResetIncrementalState()
+{
+    m_incEditor = NULL;
+    m_incFirstLine = wxNOT_FOUND;
+    m_incLastLine = wxNOT_FOUND;
+    m_dirtyLines.clear();
+    ++m_session;
+}
+// ------------------------------------------------------------
+void IHunSpell::StopThread()
+{
+    if(m_thread) {
+        m_thread->Stop();
+        wxDELETE(m_thread);
+    }
 }
 // ------------------------------------------------------------
@@ -38,17 +38,25 @@
 // ------------------------------------------------------------
 #include <hunspell/hunspell.h>
 #include <wx/hashmap.h>
+#include <wx/thread.h>
 #include <vector>
+#include <set>
 #include <utility>
+#include "SpellCheckerCache.h"
 // ------------------------------------------------------------
 WX_DECLARE_STRING_HASH_MAP(wxString, languageMap);
 typedef std::pair<int, int> posLen;
 typedef std::pair<posLen, int> parseEntry;
 typedef std::vector<parseEntry> partList;
+typedef std::pair<int, int> lineRange;
+typedef std::vector<lineRange> lineRanges;
 // ------------------------------------------------------------
 class CorrectSpellingDlg;
 class SpellCheck;
 class IEditor;
+class SpellCheckerThread;
+class SpellCheckResult;
+class wxStyledTextCtrl;
 // ------------------------------------------------------------
 class IHunSpell
 {
@@ -66,12 +74,26 @@ public:
     bool ChangeLanguage(const wxString& language);
     /// check spelling for one word. Return 0 if the word was not found, otherwise != 0.
     int CheckWord(const wxString& word);
+    /// same as CheckWord, but bypasses the verdict cache. Safe to call from the worker thread
+    int CheckWordNoCache(const wxString& word);
     /// returns an array with suggestions for the misspelled word.
     wxArrayString GetSuggestions(const wxString& misspelled);
     /// makes a spell check for the given cpp text. Canceled is set to true when the user cancels.
     void CheckCppSpelling(const wxString& check);
     /// makes a spell check for the given plain text. Canceled is set to true when the user cancels.
     void CheckSpelling(const wxString& check);
+    /// continuous check: marks errors in the visible and modified lines only. Unknown words are
+    /// looked up by the worker thread and marked once the results arrive
+    void CheckCppSpellingIncremental(IEditor* pEditor);
+    /// 'line' of the tracked editor was modified and 'linesAdded' lines were inserted after it
+    /// (removed when negative). The modified lines must be re-checked
+    void MarkLinesDirty(int line, int linesAdded);
+    /// drop the incremental state, the next continuous check starts from scratch
+    void ResetIncrementalState();
+    /// the worker thread finished a batch of words, takes ownership of 'result'
+    void OnWordsChecked(SpellCheckResult* result);
+    /// stops the worker thread
+    void StopThread();
     /// retrieves all predefined language names, used as key to get the filename
     void GetAllLanguageKeyNames(wxArrayString& lang);
     /// checks for predefined language names, which could be found in path
@@ -126,6 +148,9 @@ public:
 
 protected:
     int CheckCppType(IEditor* pEditor);
+    void FindStyleRuns(wxStyledTextCtrl* pTextCtrl, int startPos, int endPos);
+    void MarkRange(IEditor* pEditor, const lineRange& lines, std::set<wxString>& unknownWords);
+    void SendRequest(const std::set<wxString>& words, const lineRanges& lines);
     int MarkErrors(IEditor* pEditor);
     void InitLanguageList();
 
@@ -147,5 +172,17 @@ protected:
     partList m_parseValues; // list with position results for CPP parsing
 
     int m_scanners; // flags for scanner types
+
+    wxCriticalSection m_spellLock; // guards m_pSpell, which is shared with the worker thread
+    SpellCheckerCache m_cache;     // hunspell verdicts, accessed from the main thread only
+    SpellCheckerThread* m_thread;  // performs the lookups for the continuous check
+    size_t m_generation;           // incremented whenever cached verdicts become invalid
+
+    // incremental (continuous) check state
+    IEditor* m_incEditor;       // the editor the state below refers to
+    int m_incFirstLine;         // last checked visible range
+    int m_incLastLine;
+    size_t m_session;           // incremented whenever the state below is reset
+    lineRanges m_dirtyLines;    // lines modified since the last check
 };
 #endif // _HUNSPELLINTERFACE_
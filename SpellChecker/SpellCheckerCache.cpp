@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : SpellCheckerCache.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include "SpellCheckerCache.h"
+
+SpellCheckerCache::SpellCheckerCache(size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+SpellCheckerCache::~SpellCheckerCache() {}
+
+bool SpellCheckerCache::Get(const wxString& word, bool& correct)
+{
+    Index_t::iterator iter = m_index.find(word);
+    if(iter == m_index.end()) return false;
+
+    // move the entry to the front of the list
+    m_entries.splice(m_entries.begin(), m_entries, iter->second);
+    correct = iter->second->second;
+    return true;
+}
+
+void SpellCheckerCache::Set(const wxString& word, bool correct)
+{
+    Index_t::iterator iter = m_index.find(word);
+    if(iter != m_index.end()) {
+        iter->second->second = correct;
+        m_entries.splice(m_entries.begin(), m_entries, iter->second);
+        return;
+    }
+
+    m_entries.push_front(std::make_pair(word, correct));
+    m_index.insert(std::make_pair(word, m_entries.begin()));
+
+    while(m_index.size() > m_capacity && !m_entries.empty()) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+}
+
+void SpellCheckerCache::Clear()
+{
+    m_index.clear();
+    m_entries.clear();
+}
+
+void SpellCheckerCache::SetCapacity(size_t capacity)
+{
+    m_capacity = capacity;
+    while(m_index.size() > m_capacity && !m_entries.empty()) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+}
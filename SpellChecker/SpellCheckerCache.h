@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : SpellCheckerCache.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef SPELLCHECKERCACHE_H
+#define SPELLCHECKERCACHE_H
+
+#include <wx/string.h>
+#include <list>
+#include <map>
+#include <utility>
+
+/**
+ * @class SpellCheckerCache
+ * @brief a bounded LRU cache of hunspell verdicts (word -> correct/misspelled)
+ * The cache only holds the dictionary result, the ignore list and the user dictionary
+ * are consulted separately so they can change without invalidating it
+ */
+class SpellCheckerCache
+{
+    typedef std::pair<wxString, bool> Entry_t;
+    typedef std::list<Entry_t> List_t;
+    typedef std::map<wxString, List_t::iterator> Index_t;
+
+    List_t m_entries; // most recently used first
+    Index_t m_index;
+    size_t m_capacity;
+
+public:
+    SpellCheckerCache(size_t capacity = 20000);
+    virtual ~SpellCheckerCache();
+
+    /**
+     * @brief lookup a word. Return true if the word is known, in which case 'correct'
+     * is set to the dictionary verdict
+     */
+    bool Get(const wxString& word, bool& correct);
+
+    /**
+     * @brief store the verdict for a word, evicting the least recently used entry if needed
+     */
+    void Set(const wxString& word, bool correct);
+
+    /**
+     * @brief forget everything (e.g. the dictionary has changed)
+     */
+    void Clear();
+
+    size_t GetCount() const { return m_index.size(); }
+    void SetCapacity(size_t capacity);
+    size_t GetCapacity() const { return m_capacity; }
+};
+
+#endif // SPELLCHECKERCACHE_H
@@ -0,0 +1,62 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : SpellCheckerThread.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include "SpellCheckerThread.h"
+#include "IHunSpell.h"
+
+wxDEFINE_EVENT(wxEVT_SPELLCHECK_THREAD_DONE, wxCommandEvent);
+
+SpellCheckerThread::SpellCheckerThread(IHunSpell* engine)
+    : m_engine(engine)
+{
+    SetSleepInterval(50);
+}
+
+SpellCheckerThread::~SpellCheckerThread() {}
+
+void SpellCheckerThread::ProcessRequest(ThreadRequest* request)
+{
+    SpellCheckRequest* req = dynamic_cast<SpellCheckRequest*>(request);
+    if(!req || !req->m_owner) return;
+
+    SpellCheckResult* result = new SpellCheckResult();
+    result->m_generation = req->m_generation;
+    result->m_session = req->m_session;
+    result->m_lines = req->m_lines;
+    result->m_verdicts.reserve(req->m_words.size());
+
+    for(size_t i = 0; i < req->m_words.size(); ++i) {
+        if(TestDestroy()) {
+            delete result;
+            return;
+        }
+        const wxString& word = req->m_words.at(i);
+        result->m_verdicts.push_back(std::make_pair(word, m_engine->CheckWordNoCache(word) != 0));
+    }
+
+    wxCommandEvent event(wxEVT_SPELLCHECK_THREAD_DONE);
+    event.SetClientData(result);
+    req->m_owner->AddPendingEvent(event);
+}
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : SpellCheckerThread.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef SPELLCHECKERTHREAD_H
+#define SPELLCHECKERTHREAD_H
+
+#include "worker_thread.h"
+#include <wx/event.h>
+#include <wx/string.h>
+#include <vector>
+#include <utility>
+
+class IHunSpell;
+
+// Sent by the worker thread to the owner once a batch of words was checked.
+// The event client data is a SpellCheckResult* which must be deleted by the receiver
+wxDECLARE_EVENT(wxEVT_SPELLCHECK_THREAD_DONE, wxCommandEvent);
+
+/**
+ * @class SpellCheckRequest
+ * @brief a batch of words that are not yet in the verdict cache
+ */
+class SpellCheckRequest : public ThreadRequest
+{
+public:
+    std::vector<wxString> m_words;
+    std::vector<std::pair<int, int> > m_lines; // the lines to re-mark once the words are known
+    size_t m_generation;                       // the engine generation this request was issued for
+    size_t m_session;                          // the incremental check session
+    wxEvtHandler* m_owner;
+
+    SpellCheckRequest()
+        : m_generation(0)
+        , m_session(0)
+        , m_owner(NULL)
+    {
+    }
+    virtual ~SpellCheckRequest() {}
+};
+
+/**
+ * @class SpellCheckResult
+ * @brief the hunspell verdict for each word of a SpellCheckRequest
+ */
+class SpellCheckResult
+{
+public:
+    typedef std::vector<std::pair<wxString, bool> > Verdicts_t;
+    Verdicts_t m_verdicts;
+    std::vector<std::pair<int, int> > m_lines;
+    size_t m_generation;
+    size_t m_session;
+
+    SpellCheckResult()
+        : m_generation(0)
+        , m_session(0)
+    {
+    }
+};
+
+/**
+ * @class SpellCheckerThread
+ * @brief runs the hunspell lookups of the continuous checker off the UI thread
+ */
+class SpellCheckerThread : public WorkerThread
+{
+    IHunSpell* m_engine;
+
+public:
+    SpellCheckerThread(IHunSpell* engine);
+    virtual ~SpellCheckerThread();
+
+    virtual void ProcessRequest(ThreadRequest* request);
+};
+
+#endif // SPELLCHECKERTHREAD_H
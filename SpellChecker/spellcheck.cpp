@@ -45,6 +45,7 @@
 #include "scGlobals.h"
 #include "IHunSpell.h"
 #include "SpellCheckerSettings.h"
+#include "SpellCheckerThread.h"
 
 #include <wx/mstream.h>
 #include <wx/xrc/xmlres.h>
@@ -102,6 +103,7 @@ SpellCheck::~SpellCheck()
     m_topWin->Disconnect(wxEVT_CMD_EDITOR_CONTEXT_MENU, wxCommandEventHandler(SpellCheck::OnContextMenu), NULL, this);
     //	m_topWin->Disconnect( wxEVT_WORKSPACE_LOADED, wxCommandEventHandler( SpellCheck::OnWspLoaded ), NULL, this );
     m_topWin->Disconnect(wxEVT_WORKSPACE_CLOSED, wxCommandEventHandler(SpellCheck::OnWspClosed), NULL, this);
+    Disconnect(wxEVT_SPELLCHECK_THREAD_DONE, wxCommandEventHandler(SpellCheck::OnSpellThreadDone), NULL, this);
 
     if(m_pEngine != NULL) wxDELETE(m_pEngine);
 }
@@ -114,6 +116,7 @@ void SpellCheck::Init()
     m_shortName = s_plugName;
     m_sepItem = NULL;
     m_pToolbar = NULL;
+    m_trackedEditor = NULL;
     m_topWin = wxTheApp;
     m_checkContinuous = false;
     m_pEngine = new IHunSpell();
@@ -135,6 +138,7 @@ void SpellCheck::Init()
     m_topWin->Connect(wxEVT_CMD_EDITOR_CONTEXT_MENU, wxCommandEventHandler(SpellCheck::OnContextMenu), NULL, this);
     m_topWin->Connect(wxEVT_WORKSPACE_LOADED, wxCommandEventHandler(SpellCheck::OnWspLoaded), NULL, this);
     m_topWin->Connect(wxEVT_WORKSPACE_CLOSED, wxCommandEventHandler(SpellCheck::OnWspClosed), NULL, this);
+    Connect(wxEVT_SPELLCHECK_THREAD_DONE, wxCommandEventHandler(SpellCheck::OnSpellThreadDone), NULL, this);
 
     EventNotifier::Get()->Connect(wxEVT_CONTEXT_MENU_EDITOR_SHOWING,
                                   clContextMenuEventHandler(SpellCheck::OnEditorContextMenuShowing),
@@ -144,6 +148,8 @@ void SpellCheck::Init()
                                   clContextMenuEventHandler(SpellCheck::OnEditorContextMenuDismissed),
                                   NULL,
                                   this);
+    EventNotifier::Get()->Connect(
+        wxEVT_EDITOR_CLOSING, wxCommandEventHandler(SpellCheck::OnEditorClosing), NULL, this);
 }
 // ------------------------------------------------------------
 clToolBar* SpellCheck::CreateToolBar(wxWindow* parent)
@@ -249,6 +255,10 @@ void SpellCheck::UnHookPopupMenu(wxMenu* menu, MenuType type)
 void SpellCheck::UnPlug()
 {
     if(m_timer.IsRunning()) m_timer.Stop();
+    TrackEditor(NULL);
+    EventNotifier::Get()->Disconnect(
+        wxEVT_EDITOR_CLOSING, wxCommandEventHandler(SpellCheck::OnEditorClosing), NULL, this);
+    if(m_pEngine) m_pEngine->StopThread();
 }
 // ------------------------------------------------------------
 // returns pointer to editor
@@ -369,7 +379,6 @@ void SpellCheck::OnContinousCheck(wxCommandEvent& e)
         }
 
         SetCheckContinuous(true);
-        wxString text = editor->GetEditorText();
 
         // if we don't have a dictionary yet, open settings
         if(!m_pEngine->GetDictionary()) {
@@ -377,16 +386,7 @@ void SpellCheck::OnContinousCheck(wxCommandEvent& e)
             return;
         }
 
-        switch(editor->GetLexerId()) {
-        case 3: { // wxSCI_LEX_CPP
-            if(m_mgr->IsWorkspaceOpen()) {
-                m_pEngine->CheckCppSpelling(text);
-            }
-        } break;
-        case 1: { // wxSCI_LEX_NULL
-            m_pEngine->CheckSpelling(text);
-        } break;
-        }
+        DoContinuousCheck(editor);
         m_timer.Start(PARSE_TIME);
     }
 }
@@ -402,16 +402,23 @@ void SpellCheck::OnTimer(wxTimerEvent& e)
     if(!editor) return;
 
     if(GetCheckContinuous()) {
-        switch(editor->GetLexerId()) {
-        case 3: { // wxSCI_LEX_CPP
-            if(m_mgr->IsWorkspaceOpen()) {
-                m_pEngine->CheckCppSpelling(editor->GetEditorText());
-            }
-        } break;
-        case 1: { // wxSCI_LEX_NULL
-            m_pEngine->CheckSpelling(editor->GetEditorText());
-        } break;
+        DoContinuousCheck(editor);
+    }
+}
+// ------------------------------------------------------------
+void SpellCheck::DoContinuousCheck(IEditor* editor)
+{
+    switch(editor->GetLexerId()) {
+    case 3: { // wxSCI_LEX_CPP
+        if(m_mgr->IsWorkspaceOpen()) {
+            // only the visible and modified lines are checked
+            TrackEditor(editor);
+            m_pEngine->CheckCppSpellingIncremental(editor);
         }
+    } break;
+    case 1: { // wxSCI_LEX_NULL
+        m_pEngine->CheckSpelling(editor->GetEditorText());
+    } break;
     }
 }
 // ------------------------------------------------------------
@@ -479,6 +486,7 @@ void SpellCheck::SetCheckContinuous(bool value)
         }
     } else {
         if(m_timer.IsRunning()) m_timer.Stop();
+        if(m_pEngine) m_pEngine->ResetIncrementalState();
 
         if(m_pToolbar) {
             m_pToolbar->ToggleTool(XRCID(s_contCheckID), false);
@@ -513,6 +521,54 @@ void SpellCheck::OnEditorContextMenuShowing(clContextMenuEvent& e)
     }
 }
 
+void SpellCheck::TrackEditor(IEditor* editor)
+{
+    if(editor == m_trackedEditor) return;
+
+    if(m_trackedEditor) {
+        m_trackedEditor->GetSTC()->Disconnect(
+            wxEVT_STC_MODIFIED, wxStyledTextEventHandler(SpellCheck::OnEditorModified), NULL, this);
+    }
+    m_trackedEditor = editor;
+    if(m_trackedEditor) {
+        m_trackedEditor->GetSTC()->Connect(
+            wxEVT_STC_MODIFIED, wxStyledTextEventHandler(SpellCheck::OnEditorModified), NULL, this);
+    }
+}
+
+void SpellCheck::OnEditorModified(wxStyledTextEvent& e)
+{
+    e.Skip();
+    if(!m_trackedEditor || !m_pEngine) return;
+
+    if(e.GetModificationType() & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT)) {
+        int line = m_trackedEditor->GetSTC()->LineFromPosition(e.GetPosition());
+        m_pEngine->MarkLinesDirty(line, e.GetLinesAdded());
+    }
+}
+
+void SpellCheck::OnEditorClosing(wxCommandEvent& e)
+{
+    e.Skip();
+    IEditor* editor = reinterpret_cast<IEditor*>(e.GetClientData());
+    if(editor && editor == m_trackedEditor) {
+        TrackEditor(NULL);
+        if(m_pEngine) m_pEngine->ResetIncrementalState();
+    }
+}
+
+void SpellCheck::OnSpellThreadDone(wxCommandEvent& e)
+{
+    SpellCheckResult* result = reinterpret_cast<SpellCheckResult*>(e.GetClientData());
+    if(!result) return;
+
+    if(m_pEngine && GetCheckContinuous()) {
+        m_pEngine->OnWordsChecked(result);
+    } else {
+        delete result;
+    }
+}
+
 void SpellCheck::ClearIndicatorsFromEditors()
 {
     // Remove the indicators from all the editors
@@ -40,6 +40,7 @@
 #include "spellcheckeroptions.h"
 #include <wx/timer.h>
 #include "cl_command_event.h"
+#include <wx/stc/stc.h>
 //------------------------------------------------------------
 class IHunSpell;
 class SpellCheck : public IPlugin
@@ -74,6 +75,9 @@ public:
     void OnWspClosed(wxCommandEvent& e);
     void OnEditorContextMenuShowing(clContextMenuEvent& e);
     void OnEditorContextMenuDismissed(clContextMenuEvent& e);
+    void OnEditorClosing(wxCommandEvent& e);
+    void OnEditorModified(wxStyledTextEvent& e);
+    void OnSpellThreadDone(wxCommandEvent& e);
 
     wxMenuItem* m_sepItem;
     wxEvtHandler* m_topWin;
@@ -86,6 +90,8 @@ protected:
     void LoadSettings();
     void SaveSettings();
     void ClearIndicatorsFromEditors();
+    void TrackEditor(IEditor* editor);
+    void DoContinuousCheck(IEditor* editor);
 
 protected:
     bool m_checkContinuous;
@@ -93,6 +99,7 @@ protected:
     wxTimer m_timer;
     wxString m_currentWspPath;
     wxAuiToolBar* m_pToolbar;
+    IEditor* m_trackedEditor; // the editor whose modifications are reported to the engine
 };
 //------------------------------------------------------------
 #endif // SpellCheck
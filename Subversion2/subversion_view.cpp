@@ -146,6 +146,47 @@ public:
     const wxFileName& GetFilename() const { return m_filename; }
 };
 
+// ---------------------------------------------------------------------
+// Compute the working copy status from .svn/wc.db in the background
+// ---------------------------------------------------------------------
+class SvnWcStatusThread : public wxThread
+{
+    SubversionView* m_view;
+    SvnWcStatus* m_wcStatus;
+    int m_generation;
+
+public:
+    wxString m_root;
+    bool m_fileExplorerOnly;
+    bool m_succeeded;
+    SvnWcStatus::Result m_result;
+
+public:
+    SvnWcStatusThread(SubversionView* view,
+                      SvnWcStatus* wcStatus,
+                      const wxString& root,
+                      bool fileExplorerOnly,
+                      int generation)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_view(view)
+        , m_wcStatus(wcStatus)
+        , m_generation(generation)
+        , m_root(root)
+        , m_fileExplorerOnly(fileExplorerOnly)
+        , m_succeeded(false)
+    {
+    }
+
+    virtual ~SvnWcStatusThread() {}
+
+    virtual void* Entry()
+    {
+        m_succeeded = m_wcStatus->GetStatus(m_root, m_result);
+        m_view->CallAfter(&SubversionView::OnWcStatusReady, m_generation);
+        return NULL;
+    }
+};
+
 SubversionView::SubversionView(wxWindow* parent, Subversion2* plugin)
     : SubversionPageBase(parent)
     , m_plugin(plugin)
@@ -153,6 +194,8 @@ SubversionView::SubversionView(wxWindow* parent, Subversion2* plugin)
     , m_diffCommand(plugin)
     , m_fileExplorerLastBaseImgIdx(-1)
     , m_codeliteEcho(NULL)
+    , m_statusThread(NULL)
+    , m_statusGeneration(0)
 {
     CreatGUIControls();
     m_themeHelper = new ThemeHandlerHelper(this);
@@ -170,6 +213,7 @@ SubversionView::SubversionView(wxWindow* parent, Subversion2* plugin)
 
 SubversionView::~SubversionView()
 {
+    DoCancelStatus();
     wxDELETE(m_themeHelper);
     DisconnectEvents();
 }
@@ -329,19 +373,78 @@ void SubversionView::BuildTree(const wxString& root)
     if(root.IsEmpty()) return;
 
     DoChangeRootPathUI(root);
-
-    wxString command;
-    command << m_plugin->GetSvnExeName() << wxT(" status");
-    m_simpleCommand.Execute(command, root, new SvnStatusHandler(m_plugin, wxNOT_FOUND, NULL), m_plugin);
+    DoBuildStatus(root, false);
 }
 
 void SubversionView::BuildExplorerTree(const wxString& root)
 {
     if(root.IsEmpty()) return;
+    DoBuildStatus(root, true);
+}
+
+void SubversionView::DoBuildStatus(const wxString& root, bool fileExplorerOnly)
+{
+    // A working copy we can read directly does not need 'svn status'
+    if(SvnWcStatus::FindWcRoot(root).IsEmpty()) {
+        DoRunSvnStatus(root, fileExplorerOnly);
+        return;
+    }
+
+    DoCancelStatus();
+    m_wcStatus.ResetCancel();
+    m_statusThread = new SvnWcStatusThread(this, &m_wcStatus, root, fileExplorerOnly, ++m_statusGeneration);
+    if(m_statusThread->Create() != wxTHREAD_NO_ERROR || m_statusThread->Run() != wxTHREAD_NO_ERROR) {
+        wxDELETE(m_statusThread);
+        CL_WARNING("Subversion: failed to start the status thread, running 'svn status'");
+        DoRunSvnStatus(root, fileExplorerOnly);
+    }
+}
 
+void SubversionView::DoRunSvnStatus(const wxString& root, bool fileExplorerOnly)
+{
     wxString command;
     command << m_plugin->GetSvnExeName() << wxT(" status");
-    m_simpleCommand.Execute(command, root, new SvnStatusHandler(m_plugin, wxNOT_FOUND, NULL, true, root), m_plugin);
+    if(fileExplorerOnly) {
+        m_simpleCommand.Execute(command, root, new SvnStatusHandler(m_plugin, wxNOT_FOUND, NULL, true, root), m_plugin);
+    } else {
+        m_simpleCommand.Execute(command, root, new SvnStatusHandler(m_plugin, wxNOT_FOUND, NULL), m_plugin);
+    }
+}
+
+void SubversionView::DoCancelStatus()
+{
+    if(m_statusThread) {
+        m_wcStatus.Cancel();
+        m_statusThread->Wait();
+        wxDELETE(m_statusThread);
+    }
+}
+
+void SubversionView::OnWcStatusReady(int generation)
+{
+    if(generation != m_statusGeneration || !m_statusThread) return;
+
+    m_statusThread->Wait();
+    SvnWcStatusThread* thread = m_statusThread;
+    m_statusThread = NULL;
+
+    if(thread->m_succeeded) {
+        const SvnWcStatus::Result& res = thread->m_result;
+        UpdateTree(res.modifiedFiles,
+                   res.conflictedFiles,
+                   res.unversionedFiles,
+                   res.newFiles,
+                   res.deletedFiles,
+                   res.lockedFiles,
+                   res.ignoredFiles,
+                   thread->m_fileExplorerOnly,
+                   thread->m_fileExplorerOnly ? thread->m_root : wxString());
+
+    } else {
+        CL_DEBUG("Subversion: can not read the working copy of %s, running 'svn status'", thread->m_root);
+        DoRunSvnStatus(thread->m_root, thread->m_fileExplorerOnly);
+    }
+    delete thread;
 }
 
 void SubversionView::OnWorkspaceLoaded(wxCommandEvent& event)
@@ -940,6 +1043,8 @@ void SubversionView::OnClearOuptut(wxCommandEvent& event)
 void SubversionView::OnRefreshView(wxCommandEvent& event)
 {
     event.Skip();
+    // An explicit refresh re-reads everything
+    m_wcStatus.Clear();
     BuildTree();
 }
 
@@ -954,6 +1059,11 @@ void SubversionView::OnFileAdded(clCommandEvent& event)
     int flags = event.GetInt();
     if(flags & kEventImportingFolder) return;
 
+    const wxArrayString& addedFiles = event.GetStrings();
+    for(size_t i = 0; i < addedFiles.GetCount(); ++i) {
+        m_wcStatus.Invalidate(addedFiles.Item(i));
+    }
+
     SvnSettingsData ssd = m_plugin->GetSettings();
     if(ssd.GetFlags() & SvnAddFileToSvn) {
         const wxArrayString& files = event.GetStrings();
@@ -991,6 +1101,10 @@ void SubversionView::OnFileAdded(clCommandEvent& event)
 void SubversionView::OnFileRenamed(wxCommandEvent& event)
 {
     wxArrayString* files = (wxArrayString*)event.GetClientData();
+    if(files && files->GetCount() == 2) {
+        m_wcStatus.Invalidate(files->Item(0));
+        m_wcStatus.Invalidate(files->Item(1));
+    }
 
     // If the Svn Client Version is set to 0.0 it means that we dont have SVN client installed
     if(m_plugin->GetSvnClientVersion() && files && (m_plugin->GetSettings().GetFlags() & SvnRenameFileInRepo)) {
@@ -1444,7 +1558,8 @@ void SubversionView::DoCreateFileExplorerImages()
 void SubversionView::OnFileSaved(clCommandEvent& event)
 {
     event.Skip();
-    OnRefreshView(event);
+    m_wcStatus.Invalidate(event.GetString());
+    BuildTree();
 }
 void SubversionView::OnCharAdded(wxStyledTextEvent& event) { m_subversionConsole->OnCharAdded(event); }
 void SubversionView::OnKeyDown(wxKeyEvent& event) { m_subversionConsole->OnKeyDown(event); }
@@ -38,9 +38,11 @@ Subclass of SubversionPageBase, which is generated by wxFormBuilder.
 #include "svn_console.h"
 #include "theme_handler_helper.h"
 #include "cl_command_event.h"
+#include "svn_wc_status.h"
 
 class Subversion2;
 class wxMenu;
+class SvnWcStatusThread;
 
 class SvnPageSelectionInfo
 {
@@ -77,7 +79,10 @@ class SubversionView : public SubversionPageBase
     ThemeHandlerHelper* m_themeHelper;
     wxFileName m_workspaceFile;
     IProcess* m_codeliteEcho;
-    
+    SvnWcStatus m_wcStatus;
+    SvnWcStatusThread* m_statusThread;
+    int m_statusGeneration;
+
 public:
     enum { SvnInfo_Tag, SvnInfo_Branch, SvnInfo_Info };
 
@@ -103,6 +108,9 @@ protected:
     void DoRootDirChanged(const wxString& path);
     wxString DoGetCurRepoPath() const;
     void DoCreateFileExplorerImages();
+    void DoBuildStatus(const wxString& root, bool fileExplorerOnly);
+    void DoRunSvnStatus(const wxString& root, bool fileExplorerOnly);
+    void DoCancelStatus();
 
 protected:
     // Menu management
@@ -182,6 +190,7 @@ public:
     void BuildTree();
     void BuildTree(const wxString& root);
     void BuildExplorerTree(const wxString& root);
+    void OnWcStatusReady(int generation);
 
     wxString GetRootDir() const { return DoGetCurRepoPath(); }
 };
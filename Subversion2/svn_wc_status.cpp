@@ -0,0 +1,951 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : svn_wc_status.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+
+#include "svn_wc_status.h"
+#include "file_logger.h"
+#include <wx/wxsqlite3.h>
+#include <wx/filename.h>
+#include <wx/datetime.h>
+#include <wx/filefn.h>
+#include <wx/file.h>
+#include <wx/dir.h>
+#include <wx/fileconf.h>
+#include <wx/stdpaths.h>
+#include <wx/tokenzr.h>
+#include <wx/log.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <set>
+
+// The compiled-in default of the 'global-ignores' runtime option
+static const wxChar* DEFAULT_GLOBAL_IGNORES =
+    wxT("*.o *.lo *.la *.al .libs *.so *.so.[0-9]* *.a *.pyc *.pyo __pycache__ *.rej *~ #*# .#* .*.swp .DS_Store");
+
+// Entries modified during the last few seconds are not cached, their
+// timestamps are not precise enough to detect a second change
+#define RECENT_CHANGE_SECONDS 2
+
+/**
+ * @brief return the modification time of a file in microseconds and the precision (in microseconds)
+ * the platform provides it with. svn records last_mod_time in microseconds
+ */
+static wxLongLong GetModificationTime(const wxString& path, const wxStructStat& st, wxLongLong& precision)
+{
+    wxLongLong seconds((wxLongLong_t)st.st_mtime);
+#if defined(__WXMSW__)
+    // the CRT only reports seconds, wxFileName reads the FILETIME with milliseconds
+    wxDateTime modified;
+    if(wxFileName(path).GetTimes(NULL, &modified, NULL)) {
+        precision = 1000;
+        return modified.GetValue() * 1000;
+    }
+#elif defined(__APPLE__)
+    precision = 1;
+    return seconds * 1000000 + st.st_mtimespec.tv_nsec / 1000;
+#elif defined(__linux__) || defined(__FreeBSD__)
+    precision = 1;
+    return seconds * 1000000 + st.st_mtim.tv_nsec / 1000;
+#endif
+    wxUnusedVar(path);
+    precision = 1000000;
+    return seconds * 1000000;
+}
+
+static int GetDepth(const wxString& relpath)
+{
+    return relpath.IsEmpty() ? 0 : (int)relpath.Freq(wxT('/')) + 1;
+}
+
+/**
+ * @brief fnmatch() like matching of the ignore patterns: supports '*', '?' and '[...]'
+ */
+static bool WildMatch(const wxString& pattern, size_t p, const wxString& str, size_t s)
+{
+    while(p < pattern.length()) {
+        wxChar pc = pattern.GetChar(p);
+        if(pc == wxT('*')) {
+            while(p < pattern.length() && pattern.GetChar(p) == wxT('*')) {
+                ++p;
+            }
+            if(p == pattern.length()) {
+                return true;
+            }
+            for(; s <= str.length(); ++s) {
+                if(WildMatch(pattern, p, str, s)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        if(s == str.length()) {
+            return false;
+        }
+
+        wxChar sc = str.GetChar(s);
+        if(pc == wxT('[')) {
+            size_t q = p + 1;
+            bool negate = false;
+            if(q < pattern.length() && (pattern.GetChar(q) == wxT('!') || pattern.GetChar(q) == wxT('^'))) {
+                negate = true;
+                ++q;
+            }
+
+            bool matched = false;
+            bool first = true;
+            while(q < pattern.length() && (first || pattern.GetChar(q) != wxT(']'))) {
+                first = false;
+                wxChar lo = pattern.GetChar(q);
+                wxChar hi = lo;
+                if(q + 2 < pattern.length() && pattern.GetChar(q + 1) == wxT('-') && pattern.GetChar(q + 2) != wxT(']')) {
+                    hi = pattern.GetChar(q + 2);
+                    q += 2;
+                }
+                if(sc >= lo && sc <= hi) {
+                    matched = true;
+                }
+                ++q;
+            }
+
+            if(q < pattern.length()) {
+                if(matched == negate) {
+                    return false;
+                }
+                p = q + 1;
+                ++s;
+                continue;
+            }
+            // no closing bracket, match the '[' literally
+        }
+
+        if(pc == wxT('\\') && p + 1 < pattern.length()) {
+            pc = pattern.GetChar(++p);
+        }
+
+        if(pc != sc) {
+            return false;
+        }
+        ++p;
+        ++s;
+    }
+    return s == str.length();
+}
+
+static bool IsIgnored(const wxString& name, const wxArrayString& patterns)
+{
+    for(size_t i = 0; i < patterns.GetCount(); ++i) {
+        if(WildMatch(patterns.Item(i), 0, name, 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void AppendWithPrefix(const wxArrayString& paths, const wxString& prefix, wxArrayString& result)
+{
+    for(size_t i = 0; i < paths.GetCount(); ++i) {
+        result.Add(prefix + paths.Item(i));
+    }
+}
+
+/**
+ * @brief parse the properties skel "(name value name value ...)" stored
+ * in the NODES and ACTUAL_NODE tables. Collect the ignore patterns and
+ * check whether svn translates the file content
+ */
+static void ParseProperties(const unsigned char* data,
+                            int len,
+                            wxArrayString& ignores,
+                            wxArrayString& globalIgnores,
+                            bool& translated)
+{
+    ignores.Clear();
+    globalIgnores.Clear();
+    translated = false;
+
+    wxArrayString atoms;
+    int i = 0;
+    while(i < len && data[i] != '(') {
+        ++i;
+    }
+    ++i;
+
+    while(i < len && data[i] != ')') {
+        unsigned char ch = data[i];
+        if(isspace(ch)) {
+            ++i;
+
+        } else if(isdigit(ch)) {
+            // explicit-length atom: "<length> <bytes>"
+            int length = 0;
+            while(i < len && isdigit(data[i])) {
+                length = length * 10 + (data[i] - '0');
+                ++i;
+            }
+            ++i;
+            if(i + length > len) {
+                break;
+            }
+            atoms.Add(wxString::FromUTF8((const char*)data + i, length));
+            i += length;
+
+        } else if(ch == '(') {
+            // nested lists are not used for properties, skip them
+            int depth = 0;
+            for(; i < len; ++i) {
+                if(data[i] == '(') {
+                    ++depth;
+                } else if(data[i] == ')' && --depth == 0) {
+                    ++i;
+                    break;
+                }
+            }
+            atoms.Add(wxEmptyString);
+
+        } else {
+            // implicit-length atom
+            int start = i;
+            while(i < len && !isspace(data[i]) && data[i] != '(' && data[i] != ')') {
+                ++i;
+            }
+            atoms.Add(wxString::FromUTF8((const char*)data + start, i - start));
+        }
+    }
+
+    for(size_t k = 0; k + 1 < atoms.GetCount(); k += 2) {
+        if(atoms.Item(k) == wxT("svn:ignore")) {
+            ignores = ::wxStringTokenize(atoms.Item(k + 1), wxT("\r\n"), wxTOKEN_STRTOK);
+
+        } else if(atoms.Item(k) == wxT("svn:global-ignores")) {
+            globalIgnores = ::wxStringTokenize(atoms.Item(k + 1), wxT("\r\n"), wxTOKEN_STRTOK);
+
+        } else if(atoms.Item(k) == wxT("svn:eol-style") || atoms.Item(k) == wxT("svn:keywords")) {
+            translated = true;
+        }
+    }
+}
+
+SvnWcStatus::SvnWcStatus()
+    : m_parent(NULL)
+    , m_unknownState(false)
+    , m_cancelled(false)
+    , m_clearRequested(false)
+{
+}
+
+SvnWcStatus::~SvnWcStatus()
+{
+    DoDeleteExternals();
+}
+
+void SvnWcStatus::DoDeleteExternals()
+{
+    ExternalsMap_t::iterator iter = m_externals.begin();
+    for(; iter != m_externals.end(); ++iter) {
+        delete iter->second;
+    }
+    m_externals.clear();
+}
+
+wxString SvnWcStatus::FindWcRoot(const wxString& path)
+{
+    wxFileName dir(path, wxEmptyString);
+    while(true) {
+        wxFileName db(dir.GetPath(), wxT("wc.db"));
+        db.AppendDir(wxT(".svn"));
+        if(db.FileExists()) {
+            return dir.GetPath();
+        }
+
+        if(dir.GetDirCount() == 0) {
+            break;
+        }
+        dir.RemoveLastDir();
+    }
+    return wxEmptyString;
+}
+
+void SvnWcStatus::Invalidate(const wxString& path)
+{
+    wxCriticalSectionLocker locker(m_lock);
+    // the path is consumed by the worker thread, make our own copy
+    m_pending.Add(path.c_str());
+}
+
+void SvnWcStatus::Clear()
+{
+    wxCriticalSectionLocker locker(m_lock);
+    m_clearRequested = true;
+}
+
+void SvnWcStatus::DoReset()
+{
+    m_dbSignature.Clear();
+    m_nodes.clear();
+    m_children.clear();
+    m_files.clear();
+    m_dirs.clear();
+    m_configIgnores.Clear();
+    m_externalDirs.clear();
+    DoDeleteExternals();
+}
+
+void SvnWcStatus::DoApplyPending()
+{
+    wxArrayString pending;
+    bool clear;
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        pending = m_pending;
+        clear = m_clearRequested;
+        m_pending.Clear();
+        m_clearRequested = false;
+    }
+
+    if(clear) {
+        DoReset();
+        return;
+    }
+
+    for(size_t i = 0; i < pending.GetCount(); ++i) {
+        // the path might be inside an external
+        ExternalsMap_t::iterator iter = m_externals.begin();
+        for(; iter != m_externals.end(); ++iter) {
+            iter->second->Invalidate(pending.Item(i));
+        }
+
+        wxString relpath;
+        if(!DoGetRelPath(pending.Item(i), relpath)) {
+            continue;
+        }
+
+        // the path might be a file or a directory
+        m_files.erase(relpath);
+        m_dirs.erase(relpath);
+        m_dirs.erase(relpath.Contains(wxT("/")) ? relpath.BeforeLast(wxT('/')) : wxString());
+    }
+}
+
+bool SvnWcStatus::GetStatus(const wxString& root, Result& result)
+{
+    m_unknownState = false;
+
+    wxString wcRoot = FindWcRoot(root);
+    if(wcRoot.IsEmpty()) {
+        return false;
+    }
+
+    if(wcRoot != m_wcRoot) {
+        DoReset();
+        m_wcRoot = wcRoot;
+    }
+
+    DoApplyPending();
+    if(!DoLoad()) {
+        return false;
+    }
+
+    if(!DoGetRelPath(root, m_scanRoot)) {
+        return false;
+    }
+
+    NodeMap_t::const_iterator iter = m_nodes.find(m_scanRoot);
+    if(iter == m_nodes.end() || !iter->second.present || iter->second.kind != wxT('d')) {
+        // not a versioned directory, let 'svn status' report it
+        return false;
+    }
+
+    // svn:global-ignores are inherited from the parent directories
+    wxArrayString ignores = m_configIgnores;
+    wxString parent = m_scanRoot;
+    while(!parent.IsEmpty()) {
+        parent = parent.Contains(wxT("/")) ? parent.BeforeLast(wxT('/')) : wxString();
+        NodeMap_t::const_iterator parentIter = m_nodes.find(parent);
+        if(parentIter != m_nodes.end()) {
+            WX_APPEND_ARRAY(ignores, parentIter->second.globalIgnores);
+        }
+    }
+
+    DoScanDir(m_scanRoot, ignores, true, result);
+
+    std::set<wxString>::const_iterator extIter = m_externalDirs.begin();
+    for(; extIter != m_externalDirs.end() && !IsCancelled(); ++extIter) {
+        if(m_scanRoot.IsEmpty() || extIter->StartsWith(m_scanRoot + wxT("/"))) {
+            if(!DoScanExternal(*extIter, result)) {
+                return false;
+            }
+        }
+    }
+
+    if(m_unknownState) {
+        return false;
+    }
+
+    result.modifiedFiles.Sort();
+    result.conflictedFiles.Sort();
+    result.unversionedFiles.Sort();
+    result.newFiles.Sort();
+    result.deletedFiles.Sort();
+    result.lockedFiles.Sort();
+    result.ignoredFiles.Sort();
+    return !IsCancelled();
+}
+
+bool SvnWcStatus::DoScanExternal(const wxString& relpath, Result& result)
+{
+    // an external which is not checked out (yet) is reported by 'svn status'
+    wxString path = DoGetFullPath(relpath);
+    wxFileName db(path, wxT("wc.db"));
+    db.AppendDir(wxT(".svn"));
+    if(!db.FileExists()) {
+        return false;
+    }
+
+    SvnWcStatus*& status = m_externals[relpath];
+    if(!status) {
+        status = new SvnWcStatus();
+        status->m_parent = this;
+    }
+
+    Result externalResult;
+    if(!status->GetStatus(path, externalResult)) {
+        return false;
+    }
+
+    wxString prefix = DoGetDisplayPath(relpath) + wxFILE_SEP_PATH;
+    AppendWithPrefix(externalResult.modifiedFiles, prefix, result.modifiedFiles);
+    AppendWithPrefix(externalResult.conflictedFiles, prefix, result.conflictedFiles);
+    AppendWithPrefix(externalResult.unversionedFiles, prefix, result.unversionedFiles);
+    AppendWithPrefix(externalResult.newFiles, prefix, result.newFiles);
+    AppendWithPrefix(externalResult.deletedFiles, prefix, result.deletedFiles);
+    AppendWithPrefix(externalResult.lockedFiles, prefix, result.lockedFiles);
+    AppendWithPrefix(externalResult.ignoredFiles, prefix, result.ignoredFiles);
+    return true;
+}
+
+wxString SvnWcStatus::DoGetDbSignature() const
+{
+    wxFileName db(m_wcRoot, wxT("wc.db"));
+    db.AppendDir(wxT(".svn"));
+
+    wxStructStat st;
+    if(wxStat(db.GetFullPath(), &st) != 0) {
+        return wxEmptyString;
+    }
+
+    // SQLite bumps the "file change counter" in the database header on
+    // every write transaction, unlike the modification time this is
+    // precise enough to detect two svn commands in the same second
+    unsigned char counter[4] = { 0, 0, 0, 0 };
+    {
+        wxLogNull noLog;
+        wxFile file(db.GetFullPath());
+        if(file.IsOpened() && file.Seek(24) != wxInvalidOffset) {
+            file.Read(counter, sizeof(counter));
+        }
+    }
+
+    return wxString::Format(wxT("%ld:%ld:%02x%02x%02x%02x"),
+                            (long)st.st_mtime,
+                            (long)st.st_size,
+                            counter[0],
+                            counter[1],
+                            counter[2],
+                            counter[3]);
+}
+
+bool SvnWcStatus::DoLoad()
+{
+    wxString signature = DoGetDbSignature();
+    if(signature.IsEmpty()) {
+        return false;
+    }
+
+    if(signature == m_dbSignature) {
+        return true;
+    }
+
+    // the file states were computed against the old nodes
+    m_dbSignature.Clear();
+    m_nodes.clear();
+    m_children.clear();
+    m_files.clear();
+    m_externalDirs.clear();
+
+    wxFileName dbfile(m_wcRoot, wxT("wc.db"));
+    dbfile.AppendDir(wxT(".svn"));
+
+    try {
+        wxSQLite3Database db;
+        db.Open(dbfile.GetFullPath());
+
+        int format = db.ExecuteScalar(wxT("PRAGMA user_version"));
+        if(format < 29 || format > 31) {
+            CL_DEBUG("Subversion: unsupported working copy format %d (%s)", format, m_wcRoot);
+            return false;
+        }
+
+        // lock tokens held by this working copy
+        std::set<wxString> locks;
+        wxSQLite3ResultSet lockRes = db.ExecuteQuery(wxT("SELECT repos_id, repos_relpath FROM LOCK"));
+        while(lockRes.NextRow()) {
+            wxString key;
+            key << lockRes.GetAsString(0) << wxT(":") << lockRes.GetAsString(1);
+            locks.insert(key);
+        }
+
+        wxSQLite3ResultSet nodeRes = db.ExecuteQuery(
+            wxT("SELECT local_relpath, op_depth, presence, kind, checksum, translated_size, last_mod_time, "
+                "properties, repos_id, repos_path FROM NODES ORDER BY local_relpath, op_depth"));
+        while(nodeRes.NextRow()) {
+            wxString relpath = nodeRes.GetAsString(0);
+            int opDepth = nodeRes.GetInt(1);
+            wxString presence = nodeRes.GetAsString(2);
+
+            NodeMap_t::iterator iter = m_nodes.find(relpath);
+            if(iter == m_nodes.end()) {
+                iter = m_nodes.insert(std::make_pair(relpath, Node())).first;
+                if(!relpath.IsEmpty()) {
+                    wxString parent = relpath.Contains(wxT("/")) ? relpath.BeforeLast(wxT('/')) : wxString();
+                    m_children[parent].Add(relpath.AfterLast(wxT('/')));
+                }
+            }
+
+            // The rows of a node are sorted by op_depth, the highest (the
+            // working layer) determines the status
+            Node& node = iter->second;
+            if(presence == wxT("base-deleted")) {
+                node.status = wxT('D');
+                continue;
+            }
+
+            if(presence != wxT("normal") && presence != wxT("incomplete")) {
+                node.present = false;
+                node.status = wxT(' ');
+                continue;
+            }
+
+            if(opDepth == 0) {
+                wxString key;
+                key << nodeRes.GetAsString(8) << wxT(":") << nodeRes.GetAsString(9);
+                node.hasBase = true;
+                node.locked = locks.count(key) != 0;
+            }
+
+            wxString kind = nodeRes.GetAsString(3);
+            node.present = true;
+            node.kind = (kind == wxT("dir")) ? wxT('d') : ((kind == wxT("symlink")) ? wxT('s') : wxT('f'));
+            node.checksum = nodeRes.GetAsString(4);
+            node.size = nodeRes.IsNull(5) ? wxLongLong(-1) : nodeRes.GetInt64(5);
+            node.mtime = nodeRes.GetInt64(6);
+
+            // Only the root of an add / copy operation is reported as added
+            node.status = wxT(' ');
+            if(opDepth > 0 && opDepth == GetDepth(relpath)) {
+                node.status = node.hasBase ? wxT('R') : wxT('A');
+            }
+
+            if(!nodeRes.IsNull(7)) {
+                int len = 0;
+                const unsigned char* props = nodeRes.GetBlob(7, len);
+                ParseProperties(props, len, node.ignores, node.globalIgnores, node.translated);
+            }
+        }
+
+        // Conflicts and local property changes. The conflict columns
+        // differ between the formats so look them up by name
+        wxSQLite3ResultSet actualRes = db.ExecuteQuery(wxT("SELECT * FROM ACTUAL_NODE"));
+        int relpathCol = wxNOT_FOUND;
+        int propsCol = wxNOT_FOUND;
+        std::vector<int> conflictCols;
+        for(int i = 0; i < actualRes.GetColumnCount(); ++i) {
+            wxString name = actualRes.GetColumnName(i);
+            if(name == wxT("local_relpath")) {
+                relpathCol = i;
+
+            } else if(name == wxT("properties")) {
+                propsCol = i;
+
+            } else if(name == wxT("conflict_old") || name == wxT("conflict_new") || name == wxT("conflict_working") ||
+                      name == wxT("prop_reject") || name == wxT("tree_conflict_data") || name == wxT("conflict_data")) {
+                conflictCols.push_back(i);
+            }
+        }
+
+        while(relpathCol != wxNOT_FOUND && actualRes.NextRow()) {
+            wxString relpath = actualRes.GetAsString(relpathCol);
+            bool conflicted = false;
+            for(size_t i = 0; i < conflictCols.size() && !conflicted; ++i) {
+                conflicted = !actualRes.IsNull(conflictCols.at(i));
+            }
+
+            NodeMap_t::iterator iter = m_nodes.find(relpath);
+            if(iter == m_nodes.end()) {
+                if(!conflicted || relpath.IsEmpty()) {
+                    continue;
+                }
+                // a tree conflict victim which is no longer in NODES
+                iter = m_nodes.insert(std::make_pair(relpath, Node())).first;
+                wxString parent = relpath.Contains(wxT("/")) ? relpath.BeforeLast(wxT('/')) : wxString();
+                m_children[parent].Add(relpath.AfterLast(wxT('/')));
+            }
+
+            Node& node = iter->second;
+            node.conflicted = conflicted;
+            if(propsCol != wxNOT_FOUND && !actualRes.IsNull(propsCol)) {
+                int len = 0;
+                const unsigned char* props = actualRes.GetBlob(propsCol, len);
+                ParseProperties(props, len, node.ignores, node.globalIgnores, node.translated);
+            }
+        }
+
+        // Directory externals are not part of NODES, they have a wc.db of their own
+        wxSQLite3ResultSet externalsRes =
+            db.ExecuteQuery(wxT("SELECT local_relpath FROM EXTERNALS WHERE kind = 'dir'"));
+        while(externalsRes.NextRow()) {
+            m_externalDirs.insert(externalsRes.GetAsString(0));
+        }
+
+    } catch(wxSQLite3Exception& e) {
+        CL_DEBUG("Subversion: failed to read %s: %s", dbfile.GetFullPath(), e.GetMessage());
+        m_nodes.clear();
+        m_children.clear();
+        m_externalDirs.clear();
+        return false;
+    }
+
+    // drop the externals which were removed
+    ExternalsMap_t::iterator extIter = m_externals.begin();
+    while(extIter != m_externals.end()) {
+        if(m_externalDirs.count(extIter->first) == 0) {
+            delete extIter->second;
+            m_externals.erase(extIter++);
+        } else {
+            ++extIter;
+        }
+    }
+
+    DoLoadConfigIgnores();
+    m_dbSignature = signature;
+    CL_DEBUG("Subversion: loaded %u nodes from %s", (unsigned)m_nodes.size(), dbfile.GetFullPath());
+    return true;
+}
+
+void SvnWcStatus::DoLoadConfigIgnores()
+{
+    m_configIgnores = ::wxStringTokenize(DEFAULT_GLOBAL_IGNORES, wxT(" \t"), wxTOKEN_STRTOK);
+
+#ifdef __WXMSW__
+    wxFileName configFile(wxStandardPaths::Get().GetUserConfigDir(), wxT("config"));
+    configFile.AppendDir(wxT("Subversion"));
+#else
+    wxFileName configFile(wxGetHomeDir(), wxT("config"));
+    configFile.AppendDir(wxT(".subversion"));
+#endif
+
+    if(!configFile.FileExists()) {
+        return;
+    }
+
+    wxLogNull noLog;
+    wxFileConfig config(wxEmptyString, wxEmptyString, configFile.GetFullPath(), wxEmptyString, wxCONFIG_USE_LOCAL_FILE);
+    wxString value;
+    if(config.Read(wxT("miscellany/global-ignores"), &value)) {
+        m_configIgnores = ::wxStringTokenize(value, wxT(" \t"), wxTOKEN_STRTOK);
+    }
+}
+
+void SvnWcStatus::DoScanDir(const wxString& relDir,
+                            const wxArrayString& inheritedIgnores,
+                            bool listDisk,
+                            Result& result)
+{
+    if(IsCancelled()) {
+        return;
+    }
+
+    wxArrayString globalIgnores = inheritedIgnores;
+    wxArrayString ignores;
+    NodeMap_t::const_iterator dirIter = m_nodes.find(relDir);
+    if(dirIter != m_nodes.end()) {
+        WX_APPEND_ARRAY(globalIgnores, dirIter->second.globalIgnores);
+        ignores = dirIter->second.ignores;
+    }
+    WX_APPEND_ARRAY(ignores, globalIgnores);
+
+    std::set<wxString> versioned;
+    ChildrenMap_t::const_iterator children = m_children.find(relDir);
+    if(children != m_children.end()) {
+        const wxArrayString& names = children->second;
+        for(size_t i = 0; i < names.GetCount() && !IsCancelled(); ++i) {
+            wxString relpath = relDir.IsEmpty() ? names.Item(i) : relDir + wxT("/") + names.Item(i);
+            const Node& node = m_nodes.find(relpath)->second;
+            if(node.present || node.conflicted) {
+                versioned.insert(names.Item(i));
+            }
+
+            DoCheckNode(relpath, node, result);
+            if(node.present && node.kind == wxT('d')) {
+                // the content of a deleted directory is reported from the database only
+                DoScanDir(relpath, globalIgnores, listDisk && node.status != wxT('D'), result);
+            }
+        }
+    }
+
+    if(!listDisk || IsCancelled()) {
+        return;
+    }
+
+    // Anything else on the disk is unversioned. Just like 'svn status' we
+    // don't descend into unversioned directories
+    wxArrayString entries;
+    DoListDir(relDir, entries);
+    for(size_t i = 0; i < entries.GetCount(); ++i) {
+        const wxString& name = entries.Item(i);
+        wxString relpath = relDir.IsEmpty() ? name : relDir + wxT("/") + name;
+        if(name == wxT(".svn") || versioned.count(name) || m_externalDirs.count(relpath) || IsIgnored(name, ignores)) {
+            // externals are scanned separately
+            continue;
+        }
+        result.unversionedFiles.Add(DoGetDisplayPath(relpath));
+    }
+}
+
+void SvnWcStatus::DoCheckNode(const wxString& relpath, const Node& node, Result& result)
+{
+    wxString displayPath = DoGetDisplayPath(relpath);
+    if(node.conflicted) {
+        result.conflictedFiles.Add(displayPath);
+
+    } else if(node.status == wxT('A')) {
+        result.newFiles.Add(displayPath);
+
+    } else if(node.status == wxT('D')) {
+        result.deletedFiles.Add(displayPath);
+
+    } else if(node.status == wxT(' ') && node.present && node.kind == wxT('f') && DoIsModified(relpath, node)) {
+        result.modifiedFiles.Add(displayPath);
+    }
+
+    if(node.locked) {
+        result.lockedFiles.Add(displayPath);
+    }
+}
+
+bool SvnWcStatus::DoIsModified(const wxString& relpath, const Node& node)
+{
+    wxString path = DoGetFullPath(relpath);
+    wxStructStat st;
+    if(wxStat(path, &st) != 0 || (st.st_mode & S_IFMT) == S_IFDIR) {
+        // missing or obstructed, 'svn status' reports these as '!' and '~'
+        return false;
+    }
+
+    wxLongLong size((wxLongLong_t)st.st_size);
+    time_t mtime = st.st_mtime;
+    wxLongLong precision;
+    wxLongLong preciseMtime = GetModificationTime(path, st, precision);
+
+    FileStateMap_t::const_iterator iter = m_files.find(relpath);
+    if(iter != m_files.end() && iter->second.size == size && iter->second.mtime == mtime) {
+        return iter->second.modified;
+    }
+
+    bool modified = false;
+    if(node.checksum.IsEmpty()) {
+        modified = false;
+
+    } else if(node.size >= 0 && node.size != size) {
+        modified = true;
+
+    } else if(node.size >= 0 && precision < 1000000 && node.mtime / precision == preciseMtime / precision) {
+        // same size and timestamp as recorded by svn. A timestamp with a precision of one second
+        // is not conclusive (the file may have been edited in the second svn wrote it), the file
+        // is compared with its pristine copy instead
+        modified = false;
+
+    } else if(node.translated) {
+        // the pristine copy is stored untranslated, comparing it with the
+        // working file would report a false modification
+        m_unknownState = true;
+        return false;
+
+    } else {
+        modified = !DoIsSameAsPristine(path, node.checksum, size);
+    }
+
+    if(time(NULL) - mtime >= RECENT_CHANGE_SECONDS) {
+        FileState& state = m_files[relpath];
+        state.size = size;
+        state.mtime = mtime;
+        state.modified = modified;
+    }
+    return modified;
+}
+
+bool SvnWcStatus::DoIsSameAsPristine(const wxString& path, const wxString& checksum, wxLongLong size) const
+{
+    // checksum is "$sha1$<hex digest>", the pristine copy is stored under
+    // .svn/pristine/<first two digits>/<digest>.svn-base
+    wxString digest = checksum.AfterLast(wxT('$'));
+    if(digest.Length() < 2) {
+        return false;
+    }
+
+    wxFileName pristine(m_wcRoot, digest + wxT(".svn-base"));
+    pristine.AppendDir(wxT(".svn"));
+    pristine.AppendDir(wxT("pristine"));
+    pristine.AppendDir(digest.Left(2));
+
+    // A different size means that the file was modified. Files svn
+    // translates (svn:eol-style, svn:keywords) are not compared here
+    wxStructStat st;
+    if(wxStat(pristine.GetFullPath(), &st) != 0 || wxLongLong((wxLongLong_t)st.st_size) != size) {
+        return false;
+    }
+
+    wxLogNull noLog;
+    wxFile working(path);
+    wxFile base(pristine.GetFullPath());
+    if(!working.IsOpened() || !base.IsOpened()) {
+        return false;
+    }
+
+    static const size_t CHUNK_SIZE = 64 * 1024;
+    std::vector<char> workingBuf(CHUNK_SIZE);
+    std::vector<char> baseBuf(CHUNK_SIZE);
+    while(true) {
+        ssize_t workingBytes = working.Read(&workingBuf[0], CHUNK_SIZE);
+        ssize_t baseBytes = base.Read(&baseBuf[0], CHUNK_SIZE);
+        if(workingBytes != baseBytes || workingBytes == wxInvalidOffset) {
+            return false;
+        }
+
+        if(workingBytes == 0) {
+            return true;
+        }
+
+        if(memcmp(&workingBuf[0], &baseBuf[0], workingBytes) != 0) {
+            return false;
+        }
+    }
+}
+
+void SvnWcStatus::DoListDir(const wxString& relDir, wxArrayString& entries)
+{
+    wxString path = DoGetFullPath(relDir);
+    wxStructStat st;
+    if(wxStat(path, &st) != 0) {
+        m_dirs.erase(relDir);
+        return;
+    }
+
+    DirListingMap_t::const_iterator iter = m_dirs.find(relDir);
+    if(iter != m_dirs.end() && iter->second.mtime == st.st_mtime) {
+        entries = iter->second.entries;
+        return;
+    }
+
+    wxLogNull noLog;
+    wxDir dir(path);
+    if(dir.IsOpened()) {
+        wxString name;
+        bool cont = dir.GetFirst(&name, wxEmptyString, wxDIR_FILES | wxDIR_DIRS | wxDIR_HIDDEN);
+        while(cont) {
+            entries.Add(name);
+            cont = dir.GetNext(&name);
+        }
+    }
+
+    if(time(NULL) - st.st_mtime >= RECENT_CHANGE_SECONDS) {
+        DirListing& listing = m_dirs[relDir];
+        listing.mtime = st.st_mtime;
+        listing.entries = entries;
+
+    } else {
+        m_dirs.erase(relDir);
+    }
+}
+
+wxString SvnWcStatus::DoGetFullPath(const wxString& relpath) const
+{
+    if(relpath.IsEmpty()) {
+        return m_wcRoot;
+    }
+
+    wxString path = relpath;
+    path.Replace(wxT("/"), wxString(wxFILE_SEP_PATH));
+    wxString fullpath = m_wcRoot;
+    if(!fullpath.EndsWith(wxString(wxFILE_SEP_PATH))) {
+        fullpath << wxFILE_SEP_PATH;
+    }
+    fullpath << path;
+    return fullpath;
+}
+
+bool SvnWcStatus::DoGetRelPath(const wxString& path, wxString& relpath) const
+{
+    wxString fullpath = path;
+    wxString root = m_wcRoot;
+    fullpath.Replace(wxT("\\"), wxT("/"));
+    root.Replace(wxT("\\"), wxT("/"));
+    while(fullpath.EndsWith(wxT("/"))) {
+        fullpath.RemoveLast();
+    }
+    while(root.EndsWith(wxT("/"))) {
+        root.RemoveLast();
+    }
+
+    if(fullpath.Length() < root.Length()) {
+        return false;
+    }
+
+    wxString prefix = fullpath.Left(root.Length());
+    bool samePrefix = wxFileName::IsCaseSensitive() ? (prefix == root) : (prefix.CmpNoCase(root) == 0);
+    if(!samePrefix) {
+        return false;
+    }
+
+    wxString rest = fullpath.Mid(root.Length());
+    if(rest.IsEmpty()) {
+        relpath.Clear();
+        return true;
+    }
+
+    if(!rest.StartsWith(wxT("/"), &relpath)) {
+        return false;
+    }
+    return true;
+}
+
+wxString SvnWcStatus::DoGetDisplayPath(const wxString& relpath) const
+{
+    wxString displayPath = m_scanRoot.IsEmpty() ? relpath : relpath.Mid(m_scanRoot.Length() + 1);
+    displayPath.Replace(wxT("/"), wxString(wxFILE_SEP_PATH));
+    return displayPath;
+}
@@ -0,0 +1,185 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : svn_wc_status.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SVN_WC_STATUS_H
+#define SVN_WC_STATUS_H
+
+#include <wx/string.h>
+#include <wx/arrstr.h>
+#include <wx/longlong.h>
+#include <wx/thread.h>
+#include <map>
+#include <set>
+
+/**
+ * @class SvnWcStatus
+ * @brief compute the working copy status without spawning 'svn status'
+ *
+ * The nodes are read from the working copy '.svn/wc.db' (formats 29-31,
+ * i.e. svn 1.7 - 1.14) and compared against the files on disk. The database
+ * rows are reloaded only when the database changes, directory listings are
+ * cached by the directory modification time and file states by their
+ * size / modification time, so a refresh only stats the files.
+ * Directory externals are working copies of their own, they are scanned by
+ * a nested SvnWcStatus.
+ * Callers should fallback to 'svn status' when GetStatus() returns false
+ */
+class SvnWcStatus
+{
+public:
+    struct Result {
+        wxArrayString modifiedFiles;
+        wxArrayString conflictedFiles;
+        wxArrayString unversionedFiles;
+        wxArrayString newFiles;
+        wxArrayString deletedFiles;
+        wxArrayString lockedFiles;
+        wxArrayString ignoredFiles;
+    };
+
+protected:
+    struct Node {
+        wxChar        kind;       // 'f'ile, 'd'ir or 's'ymlink
+        wxChar        status;     // ' ', 'A'dded, 'D'eleted or 'R'eplaced
+        bool          present;
+        bool          hasBase;
+        bool          conflicted;
+        bool          locked;
+        bool          translated; // svn:eol-style or svn:keywords are set
+        wxString      checksum;
+        wxLongLong    size;       // translated_size, -1 when unknown
+        wxLongLong    mtime;      // last_mod_time in microseconds
+        wxArrayString ignores;
+        wxArrayString globalIgnores;
+
+        Node()
+            : kind('f')
+            , status(' ')
+            , present(false)
+            , hasBase(false)
+            , conflicted(false)
+            , locked(false)
+            , translated(false)
+            , size(-1)
+            , mtime(0)
+        {}
+    };
+
+    struct FileState {
+        wxLongLong size;
+        time_t     mtime;
+        bool       modified;
+    };
+
+    struct DirListing {
+        time_t        mtime;
+        wxArrayString entries;
+    };
+
+    typedef std::map<wxString, Node>          NodeMap_t;
+    typedef std::map<wxString, wxArrayString> ChildrenMap_t;
+    typedef std::map<wxString, FileState>     FileStateMap_t;
+    typedef std::map<wxString, DirListing>    DirListingMap_t;
+    typedef std::map<wxString, SvnWcStatus*>  ExternalsMap_t;
+
+    wxString        m_wcRoot;
+    wxString        m_dbSignature;
+    NodeMap_t       m_nodes;
+    ChildrenMap_t   m_children;
+    FileStateMap_t  m_files;      // keyed by relpath
+    DirListingMap_t m_dirs;       // keyed by relpath
+    wxArrayString   m_configIgnores;
+    wxString        m_scanRoot;
+    std::set<wxString> m_externalDirs;  // relpaths of the directory externals
+    ExternalsMap_t  m_externals;      // keyed by relpath
+    SvnWcStatus*    m_parent;         // set for the status of an external
+    bool            m_unknownState;   // a node needs 'svn status' to decide
+    volatile bool   m_cancelled;
+
+    // Change notifications, posted from the main thread
+    wxCriticalSection m_lock;
+    wxArrayString     m_pending;
+    bool              m_clearRequested;
+
+protected:
+    void DoReset();
+    void DoApplyPending();
+    bool DoLoad();
+    void DoLoadConfigIgnores();
+    void DoScanDir(const wxString& relDir, const wxArrayString& inheritedIgnores, bool listDisk, Result& result);
+    bool DoScanExternal(const wxString& relpath, Result& result);
+    void DoDeleteExternals();
+    bool IsCancelled() const { return m_cancelled || (m_parent && m_parent->IsCancelled()); }
+    void DoCheckNode(const wxString& relpath, const Node& node, Result& result);
+    bool DoIsModified(const wxString& relpath, const Node& node);
+    bool DoIsSameAsPristine(const wxString& path, const wxString& checksum, wxLongLong size) const;
+    void DoListDir(const wxString& relDir, wxArrayString& entries);
+    wxString DoGetFullPath(const wxString& relpath) const;
+    bool DoGetRelPath(const wxString& path, wxString& relpath) const;
+    wxString DoGetDisplayPath(const wxString& relpath) const;
+    wxString DoGetDbSignature() const;
+
+public:
+    SvnWcStatus();
+    virtual ~SvnWcStatus();
+
+    /**
+     * @brief return the root of the working copy containing 'path' or an
+     * empty string if 'path' is not inside a working copy we can read
+     */
+    static wxString FindWcRoot(const wxString& path);
+
+    /**
+     * @brief compute the status of all the entries under 'root'. The paths
+     * are relative to 'root', just like 'svn status' prints them
+     * @return false if the working copy database can not be used
+     */
+    bool GetStatus(const wxString& root, Result& result);
+
+    /**
+     * @brief stop a running GetStatus() call. Thread safe
+     */
+    void Cancel() { m_cancelled = true; }
+
+    /**
+     * @brief clear a previous Cancel(). Called by the owner before it starts a new
+     * GetStatus() call, a Cancel() issued after that is never lost
+     */
+    void ResetCancel() { m_cancelled = false; }
+
+    /**
+     * @brief the file (or directory) 'path' was changed, drop its cached
+     * state. Thread safe
+     */
+    void Invalidate(const wxString& path);
+
+    /**
+     * @brief drop all cached information. Thread safe
+     */
+    void Clear();
+};
+
+#endif // SVN_WC_STATUS_H
@@ -90,7 +90,6 @@ ZoomNavigator::ZoomNavigator(IManager *manager)
     
     m_topWindow->Connect(wxEVT_IDLE, wxIdleEventHandler(ZoomNavigator::OnIdle), NULL, this);
     EventNotifier::Get()->Connect(wxEVT_INIT_DONE, wxCommandEventHandler(ZoomNavigator::OnInitDone), NULL, this);
-    EventNotifier::Get()->Connect(wxEVT_FILE_SAVED, clCommandEventHandler(ZoomNavigator::OnFileSaved), NULL, this);
     EventNotifier::Get()->Connect(wxEVT_ZN_SETTINGS_UPDATED, wxCommandEventHandler(ZoomNavigator::OnSettingsChanged), NULL, this);
     m_topWindow->Connect(XRCID("zn_settings"), wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ZoomNavigator::OnSettings), NULL, this);
     DoInitialize();
@@ -104,7 +103,6 @@ void ZoomNavigator::UnPlug()
 {
     EventNotifier::Get()->Disconnect(wxEVT_INIT_DONE, wxCommandEventHandler(ZoomNavigator::OnInitDone), NULL, this);
     EventNotifier::Get()->Disconnect(wxEVT_ZN_SETTINGS_UPDATED, wxCommandEventHandler(ZoomNavigator::OnSettingsChanged), NULL, this);
-    EventNotifier::Get()->Disconnect(wxEVT_FILE_SAVED, clCommandEventHandler(ZoomNavigator::OnFileSaved), NULL, this);
     
     m_topWindow->Disconnect(wxEVT_IDLE, wxIdleEventHandler(ZoomNavigator::OnIdle), NULL, this);
     m_topWindow->Disconnect(XRCID("zn_settings"), wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(ZoomNavigator::OnSettings), NULL, this);
@@ -211,6 +209,10 @@ void ZoomNavigator::SetEditorText( IEditor* editor )
 {
     m_curfile.Clear();
     m_text->UpdateText( editor );
+    
+    // force the highlight to be applied on the new document
+    m_markerFirstLine = wxNOT_FOUND;
+    m_markerLastLine  = wxNOT_FOUND;
     if ( editor ) {
         m_curfile = editor->GetFileName().GetFullPath();
         m_text->UpdateLexer( m_curfile );
@@ -231,7 +233,6 @@ void ZoomNavigator::SetZoomTextScrollPosToMiddle( wxStyledTextCtrl* stc )
         first = 0;
 
     m_text->SetFirstVisibleLine( first );
-    m_text->ClearSelections();
 }
 
 void ZoomNavigator::PatchUpHighlights( const int first, const int last )
@@ -312,17 +313,6 @@ void ZoomNavigator::OnSettingsChanged(wxCommandEvent& e)
     }
 }
 
-void ZoomNavigator::OnFileSaved(clCommandEvent& e)
-{
-    e.Skip();
-   
-    if ( e.GetString() == m_curfile ) {
-        // Update the file content
-        m_curfile.Clear();
-        DoUpdate();
-    }
-}
-
 void ZoomNavigator::OnWorkspaceClosed(wxCommandEvent& e)
 {
     e.Skip();
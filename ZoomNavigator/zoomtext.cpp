@@ -44,11 +44,17 @@
 
 ZoomText::ZoomText(wxWindow *parent, wxWindowID id, const wxPoint& pos, const wxSize& size, long style, const wxString& name)
     : wxStyledTextCtrl( parent, id, pos, size, style |wxNO_BORDER, name )
+    , m_sharedDoc( NULL )
 {
-    SetEditable( false );
+    // Note: we never call SetEditable()/SetReadOnly() since the read-only flag belongs to the
+    // document, which is shared with the editor. Instead, we simply don't let input reach the control
     SetUseHorizontalScrollBar( false );
     SetUseVerticalScrollBar( true );
-    HideSelection( true );
+    UsePopUp( false );
+    Connect(wxEVT_KEY_DOWN, wxKeyEventHandler(ZoomText::OnKeyDown), NULL, this);
+    Connect(wxEVT_CHAR, wxKeyEventHandler(ZoomText::OnKeyDown), NULL, this);
+    Connect(wxEVT_MIDDLE_DOWN, wxMouseEventHandler(ZoomText::OnMiddleDown), NULL, this);
+    SetDropTarget( NULL );
 
     SetMarginWidth(1, 0);
     SetMarginWidth(2, 0);
@@ -60,21 +66,16 @@ ZoomText::ZoomText(wxWindow *parent, wxWindowID id, const wxPoint& pos, const wx
     
     m_zoomFactor = data.GetZoomFactor();
     m_colour = data.GetHighlightColour();
-    MarkerSetBackground(1, m_colour);
+    DoApplyHighlightColour();
     SetZoom( m_zoomFactor );
     EventNotifier::Get()->Connect(wxEVT_ZN_SETTINGS_UPDATED, wxCommandEventHandler(ZoomText::OnSettingsChanged), NULL, this);
     EventNotifier::Get()->Connect(wxEVT_CL_THEME_CHANGED, wxCommandEventHandler(ZoomText::OnThemeChanged), NULL, this);
-    MarkerDefine(1, wxSTC_MARK_BACKGROUND, m_colour, m_colour );
 
 #ifndef __WXMSW__    
     SetTwoPhaseDraw(false);
     SetBufferedDraw(false);
     SetLayoutCache(wxSTC_CACHE_DOCUMENT);
 #endif
-
-#ifdef __WXMSW__    
-    MarkerSetAlpha(1, 50);
-#endif    
 }
 
 ZoomText::~ZoomText()
@@ -90,14 +91,25 @@ void ZoomText::UpdateLexer(const wxString& filename)
     if ( !lexer ) {
         lexer = EditorConfigST::Get()->GetLexer("Text");
     }
+    // Styles are a property of the view, but the lexer and its properties belong to the document.
+    // Apply them while viewing a private empty document so the editor's document is not touched (nor re-lexed)
+    void* doc = m_sharedDoc;
+    if ( doc ) {
+        AddRefDocument( doc );
+        SetDocPointer( NULL );
+    }
+    
     lexer->Apply( this );
     
+    if ( doc ) {
+        SetDocPointer( doc );
+        ReleaseDocument( doc );
+    }
+    
     SetZoom( m_zoomFactor );
-    SetEditable( false );
     SetUseHorizontalScrollBar( false );
     SetUseVerticalScrollBar( true );
-    HideSelection( true );
-    MarkerSetBackground(1, m_colour);
+    DoApplyHighlightColour();
 }
 
 void ZoomText::OnSettingsChanged(wxCommandEvent &e)
@@ -108,25 +120,22 @@ void ZoomText::OnSettingsChanged(wxCommandEvent &e)
     if ( conf.ReadItem( &data ) ) {
         m_zoomFactor = data.GetZoomFactor();
         m_colour = data.GetHighlightColour();
-        MarkerSetBackground(1, m_colour);
+        DoApplyHighlightColour();
         SetZoom(m_zoomFactor);
-        Colourise(0, wxSTC_INVALID_POSITION);
     }
 }
 
 void ZoomText::UpdateText(IEditor* editor)
 {
-    if ( !editor ) {
-        SetReadOnly( false );
-        SetText( "" );
-        SetReadOnly( true );
-
-    } else {
-        SetReadOnly( false );
-        SetText( editor->GetEditorText() );
-        SetReadOnly( true );
-        SetCurrentPos( editor->GetCurrentPosition() );
+    void* doc = editor ? editor->GetSTC()->GetDocPointer() : NULL;
+    if ( doc == m_sharedDoc ) {
+        return;
     }
+    
+    // SetDocPointer releases our reference to the previous document and adds one to the new document,
+    // passing NULL makes Scintilla create a new empty document for us
+    m_sharedDoc = doc;
+    SetDocPointer( doc );
 }
 
 void ZoomText::HighlightLines(int start, int end)
@@ -140,10 +149,39 @@ void ZoomText::HighlightLines(int start, int end)
             start = 0;
     }
         
-    MarkerDeleteAll(1);
-    for(int i=start; i<=end; ++i) {
-        MarkerAdd(i, 1);
+    if ( start < 0 ) {
+        start = 0;
     }
+    
+    // Markers are stored in the document (which is shared with the editor), so the visible
+    // area is highlighted using the selection, which belongs to this view only.
+    // Note that unlike SetSelection(), these calls don't scroll the view
+    SetAnchor( PositionFromLine(start) );
+    SetCurrentPos( GetLineEndPosition(end) );
+}
+
+void ZoomText::DoApplyHighlightColour()
+{
+    HideSelection( false );
+    SetSelEOLFilled( true );
+    SetSelForeground( false, m_colour );
+    SetSelBackground( true, m_colour );
+#ifdef __WXMSW__
+    SetSelAlpha( 50 );
+#endif
+    SetCaretWidth( 0 );
+}
+
+void ZoomText::OnKeyDown(wxKeyEvent& e)
+{
+    // the zoom view is read-only: swallow the event
+    wxUnusedVar(e);
+}
+
+void ZoomText::OnMiddleDown(wxMouseEvent& e)
+{
+    // don't allow middle-click paste into the editor's document
+    wxUnusedVar(e);
 }
 
 void ZoomText::OnThemeChanged(wxCommandEvent& e)
@@ -41,9 +41,13 @@ class ZoomText : public wxStyledTextCtrl
     int      m_zoomFactor;
     wxColour m_colour;
     wxString m_filename;
+    void*    m_sharedDoc; // the editor document we are viewing, NULL when showing our own (empty) document
     
 protected:
     void OnThemeChanged(wxCommandEvent &e);
+    void OnKeyDown(wxKeyEvent &e);
+    void OnMiddleDown(wxMouseEvent &e);
+    void DoApplyHighlightColour();
     
 public:
     ZoomText(wxWindow *parent, wxWindowID id=wxID_ANY,
@@ -53,7 +57,11 @@ public:
     virtual ~ZoomText();
     void UpdateLexer(const wxString &filename);
     void OnSettingsChanged(wxCommandEvent &e);
-    void UpdateText(IEditor* editort);
+    /**
+     * @brief view the editor's document. The document is shared (Scintilla reference counts it) so no copy
+     * is made, the styling done by the editor's lexer is reused and the view follows the editor's modifications
+     */
+    void UpdateText(IEditor* editor);
     void HighlightLines(int start, int end);
 };
 
@@ -45,14 +45,6 @@ void PHPParserThread::ParseFiles(PHPParserThreadRequest* request)
     PHPLookupTable lookuptable;
     lookuptable.Open(fnWorkspaceFile.GetPath());
 
-    for(size_t i = 0; i < files.GetCount(); ++i) {
-        PHPSourceFile sourceFile(wxFileName(files.Item(i)));
-        sourceFile.SetFilename(files.Item(i));
-        sourceFile.SetParseFunctionBody(false);
-        sourceFile.Parse();
-
-        // Update the database
-        PHPLookupTable table;
-        table.UpdateSourceFile(sourceFile);
-    }
+    // Parse the files (in parallel) and store them, unmodified files are skipped unless this is a full retag
+    lookuptable.UpdateSourceFiles(files, false, request->bIsFullRetag);
 }
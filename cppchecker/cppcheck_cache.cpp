@@ -0,0 +1,205 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : cppcheck_cache.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include "cppcheck_cache.h"
+#include "json_node.h"
+#include "fileutils.h"
+#include <wx/tokenzr.h>
+#include <set>
+#include <vector>
+
+CppCheckResultCache::CppCheckResultCache() {}
+
+CppCheckResultCache::~CppCheckResultCache() {}
+
+void CppCheckResultCache::Load(const wxFileName& filename)
+{
+    m_filename = filename;
+    m_entries.clear();
+    if(!filename.FileExists()) return;
+
+    JSONRoot root(filename);
+    JSONElement arr = root.toElement().namedObject("files");
+    for(int i = 0; i < arr.arraySize(); ++i) {
+        JSONElement item = arr.arrayItem(i);
+        Entry entry;
+        entry.m_hash = item.namedObject("hash").toString();
+        entry.m_output = item.namedObject("output").toArrayString();
+        m_entries[item.namedObject("file").toString()] = entry;
+    }
+}
+
+void CppCheckResultCache::Save()
+{
+    if(!m_filename.IsOk()) return;
+
+    JSONRoot root(cJSON_Object);
+    JSONElement arr = JSONElement::createArray("files");
+    root.toElement().append(arr);
+
+    std::map<wxString, Entry>::const_iterator iter = m_entries.begin();
+    for(; iter != m_entries.end(); ++iter) {
+        JSONElement item = JSONElement::createObject();
+        item.addProperty("file", iter->first);
+        item.addProperty("hash", iter->second.m_hash);
+        item.addProperty("output", iter->second.m_output);
+        arr.arrayAppend(item);
+    }
+    root.save(m_filename);
+}
+
+bool CppCheckResultCache::Get(const wxString& file, const wxString& hash, wxArrayString& output) const
+{
+    if(hash.IsEmpty()) return false;
+
+    std::map<wxString, Entry>::const_iterator iter = m_entries.find(file);
+    if(iter == m_entries.end() || iter->second.m_hash != hash) return false;
+    output = iter->second.m_output;
+    return true;
+}
+
+void CppCheckResultCache::Set(const wxString& file, const wxString& hash, const wxArrayString& output)
+{
+    if(hash.IsEmpty()) return;
+
+    Entry entry;
+    entry.m_hash = hash;
+    entry.m_output = output;
+    m_entries[file] = entry;
+}
+
+//------------------------------------------------------------------------
+// CppCheckHashCalculator
+//------------------------------------------------------------------------
+
+CppCheckHashCalculator::CppCheckHashCalculator() {}
+
+CppCheckHashCalculator::~CppCheckHashCalculator() {}
+
+const wxString& CppCheckHashCalculator::DoGetStamp(const wxString& file)
+{
+    std::map<wxString, wxString>::iterator iter = m_stamps.find(file);
+    if(iter != m_stamps.end()) return iter->second;
+
+    wxString stamp;
+    wxFileName fn(file);
+    if(fn.FileExists()) {
+        stamp << fn.GetSize().ToString() << "@" << fn.GetModificationTime().GetTicks();
+    }
+    return m_stamps.insert(std::make_pair(file, stamp)).first->second;
+}
+
+const wxArrayString& CppCheckHashCalculator::DoGetIncludes(const wxString& file,
+                                                           const wxArrayString& includePaths,
+                                                           const wxString& includePathsKey)
+{
+    // a header included by sources of different projects may resolve differently
+    wxString key;
+    key << file << "|" << includePathsKey;
+    std::map<wxString, wxArrayString>::iterator iter = m_includes.find(key);
+    if(iter != m_includes.end()) return iter->second;
+
+    // Collect the quoted includes (#include "...") that can be resolved. System headers
+    // are not expected to change
+    wxArrayString includes;
+    wxString content;
+    if(FileUtils::ReadFileContent(file, content)) {
+        wxFileName fn(file);
+        wxArrayString lines = ::wxStringTokenize(content, "\n", wxTOKEN_STRTOK);
+        for(size_t i = 0; i < lines.GetCount(); ++i) {
+            wxString line = lines.Item(i);
+            line.Trim(false);
+            if(!line.StartsWith("#")) continue;
+            line.Remove(0, 1);
+            line.Trim(false);
+            if(!line.StartsWith("include")) continue;
+            line.Remove(0, 7);
+            line.Trim(false);
+            if(!line.StartsWith("\"")) continue;
+
+            wxString name = line.Mid(1).BeforeFirst('"');
+            if(name.IsEmpty()) continue;
+
+            // resolve the include: the file directory first, then the include paths
+            wxFileName incFile(name);
+            incFile.MakeAbsolute(fn.GetPath());
+            if(!incFile.FileExists()) {
+                for(size_t j = 0; j < includePaths.GetCount(); ++j) {
+                    wxFileName candidate(name);
+                    candidate.MakeAbsolute(includePaths.Item(j));
+                    if(candidate.FileExists()) {
+                        incFile = candidate;
+                        break;
+                    }
+                }
+            }
+            if(incFile.FileExists()) {
+                includes.Add(incFile.GetFullPath());
+            }
+        }
+    }
+    return m_includes.insert(std::make_pair(key, includes)).first->second;
+}
+
+wxString CppCheckHashCalculator::ComputeHash(const wxString& file,
+                                             const wxArrayString& includePaths,
+                                             const wxString& settingsHash)
+{
+    wxString content;
+    if(!FileUtils::ReadFileContent(file, content)) return wxEmptyString;
+
+    wxString key;
+    key << settingsHash << "|" << FileUtils::Hash(content);
+
+    wxString includePathsKey;
+    for(size_t i = 0; i < includePaths.GetCount(); ++i) {
+        includePathsKey << includePaths.Item(i) << ";";
+    }
+    includePathsKey = FileUtils::Hash(includePathsKey);
+
+    // Walk the include closure, each included file contributes its size and modification time
+    std::set<wxString> visited;
+    std::vector<wxString> queue;
+    queue.push_back(file);
+    visited.insert(file);
+    while(!queue.empty()) {
+        wxString current = queue.back();
+        queue.pop_back();
+
+        const wxArrayString& includes = DoGetIncludes(current, includePaths, includePathsKey);
+        for(size_t i = 0; i < includes.GetCount(); ++i) {
+            if(visited.insert(includes.Item(i)).second) {
+                queue.push_back(includes.Item(i));
+            }
+        }
+    }
+
+    std::set<wxString>::const_iterator iter = visited.begin();
+    for(; iter != visited.end(); ++iter) {
+        if(*iter == file) continue;
+        key << "|" << *iter << "=" << DoGetStamp(*iter);
+    }
+    return FileUtils::Hash(key);
+}
@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// copyright            : (C) 2014 The CodeLite Team
+// file name            : cppcheck_cache.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef CPPCHECK_CACHE_H
+#define CPPCHECK_CACHE_H
+
+#include <wx/string.h>
+#include <wx/arrstr.h>
+#include <wx/filename.h>
+#include <map>
+
+/**
+ * @class CppCheckResultCache
+ * @brief a persistent cache of cppcheck results, per source file.
+ * An entry is valid as long as the file content, the files it includes (recursively) and the
+ * cppcheck settings did not change. Files with a valid entry are not checked again
+ */
+class CppCheckResultCache
+{
+public:
+    struct Entry {
+        wxString m_hash;
+        wxArrayString m_output;
+    };
+
+protected:
+    std::map<wxString, Entry> m_entries;
+    wxFileName m_filename;
+
+public:
+    CppCheckResultCache();
+    virtual ~CppCheckResultCache();
+
+    void Load(const wxFileName& filename);
+    void Save();
+
+    /**
+     * @brief return the cached output for 'file' if its hash matches
+     */
+    bool Get(const wxString& file, const wxString& hash, wxArrayString& output) const;
+    void Set(const wxString& file, const wxString& hash, const wxArrayString& output);
+};
+
+/**
+ * @class CppCheckHashCalculator
+ * @brief compute the cache hashes of the files of a single run. The included files
+ * and their timestamps are memorized for the lifetime of the object, so headers shared
+ * by many sources are read once. This class is used by a worker thread
+ */
+class CppCheckHashCalculator
+{
+    std::map<wxString, wxArrayString> m_includes; // file + include paths -> resolved quoted includes
+    std::map<wxString, wxString> m_stamps;        // file -> size + modification time
+
+protected:
+    const wxArrayString& DoGetIncludes(const wxString& file,
+                                       const wxArrayString& includePaths,
+                                       const wxString& includePathsKey);
+    const wxString& DoGetStamp(const wxString& file);
+
+public:
+    CppCheckHashCalculator();
+    virtual ~CppCheckHashCalculator();
+
+    /**
+     * @brief compute the hash of a source file: its content, the files it includes and the settings.
+     * 'includePaths' are the include paths of the project owning the file
+     */
+    wxString ComputeHash(const wxString& file, const wxArrayString& includePaths, const wxString& settingsHash);
+};
+
+#endif // CPPCHECK_CACHE_H
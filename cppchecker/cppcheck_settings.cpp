@@ -158,7 +158,7 @@ void CppCheckSettings::RemoveSuppressedWarning(const wxString& key)
 	m_SuppressedWarnings1.erase(key);
 }
 
-wxString CppCheckSettings::GetOptions() const
+wxString CppCheckSettings::GetOptions(bool includeJobs) const
 {
 	wxString options;
 	if (GetStyle()) {
@@ -191,7 +191,7 @@ wxString CppCheckSettings::GetOptions() const
 	if (GetForce()) {
 		options << wxT("--force ");
 	}
-	if (GetJobs() > 1) {
+	if (includeJobs && GetJobs() > 1) {
 		options << wxT("-j") << GetJobs();
 	}
 	if (GetCheckConfig()) {
@@ -165,7 +165,11 @@ public:
 	virtual void Serialize(Archive& arch);
 	virtual void DeSerialize(Archive& arch);
 
-	wxString GetOptions() const;
+	/**
+	 * @brief return the cppcheck command line options
+	 * @param includeJobs when false, the -j option is omitted (used when we run several cppcheck processes)
+	 */
+	wxString GetOptions(bool includeJobs = true) const;
     void LoadProjectSpecificSettings(ProjectPtr proj);
 };
 
@@ -51,9 +51,79 @@
 #include <wx/tokenzr.h>
 #include "globals.h"
 #include "file_logger.h"
+#include "fileutils.h"
+#include <algorithm>
 
 static CppCheckPlugin* thePlugin = NULL;
 
+/**
+ * @class CppCheckHashThread
+ * @brief compute the cache hashes of the files of a run: this reads every file
+ * and the headers it includes, which is too slow for the main thread
+ */
+class CppCheckHashThread : public wxThread
+{
+    CppCheckPlugin* m_plugin;
+    wxArrayString m_files;
+    std::vector<size_t> m_fileIncludePaths; // index into m_includePaths, per file
+    std::vector<wxArrayString> m_includePaths;
+    wxString m_settingsHash;
+    int m_generation;
+    volatile bool m_cancelled;
+
+public:
+    // file -> hash, read by the plugin once the thread was joined
+    std::map<wxString, wxString> m_hashes;
+
+public:
+    CppCheckHashThread(CppCheckPlugin* plugin, const wxString& settingsHash, int generation)
+        : wxThread(wxTHREAD_JOINABLE)
+        , m_plugin(plugin)
+        , m_settingsHash(settingsHash.c_str())
+        , m_generation(generation)
+        , m_cancelled(false)
+    {
+    }
+
+    virtual ~CppCheckHashThread() {}
+
+    /**
+     * @brief add a set of include paths and return its index
+     */
+    size_t AddIncludePaths(const wxArrayString& includePaths)
+    {
+        // use c_str() to make sure that the thread owns its copy of the strings
+        wxArrayString paths;
+        for(size_t i = 0; i < includePaths.GetCount(); ++i) {
+            paths.Add(includePaths.Item(i).c_str());
+        }
+        m_includePaths.push_back(paths);
+        return m_includePaths.size() - 1;
+    }
+
+    void AddFile(const wxString& file, size_t includePaths)
+    {
+        m_files.Add(file.c_str());
+        m_fileIncludePaths.push_back(includePaths);
+    }
+
+    void Cancel() { m_cancelled = true; }
+
+    virtual void* Entry()
+    {
+        CppCheckHashCalculator calculator;
+        for(size_t i = 0; i < m_files.GetCount() && !m_cancelled; ++i) {
+            const wxArrayString& includePaths = m_includePaths.at(m_fileIncludePaths.at(i));
+            m_hashes[m_files.Item(i)] = calculator.ComputeHash(m_files.Item(i), includePaths, m_settingsHash);
+        }
+
+        if(!m_cancelled) {
+            m_plugin->CallAfter(&CppCheckPlugin::OnHashesReady, m_generation);
+        }
+        return NULL;
+    }
+};
+
 // Define the plugin entry point
 extern "C" EXPORT IPlugin* CreatePlugin(IManager* manager)
 {
@@ -82,7 +152,9 @@ END_EVENT_TABLE()
 
 CppCheckPlugin::CppCheckPlugin(IManager* manager)
     : IPlugin(manager)
-    , m_cppcheckProcess(NULL)
+    , m_hashThread(NULL)
+    , m_hashGeneration(0)
+    , m_stopped(false)
     , m_canRestart(true)
     , m_explorerSepItem(NULL)
     , m_workspaceSepItem(NULL)
@@ -236,11 +308,16 @@ void CppCheckPlugin::UnPlug()
         }
     }
 
-    // terminate the cppcheck daemon
-    if(m_cppcheckProcess) {
+    DoCancelHashing();
+
+    // terminate the cppcheck daemons
+    if(!m_cppcheckProcesses.empty()) {
         wxLogMessage(_("CppCheckPlugin: Terminating cppcheck daemon..."));
-        delete m_cppcheckProcess;
-        m_cppcheckProcess = NULL;
+        for(size_t i = 0; i < m_cppcheckProcesses.size(); ++i) {
+            delete m_cppcheckProcesses.at(i);
+        }
+        m_cppcheckProcesses.clear();
+        m_shards.clear();
     }
 }
 
@@ -306,7 +383,7 @@ wxMenu* CppCheckPlugin::CreateWorkspacePopMenu()
 
 void CppCheckPlugin::OnCheckFileEditorItem(wxCommandEvent& e)
 {
-    if(m_cppcheckProcess) {
+    if(AnalysisInProgress()) {
         wxLogMessage(_("CppCheckPlugin: CppCheck is currently busy please wait for it to complete the current check"));
         return;
     }
@@ -326,7 +403,7 @@ void CppCheckPlugin::OnCheckFileEditorItem(wxCommandEvent& e)
 
 void CppCheckPlugin::OnCheckFileExplorerItem(wxCommandEvent& e)
 {
-    if(m_cppcheckProcess) {
+    if(AnalysisInProgress()) {
         wxLogMessage(_("CppCheckPlugin: CppCheck is currently busy please wait for it to complete the current check"));
         return;
     }
@@ -346,7 +423,7 @@ void CppCheckPlugin::OnCheckFileExplorerItem(wxCommandEvent& e)
 
 void CppCheckPlugin::OnCheckWorkspaceItem(wxCommandEvent& e)
 {
-    if(m_cppcheckProcess) {
+    if(AnalysisInProgress()) {
         wxLogMessage(_("CppCheckPlugin: CppCheck is currently busy please wait for it to complete the current check"));
         return;
     }
@@ -402,7 +479,7 @@ ProjectPtr CppCheckPlugin::FindSelectedProject()
 
 void CppCheckPlugin::OnCheckProjectItem(wxCommandEvent& e)
 {
-    if(m_cppcheckProcess) {
+    if(AnalysisInProgress()) {
         wxLogMessage(_("CppCheckPlugin: CppCheck is currently busy please wait for it to complete the current check"));
         return;
     }
@@ -429,13 +506,42 @@ void CppCheckPlugin::OnCheckProjectItem(wxCommandEvent& e)
 
 void CppCheckPlugin::OnCppCheckTerminated(wxCommandEvent& e)
 {
-    m_filelist.Clear();
-
     ProcessEventData* ped = (ProcessEventData*)e.GetClientData();
+    IProcess* process = ped->GetProcess();
     delete ped;
 
-    if(m_cppcheckProcess) delete m_cppcheckProcess;
-    m_cppcheckProcess = NULL;
+    std::map<IProcess*, CppCheckShard>::iterator iter = m_shards.find(process);
+    if(iter != m_shards.end()) {
+        // flush the last (incomplete) line
+        if(!iter->second.m_buffer.IsEmpty()) {
+            DoProcessOutput(iter->second, "\n");
+        }
+        // the last file is complete only if the process was not stopped
+        if(!m_stopped) {
+            DoFileCompleted(iter->second);
+        }
+        m_shards.erase(iter);
+    }
+
+    std::vector<IProcess*>::iterator procIter =
+        std::find(m_cppcheckProcesses.begin(), m_cppcheckProcesses.end(), process);
+    if(procIter != m_cppcheckProcesses.end()) {
+        m_cppcheckProcesses.erase(procIter);
+    }
+    delete process;
+
+    // Wait for all the processes to complete
+    if(m_cppcheckProcesses.empty()) {
+        DoAnalysisCompleted();
+    }
+}
+
+void CppCheckPlugin::DoAnalysisCompleted()
+{
+    m_filelist.Clear();
+    m_fileHashes.clear();
+    m_checkedProject = NULL;
+    m_cache.Save();
 
     m_view->PrintStatusMessage();
     m_view->GotoFirstError();
@@ -502,14 +608,142 @@ void CppCheckPlugin::GetFileListFromDir(const wxString& root)
 
 void CppCheckPlugin::DoProcess(ProjectPtr proj)
 {
-    wxString command = DoGetCommand(proj);
-    m_view->AppendLine(wxString::Format(_("Starting cppcheck: %s\n"), command.c_str()));
+    m_stopped = false;
+    m_fileHashes.clear();
+
+    // Load the results of the previous runs
+    wxFileName cacheFile(WorkspaceST::Get()->GetPrivateFolder(), "cppcheck-cache.json");
+    m_cache.Load(cacheFile);
+    m_checkedProject = proj;
+
+    // Files whose content, included files and settings did not change since they were last checked
+    // are not checked again: we print their cached results. The hashes are computed by a worker thread
+    DoCancelHashing();
+    wxString settingsHash = FileUtils::Hash(DoGetCommandOptions(proj));
+    m_hashThread = new CppCheckHashThread(this, settingsHash, ++m_hashGeneration);
+
+    // The included headers are resolved with the include paths of the project owning each file
+    std::map<wxString, size_t> fileProjects;
+    if(proj) {
+        size_t includePaths = m_hashThread->AddIncludePaths(proj->GetIncludePaths());
+        for(size_t i = 0; i < m_filelist.GetCount(); ++i) {
+            fileProjects[m_filelist.Item(i)] = includePaths;
+        }
+
+    } else if(m_mgr->IsWorkspaceOpen()) {
+        wxArrayString projects;
+        wxString errmsg;
+        m_mgr->GetWorkspace()->GetProjectList(projects);
+        for(size_t i = 0; i < projects.GetCount(); ++i) {
+            ProjectPtr p = m_mgr->GetWorkspace()->FindProjectByName(projects.Item(i), errmsg);
+            if(!p) continue;
+
+            size_t includePaths = m_hashThread->AddIncludePaths(p->GetIncludePaths());
+            std::vector<wxFileName> files;
+            p->GetFiles(files, true);
+            for(size_t j = 0; j < files.size(); ++j) {
+                // a file which belongs to several projects uses the first one
+                fileProjects.insert(std::make_pair(files.at(j).GetFullPath(), includePaths));
+            }
+        }
+    }
 
-    m_cppcheckProcess = CreateAsyncProcess(this, command);
-    if(!m_cppcheckProcess) {
-        wxMessageBox(_("Failed to launch codelite_cppcheck process!"), _("Warning"), wxOK | wxCENTER | wxICON_WARNING);
+    // files which are not part of any project: their own directory only
+    size_t noIncludePaths = m_hashThread->AddIncludePaths(wxArrayString());
+    for(size_t i = 0; i < m_filelist.GetCount(); ++i) {
+        std::map<wxString, size_t>::const_iterator iter = fileProjects.find(m_filelist.Item(i));
+        m_hashThread->AddFile(m_filelist.Item(i), iter == fileProjects.end() ? noIncludePaths : iter->second);
+    }
+
+    m_view->AppendLine(_("Looking for unmodified files...\n"));
+    m_hashThread->Create();
+    m_hashThread->Run();
+}
+
+void CppCheckPlugin::DoCancelHashing()
+{
+    if(m_hashThread) {
+        m_hashThread->Cancel();
+        m_hashThread->Wait();
+        wxDELETE(m_hashThread);
+    }
+}
+
+void CppCheckPlugin::OnHashesReady(int generation)
+{
+    if(generation != m_hashGeneration || !m_hashThread) return;
+
+    // the thread is done, its results are ours now
+    m_hashThread->Wait();
+    std::map<wxString, wxString> hashes;
+    hashes.swap(m_hashThread->m_hashes);
+    wxDELETE(m_hashThread);
+
+    DoStartProcesses(hashes);
+}
+
+void CppCheckPlugin::DoStartProcesses(const std::map<wxString, wxString>& hashes)
+{
+    ProjectPtr proj = m_checkedProject;
+    wxArrayString filesToCheck;
+    size_t cachedCount(0);
+    for(size_t i = 0; i < m_filelist.GetCount(); ++i) {
+        const wxString& file = m_filelist.Item(i);
+        std::map<wxString, wxString>::const_iterator hashIter = hashes.find(file);
+        wxString hash = (hashIter == hashes.end()) ? wxString() : hashIter->second;
+
+        wxArrayString output;
+        if(m_cache.Get(file, hash, output)) {
+            ++cachedCount;
+            for(size_t j = 0; j < output.GetCount(); ++j) {
+                m_view->AppendLine(output.Item(j) + "\n");
+            }
+            continue;
+        }
+        m_fileHashes[file] = hash;
+        filesToCheck.Add(file);
+    }
+
+    if(cachedCount) {
+        m_view->AppendLine(wxString::Format(_("%u unmodified files: using the results of a previous analysis\n"),
+                                            (unsigned int)cachedCount));
+    }
+
+    if(filesToCheck.IsEmpty()) {
+        DoAnalysisCompleted();
         return;
     }
+
+    // Split the files between several cppcheck processes
+    int jobs = m_settings.GetJobs() > 1 ? m_settings.GetJobs() : wxThread::GetCPUCount();
+    size_t shards = jobs > 1 ? (size_t)jobs : 1;
+    if(shards > filesToCheck.GetCount()) shards = filesToCheck.GetCount();
+
+    std::vector<wxArrayString> shardFiles(shards);
+    for(size_t i = 0; i < filesToCheck.GetCount(); ++i) {
+        shardFiles.at(i % shards).Add(filesToCheck.Item(i));
+    }
+
+    for(size_t i = 0; i < shards; ++i) {
+        wxString fileList = DoGenerateFileList(shardFiles.at(i), i);
+        if(fileList.IsEmpty()) continue;
+
+        wxString command = DoGetCommand(proj, fileList);
+        m_view->AppendLine(wxString::Format(_("Starting cppcheck: %s\n"), command.c_str()));
+
+        IProcess* process = CreateAsyncProcess(this, command);
+        if(!process) {
+            wxMessageBox(
+                _("Failed to launch codelite_cppcheck process!"), _("Warning"), wxOK | wxCENTER | wxICON_WARNING);
+            break;
+        }
+        m_cppcheckProcesses.push_back(process);
+        m_shards[process] = CppCheckShard();
+    }
+
+    if(m_cppcheckProcesses.empty()) {
+        DoAnalysisCompleted();
+    }
 }
 
 /**
@@ -549,9 +783,17 @@ void CppCheckPlugin::SetTabVisible(bool clearContent)
 void CppCheckPlugin::StopAnalysis()
 {
     // Clear the files queue
-    if(m_cppcheckProcess) {
-        // terminate the m_cppcheckProcess
-        m_cppcheckProcess->Terminate();
+    m_stopped = true;
+    if(m_hashThread) {
+        // no cppcheck process was started yet
+        DoCancelHashing();
+        DoAnalysisCompleted();
+        return;
+    }
+
+    for(size_t i = 0; i < m_cppcheckProcesses.size(); ++i) {
+        // terminate the cppcheck process
+        m_cppcheckProcesses.at(i)->Terminate();
     }
 }
 
@@ -603,19 +845,28 @@ void CppCheckPlugin::DoStartTest(ProjectPtr proj /*=NULL*/)
     DoProcess(proj);
 }
 
-wxString CppCheckPlugin::DoGetCommand(ProjectPtr proj)
+wxString CppCheckPlugin::DoGetCommand(ProjectPtr proj, const wxString& fileList)
 {
     // Linux / Mac way: spawn the process and execute the command
     wxString cmd, path;
     path = clStandardPaths::Get().GetBinaryFullPath("codelite_cppcheck");
     ::WrapWithQuotes(path);
 
-    wxString fileList = DoGenerateFileList();
-    if(fileList.IsEmpty()) return wxT("");
-
     // build the command
     cmd << path << " ";
-    cmd << m_settings.GetOptions();
+    cmd << DoGetCommandOptions(proj);
+
+    cmd << wxT(" --file-list=");
+    cmd << wxT("\"") << fileList << wxT("\"");
+    CL_DEBUG("cppcheck command: %s", cmd);
+    return cmd;
+}
+
+wxString CppCheckPlugin::DoGetCommandOptions(ProjectPtr proj)
+{
+    // the files are split between several processes, so we don't pass -j to cppcheck
+    wxString cmd;
+    cmd << m_settings.GetOptions(false);
 
     // Append here project specifc search paths
     if(proj) {
@@ -632,17 +883,13 @@ wxString CppCheckPlugin::DoGetCommand(ProjectPtr proj)
             cmd << " -D" << projMacros.Item(i);
         }
     }
-
-    cmd << wxT(" --file-list=");
-    cmd << wxT("\"") << fileList << wxT("\"");
-    CL_DEBUG("cppcheck command: %s", cmd);
     return cmd;
 }
 
-wxString CppCheckPlugin::DoGenerateFileList()
+wxString CppCheckPlugin::DoGenerateFileList(const wxArrayString& files, size_t shard)
 {
     // create temporary file and save the file there
-    wxFileName fnFileList(WorkspaceST::Get()->GetPrivateFolder(), "cppcheck.list");
+    wxFileName fnFileList(WorkspaceST::Get()->GetPrivateFolder(), wxString::Format("cppcheck.%u.list", (unsigned int)shard));
 
     // create temporary file and save the file there
     wxFFile file(fnFileList.GetFullPath(), wxT("w+b"));
@@ -654,8 +901,8 @@ wxString CppCheckPlugin::DoGenerateFileList()
     }
 
     wxString content;
-    for(size_t i = 0; i < m_filelist.GetCount(); i++) {
-        content << m_filelist.Item(i) << wxT("\n");
+    for(size_t i = 0; i < files.GetCount(); i++) {
+        content << files.Item(i) << wxT("\n");
     }
 
     file.Write(content);
@@ -668,8 +915,67 @@ void CppCheckPlugin::OnCppCheckReadData(wxCommandEvent& e)
 {
     e.Skip();
     ProcessEventData* ped = (ProcessEventData*)e.GetClientData();
-    m_view->AppendLine(ped->GetData());
+    std::map<IProcess*, CppCheckShard>::iterator iter = m_shards.find(ped->GetProcess());
+    if(iter != m_shards.end()) {
+        DoProcessOutput(iter->second, ped->GetData());
+    } else {
+        m_view->AppendLine(ped->GetData());
+    }
 
     delete ped;
 }
+
+void CppCheckPlugin::DoProcessOutput(CppCheckShard& shard, const wxString& output)
+{
+    // The processes output is interleaved, so only complete lines are passed to the view
+    shard.m_buffer << output;
+    shard.m_buffer.Replace("\r", "");
+
+    wxString lines;
+    int where = shard.m_buffer.Find('\n', true);
+    if(where == wxNOT_FOUND) return;
+
+    lines = shard.m_buffer.Mid(0, where + 1);
+    shard.m_buffer = shard.m_buffer.Mid(where + 1);
+
+    wxArrayString arrLines = ::wxStringTokenize(lines, "\n", wxTOKEN_STRTOK);
+    for(size_t i = 0; i < arrLines.GetCount(); ++i) {
+        const wxString& line = arrLines.Item(i);
+        if(line.StartsWith("Checking ")) {
+            // "Checking <file>..." or "Checking <file>: <configuration>..."
+            wxString file = line.Mid(9);
+            if(file.EndsWith("...")) {
+                file.RemoveLast(3);
+            }
+            int configPos = file.Find(": ");
+            if(configPos != wxNOT_FOUND) {
+                file = file.Mid(0, configPos);
+            }
+            file.Trim().Trim(false);
+            wxFileName fn(file);
+            fn.MakeAbsolute();
+            if(fn.GetFullPath() != shard.m_currentFile) {
+                DoFileCompleted(shard);
+                shard.m_currentFile = fn.GetFullPath();
+            }
+
+        } else if(!line.Contains("files checked") && !shard.m_currentFile.IsEmpty()) {
+            // keep the results of the current file for the cache
+            shard.m_output.Add(line);
+        }
+    }
+    m_view->AppendLine(lines);
+}
+
+void CppCheckPlugin::DoFileCompleted(CppCheckShard& shard)
+{
+    if(shard.m_currentFile.IsEmpty()) return;
+
+    std::map<wxString, wxString>::iterator iter = m_fileHashes.find(shard.m_currentFile);
+    if(iter != m_fileHashes.end()) {
+        m_cache.Set(iter->first, iter->second, shard.m_output);
+    }
+    shard.m_currentFile.Clear();
+    shard.m_output.Clear();
+}
 
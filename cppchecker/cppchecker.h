@@ -29,14 +29,35 @@
 #include "plugin.h"
 #include "asyncprocess.h"
 #include "cppcheck_settings.h"
+#include "cppcheck_cache.h"
+#include <map>
+#include <vector>
 
 class wxMenuItem;
 class CppCheckReportPage;
+class CppCheckHashThread;
+
+/**
+ * @class CppCheckShard
+ * @brief the state of a single cppcheck process
+ */
+struct CppCheckShard {
+    wxString m_buffer;      // incomplete output line
+    wxString m_currentFile; // the file being checked
+    wxArrayString m_output; // the output of the current file
+};
 
 class CppCheckPlugin : public IPlugin
 {
     wxString m_cppcheckPath;
-    IProcess* m_cppcheckProcess;
+    std::vector<IProcess*> m_cppcheckProcesses;
+    std::map<IProcess*, CppCheckShard> m_shards;
+    CppCheckResultCache m_cache;
+    std::map<wxString, wxString> m_fileHashes; // the files being checked and their cache hash
+    CppCheckHashThread* m_hashThread;          // computes the cache hashes of a new run
+    int m_hashGeneration;
+    ProjectPtr m_checkedProject;
+    bool m_stopped;
     bool m_canRestart;
     wxArrayString m_filelist;
     wxMenuItem* m_explorerSepItem;
@@ -49,8 +70,14 @@ class CppCheckPlugin : public IPlugin
     size_t m_fileProcessed;
 
 protected:
-    wxString DoGetCommand(ProjectPtr proj);
-    wxString DoGenerateFileList();
+    wxString DoGetCommand(ProjectPtr proj, const wxString& fileList);
+    wxString DoGetCommandOptions(ProjectPtr proj);
+    wxString DoGenerateFileList(const wxArrayString& files, size_t shard);
+    void DoProcessOutput(CppCheckShard& shard, const wxString& output);
+    void DoFileCompleted(CppCheckShard& shard);
+    void DoAnalysisCompleted();
+    void DoStartProcesses(const std::map<wxString, wxString>& hashes);
+    void DoCancelHashing();
 
 protected:
     wxMenu* CreateEditorPopMenu();
@@ -145,7 +172,13 @@ public:
     /**
      * @brief return true if analysis currently running
      */
-    bool AnalysisInProgress() const { return m_cppcheckProcess != NULL; }
+    bool AnalysisInProgress() const { return !m_cppcheckProcesses.empty() || m_hashThread; }
+
+    /**
+     * @brief the hash thread is done, start checking the modified files.
+     * Called by the hash thread via CallAfter()
+     */
+    void OnHashesReady(int generation);
 
     /**
      * @brief return the progress
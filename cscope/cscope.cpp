@@ -41,6 +41,7 @@
 #include "exelocator.h"
 #include "cscopetab.h"
 #include "cscopedbbuilderthread.h"
+#include "event_notifier.h"
 #include <wx/imaglist.h>
 
 static Cscope* thePlugin = NULL;
@@ -74,6 +75,8 @@ extern "C" EXPORT int GetPluginInterfaceVersion()
 Cscope::Cscope(IManager *manager)
     : IPlugin(manager)
     , m_topWindow(NULL)
+    , m_requestId(0)
+    , m_listFileDirty(true)
 {
     m_longName = _("CScope Integration for CodeLite");
     m_shortName = CSCOPE_NAME;
@@ -84,6 +87,16 @@ Cscope::Cscope(IManager *manager)
 
     Connect(wxEVT_CSCOPE_THREAD_DONE, wxCommandEventHandler(Cscope::OnCScopeThreadEnded), NULL, this);
     Connect(wxEVT_CSCOPE_THREAD_UPDATE_STATUS, wxCommandEventHandler(Cscope::OnCScopeThreadUpdateStatus), NULL, this);
+    Connect(wxEVT_CSCOPE_THREAD_RESULTS, wxCommandEventHandler(Cscope::OnCScopeThreadResults), NULL, this);
+
+    // the file list is only re-generated when the workspace content changes
+    EventNotifier::Get()->Connect(wxEVT_WORKSPACE_LOADED,       wxCommandEventHandler(Cscope::OnWorkspaceChanged), NULL, this);
+    EventNotifier::Get()->Connect(wxEVT_WORKSPACE_CLOSED,       wxCommandEventHandler(Cscope::OnWorkspaceChanged), NULL, this);
+    EventNotifier::Get()->Connect(wxEVT_PROJ_FILE_ADDED,        clCommandEventHandler(Cscope::OnProjectChanged), NULL, this);
+    EventNotifier::Get()->Connect(wxEVT_PROJ_FILE_REMOVED,      clCommandEventHandler(Cscope::OnProjectChanged), NULL, this);
+    EventNotifier::Get()->Connect(wxEVT_PROJ_ADDED,             clCommandEventHandler(Cscope::OnProjectChanged), NULL, this);
+    EventNotifier::Get()->Connect(wxEVT_PROJ_REMOVED,           clCommandEventHandler(Cscope::OnProjectChanged), NULL, this);
+    EventNotifier::Get()->Connect(wxEVT_ACTIVE_PROJECT_CHANGED, clProjectSettingsEventHandler(Cscope::OnActiveProjectChanged), NULL, this);
 
     //start the helper thread
     CScopeThreadST::Get()->Start();
@@ -202,6 +215,14 @@ void Cscope::UnPlug()
     m_topWindow->Disconnect(XRCID("cscope_functions_calling_this_function"), wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(Cscope::OnFindFunctionsCallingThisFunction), NULL, (wxEvtHandler*)this);
     m_topWindow->Disconnect(XRCID("cscope_create_db"), wxEVT_COMMAND_MENU_SELECTED, wxCommandEventHandler(Cscope::OnCreateDB), NULL, (wxEvtHandler*)this);
 
+    EventNotifier::Get()->Disconnect(wxEVT_WORKSPACE_LOADED,       wxCommandEventHandler(Cscope::OnWorkspaceChanged), NULL, this);
+    EventNotifier::Get()->Disconnect(wxEVT_WORKSPACE_CLOSED,       wxCommandEventHandler(Cscope::OnWorkspaceChanged), NULL, this);
+    EventNotifier::Get()->Disconnect(wxEVT_PROJ_FILE_ADDED,        clCommandEventHandler(Cscope::OnProjectChanged), NULL, this);
+    EventNotifier::Get()->Disconnect(wxEVT_PROJ_FILE_REMOVED,      clCommandEventHandler(Cscope::OnProjectChanged), NULL, this);
+    EventNotifier::Get()->Disconnect(wxEVT_PROJ_ADDED,             clCommandEventHandler(Cscope::OnProjectChanged), NULL, this);
+    EventNotifier::Get()->Disconnect(wxEVT_PROJ_REMOVED,           clCommandEventHandler(Cscope::OnProjectChanged), NULL, this);
+    EventNotifier::Get()->Disconnect(wxEVT_ACTIVE_PROJECT_CHANGED, clProjectSettingsEventHandler(Cscope::OnActiveProjectChanged), NULL, this);
+
     // before this plugin is un-plugged we must remove the tab we added
     for (size_t i=0; i<m_mgr->GetOutputPaneNotebook()->GetPageCount(); i++) {
         if (m_cscopeWin == m_mgr->GetOutputPaneNotebook()->GetPage(i)) {
@@ -261,8 +282,11 @@ wxString Cscope::DoCreateListFile(bool force)
     //create temporary file and save the file there
     wxString privateFolder = WorkspaceST::Get()->GetPrivateFolder();
     wxFileName list_file( privateFolder, "cscope_file.list" );
-    if (force || settings.GetRebuildOption() || !list_file.FileExists() ) {
+    // the list is re-generated only when the workspace content (or the scope) has changed
+    // since the last time. cscope itself decides which files to re-scan by their timestamp
+    if (force || m_listFileDirty || m_listFileScope != settings.GetScanScope() || !list_file.FileExists() ) {
         wxArrayString projects;
+        m_listFiles.Clear();
         m_mgr->GetWorkspace()->GetProjectList(projects);
         wxString err_msg;
         std::vector< wxFileName > files;
@@ -293,17 +317,11 @@ wxString Cscope::DoCreateListFile(bool force)
             if (ext == wxT("exe") || ext == wxT("") || ext == wxT("xpm") || ext == wxT("png")) {
                 continue;
             }
+            m_listFiles.Add( tmpfiles.at(i).GetFullPath() );
             tmpfiles.at(i).MakeRelativeTo( privateFolder );
             files.push_back(tmpfiles.at(i));
         }
 
-        //create temporary file and save the file there
-        wxFFile file(list_file.GetFullPath(), wxT("w+b"));
-        if (!file.IsOpened()) {
-            wxLogMessage(wxT("Failed to open temporary file ") + list_file.GetFullPath());
-            return wxEmptyString;
-        }
-
         //write the content of the files into the tempfile
         wxString content;
         for (size_t i=0; i< files.size(); i++) {
@@ -311,14 +329,67 @@ wxString Cscope::DoCreateListFile(bool force)
             content << fn.GetFullPath() << wxT("\n");
         }
 
-        file.Write( content );
-        file.Flush();
-        file.Close();
+        // keep the timestamp of an unchanged list, it tells us if the database is up to date
+        wxString oldContent;
+        if ( list_file.FileExists() ) {
+            wxFFile oldFile(list_file.GetFullPath(), wxT("rb"));
+            if ( oldFile.IsOpened() ) {
+                oldFile.ReadAll( &oldContent );
+                oldFile.Close();
+            }
+        }
+
+        if ( oldContent != content ) {
+            //create temporary file and save the file there
+            wxFFile file(list_file.GetFullPath(), wxT("w+b"));
+            if (!file.IsOpened()) {
+                wxLogMessage(wxT("Failed to open temporary file ") + list_file.GetFullPath());
+                return wxEmptyString;
+            }
+
+            file.Write( content );
+            file.Flush();
+            file.Close();
+        }
+
+        m_listFileDirty = false;
+        m_listFileScope = settings.GetScanScope();
     }
 
     return list_file.GetFullPath();
 }
 
+bool Cscope::DoIsDbUpToDate(const wxString &listFile, bool invertedIndex)
+{
+    wxString privateFolder = WorkspaceST::Get()->GetPrivateFolder();
+    wxFileName db_file( privateFolder, "cscope.out" );
+    if ( !db_file.FileExists() || !wxFileName::FileExists(listFile) ) {
+        return false;
+    }
+
+    if ( invertedIndex ) {
+        if ( !wxFileName(privateFolder, "cscope.in.out").FileExists() || !wxFileName(privateFolder, "cscope.po.out").FileExists() ) {
+            return false;
+        }
+    }
+
+    // the database is up to date if it was written after the list file and
+    // after every file in it was modified
+    wxLogNull noLog;
+    time_t dbTime = db_file.GetModificationTime().GetTicks();
+    if ( wxFileName(listFile).GetModificationTime().GetTicks() > dbTime ) {
+        return false;
+    }
+
+    for (size_t i=0; i<m_listFiles.GetCount(); i++) {
+        wxFileName fn( m_listFiles.Item(i) );
+        if ( !fn.FileExists() || fn.GetModificationTime().GetTicks() >= dbTime ) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void Cscope::DoCscopeCommand(const wxString &command, const wxString &findWhat, const wxString &endMsg)
 {
     // We haven't yet found a valid cscope exe, so look for one
@@ -362,6 +433,9 @@ void Cscope::DoCscopeCommand(const wxString &command, const wxString &findWhat,
     req->SetFindWhat  (findWhat);
     req->SetWorkingDir( WorkspaceST::Get()->GetPrivateFolder() );
 
+    // a query which is still running is no longer needed
+    req->SetId        (++m_requestId);
+    CScopeThreadST::Get()->SetLatestRequestId( m_requestId );
     CScopeThreadST::Get()->Add( req );
 }
 
@@ -504,6 +578,11 @@ void Cscope::OnCreateDB(wxCommandEvent &e)
     command << GetCscopeExeName();
 
     m_mgr->GetConfigTool()->ReadObject(wxT("CscopeSettings"), &settings);
+    if ( DoIsDbUpToDate(list_file, settings.GetBuildRevertedIndexOption()) ) {
+        m_cscopeWin->SetMessage(_("CScope DB is up to date"), 100);
+        return;
+    }
+
     if (settings.GetBuildRevertedIndexOption()) {
         command << wxT(" -q");
         endMsg << _("Recreated inverted CScope DB");
@@ -546,9 +625,20 @@ wxString Cscope::GetCscopeExeName()
 }
 
 void Cscope::OnCScopeThreadEnded(wxCommandEvent &e)
+{
+    // the last chunk of results
+    OnCScopeThreadResults(e);
+}
+
+void Cscope::OnCScopeThreadResults(wxCommandEvent &e)
 {
     CScopeResultTable_t *result = (CScopeResultTable_t*)e.GetClientData();
-    m_cscopeWin->BuildTable( result );
+    if ( e.GetInt() != m_requestId ) {
+        // results of a query which was replaced by a newer one
+        CscopeDbBuilderThread::FreeResults( result );
+        return;
+    }
+    m_cscopeWin->AddResults( result );
 }
 
 void Cscope::OnCScopeThreadUpdateStatus(wxCommandEvent &e)
@@ -578,6 +668,24 @@ void Cscope::OnWorkspaceOpenUI(wxUpdateUIEvent& e)
     e.Enable(m_mgr->IsWorkspaceOpen());
 }
 
+void Cscope::OnWorkspaceChanged(wxCommandEvent& e)
+{
+    e.Skip();
+    m_listFileDirty = true;
+}
+
+void Cscope::OnProjectChanged(clCommandEvent& e)
+{
+    e.Skip();
+    m_listFileDirty = true;
+}
+
+void Cscope::OnActiveProjectChanged(clProjectSettingsEvent& e)
+{
+    e.Skip();
+    m_listFileDirty = true;
+}
+
 void Cscope::OnFindUserInsertedSymbol(wxCommandEvent& WXUNUSED(e))
 {
     wxString word = GetSearchPattern();
@@ -29,6 +29,7 @@
 #include "map"
 #include "vector"
 #include "cscopeentrydata.h"
+#include "cl_command_event.h"
 
 class CscopeTab;
 
@@ -36,6 +37,10 @@ class Cscope : public IPlugin
 {
 	wxEvtHandler *m_topWindow;
 	CscopeTab    *m_cscopeWin;
+	int           m_requestId;
+	bool          m_listFileDirty;
+	wxString      m_listFileScope;
+	wxArrayString m_listFiles;
 
 public:
 	Cscope(IManager *manager);
@@ -55,6 +60,7 @@ protected:
 	wxMenu * CreateEditorPopMenu();
 	wxString GetCscopeExeName();
 	wxString DoCreateListFile(bool force);
+	bool     DoIsDbUpToDate(const wxString &listFile, bool invertedIndex);
 	void     DoCscopeCommand(const wxString &command, const wxString &findWhat, const wxString &endMsg);
 	void     DoFindSymbol(const wxString& word);
 	wxString GetSearchPattern() const;
@@ -70,9 +76,13 @@ protected:
 	void OnCreateDB                         (wxCommandEvent &e);
 	void OnDoSettings                       (wxCommandEvent &e);
 	void OnCScopeThreadEnded                (wxCommandEvent &e);
+	void OnCScopeThreadResults              (wxCommandEvent &e);
 	void OnCScopeThreadUpdateStatus         (wxCommandEvent &e);
 	void OnCscopeUI                         (wxUpdateUIEvent &e);
 	void OnWorkspaceOpenUI                  (wxUpdateUIEvent &e);
+	void OnWorkspaceChanged                 (wxCommandEvent &e);
+	void OnProjectChanged                   (clCommandEvent &e);
+	void OnActiveProjectChanged             (clProjectSettingsEvent &e);
 };
 
 #endif //Cscope
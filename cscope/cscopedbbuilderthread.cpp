@@ -23,7 +23,7 @@
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 #include "cscopestatusmessage.h"
-#include "procutils.h"
+#include "asyncprocess.h"
 #include "dirsaver.h"
 #include "wx/filefn.h"
 #include "cscopedbbuilderthread.h"
@@ -31,8 +31,15 @@
 
 int wxEVT_CSCOPE_THREAD_DONE            = wxNewId();
 int wxEVT_CSCOPE_THREAD_UPDATE_STATUS   = wxNewId();
+int wxEVT_CSCOPE_THREAD_RESULTS         = wxNewId();
+
+// Parsed entries are sent to the UI once this many were collected or
+// when this many milliseconds passed since the previous chunk
+#define CSCOPE_RESULTS_CHUNK_SIZE     1000
+#define CSCOPE_RESULTS_CHUNK_INTERVAL 250
 
 CscopeDbBuilderThread::CscopeDbBuilderThread()
+	: m_latestRequestId(0)
 {
 }
 
@@ -44,81 +51,152 @@ void CscopeDbBuilderThread::ProcessRequest(ThreadRequest *request)
 {
 	CscopeRequest *req = (CscopeRequest*)request;
 
+	// Only queries can be superseded, a database build always runs to its end
+	bool isQuery = !req->GetFindWhat().IsEmpty();
+	if ( isQuery && req->GetId() != m_latestRequestId ) {
+		return;
+	}
+
 	//change dir to the workspace directory
 	DirSaver ds;
 
 	wxSetWorkingDirectory(req->GetWorkingDir());
 	SendStatusEvent( _("Executing cscope..."), 10, req->GetFindWhat(), req->GetOwner() );
 
-	//notify the database creation process as completed
-	wxArrayString output;
-
 	//set environment variables required by cscope
 	wxSetEnv(wxT("TMPDIR"), wxFileName::GetTempDir());
-	ProcUtils::SafeExecuteCommand(req->GetCmd(), output);
-	SendStatusEvent( _("Parsing results..."), 50, wxEmptyString, req->GetOwner() );
 
-	CScopeResultTable_t *result = ParseResults( output );
+	CScopeResultTable_t *results = new CScopeResultTable_t();
+	IProcess::Ptr_t proc(::CreateSyncProcess(req->GetCmd(), IProcessCreateDefault | IProcessCreateWithHiddenConsole, req->GetWorkingDir()));
+	if ( proc ) {
+		// parse the output while cscope is still producing it, and pass the
+		// entries to the UI in chunks instead of waiting for the whole output
+		wxString output, buff;
+		size_t chunkCount(0), totalCount(0);
+		wxLongLong lastChunk = wxGetLocalTimeMillis();
+
+		while ( proc->Read(buff) ) {
+			if ( (isQuery && req->GetId() != m_latestRequestId) || TestDestroy() ) {
+				// the process is killed when 'proc' goes out of scope
+				FreeResults(results);
+				return;
+			}
+
+			if ( !buff.IsEmpty() ) {
+				output << buff;
+
+				// keep the trailing partial line for the next read
+				size_t first(0), eol;
+				while ( (eol = output.find(wxT('\n'), first)) != wxString::npos ) {
+					if ( ParseLine(output, first, eol, results) ) {
+						++chunkCount;
+						++totalCount;
+					}
+					first = eol + 1;
+				}
+				output.erase(0, first);
+			}
+
+			if ( chunkCount && (chunkCount >= CSCOPE_RESULTS_CHUNK_SIZE || wxGetLocalTimeMillis() - lastChunk >= CSCOPE_RESULTS_CHUNK_INTERVAL) ) {
+				SendResults(results, wxEVT_CSCOPE_THREAD_RESULTS, req);
+				SendStatusEvent( wxString::Format(_("Parsing results... (%u)"), (unsigned int)totalCount), 50, wxEmptyString, req->GetOwner() );
+
+				results    = new CScopeResultTable_t();
+				chunkCount = 0;
+				lastChunk  = wxGetLocalTimeMillis();
+			}
+		}
+
+		// output which did not end with a newline
+		ParseLine(output, 0, output.length(), results);
+	}
+
 	SendStatusEvent( _("Done"), 100, wxEmptyString, req->GetOwner() );
 
 	// send status message
 	SendStatusEvent(req->GetEndMsg(), 100, wxEmptyString, req->GetOwner());
 
-	// send the results
-	wxCommandEvent e(wxEVT_CSCOPE_THREAD_DONE);
-	e.SetClientData(result);
-	req->GetOwner()->AddPendingEvent(e);
+	// send the remaining results
+	SendResults(results, wxEVT_CSCOPE_THREAD_DONE, req);
 }
 
-CScopeResultTable_t* CscopeDbBuilderThread::ParseResults(const wxArrayString &output)
+bool CscopeDbBuilderThread::ParseLine(const wxString &output, size_t first, size_t last, CScopeResultTable_t *results)
 {
-	CScopeResultTable_t *results = new CScopeResultTable_t();
-	for (size_t i=0; i< output.GetCount(); i++) {
-		//parse each line
-		wxString line = output.Item(i);
-		CscopeEntryData data;
-
-		//first is the file name
-		line = line.Trim().Trim(false);
-		//skip errors
-		if(line.StartsWith(wxT("cscope:"))){continue;}
-
-		wxString file = line.BeforeFirst(wxT(' '));
-		data.SetFile(file);
-		line = line.AfterFirst(wxT(' '));
-
-		//next is the scope
-		line = line.Trim().Trim(false);
-		wxString scope = line.BeforeFirst(wxT(' '));
-		line = line.AfterFirst(wxT(' '));
-		data.SetScope( scope );
-
-		//next is the line number
-		line = line.Trim().Trim(false);
-		long nn;
-		wxString line_number = line.BeforeFirst(wxT(' '));
-		line_number.ToLong( &nn );
-		data.SetLine( nn );
-		line = line.AfterFirst(wxT(' '));
-
-		//the rest is the pattern
-		wxString pattern = line;
-		data.SetPattern(pattern);
-
-		//insert the result
-		CScopeResultTable_t::const_iterator iter = results->find(data.GetFile());
-		std::vector< CscopeEntryData > *vec(NULL);
-		if (iter != results->end()) {
-			//this file already exist, append the result
-			vec = iter->second;
-		} else {
-			vec = new std::vector< CscopeEntryData >();
-			//add it to the map
-			(*results)[data.GetFile()] = vec;
+	// trim the line
+	while ( first < last && wxIsspace(output.GetChar(first)) ) {
+		++first;
+	}
+	while ( last > first && wxIsspace(output.GetChar(last-1)) ) {
+		--last;
+	}
+
+	//skip empty lines and errors
+	if ( first == last || output.compare(first, 7, wxT("cscope:")) == 0 ) {
+		return false;
+	}
+
+	// the line is: <file> <scope> <line number> <pattern>
+	wxString tokens[3];
+	size_t pos = first;
+	for (size_t i=0; i<3; i++) {
+		while ( pos < last && wxIsspace(output.GetChar(pos)) ) {
+			++pos;
+		}
+		size_t start = pos;
+		while ( pos < last && output.GetChar(pos) != wxT(' ') ) {
+			++pos;
 		}
-		vec->push_back( data );
+		tokens[i] = output.substr(start, pos - start);
+		if ( pos < last ) {
+			// skip the separator
+			++pos;
+		}
+	}
+
+	CscopeEntryData data;
+	long nn(0);
+	tokens[2].ToLong( &nn );
+	data.SetFile   ( tokens[0] );
+	data.SetScope  ( tokens[1] );
+	data.SetLine   ( nn );
+	//the rest is the pattern
+	data.SetPattern( output.substr(pos, last - pos) );
+
+	//insert the result
+	CScopeResultTable_t::const_iterator iter = results->find(data.GetFile());
+	std::vector< CscopeEntryData > *vec(NULL);
+	if (iter != results->end()) {
+		//this file already exist, append the result
+		vec = iter->second;
+	} else {
+		vec = new std::vector< CscopeEntryData >();
+		//add it to the map
+		(*results)[data.GetFile()] = vec;
+	}
+	vec->push_back( data );
+	return true;
+}
+
+void CscopeDbBuilderThread::SendResults(CScopeResultTable_t *results, int eventType, CscopeRequest *req)
+{
+	wxCommandEvent e(eventType);
+	e.SetClientData(results);
+	e.SetInt(req->GetId());
+	req->GetOwner()->AddPendingEvent(e);
+}
+
+void CscopeDbBuilderThread::FreeResults(CScopeResultTable_t *results)
+{
+	if ( !results ) {
+		return;
+	}
+
+	CScopeResultTable_t::iterator iter = results->begin();
+	for (; iter != results->end(); iter++) {
+		delete iter->second;
 	}
-	return results;
+	results->clear();
+	delete results;
 }
 
 void CscopeDbBuilderThread::SendStatusEvent(const wxString &msg, int percent, const wxString &findWhat, wxEvtHandler *owner)
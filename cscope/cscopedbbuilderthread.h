@@ -37,6 +37,7 @@
 
 extern int wxEVT_CSCOPE_THREAD_DONE;
 extern int wxEVT_CSCOPE_THREAD_UPDATE_STATUS;
+extern int wxEVT_CSCOPE_THREAD_RESULTS;
 
 typedef std::vector< CscopeEntryData > CScopeEntryDataVec_t;
 typedef std::map<wxString, CScopeEntryDataVec_t* > CScopeResultTable_t;
@@ -55,8 +56,9 @@ class CscopeRequest : public ThreadRequest
 	wxString      m_outfile;
 	wxString      m_endMsg;
 	wxString      m_findWhat;
+	int           m_id;
 public:
-	CscopeRequest() {};
+	CscopeRequest() : m_owner(NULL), m_id(0) {};
 	~CscopeRequest() {};
 
 
@@ -100,21 +102,44 @@ public:
 	const wxString& GetEndMsg() const {
 		return m_endMsg;
 	}
+	void SetId(int id) {
+		this->m_id = id;
+	}
+	int GetId() const {
+		return m_id;
+	}
 };
 
 class CscopeDbBuilderThread : public WorkerThread
 {
 	friend class Singleton< CscopeDbBuilderThread >;
+	volatile int m_latestRequestId;
+
 protected:
 	void ProcessRequest(ThreadRequest *req);
-	CScopeResultTable_t* ParseResults(const wxArrayString &output);
+	bool ParseLine(const wxString &output, size_t first, size_t last, CScopeResultTable_t *results);
 
 protected:
 	void SendStatusEvent(const wxString &msg, int percent, const wxString &findWhat, wxEvtHandler *owner);
+	void SendResults(CScopeResultTable_t *results, int eventType, CscopeRequest *req);
 
 public:
 	CscopeDbBuilderThread();
 	~CscopeDbBuilderThread();
+
+	/**
+	 * @brief a newer query was issued, the output of older queries is
+	 * no longer needed. Called from the main thread
+	 */
+	void SetLatestRequestId(int id) {
+		m_latestRequestId = id;
+	}
+
+	/**
+	 * @brief free a result table sent with wxEVT_CSCOPE_THREAD_RESULTS /
+	 * wxEVT_CSCOPE_THREAD_DONE
+	 */
+	static void FreeResults(CScopeResultTable_t *results);
 };
 
 typedef Singleton< CscopeDbBuilderThread > CScopeThreadST;
@@ -83,9 +83,11 @@ void CscopeTab::Clear()
         FreeTable();
     }
     m_dataviewModel->Clear();
+    m_fileItems.clear();
+    m_insertedItems.clear();
 }
 
-void CscopeTab::BuildTable(CScopeResultTable_t *table)
+void CscopeTab::AddResults(CScopeResultTable_t *table)
 {
     if ( !table ) {
         return;
@@ -97,18 +99,24 @@ void CscopeTab::BuildTable(CScopeResultTable_t *table)
     }
 
     m_table = table;
-    m_dataviewModel->Clear();
 
-    wxStringSet_t insertedItems;
     CScopeResultTable_t::iterator iter = m_table->begin();
     for (; iter != m_table->end(); ++iter ) {
         wxString file = iter->first;
 
         wxVector<wxVariant> cols;
-        cols.push_back( CScoptViewResultsModel::CreateIconTextVariant(file, GetBitmap(file)) );
-        cols.push_back(wxString());
-        cols.push_back(wxString());
-        wxDataViewItem fileItem = m_dataviewModel->AppendItem( wxDataViewItem(0), cols, NULL);
+        wxDataViewItem fileItem;
+        std::map<wxString, wxDataViewItem>::iterator fileIter = m_fileItems.find(file);
+        if ( fileIter != m_fileItems.end() ) {
+            fileItem = fileIter->second;
+
+        } else {
+            cols.push_back( CScoptViewResultsModel::CreateIconTextVariant(file, GetBitmap(file)) );
+            cols.push_back(wxString());
+            cols.push_back(wxString());
+            fileItem = m_dataviewModel->AppendItem( wxDataViewItem(0), cols, NULL);
+            m_fileItems.insert( std::make_pair(file, fileItem) );
+        }
 
         // Add the entries for this file
         CScopeEntryDataVec_t* vec = iter->second;
@@ -117,8 +125,8 @@ void CscopeTab::BuildTable(CScopeResultTable_t *table)
             // Dont insert duplicate entries to the match view
             wxString display_string;
             display_string << _("Line: ") << entry.GetLine() << wxT(", ") << entry.GetScope() << wxT(", ") << entry.GetPattern();
-            if(insertedItems.find(display_string) == insertedItems.end()) {
-                insertedItems.insert(display_string);
+            if(m_insertedItems.find(display_string) == m_insertedItems.end()) {
+                m_insertedItems.insert(display_string);
                 cols.clear();
                 cols.push_back( CScoptViewResultsModel::CreateIconTextVariant(entry.GetScope(), wxNullBitmap) );
                 cols.push_back( (wxString() << entry.GetLine()) );
@@ -132,15 +140,8 @@ void CscopeTab::BuildTable(CScopeResultTable_t *table)
 
 void CscopeTab::FreeTable()
 {
-    if (m_table) {
-        CScopeResultTable_t::iterator iter = m_table->begin();
-        for (; iter != m_table->end(); iter++ ) {
-            //delete the vector
-            delete iter->second;
-        }
-        m_table->clear();
-        wxDELETE(m_table);
-    }
+    CscopeDbBuilderThread::FreeResults(m_table);
+    m_table = NULL;
 }
 
 void CscopeTab::DoItemActivated(const wxDataViewItem& item )
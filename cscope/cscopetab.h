@@ -65,6 +65,8 @@ class CscopeTab : public CscopeTabBase
     StringManager      m_stringManager;
     wxFont             m_font;
     BitmapLoader::BitmapMap_t m_bitmaps;
+    std::map<wxString, wxDataViewItem> m_fileItems;
+    wxStringSet_t      m_insertedItems;
 
 protected:
     virtual void OnItemSelected(wxDataViewEvent& event);
@@ -87,7 +89,12 @@ public:
     CscopeTab( wxWindow* parent, IManager *mgr );
     virtual ~CscopeTab();
 
-    void BuildTable(CScopeResultTable_t *table);
+    /**
+     * @brief append a chunk of results to the view. Files which were already
+     * added by a previous chunk are reused, duplicate entries are skipped.
+     * The table is owned (and freed) by the view
+     */
+    void AddResults(CScopeResultTable_t *table);
     void Clear();
     void SetMessage(const wxString &msg, int percent);
 